@@ -1,17 +1,22 @@
 #pragma once
 
-#ifdef ELLE_WITH_MEASURE
-# include <atomic>
-# include <chrono>
-# include <iostream>
-# include <string>
+#include <chrono>
 
-# include <elle/memory.hh>
-# include <elle/printf.hh>
-#endif
+#include <boost/preprocessor/cat.hpp>
+
+#include <elle/metrics.hh>
+
+/// The histogram of a measure point, looked up once.
+#define ELLE_MEASURE_HISTOGRAM(_name)                                   \
+  [&] () -> ::elle::metrics::Histogram&                                 \
+  {                                                                     \
+    static auto& histogram = ::elle::metrics::histogram(_name);         \
+    return histogram;                                                   \
+  }()                                                                   \
+  /**/
 
 #define ELLE_MEASURE_INSTANCE(_name)                                    \
-  ::elle::Measure(__FILE__, __LINE__, _name)                            \
+  ::elle::Measure(ELLE_MEASURE_HISTOGRAM(_name))                        \
   /**/
 
 #define ELLE_MEASURE_SCOPE_INTERNAL(_name)                                   \
@@ -33,6 +38,10 @@ namespace elle
 {
   /// A class to measure execution time of a given scope.
   ///
+  /// Durations are recorded, in nanoseconds, in the metrics histogram named
+  /// after the measure. Nothing is measured unless metrics are enabled, see
+  /// elle::metrics::enabled.
+  ///
   /// \code{.cc}
   ///
   /// void
@@ -56,31 +65,28 @@ namespace elle
   /// \endcode
   struct Measure
   {
-#ifdef ELLE_WITH_MEASURE
-    Measure(char const* file, unsigned int line, std::string name)
-      : file{file}
-      , line{line}
-      , name{name}
+    using Clock = std::chrono::steady_clock;
+
+    Measure(metrics::Histogram& histogram)
+      : _histogram(metrics::enabled() ? &histogram : nullptr)
+      , _start(this->_histogram ? Clock::now() : Clock::time_point())
+    {}
+
+    Measure(Measure&& source)
+      : _histogram(source._histogram)
+      , _start(source._start)
     {
-      _indent()++;
+      source._histogram = nullptr;
     }
 
+    /// Record the time elapsed since construction, once.
     void
     end()
     {
-      if (!this->done)
+      if (this->_histogram)
       {
-        this->done = true;
-        using namespace std::chrono;
-        auto d = duration_cast<milliseconds>(system_clock::now() - this->start);
-        elle::fprintf(std::cout,
-                      "%s %s took %s ms (%s:%s)\n",
-                      std::string(_indent(), '#'),
-                      this->name,
-                      d.count(),
-                      this->file,
-                      this->line);
-        _indent()--;
+        this->_histogram->record(Clock::now() - this->_start);
+        this->_histogram = nullptr;
       }
     }
 
@@ -89,27 +95,13 @@ namespace elle
       this->end();
     }
 
-    char const* file;
-    unsigned int line;
-    std::string const name;
-    std::chrono::system_clock::time_point const start
-      = std::chrono::system_clock::now();
-    bool done = false;
-
-  private:
-    static
-    std::atomic_size_t& _indent()
+    operator bool() const
     {
-      static std::atomic_size_t i;
-      return i;
+      return false;
     }
-#else
-    // Empty implementation
-    template <typename... Args>
-    inline Measure(Args&&...) {}
-    inline void end() {}
-#endif
-  public:
-     operator bool() const { return false; }
+
+  private:
+    metrics::Histogram* _histogram;
+    Clock::time_point _start;
   };
 }
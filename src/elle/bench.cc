@@ -1,5 +1,7 @@
 #include <elle/bench.hh>
 
+#include <cmath>
+
 #include <elle/log.hh>
 #include <elle/printf.hh>
 
@@ -32,11 +34,19 @@ namespace elle
     , _enabled{elle::log::detail::Send::active(elle::log::Logger::Level::trace,
                                                elle::log::Logger::Type::info,
                                                this->_name.c_str())}
+    , _histogram(metrics::histogram(name))
     , _start{now()}
   {}
 
   void
   Bench::add(double val)
+  {
+    this->_histogram.record(std::uint64_t(std::llround(std::max(val, 0.))));
+    this->_add(val);
+  }
+
+  void
+  Bench::_add(double val)
   {
     if (!this->_count)
       this->_min = this->_max = val;
@@ -102,15 +112,15 @@ namespace elle
   }
 
   Bench::BenchScope::BenchScope(Bench& owner)
-    : _owner(owner)
-  {
-    this->_start = now();
-  }
+    : _start(std::chrono::steady_clock::now())
+    , _owner(owner)
+  {}
 
   Bench::BenchScope::~BenchScope()
   {
-    using ms = std::chrono::microseconds;
-    auto const d = std::chrono::duration_cast<ms>(now() - this->_start);
-    this->_owner.add(d.count());
+    auto const d = std::chrono::steady_clock::now() - this->_start;
+    this->_owner._histogram.record(d);
+    this->_owner._add(
+      std::chrono::duration_cast<std::chrono::microseconds>(d).count());
   }
 }
@@ -2,6 +2,7 @@
 
 #include <elle/attribute.hh>
 #include <elle/compiler.hh>
+#include <elle/metrics.hh>
 #include <elle/time.hh>
 
 namespace elle
@@ -9,7 +10,8 @@ namespace elle
 
   /// Bench a block of code or display statistics about some data.
   ///
-  /// N.B. The Bench is active if the LOG_LEVEL related is activated.
+  /// N.B. The Bench is active if the LOG_LEVEL related is activated.  Values
+  /// are recorded regardless in the metrics histogram of the same name.
   ///
   /// @code{.cc}
   ///
@@ -41,11 +43,13 @@ namespace elle
     ///
     /// This call show() if the component is enabled.
     ~Bench();
-    /// Add a time period (in milliseconds) for a given Bench.
+    /// Add a value to the Bench.
     ///
-    /// BenchScope automatically adds its lifetime duration to its owner Bench.
+    /// The metrics histogram holds @a val as is, in whatever unit the caller
+    /// uses. BenchScope instead records its lifetime in nanoseconds there,
+    /// like ELLE_MEASURE, and in microseconds in the Bench statistics.
     ///
-    /// @param val A duration (in milliseconds) to add to the Bench.
+    /// @param val The value to add to the Bench.
     void
     add(double val);
     /// Reset all underlying values of the Bench.
@@ -65,9 +69,13 @@ namespace elle
       BenchScope(Bench& owner);
       ~BenchScope();
     private:
-      Time _start;
+      std::chrono::steady_clock::time_point _start;
       Bench& _owner;
     };
+  private:
+    /// Add @a val to the statistics only.
+    void
+    _add(double val);
 
     ELLE_ATTRIBUTE_R(std::string, name);
     ELLE_ATTRIBUTE_R(double, sum);
@@ -77,6 +85,7 @@ namespace elle
     ELLE_ATTRIBUTE_R(Duration, log_interval);
     ELLE_ATTRIBUTE(double, roundfactor);
     ELLE_ATTRIBUTE_R(bool, enabled);
+    ELLE_ATTRIBUTE(metrics::Histogram&, histogram);
     // Make it last, so that it is set only when the remainder was
     // initialized.
     ELLE_ATTRIBUTE_R(Time, start);
@@ -0,0 +1,40 @@
+// Turn logs written by elle::log::BinaryLogger back into text.
+//
+// Usage: elle-log-decode [FILE...]
+//
+// Decode each FILE, or the standard input, to the standard output.  The text
+// is rendered as TextLogger would, following the usual environment: e.g.
+// ELLE_LOG_LEVEL to filter messages, ELLE_LOG_TIME to show times,
+// ELLE_LOG_TID to show thread ids.
+
+#include <fstream>
+#include <iostream>
+
+#include <elle/Error.hh>
+#include <elle/err.hh>
+#include <elle/log/BinaryLogger.hh>
+#include <elle/log/TextLogger.hh>
+#include <elle/printf.hh>
+
+int
+main(int argc, char** argv)
+{
+  try
+  {
+    elle::log::TextLogger out(std::cout, "DUMP");
+    if (argc < 2)
+      elle::log::BinaryLogger::decode(std::cin, out);
+    for (int i = 1; i < argc; ++i)
+    {
+      std::ifstream in(argv[i], std::ios::binary);
+      if (!in)
+        elle::err("unable to open %s", argv[i]);
+      elle::log::BinaryLogger::decode(in, out);
+    }
+  }
+  catch (elle::Error const& e)
+  {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+}
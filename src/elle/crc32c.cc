@@ -0,0 +1,142 @@
+#include <elle/crc32c.hh>
+
+#include <array>
+#include <cstring>
+
+#include <elle/Buffer.hh>
+
+#if defined __x86_64__ && (defined __GNUC__ || defined __clang__)
+# define ELLE_CRC32C_SSE42
+# include <nmmintrin.h>
+#elif defined __aarch64__ && defined __ARM_FEATURE_CRC32
+# define ELLE_CRC32C_ARM
+# include <arm_acle.h>
+#endif
+
+namespace elle
+{
+  namespace
+  {
+    /// Reflected Castagnoli polynomial.
+    constexpr std::uint32_t polynomial = 0x82f63b78;
+
+    using Tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+    /// Slicing-by-8 tables: tables[k][b] is the CRC of byte b followed by k
+    /// zero bytes.
+    Tables const&
+    tables()
+    {
+      static auto const res = []
+        {
+          auto res = Tables{};
+          for (unsigned b = 0; b < 256; ++b)
+          {
+            auto crc = std::uint32_t(b);
+            for (int i = 0; i < 8; ++i)
+              crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+            res[0][b] = crc;
+          }
+          for (unsigned b = 0; b < 256; ++b)
+            for (int k = 1; k < 8; ++k)
+              res[k][b] =
+                (res[k - 1][b] >> 8) ^ res[0][res[k - 1][b] & 0xff];
+          return res;
+        }();
+      return res;
+    }
+
+    std::uint32_t
+    software(unsigned char const* p, std::size_t size, std::uint32_t crc)
+    {
+      auto const& t = tables();
+      for (; size && reinterpret_cast<std::uintptr_t>(p) % 8; --size)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+      for (; size >= 8; size -= 8, p += 8)
+      {
+        // Little endian loads: the reflected CRC consumes the low byte first.
+        auto const low = std::uint32_t(p[0]) | std::uint32_t(p[1]) << 8 |
+          std::uint32_t(p[2]) << 16 | std::uint32_t(p[3]) << 24;
+        auto const high = std::uint32_t(p[4]) | std::uint32_t(p[5]) << 8 |
+          std::uint32_t(p[6]) << 16 | std::uint32_t(p[7]) << 24;
+        auto const x = crc ^ low;
+        crc =
+          t[7][x & 0xff] ^ t[6][(x >> 8) & 0xff] ^
+          t[5][(x >> 16) & 0xff] ^ t[4][x >> 24] ^
+          t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^
+          t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+      }
+      for (; size; --size)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+      return crc;
+    }
+
+#if defined ELLE_CRC32C_SSE42
+    __attribute__((target("sse4.2")))
+    std::uint32_t
+    hardware(unsigned char const* p, std::size_t size, std::uint32_t crc)
+    {
+      for (; size && reinterpret_cast<std::uintptr_t>(p) % 8; --size)
+        crc = _mm_crc32_u8(crc, *p++);
+      auto crc64 = std::uint64_t(crc);
+      for (; size >= 8; size -= 8, p += 8)
+      {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+      }
+      crc = std::uint32_t(crc64);
+      for (; size; --size)
+        crc = _mm_crc32_u8(crc, *p++);
+      return crc;
+    }
+
+    bool
+    has_hardware()
+    {
+      static bool const res = __builtin_cpu_supports("sse4.2");
+      return res;
+    }
+#elif defined ELLE_CRC32C_ARM
+    std::uint32_t
+    hardware(unsigned char const* p, std::size_t size, std::uint32_t crc)
+    {
+      for (; size && reinterpret_cast<std::uintptr_t>(p) % 8; --size)
+        crc = __crc32cb(crc, *p++);
+      for (; size >= 8; size -= 8, p += 8)
+      {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        crc = __crc32cd(crc, word);
+      }
+      for (; size; --size)
+        crc = __crc32cb(crc, *p++);
+      return crc;
+    }
+
+    constexpr
+    bool
+    has_hardware()
+    {
+      return true;
+    }
+#endif
+  }
+
+  std::uint32_t
+  crc32c(void const* data, std::size_t size, std::uint32_t crc)
+  {
+    auto const p = static_cast<unsigned char const*>(data);
+#if defined ELLE_CRC32C_SSE42 || defined ELLE_CRC32C_ARM
+    if (has_hardware())
+      return ~hardware(p, size, ~crc);
+#endif
+    return ~software(p, size, ~crc);
+  }
+
+  std::uint32_t
+  crc32c(ConstWeakBuffer data, std::uint32_t crc)
+  {
+    return crc32c(data.contents(), data.size(), crc);
+  }
+}
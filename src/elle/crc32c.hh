@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <elle/compiler.hh>
+#include <elle/fwd.hh>
+
+namespace elle
+{
+  /// The CRC-32C (Castagnoli) of @a size bytes at @a data.
+  ///
+  /// Computed with the SSE 4.2 or ARMv8 CRC instructions when available, with
+  /// a table driven implementation otherwise. Checksums can be computed
+  /// incrementally by passing the checksum of the previous bytes:
+  ///
+  /// @code{.cc}
+  ///
+  /// auto crc = elle::crc32c(header, header_size);
+  /// crc = elle::crc32c(body, body_size, crc);
+  /// assert(crc == elle::crc32c(message, header_size + body_size));
+  ///
+  /// @endcode
+  ///
+  /// @param data The bytes to checksum.
+  /// @param size The number of bytes.
+  /// @param crc The checksum of the preceding bytes, if any.
+  /// @returns The checksum of the preceding bytes followed by @a data.
+  ELLE_API
+  std::uint32_t
+  crc32c(void const* data, std::size_t size, std::uint32_t crc = 0);
+
+  /// The CRC-32C of @a data, see crc32c(void const*, std::size_t,
+  /// std::uint32_t).
+  ELLE_API
+  std::uint32_t
+  crc32c(ConstWeakBuffer data, std::uint32_t crc = 0);
+}
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <boost/optional.hpp>
+
+#include <elle/attribute.hh>
 #include <elle/serialization/SerializerIn.hh>
 #include <elle/serialization/SerializerOut.hh>
 
@@ -24,11 +33,122 @@ namespace elle
       {
         return T(std::move(args)...);
       }
+
+      /// The names of a list of fields.
+      template <typename ... Fields>
+      struct names
+      {
+        static
+        std::vector<std::string>
+        value()
+        {
+          return {Fields::name()...};
+        }
+      };
+
+      /// A perfect hash of the field names of a model.
+      ///
+      /// A key is hashed once, and finds its only candidate field in one
+      /// probe. Unknown keys are mostly told apart by their hash alone.
+      class Keys
+      {
+      public:
+        Keys(std::vector<std::string> names)
+          : _names(std::move(names))
+        {
+          // Grow the table until some seed spreads the names without
+          // collision, which takes a few tries for a handful of fields.
+          for (auto size = std::size_t(4); ; size *= 2)
+          {
+            while (size < 2 * this->_names.size())
+              size *= 2;
+            for (this->_seed = 0; this->_seed < 64; ++this->_seed)
+              if (this->_spread(size))
+                return;
+          }
+        }
+
+        /// The name of the field at @a i, in model order.
+        std::string const&
+        name(int i) const
+        {
+          return this->_names[i];
+        }
+
+        /// The index of the field named @a key, or -1.
+        int
+        index(std::string const& key) const
+        {
+          auto const h = this->_hash(key);
+          auto const i = this->_slots[h & (this->_slots.size() - 1)];
+          if (i < 0 || this->_hashes[i] != h || this->_names[i] != key)
+            return -1;
+          return i;
+        }
+
+      private:
+        /// FNV-1a, salted with the seed.
+        uint64_t
+        _hash(std::string const& key) const
+        {
+          auto res = uint64_t(14695981039346656037ull) ^ this->_seed;
+          for (auto c: key)
+          {
+            res ^= static_cast<unsigned char>(c);
+            res *= 1099511628211ull;
+          }
+          return res;
+        }
+
+        /// Fill a table of @a size slots, if the names do not collide in it.
+        bool
+        _spread(std::size_t size)
+        {
+          this->_hashes.clear();
+          this->_slots.assign(size, -1);
+          for (int i = 0; i < int(this->_names.size()); ++i)
+          {
+            this->_hashes.emplace_back(this->_hash(this->_names[i]));
+            auto& slot = this->_slots[this->_hashes.back() & (size - 1)];
+            if (slot == -1)
+              slot = i;
+            // A name given twice is only dispatched to its first field.
+            else if (this->_names[slot] != this->_names[i])
+              return false;
+          }
+          return true;
+        }
+
+        ELLE_ATTRIBUTE(std::vector<std::string>, names);
+        ELLE_ATTRIBUTE(std::vector<uint64_t>, hashes);
+        ELLE_ATTRIBUTE(std::vector<int>, slots);
+        ELLE_ATTRIBUTE(uint64_t, seed);
+      };
     }
 
+    /// Serialize objects of type O as modeled by M.
+    ///
+    /// The model is compiled into a plan once: fields are serialized in
+    /// model order under names computed once, and deserialized from keyed
+    /// formats such as JSON in the order the input has them, each key being
+    /// dispatched to its field by a perfect hash (see keys()).
     template <typename O, typename M = typename DefaultModel<O>::type>
     struct Serializer
     {
+      /// The field names of M, and their perfect hash.
+      static
+      _details::Keys const&
+      keys()
+      {
+        static auto const res =
+          _details::Keys(M::Fields::template apply<_details::names>::value());
+        return res;
+      }
+
+      /// The index of field T in M.
+      template <typename T>
+      using index = typename M::Fields::template index_of<T>;
+
       template <typename T>
       struct Serialize
       {
@@ -37,7 +157,8 @@ namespace elle
         int
         value(O const& o, elle::serialization::SerializerOut& s)
         {
-          s.serialize(T::name(), M::template FieldType<T>::get(o));
+          s.serialize(keys().name(index<T>::value),
+                      M::template FieldType<T>::get(o));
           return 0;
         }
       };
@@ -51,7 +172,7 @@ namespace elle
         type
         value(elle::serialization::SerializerIn& s)
         {
-          return s.deserialize<type>(T::name());
+          return s.deserialize<type>(keys().name(index<T>::value));
         }
       };
 
@@ -64,7 +185,8 @@ namespace elle
         value(elle::serialization::SerializerIn& s, O& o)
         {
           T::attr_get(o) =
-            s.deserialize<typename T::template attr_type<O>>(T::name());
+            s.deserialize<typename T::template attr_type<O>>(
+              keys().name(index<T>::value));
           return false;
         }
       };
@@ -93,6 +215,63 @@ namespace elle
 
     namespace _details
     {
+      template <typename T>
+      struct Slot
+      {
+        using type = boost::optional<T>;
+      };
+
+      /// Deserialize by constructor, from a keyed input.
+      ///
+      /// Fields are kept aside as they come, then the missing ones are looked
+      /// up by name for the format to default them or report them.
+      template <typename O, typename M>
+      struct Construct
+      {
+        using Slots = typename M::Types::template map<Slot>::type
+          ::template apply<std::tuple>;
+        using Read = void (*)(elle::serialization::SerializerIn&, Slots&);
+
+        template <std::size_t I>
+        static
+        void
+        read(elle::serialization::SerializerIn& s, Slots& slots)
+        {
+          using T = typename std::tuple_element_t<I, Slots>::value_type;
+          std::get<I>(slots).emplace(s.deserialize<T>());
+        }
+
+        template <std::size_t ... I>
+        static
+        boost::optional<O>
+        value(elle::serialization::SerializerIn& s, std::index_sequence<I...>)
+        {
+          static auto const reads = std::array<Read, sizeof ... (I)>{{
+            &read<I>...
+          }};
+          auto const& keys = Serializer<O, M>::keys();
+          auto slots = Slots{};
+          if (!s.deserialize_keys(
+                [&] (std::string const& key)
+                {
+                  auto const i = keys.index(key);
+                  if (i != -1)
+                    reads[i](s, slots);
+                }))
+            return boost::none;
+          int ignore[] = {
+            0,
+            (std::get<I>(slots) ? 0 :
+             (std::get<I>(slots).emplace(
+               s.deserialize<
+                 typename std::tuple_element_t<I, Slots>::value_type>(
+                   keys.name(I))), 0))...
+          };
+          (void)ignore;
+          return O(std::move(*std::get<I>(slots))...);
+        }
+      };
+
       /// Deserialize by constructor.
       template <typename O, typename M>
       std::enable_if_t<
@@ -100,6 +279,11 @@ namespace elle
         O>
       deserialize_switch(elle::serialization::SerializerIn& s)
       {
+        using Fields = typename M::Fields::template apply<std::tuple>;
+        if (auto res = Construct<O, M>::value(
+              s, std::make_index_sequence<std::tuple_size<Fields>::value>()))
+          return std::move(*res);
+        // Fields come in model order.
         return std::forward_tuple(
           [] (auto&& ... args) -> O
           {
@@ -132,6 +316,60 @@ namespace elle
         };
       };
 
+      /// Deserialize via fields assignment, from a keyed input.
+      ///
+      /// Fields are assigned as they come, then the missing ones are looked
+      /// up by name for the format to default them or report them.
+      template <typename O, typename M>
+      struct Assign
+      {
+        using Fields = typename M::Fields::template apply<std::tuple>;
+        using Read = void (*)(elle::serialization::SerializerIn&, O&);
+
+        template <std::size_t I>
+        static
+        void
+        read(elle::serialization::SerializerIn& s, O& o)
+        {
+          using Field = std::tuple_element_t<I, Fields>;
+          Field::attr_get(o) =
+            s.deserialize<typename Field::template attr_type<O>>();
+        }
+
+        template <std::size_t ... I>
+        static
+        bool
+        value(elle::serialization::SerializerIn& s,
+              O& o,
+              std::index_sequence<I...>)
+        {
+          static auto const reads = std::array<Read, sizeof ... (I)>{{
+            &read<I>...
+          }};
+          auto const& keys = Serializer<O, M>::keys();
+          auto seen = std::bitset<sizeof ... (I)>{};
+          if (!s.deserialize_keys(
+                [&] (std::string const& key)
+                {
+                  auto const i = keys.index(key);
+                  if (i != -1)
+                  {
+                    reads[i](s, o);
+                    seen.set(i);
+                  }
+                }))
+            return false;
+          int ignore[] = {
+            0,
+            (seen.test(I) ? 0 :
+             (Serializer<O, M>::template DeserializeAssign<
+                std::tuple_element_t<I, Fields>>::value(s, o), 0))...
+          };
+          (void)ignore;
+          return true;
+        }
+      };
+
       /// Deserialize via default construct and fields assignment.
       template <typename O, typename M>
       std::enable_if_t<
@@ -140,9 +378,14 @@ namespace elle
         O>
         deserialize_switch(elle::serialization::SerializerIn& s)
       {
+        using Fields = typename M::Fields::template apply<std::tuple>;
         O res;
-        M::Fields::template map<Serializer<O, M>::
-                                template DeserializeAssign>::value(s, res);
+        if (!Assign<O, M>::value(
+              s, res,
+              std::make_index_sequence<std::tuple_size<Fields>::value>()))
+          // Fields come in model order.
+          M::Fields::template map<Serializer<O, M>::
+                                  template DeserializeAssign>::value(s, res);
         return res;
       }
     }
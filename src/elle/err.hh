@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <utility>
 
 #include <elle/compiler.hh>
@@ -7,6 +8,16 @@
 
 namespace elle
 {
+  namespace _details
+  {
+    template <typename S>
+    class StaticFormat;
+  }
+
+  template <typename S, typename ... Args>
+  std::string
+  print(_details::StaticFormat<S> fmt, Args&& ... args);
+
   /// Throw an elle::Error.
   ELLE_API
   ELLE_COMPILER_ATTRIBUTE_NORETURN
@@ -30,4 +41,23 @@ namespace elle
   {
     throw E(sprintf(fmt, std::forward<Args>(args)...));
   }
+
+  /// Format with a format checked at compile time and throw an elle::Error.
+  template <typename S, typename ... Args>
+  ELLE_COMPILER_ATTRIBUTE_NORETURN
+  void
+  err(_details::StaticFormat<S> fmt, Args&& ... args)
+  {
+    elle::err(elle::print(fmt, std::forward<Args>(args)...));
+  }
+
+  /// Format with a format checked at compile time and throw an exception of
+  /// type \E.
+  template <typename E, typename S, typename ... Args>
+  ELLE_COMPILER_ATTRIBUTE_NORETURN
+  void
+  err(_details::StaticFormat<S> fmt, Args&& ... args)
+  {
+    throw E(elle::print(fmt, std::forward<Args>(args)...));
+  }
 }
@@ -0,0 +1,169 @@
+#include <zlib.h>
+
+#include <limits>
+
+#include <elle/assert.hh>
+#include <elle/err.hh>
+#include <elle/format/deflate.hh>
+#include <elle/log.hh>
+
+ELLE_LOG_COMPONENT("elle.format.deflate");
+
+namespace elle
+{
+  namespace format
+  {
+    namespace deflate
+    {
+      // Raw DEFLATE, without the zlib header and trailer.
+      static int const window_bits = -15;
+
+      /*-----------.
+      | Compressor |
+      `-----------*/
+
+      struct Compressor::Impl
+      {
+        z_stream stream;
+      };
+
+      Compressor::Compressor(int level, elle::Buffer dictionary)
+        : _level(level)
+        , _dictionary(std::move(dictionary))
+        , _impl(std::make_unique<Impl>())
+      {
+        auto& s = this->_impl->stream;
+        s.zalloc = Z_NULL;
+        s.zfree = Z_NULL;
+        s.opaque = Z_NULL;
+        auto const err = deflateInit2(
+          &s, level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
+        if (err == Z_MEM_ERROR)
+          throw std::bad_alloc();
+        else if (err != Z_OK)
+          elle::err("ZLIB deflateInit error: %s", err);
+      }
+
+      Compressor::~Compressor()
+      {
+        deflateEnd(&this->_impl->stream);
+      }
+
+      elle::Buffer
+      Compressor::compress(std::vector<elle::ConstWeakBuffer> const& message)
+      {
+        auto& s = this->_impl->stream;
+        deflateReset(&s);
+        if (!this->_dictionary.empty())
+          deflateSetDictionary(
+            &s, this->_dictionary.contents(), this->_dictionary.size());
+        auto size = uLong(0);
+        for (auto const& piece: message)
+          size += piece.size();
+        auto res = elle::Buffer(deflateBound(&s, size));
+        s.next_out = res.mutable_contents();
+        s.avail_out = res.size();
+        // deflateBound only holds for a single Z_FINISH over the whole
+        // input: make room whenever the output fills up.
+        auto const grow = [&]
+          {
+            auto const used = res.size() - s.avail_out;
+            res.size(res.size() * 2);
+            s.next_out = res.mutable_contents() + used;
+            s.avail_out = res.size() - used;
+          };
+        for (auto const& piece: message)
+        {
+          s.next_in = const_cast<Bytef*>(piece.contents());
+          s.avail_in = piece.size();
+          while (s.avail_in)
+          {
+            if (!s.avail_out)
+              grow();
+            auto const ret = ::deflate(&s, Z_NO_FLUSH);
+            ELLE_ASSERT_NEQ(ret, Z_STREAM_ERROR);
+          }
+        }
+        while (true)
+        {
+          if (!s.avail_out)
+            grow();
+          auto const ret = ::deflate(&s, Z_FINISH);
+          if (ret == Z_STREAM_END)
+            break;
+          else if (ret != Z_OK && ret != Z_BUF_ERROR)
+            elle::err("ZLIB deflate error: %s", ret);
+        }
+        res.size(res.size() - s.avail_out);
+        ELLE_DUMP("compressed %s bytes to %s", size, res.size());
+        return res;
+      }
+
+      elle::Buffer
+      Compressor::compress(elle::ConstWeakBuffer message)
+      {
+        return this->compress(std::vector<elle::ConstWeakBuffer>{message});
+      }
+
+      /*-------------.
+      | Decompressor |
+      `-------------*/
+
+      struct Decompressor::Impl
+      {
+        z_stream stream;
+      };
+
+      Decompressor::Decompressor(elle::Buffer dictionary)
+        : _dictionary(std::move(dictionary))
+        , _impl(std::make_unique<Impl>())
+      {
+        auto& s = this->_impl->stream;
+        s.zalloc = Z_NULL;
+        s.zfree = Z_NULL;
+        s.opaque = Z_NULL;
+        s.next_in = Z_NULL;
+        s.avail_in = 0;
+        auto const err = inflateInit2(&s, window_bits);
+        if (err == Z_MEM_ERROR)
+          throw std::bad_alloc();
+        else if (err != Z_OK)
+          elle::err("ZLIB inflateInit error: %s", err);
+      }
+
+      Decompressor::~Decompressor()
+      {
+        inflateEnd(&this->_impl->stream);
+      }
+
+      elle::Buffer
+      Decompressor::decompress(elle::ConstWeakBuffer compressed,
+                               elle::Buffer::Size size)
+      {
+        if (compressed.size() > std::numeric_limits<uInt>::max() ||
+            size > std::numeric_limits<uInt>::max())
+          elle::err("message too large to decompress: %s", size);
+        auto& s = this->_impl->stream;
+        inflateReset(&s);
+        // Raw streams take their dictionary upfront.
+        if (!this->_dictionary.empty())
+          inflateSetDictionary(
+            &s, this->_dictionary.contents(), this->_dictionary.size());
+        auto res = elle::Buffer(size);
+        s.next_in = const_cast<Bytef*>(compressed.contents());
+        s.avail_in = compressed.size();
+        s.next_out = res.mutable_contents();
+        s.avail_out = res.size();
+        auto const ret = inflate(&s, Z_FINISH);
+        if (ret != Z_STREAM_END)
+          elle::err("unable to decompress %s bytes to %s: %s",
+                    compressed.size(), size,
+                    s.msg ? s.msg : (s.avail_out ? "truncated" : "too large"));
+        if (s.avail_out || s.avail_in)
+          elle::err("decompressed %s bytes to %s instead of %s",
+                    compressed.size(), size - s.avail_out, size);
+        return res;
+      }
+    }
+  }
+}
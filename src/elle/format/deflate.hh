@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <elle/Buffer.hh>
+#include <elle/attribute.hh>
+#include <elle/compiler.hh>
+
+namespace elle
+{
+  namespace format
+  {
+    namespace deflate
+    {
+      /// Compress independent messages to raw DEFLATE.
+      ///
+      /// Unlike gzip::Stream, every message is compressed on its own, with no
+      /// header, so a Decompressor can expand them in any order. The zlib
+      /// state is reused from one message to the next.
+      ///
+      /// A preset dictionary, made of byte strings common to the messages,
+      /// improves the compression of small ones. The Decompressor must use
+      /// the same.
+      ///
+      /// @code{.cc}
+      ///
+      /// auto c = elle::format::deflate::Compressor();
+      /// auto d = elle::format::deflate::Decompressor();
+      /// auto compressed = c.compress(message);
+      /// assert(d.decompress(compressed, message.size()) == message);
+      ///
+      /// @endcode
+      class ELLE_API Compressor
+      {
+      public:
+        /// Construct a Compressor.
+        ///
+        /// @param level The zlib compression level, from 1 (fastest) to 9
+        ///              (smallest).
+        /// @param dictionary The preset dictionary, if any.
+        Compressor(int level = 1, elle::Buffer dictionary = {});
+        ~Compressor();
+
+      public:
+        /// Compress a message made of several pieces.
+        elle::Buffer
+        compress(std::vector<elle::ConstWeakBuffer> const& message);
+        /// Compress @a message.
+        elle::Buffer
+        compress(elle::ConstWeakBuffer message);
+        ELLE_ATTRIBUTE_R(int, level);
+        ELLE_ATTRIBUTE_R(elle::Buffer, dictionary);
+
+      private:
+        struct Impl;
+        ELLE_ATTRIBUTE(std::unique_ptr<Impl>, impl);
+      };
+
+      /// Expand messages compressed by a Compressor.
+      class ELLE_API Decompressor
+      {
+      public:
+        /// Construct a Decompressor.
+        ///
+        /// @param dictionary The preset dictionary of the Compressor.
+        Decompressor(elle::Buffer dictionary = {});
+        ~Decompressor();
+
+      public:
+        /// Expand @a compressed.
+        ///
+        /// @param compressed The compressed message.
+        /// @param size The size of the message.
+        /// @returns The message.
+        /// @throws elle::Error if @a compressed is corrupted or does not
+        ///         expand to exactly @a size bytes.
+        elle::Buffer
+        decompress(elle::ConstWeakBuffer compressed, elle::Buffer::Size size);
+        ELLE_ATTRIBUTE_R(elle::Buffer, dictionary);
+
+      private:
+        struct Impl;
+        ELLE_ATTRIBUTE(std::unique_ptr<Impl>, impl);
+      };
+    }
+  }
+}
@@ -0,0 +1,710 @@
+#include <elle/json/Reader.hh>
+
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <vector>
+
+#include <elle/assert.hh>
+#include <elle/json/exceptions.hh>
+#include <elle/log.hh>
+#include <elle/printf.hh>
+
+ELLE_LOG_COMPONENT("elle.json.Reader");
+
+namespace elle
+{
+  namespace json
+  {
+    /*-------.
+    | Inputs |
+    `-------*/
+
+    namespace
+    {
+      /// Characters from memory.
+      class MemoryInput
+      {
+      public:
+        MemoryInput(elle::ConstWeakBuffer input)
+          : _begin(reinterpret_cast<char const*>(input.contents()))
+          , _position(_begin)
+          , _end(_begin + input.size())
+        {}
+
+        int
+        peek() const
+        {
+          return this->_position == this->_end
+            ? -1 : static_cast<unsigned char>(*this->_position);
+        }
+
+        int
+        get()
+        {
+          return this->_position == this->_end
+            ? -1 : static_cast<unsigned char>(*this->_position++);
+        }
+
+        /// Append to @a output up to the next quote or backslash.
+        void
+        string_run(std::string& output)
+        {
+          auto const start = this->_position;
+          // Look for either byte in eight at once.
+          auto constexpr ones = 0x0101010101010101ull;
+          auto constexpr highs = 0x8080808080808080ull;
+          auto const has = [&] (uint64_t word, unsigned char c)
+            {
+              auto const x = word ^ (ones * c);
+              return (x - ones) & ~x & highs;
+            };
+          while (this->_end - this->_position >= 8)
+          {
+            uint64_t word;
+            std::memcpy(&word, this->_position, 8);
+            if (has(word, '"') | has(word, '\\'))
+              break;
+            this->_position += 8;
+          }
+          while (this->_position != this->_end &&
+                 *this->_position != '"' && *this->_position != '\\')
+            ++this->_position;
+          output.append(start, this->_position);
+        }
+
+        std::size_t
+        offset() const
+        {
+          return this->_position - this->_begin;
+        }
+
+      private:
+        char const* _begin;
+        char const* _position;
+        char const* _end;
+      };
+
+      /// Characters from a stream, consumed one by one.
+      class StreamInput
+      {
+      public:
+        StreamInput(std::istream& input)
+          : _input(*input.rdbuf())
+          , _offset(0)
+        {}
+
+        int
+        peek() const
+        {
+          auto const c = this->_input.sgetc();
+          return c == std::char_traits<char>::eof()
+            ? -1 : static_cast<unsigned char>(c);
+        }
+
+        int
+        get()
+        {
+          auto const c = this->_input.sbumpc();
+          if (c == std::char_traits<char>::eof())
+            return -1;
+          ++this->_offset;
+          return static_cast<unsigned char>(c);
+        }
+
+        /// Append to @a output up to the next quote or backslash.
+        void
+        string_run(std::string& output)
+        {
+          while (true)
+          {
+            auto const c = this->peek();
+            if (c == -1 || c == '"' || c == '\\')
+              return;
+            output.push_back(this->get());
+          }
+        }
+
+        std::size_t
+        offset() const
+        {
+          return this->_offset;
+        }
+
+      private:
+        std::streambuf& _input;
+        std::size_t _offset;
+      };
+    }
+
+    /*-------.
+    | Parser |
+    `-------*/
+
+    struct Reader::Impl
+    {
+      virtual
+      ~Impl() = default;
+      virtual
+      Event
+      next() = 0;
+      virtual
+      std::size_t
+      offset() const = 0;
+
+      /// What comes next.
+      enum class Expect
+      {
+        value,
+        value_or_close,
+        key_or_close,
+        separator_or_close,
+        end,
+      };
+      Expect expect = Expect::value;
+      /// Whether peek() already read the next event.
+      bool peeked = false;
+      Reader::Event ahead = Reader::Event::end;
+      /// The open containers, '{' or '['.
+      std::vector<char> stack;
+      bool boolean = false;
+      int64_t integer = 0;
+      double real = 0;
+      std::string string;
+    };
+
+    namespace
+    {
+      template <typename Input>
+      class Parser
+        : public Reader::Impl
+      {
+      public:
+        using Event = Reader::Event;
+
+        template <typename ... Args>
+        Parser(Args&& ... args)
+          : _input(std::forward<Args>(args)...)
+        {}
+
+        Event
+        next() override
+        {
+          if (this->expect == Expect::end)
+            return Event::end;
+          this->_skip_whitespace();
+          switch (this->expect)
+          {
+            case Expect::end:
+              return Event::end;
+            case Expect::separator_or_close:
+            {
+              auto const c = this->_input.peek();
+              if (c == ',')
+              {
+                this->_input.get();
+                this->_skip_whitespace();
+                if (this->stack.back() == '{')
+                  return this->_key_or_close();
+                else
+                  return this->_value_or_close();
+              }
+              else
+                return this->_close(c);
+            }
+            case Expect::key_or_close:
+              return this->_key_or_close();
+            case Expect::value_or_close:
+              return this->_value_or_close();
+            case Expect::value:
+              return this->_value();
+          }
+          elle::unreachable();
+        }
+
+        std::size_t
+        offset() const override
+        {
+          return this->_input.offset();
+        }
+
+      private:
+        /*--------.
+        | Helpers |
+        `--------*/
+
+        [[noreturn]]
+        void
+        _error(std::string const& what)
+        {
+          throw ParseError(elle::sprintf(
+                             "JSON error at offset %s: %s",
+                             this->_input.offset(), what));
+        }
+
+        [[noreturn]]
+        void
+        _unexpected(int c, char const* expected)
+        {
+          if (c == -1)
+            this->_error(elle::sprintf(
+                           "unexpected end of input, expected %s", expected));
+          else
+            this->_error(elle::sprintf(
+                           "unexpected '%s', expected %s",
+                           std::string(1, char(c)), expected));
+        }
+
+        void
+        _skip_whitespace()
+        {
+          while (true)
+          {
+            auto const c = this->_input.peek();
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+              this->_input.get();
+            else
+              return;
+          }
+        }
+
+        /// Update what is expected once a value is complete.
+        Event
+        _complete(Event e)
+        {
+          this->expect = this->stack.empty()
+            ? Expect::end : Expect::separator_or_close;
+          return e;
+        }
+
+        /*-----------.
+        | Containers |
+        `-----------*/
+
+        Event
+        _close(int c)
+        {
+          if (c == '}' && this->stack.back() == '{')
+          {
+            this->_input.get();
+            this->stack.pop_back();
+            return this->_complete(Event::object_end);
+          }
+          else if (c == ']' && this->stack.back() == '[')
+          {
+            this->_input.get();
+            this->stack.pop_back();
+            return this->_complete(Event::array_end);
+          }
+          else if (this->stack.back() == '{')
+            this->_unexpected(c, "',' or '}'");
+          else
+            this->_unexpected(c, "',' or ']'");
+        }
+
+        Event
+        _key_or_close()
+        {
+          auto const c = this->_input.peek();
+          if (c == '}')
+            return this->_close(c);
+          else if (c != '"')
+            this->_unexpected(c, "key");
+          this->_input.get();
+          this->_string();
+          this->_skip_whitespace();
+          auto const colon = this->_input.get();
+          if (colon != ':')
+            this->_unexpected(colon, "':'");
+          this->expect = Expect::value;
+          return Event::key;
+        }
+
+        Event
+        _value_or_close()
+        {
+          auto const c = this->_input.peek();
+          if (c == ']')
+            return this->_close(c);
+          return this->_value();
+        }
+
+        Event
+        _value()
+        {
+          auto const c = this->_input.peek();
+          switch (c)
+          {
+            case '{':
+              this->_input.get();
+              this->stack.push_back('{');
+              this->expect = Expect::key_or_close;
+              return Event::object_begin;
+            case '[':
+              this->_input.get();
+              this->stack.push_back('[');
+              this->expect = Expect::value_or_close;
+              return Event::array_begin;
+            case '"':
+              this->_input.get();
+              this->_string();
+              return this->_complete(Event::string);
+            case 't':
+              this->_literal("true");
+              this->boolean = true;
+              return this->_complete(Event::boolean);
+            case 'f':
+              this->_literal("false");
+              this->boolean = false;
+              return this->_complete(Event::boolean);
+            case 'n':
+              this->_literal("null");
+              return this->_complete(Event::null);
+            default:
+              if (c == '-' || (c >= '0' && c <= '9'))
+                return this->_complete(this->_number());
+              this->_unexpected(c, "value");
+          }
+        }
+
+        /*--------.
+        | Scalars |
+        `--------*/
+
+        void
+        _literal(char const* literal)
+        {
+          for (auto p = literal; *p; ++p)
+          {
+            auto const c = this->_input.get();
+            if (c != *p)
+              this->_unexpected(c, literal);
+          }
+        }
+
+        Event
+        _number()
+        {
+          char text[64];
+          auto size = 0;
+          auto real = false;
+          auto const take = [&]
+            {
+              if (size == sizeof text - 1)
+                this->_error("number too long");
+              text[size++] = this->_input.get();
+            };
+          auto const digits = [&]
+            {
+              auto const start = size;
+              while (this->_input.peek() >= '0' && this->_input.peek() <= '9')
+                take();
+              if (size == start)
+                this->_unexpected(this->_input.peek(), "digit");
+            };
+          if (this->_input.peek() == '-')
+            take();
+          digits();
+          if (this->_input.peek() == '.')
+          {
+            real = true;
+            take();
+            digits();
+          }
+          if (this->_input.peek() == 'e' || this->_input.peek() == 'E')
+          {
+            real = true;
+            take();
+            if (this->_input.peek() == '+' || this->_input.peek() == '-')
+              take();
+            digits();
+          }
+          text[size] = 0;
+          if (!real)
+          {
+            auto const negative = text[0] == '-';
+            auto value = uint64_t(0);
+            auto overflow = false;
+            for (auto p = text + (negative ? 1 : 0); *p; ++p)
+            {
+              auto const digit = uint64_t(*p - '0');
+              if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+              {
+                overflow = true;
+                break;
+              }
+              value = value * 10 + digit;
+            }
+            auto const max = uint64_t(std::numeric_limits<int64_t>::max());
+            if (!overflow && !negative)
+            {
+              // Beyond int64_t, wrap like unsigned values were written.
+              this->integer = static_cast<int64_t>(value);
+              return Event::integer;
+            }
+            else if (!overflow && value <= max + 1)
+            {
+              this->integer = value == max + 1
+                ? std::numeric_limits<int64_t>::min()
+                : -static_cast<int64_t>(value);
+              return Event::integer;
+            }
+          }
+          // strtod honors the locale decimal point.
+          if (auto dot = std::strchr(text, '.'))
+            *dot = *std::localeconv()->decimal_point;
+          this->real = std::strtod(text, nullptr);
+          return Event::real;
+        }
+
+        void
+        _string()
+        {
+          this->string.clear();
+          while (true)
+          {
+            this->_input.string_run(this->string);
+            auto const c = this->_input.get();
+            if (c == '"')
+              return;
+            else if (c == -1)
+              this->_unexpected(c, "'\"'");
+            auto const escaped = this->_input.get();
+            switch (escaped)
+            {
+              case '"':
+              case '\\':
+              case '/':
+                this->string.push_back(escaped);
+                break;
+              case 'b':
+                this->string.push_back('\b');
+                break;
+              case 'f':
+                this->string.push_back('\f');
+                break;
+              case 'n':
+                this->string.push_back('\n');
+                break;
+              case 'r':
+                this->string.push_back('\r');
+                break;
+              case 't':
+                this->string.push_back('\t');
+                break;
+              case 'u':
+                this->_unicode();
+                break;
+              default:
+                this->_unexpected(escaped, "escape sequence");
+            }
+          }
+        }
+
+        unsigned
+        _hex4()
+        {
+          auto res = 0u;
+          for (int i = 0; i < 4; ++i)
+          {
+            auto const c = this->_input.get();
+            res <<= 4;
+            if (c >= '0' && c <= '9')
+              res += c - '0';
+            else if (c >= 'a' && c <= 'f')
+              res += c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+              res += c - 'A' + 10;
+            else
+              this->_unexpected(c, "hexadecimal digit");
+          }
+          return res;
+        }
+
+        void
+        _unicode()
+        {
+          auto code = this->_hex4();
+          // Join surrogate pairs, keep lone surrogates as they are.
+          if (code >= 0xD800 && code < 0xDC00 && this->_input.peek() == '\\')
+          {
+            this->_input.get();
+            auto const c = this->_input.get();
+            if (c != 'u')
+              this->_unexpected(c, "'u'");
+            auto const low = this->_hex4();
+            if (low >= 0xDC00 && low < 0xE000)
+              code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            else
+            {
+              this->_utf8(code);
+              code = low;
+            }
+          }
+          this->_utf8(code);
+        }
+
+        void
+        _utf8(unsigned code)
+        {
+          auto& s = this->string;
+          if (code < 0x80)
+            s.push_back(code);
+          else if (code < 0x800)
+          {
+            s.push_back(0xC0 | (code >> 6));
+            s.push_back(0x80 | (code & 0x3F));
+          }
+          else if (code < 0x10000)
+          {
+            s.push_back(0xE0 | (code >> 12));
+            s.push_back(0x80 | ((code >> 6) & 0x3F));
+            s.push_back(0x80 | (code & 0x3F));
+          }
+          else
+          {
+            s.push_back(0xF0 | (code >> 18));
+            s.push_back(0x80 | ((code >> 12) & 0x3F));
+            s.push_back(0x80 | ((code >> 6) & 0x3F));
+            s.push_back(0x80 | (code & 0x3F));
+          }
+        }
+
+        Input _input;
+      };
+    }
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    Reader::Reader(std::istream& input)
+      : _impl(std::make_unique<Parser<StreamInput>>(input))
+    {}
+
+    Reader::Reader(elle::ConstWeakBuffer input)
+      : _impl(std::make_unique<Parser<MemoryInput>>(input))
+    {}
+
+    Reader::~Reader()
+    {}
+
+    /*--------.
+    | Parsing |
+    `--------*/
+
+    Reader::Event
+    Reader::next()
+    {
+      if (this->_impl->peeked)
+      {
+        this->_impl->peeked = false;
+        return this->_impl->ahead;
+      }
+      auto const res = this->_impl->next();
+      ELLE_DUMP("read %s", res);
+      return res;
+    }
+
+    Reader::Event
+    Reader::peek()
+    {
+      if (!this->_impl->peeked)
+      {
+        this->_impl->ahead = this->next();
+        this->_impl->peeked = true;
+      }
+      return this->_impl->ahead;
+    }
+
+    void
+    Reader::skip()
+    {
+      auto nesting = 0;
+      do
+        switch (this->next())
+        {
+          case Event::object_begin:
+          case Event::array_begin:
+            ++nesting;
+            break;
+          case Event::object_end:
+          case Event::array_end:
+            --nesting;
+            break;
+          default:
+            break;
+        }
+      while (nesting > 0);
+    }
+
+    bool
+    Reader::boolean() const
+    {
+      return this->_impl->boolean;
+    }
+
+    int64_t
+    Reader::integer() const
+    {
+      return this->_impl->integer;
+    }
+
+    double
+    Reader::real() const
+    {
+      return this->_impl->real;
+    }
+
+    std::string&
+    Reader::string()
+    {
+      return this->_impl->string;
+    }
+
+    int
+    Reader::depth() const
+    {
+      return this->_impl->stack.size();
+    }
+
+    std::size_t
+    Reader::offset() const
+    {
+      return this->_impl->offset();
+    }
+
+    std::ostream&
+    operator <<(std::ostream& output, Reader::Event e)
+    {
+      switch (e)
+      {
+        case Reader::Event::null:
+          return output << "null";
+        case Reader::Event::boolean:
+          return output << "boolean";
+        case Reader::Event::integer:
+          return output << "integer";
+        case Reader::Event::real:
+          return output << "real";
+        case Reader::Event::string:
+          return output << "string";
+        case Reader::Event::key:
+          return output << "key";
+        case Reader::Event::object_begin:
+          return output << "object begin";
+        case Reader::Event::object_end:
+          return output << "object end";
+        case Reader::Event::array_begin:
+          return output << "array begin";
+        case Reader::Event::array_end:
+          return output << "array end";
+        case Reader::Event::end:
+          return output << "end";
+      }
+      elle::unreachable();
+    }
+  }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include <elle/Buffer.hh>
+#include <elle/attribute.hh>
+#include <elle/compiler.hh>
+
+namespace elle
+{
+  namespace json
+  {
+    /// A pull parser for one JSON value.
+    ///
+    /// Every call to next() reads one more token and tells what it is. The
+    /// value of scalars, and of keys, is then available through boolean(),
+    /// integer(), real() and string(). No tree is built: containers are
+    /// reported by their boundaries, and it is up to the caller to assemble
+    /// them or not.
+    ///
+    /// On a stream, exactly the value is read and the rest is left untouched.
+    /// In memory, strings are scanned eight bytes at a time.
+    ///
+    /// Integers that do not fit an int64_t but fit an uint64_t are wrapped,
+    /// larger ones are read as reals. Trailing commas in objects and arrays
+    /// are accepted.
+    ///
+    /// @code{.cc}
+    ///
+    /// elle::json::Reader r(stream);
+    /// using Event = elle::json::Reader::Event;
+    /// assert(r.next() == Event::array_begin);
+    /// while (r.next() == Event::integer)
+    ///   sum += r.integer();
+    ///
+    /// @endcode
+    class ELLE_API Reader
+    {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      /// What next() read.
+      enum class Event
+      {
+        null,
+        boolean,
+        integer,
+        real,
+        string,
+        /// The key of the next value in an object, in string().
+        key,
+        object_begin,
+        object_end,
+        array_begin,
+        array_end,
+        /// The value is complete.
+        end,
+      };
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Read a value from @a input.
+      Reader(std::istream& input);
+      /// Read a value from @a input, which must outlive the Reader.
+      Reader(elle::ConstWeakBuffer input);
+      /// A temporary would not outlive the Reader.
+      Reader(elle::Buffer&& input) = delete;
+      ~Reader();
+
+    /*--------.
+    | Parsing |
+    `--------*/
+    public:
+      /// Read the next token.
+      ///
+      /// @throws ParseError if the input is not valid JSON.
+      Event
+      next();
+      /// Read the next token, without consuming it.
+      ///
+      /// The following next() returns it again. Its value, and the depth it
+      /// leads to, are available right away.
+      ///
+      /// @throws ParseError if the input is not valid JSON.
+      Event
+      peek();
+      /// Consume the next value, and everything it contains.
+      ///
+      /// @throws ParseError if the input is not valid JSON.
+      void
+      skip();
+      /// The last boolean read.
+      bool
+      boolean() const;
+      /// The last integer read.
+      int64_t
+      integer() const;
+      /// The last real read.
+      double
+      real() const;
+      /// The last string or key read, which may be moved from.
+      std::string&
+      string();
+      /// The number of objects and arrays the Reader is in.
+      int
+      depth() const;
+      /// The number of bytes consumed.
+      std::size_t
+      offset() const;
+
+    public:
+      struct Impl;
+    private:
+      ELLE_ATTRIBUTE(std::unique_ptr<Impl>, impl);
+    };
+
+    ELLE_API
+    std::ostream&
+    operator <<(std::ostream& output, Reader::Event e);
+  }
+}
@@ -0,0 +1,274 @@
+#include <elle/json/Writer.hh>
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+
+#include <elle/assert.hh>
+#include <elle/err.hh>
+
+namespace elle
+{
+  namespace json
+  {
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    Writer::Writer(std::ostream& output, bool pretty)
+      : _output(output)
+      , _pretty(pretty)
+      , _keyed(false)
+    {}
+
+    /*--------.
+    | Scalars |
+    `--------*/
+
+    void
+    Writer::null()
+    {
+      this->_value();
+      this->_output.write("null", 4);
+    }
+
+    void
+    Writer::boolean(bool v)
+    {
+      this->_value();
+      if (v)
+        this->_output.write("true", 4);
+      else
+        this->_output.write("false", 5);
+    }
+
+    void
+    Writer::integer(int64_t v)
+    {
+      this->_value();
+      if (v < 0)
+      {
+        this->_output.put('-');
+        // Negate as unsigned, for the minimum.
+        this->_digits(-static_cast<uint64_t>(v));
+      }
+      else
+        this->_digits(v);
+    }
+
+    void
+    Writer::unsigned_integer(uint64_t v)
+    {
+      this->_value();
+      this->_digits(v);
+    }
+
+    void
+    Writer::real(double v)
+    {
+      if (!std::isfinite(v))
+        elle::err("unable to write %s in JSON", v);
+      this->_value();
+      // The shortest of 15 or 17 significant digits that reads back the same.
+      char text[32];
+      std::snprintf(text, sizeof text, "%.15g", v);
+      if (std::strtod(text, nullptr) != v)
+        std::snprintf(text, sizeof text, "%.17g", v);
+      auto const point = *std::localeconv()->decimal_point;
+      auto real = false;
+      for (auto p = text; *p; ++p)
+        if (*p == point)
+        {
+          *p = '.';
+          real = true;
+        }
+        else if (*p == 'e')
+          real = true;
+      this->_output << text;
+      // Read back as a real, not an integer.
+      if (!real)
+        this->_output.write(".0", 2);
+    }
+
+    void
+    Writer::string(char const* data, std::size_t size)
+    {
+      this->_value();
+      this->_escape(data, size);
+    }
+
+    void
+    Writer::string(std::string const& v)
+    {
+      this->string(v.data(), v.size());
+    }
+
+    /*-----------.
+    | Containers |
+    `-----------*/
+
+    void
+    Writer::object_begin()
+    {
+      this->_value();
+      this->_output.put('{');
+      this->_levels.push_back(Level{'{', 0});
+    }
+
+    void
+    Writer::key(std::string const& name)
+    {
+      ELLE_ASSERT(!this->_levels.empty());
+      ELLE_ASSERT_EQ(this->_levels.back().kind, '{');
+      ELLE_ASSERT(!this->_keyed);
+      if (this->_levels.back().count++)
+        this->_output.put(',');
+      this->_indent();
+      this->_escape(name.data(), name.size());
+      if (this->_pretty)
+        this->_output.write(" : ", 3);
+      else
+        this->_output.put(':');
+      this->_keyed = true;
+    }
+
+    void
+    Writer::object_end()
+    {
+      this->_close('}');
+    }
+
+    void
+    Writer::array_begin()
+    {
+      this->_value();
+      this->_output.put('[');
+      this->_levels.push_back(Level{'[', 0});
+    }
+
+    void
+    Writer::array_end()
+    {
+      this->_close(']');
+    }
+
+    int
+    Writer::depth() const
+    {
+      return this->_levels.size();
+    }
+
+    /*--------.
+    | Helpers |
+    `--------*/
+
+    void
+    Writer::_value()
+    {
+      if (this->_keyed)
+        this->_keyed = false;
+      else if (!this->_levels.empty())
+      {
+        auto& level = this->_levels.back();
+        ELLE_ASSERT_EQ(level.kind, '[');
+        if (level.count++)
+          this->_output.put(',');
+        this->_indent();
+      }
+    }
+
+    void
+    Writer::_digits(uint64_t v)
+    {
+      char digits[20];
+      auto p = std::end(digits);
+      do
+      {
+        *--p = '0' + v % 10;
+        v /= 10;
+      }
+      while (v);
+      this->_output.write(p, std::end(digits) - p);
+    }
+
+    void
+    Writer::_close(char c)
+    {
+      ELLE_ASSERT(!this->_levels.empty());
+      ELLE_ASSERT_EQ(this->_levels.back().kind, c == '}' ? '{' : '[');
+      ELLE_ASSERT(!this->_keyed);
+      this->_levels.pop_back();
+      // Pretty containers close on their own line, even empty ones.
+      if (this->_pretty)
+      {
+        this->_output.put('\n');
+        for (auto i = this->_levels.size(); i; --i)
+          this->_output.write("    ", 4);
+      }
+      this->_output.put(c);
+    }
+
+    void
+    Writer::_indent()
+    {
+      if (!this->_pretty)
+        return;
+      this->_output.put('\n');
+      for (auto i = this->_levels.size(); i; --i)
+        this->_output.write("    ", 4);
+    }
+
+    void
+    Writer::_escape(char const* data, std::size_t size)
+    {
+      static char const hex[] = "0123456789abcdef";
+      auto& o = this->_output;
+      o.put('"');
+      auto run = data;
+      auto const end = data + size;
+      for (auto p = data; p != end; ++p)
+      {
+        auto const c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\')
+          continue;
+        o.write(run, p - run);
+        run = p + 1;
+        switch (c)
+        {
+          case '"':
+            o.write("\\\"", 2);
+            break;
+          case '\\':
+            o.write("\\\\", 2);
+            break;
+          case '\b':
+            o.write("\\b", 2);
+            break;
+          case '\f':
+            o.write("\\f", 2);
+            break;
+          case '\n':
+            o.write("\\n", 2);
+            break;
+          case '\r':
+            o.write("\\r", 2);
+            break;
+          case '\t':
+            o.write("\\t", 2);
+            break;
+          default:
+          {
+            char const u[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+            o.write(u, sizeof u);
+          }
+        }
+      }
+      o.write(run, end - run);
+      o.put('"');
+    }
+  }
+}
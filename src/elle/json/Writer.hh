@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <elle/attribute.hh>
+#include <elle/compiler.hh>
+
+namespace elle
+{
+  namespace json
+  {
+    /// Write one JSON value token by token.
+    ///
+    /// Nothing is buffered but the nesting: every call writes its token to
+    /// the stream right away, with the separators and, if pretty, the
+    /// indentation it needs.
+    ///
+    /// @code{.cc}
+    ///
+    /// elle::json::Writer w(std::cout);
+    /// w.object_begin();
+    /// w.key("ids");
+    /// w.array_begin();
+    /// for (auto id: ids)
+    ///   w.integer(id);
+    /// w.array_end();
+    /// w.object_end();
+    ///
+    /// @endcode
+    class ELLE_API Writer
+    {
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Write to @a output.
+      ///
+      /// @param pretty Whether to put every element on its own line,
+      ///               indented.
+      Writer(std::ostream& output, bool pretty = false);
+
+    /*--------.
+    | Scalars |
+    `--------*/
+    public:
+      void
+      null();
+      void
+      boolean(bool v);
+      void
+      integer(int64_t v);
+      void
+      unsigned_integer(uint64_t v);
+      /// @throws elle::Error if @a v is not finite.
+      void
+      real(double v);
+      void
+      string(char const* data, std::size_t size);
+      void
+      string(std::string const& v);
+
+    /*-----------.
+    | Containers |
+    `-----------*/
+    public:
+      void
+      object_begin();
+      /// Write the key of the next value of the current object.
+      void
+      key(std::string const& name);
+      void
+      object_end();
+      void
+      array_begin();
+      void
+      array_end();
+      /// The number of objects and arrays the Writer is in.
+      int
+      depth() const;
+
+    private:
+      /// Write what goes before a value.
+      void
+      _value();
+      void
+      _digits(uint64_t v);
+      void
+      _close(char c);
+      void
+      _indent();
+      void
+      _escape(char const* data, std::size_t size);
+      ELLE_ATTRIBUTE_R(std::ostream&, output);
+      ELLE_ATTRIBUTE_R(bool, pretty);
+      /// The open containers, with how many elements they have.
+      struct Level
+      {
+        char kind;
+        int count;
+      };
+      ELLE_ATTRIBUTE(std::vector<Level>, levels);
+      /// Whether a key was just written.
+      ELLE_ATTRIBUTE(bool, keyed);
+    };
+  }
+}
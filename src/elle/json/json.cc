@@ -1,10 +1,11 @@
-#include <json_spirit/reader.h>
-#include <json_spirit/value.h>
-#include <json_spirit/writer.h>
+#include <cctype>
 
 #include <elle/Backtrace.hh>
 #include <elle/IOStream.hh>
 #include <elle/assert.hh>
+#include <elle/err.hh>
+#include <elle/json/Reader.hh>
+#include <elle/json/Writer.hh>
 #include <elle/json/exceptions.hh>
 #include <elle/json/json.hh>
 #include <elle/log.hh>
@@ -16,81 +17,113 @@ namespace elle
 {
   namespace json
   {
-    using Config = json_spirit::Config_map<std::string>;
-
     namespace
     {
+      /// Build the value @a reader is at, its first event being @a e.
       Json
-      from_spirit(json_spirit::Value const& value)
+      build(Reader& reader, Reader::Event e)
       {
-        switch (value.type())
+        using Event = Reader::Event;
+        // The containers being built, and the key of their next value.
+        auto stack = std::vector<std::pair<Json, std::string>>{};
+        auto res = Json{};
+        while (true)
         {
-          case json_spirit::Value::OBJECT_TYPE:
+          auto value = Json{};
+          switch (e)
           {
-            auto res = Object{};
-            for (auto const& element: value.getObject())
-            {
-              // Enforce evulation order.
-              auto key = Config::get_name(element);
-              auto value = from_spirit(Config::get_value(element));
-              res.emplace(key, value);
-            }
-            return res;
+            case Event::null:
+              value = NullType();
+              break;
+            case Event::boolean:
+              value = reader.boolean();
+              break;
+            case Event::integer:
+              value = reader.integer();
+              break;
+            case Event::real:
+              value = reader.real();
+              break;
+            case Event::string:
+              value = std::move(reader.string());
+              break;
+            case Event::key:
+              stack.back().second = std::move(reader.string());
+              e = reader.next();
+              continue;
+            case Event::object_begin:
+              stack.emplace_back(Object(), std::string());
+              e = reader.next();
+              continue;
+            case Event::array_begin:
+              stack.emplace_back(Array(), std::string());
+              e = reader.next();
+              continue;
+            case Event::object_end:
+            case Event::array_end:
+              value = std::move(stack.back().first);
+              stack.pop_back();
+              break;
+            case Event::end:
+              ELLE_ABORT("unexpected end of JSON value");
           }
-          case json_spirit::Value::ARRAY_TYPE:
+          if (stack.empty())
           {
-            auto res = Array{};
-            for (auto const& element: value.getArray())
-              res.emplace_back(from_spirit(element));
-            return res;
+            res = std::move(value);
+            break;
           }
-          case json_spirit::Value::STRING_TYPE:
-            return value.getString();
-          case json_spirit::Value::BOOL_TYPE:
-            return value.getBool();
-          case json_spirit::Value::INT_TYPE:
-            return value.getInt64();
-          case json_spirit::Value::REAL_TYPE:
-            return value.getReal();
-          case json_spirit::Value::NULL_TYPE:
-            return NullType();
-          default:
-            ELLE_ABORT("unknown JSON value type");
+          auto& parent = stack.back();
+          if (auto object = boost::any_cast<Object>(&parent.first))
+            (*object)[std::move(parent.second)] = std::move(value);
+          else
+            boost::any_cast<Array&>(parent.first).emplace_back(
+              std::move(value));
+          e = reader.next();
         }
+        return res;
       }
 
-      json_spirit::Value
-      to_spirit(Json const& any)
+      void
+      write(Writer& writer, Json const& any)
       {
-        ELLE_DUMP("to_spirit of type: %s", any.type().name());
-        if (any.type() == typeid(OrderedObject))
+        ELLE_DUMP("write JSON of type: %s", any.type().name());
+        if (auto object = boost::any_cast<OrderedObject>(&any))
         {
-          auto res = Config::Object_type{};
-          for (auto const& element: boost::any_cast<OrderedObject>(any))
+          writer.object_begin();
+          for (auto const& element: *object)
           {
-            auto key = element.first;
-            auto value = to_spirit(element.second);
-            res.emplace(key, value);
+            writer.key(element.first);
+            write(writer, element.second);
           }
-          return res;
+          writer.object_end();
         }
-        else if (any.type() == typeid(Object))
+        else if (auto object = boost::any_cast<Object>(&any))
         {
-          auto res = Config::Object_type{};
-          for (auto const& element: boost::any_cast<Object>(any))
+          // Sort keys, for a deterministic output.
+          auto elements = std::vector<Object::value_type const*>{};
+          elements.reserve(object->size());
+          for (auto const& element: *object)
+            elements.emplace_back(&element);
+          std::sort(elements.begin(), elements.end(),
+                    [] (Object::value_type const* lhs,
+                        Object::value_type const* rhs)
+                    {
+                      return lhs->first < rhs->first;
+                    });
+          writer.object_begin();
+          for (auto element: elements)
           {
-            auto key = element.first;
-            auto value = to_spirit(element.second);
-            res.emplace(key, value);
+            writer.key(element->first);
+            write(writer, element->second);
           }
-          return res;
+          writer.object_end();
         }
-        else if (any.type() == typeid(Array))
+        else if (auto array = boost::any_cast<Array>(&any))
         {
-          auto res = Config::Array_type{};
-          for (auto const& element: boost::any_cast<Array>(any))
-            res.emplace_back(to_spirit(element));
-          return res;
+          writer.array_begin();
+          for (auto const& element: *array)
+            write(writer, element);
+          writer.array_end();
         }
 
 #ifdef __clang__
@@ -99,36 +132,36 @@ namespace elle
 # define CL(a) (a)
 #endif
 
-#define CASE(Type)                                      \
+#define CASE(Type, Method, Cast)                        \
         else if (CL(any.type()) == CL(typeid(Type)))    \
-          return boost::any_cast<Type>(any)
+          writer.Method(Cast(boost::any_cast<Type const&>(any)))
 
-        CASE(std::string);
-        CASE(char const*);
-        CASE(bool);
-        CASE(int16_t);
-        CASE(int32_t);
-        CASE(int64_t);
-        CASE(uint16_t);
-        CASE(uint32_t);
-        CASE(uint64_t);
+        CASE(std::string, string, );
+        CASE(char const*, string, std::string);
+        CASE(bool, boolean, );
+        CASE(int16_t, integer, int64_t);
+        CASE(int32_t, integer, int64_t);
+        CASE(int64_t, integer, int64_t);
+        CASE(uint16_t, unsigned_integer, uint64_t);
+        CASE(uint32_t, unsigned_integer, uint64_t);
+        CASE(uint64_t, unsigned_integer, uint64_t);
         // On macOS, `uint64_t` is `unsigned long long`, which is not
         // the same type as `unsigned long`.
-        CASE(long);
-        CASE(unsigned long);
-        CASE(float);
-        CASE(double);
-        else if (CL(any.type()) == CL(typeid(long long)))
-          return int64_t(boost::any_cast<long long>(any));
-        else if (CL(any.type()) == CL(typeid(unsigned long long)))
-          return uint64_t(boost::any_cast<unsigned long long>(any));
+        CASE(long, integer, int64_t);
+        CASE(unsigned long, unsigned_integer, uint64_t);
+        CASE(long long, integer, int64_t);
+        CASE(unsigned long long, unsigned_integer, uint64_t);
+        CASE(float, real, double);
+        CASE(double, real, double);
         else if (CL(any.type()) == CL(typeid(NullType)))
-          return json_spirit::Value();
+          writer.null();
         else if (CL(any.type()) == CL(typeid(void)))
-          return json_spirit::Value();
+          writer.null();
         else
-          ELLE_ABORT("unable to make JSON from type: %s",
-                     elle::demangle(any.type().name()));
+          elle::err("unable to make JSON from type: %s",
+                    elle::demangle(any.type().name()));
+#undef CASE
+#undef CL
       }
     }
 
@@ -136,22 +169,33 @@ namespace elle
     read(std::istream& stream)
     {
       ELLE_TRACE_SCOPE("read json from stream");
-      json_spirit::Value value;
-      if (!json_spirit::read(stream, value))
-        throw ParseError(elle::sprintf("JSON error"));
-      return from_spirit(value);
+      Reader reader(stream);
+      return build(reader, reader.next());
+    }
+
+    Json
+    read(Reader& reader)
+    {
+      return build(reader, reader.next());
     }
 
     Json
     read(std::string const& json)
     {
-      std::stringstream s(json);
-      auto res = read(s);
-      {
-        std::string word;
-        if (s >> word)
-          elle::err("garbage at end of JSON value: %s", word);
-      }
+      Reader reader{elle::ConstWeakBuffer(json)};
+      auto res = build(reader, reader.next());
+      auto const end = std::find_if(
+        json.begin() + reader.offset(), json.end(),
+        [] (char c) { return !std::isspace(static_cast<unsigned char>(c)); });
+      if (end != json.end())
+        elle::err("garbage at end of JSON value: %s",
+                  std::string(end, std::find_if(
+                                 end, json.end(),
+                                 [] (char c)
+                                 {
+                                   return std::isspace(
+                                     static_cast<unsigned char>(c));
+                                 })));
       return res;
     }
 
@@ -162,12 +206,9 @@ namespace elle
           bool pretty_print)
     {
       ELLE_TRACE_SCOPE("write json to stream");
-      auto spirit = to_spirit(any);
       elle::IOStreamClear clearer(stream);
-      int options = json_spirit::raw_utf8;
-      if (pretty_print)
-        options |= json_spirit::pretty_print;
-      json_spirit::write(spirit, stream, options);
+      Writer writer(stream, pretty_print);
+      write(writer, any);
       if (with_endl)
         stream << '\n';
       stream.flush();
@@ -21,6 +21,8 @@ namespace elle
     class NullType
     {};
 
+    class Reader;
+
     template <typename Cont>
     auto
     make_array(const Cont& c)
@@ -50,6 +52,10 @@ namespace elle
     Json
     read(std::string const& json);
 
+    /// Read the next value of @a reader into a tree.
+    Json
+    read(Reader& reader);
+
     void
     write(std::ostream& stream,
           Json const& any,
@@ -0,0 +1,399 @@
+#include <elle/log/AsyncLogger.hh>
+
+#include <climits>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+#ifdef INFINIT_WINDOWS
+# include <io.h>
+#else
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
+
+#include <elle/assert.hh>
+
+namespace elle
+{
+  namespace log
+  {
+    namespace
+    {
+      /// Records written by a single writev at most.
+#ifdef IOV_MAX
+      constexpr std::size_t batch_size = IOV_MAX < 256 ? IOV_MAX : 256;
+#else
+      constexpr std::size_t batch_size = 256;
+#endif
+
+      /// The stream given to TextLogger, which AsyncLogger never uses.
+      std::ostream&
+      null_stream()
+      {
+        static std::ostream res(nullptr);
+        return res;
+      }
+
+      /// Live loggers, for the fatal signal handler to flush.
+      std::atomic<AsyncLogger*> loggers[16];
+
+      void
+      write_all(int fd, char const* data, std::size_t size)
+      {
+        while (size)
+        {
+          auto const n = ::write(fd, data, size);
+          if (n < 0)
+          {
+            if (errno == EINTR)
+              continue;
+            return;
+          }
+          data += n;
+          size -= n;
+        }
+      }
+
+#ifndef INFINIT_WINDOWS
+      void
+      writev_all(int fd, iovec* iov, int count)
+      {
+        while (count)
+        {
+          auto n = ::writev(fd, iov, count);
+          if (n < 0)
+          {
+            if (errno == EINTR)
+              continue;
+            return;
+          }
+          while (count && std::size_t(n) >= iov->iov_len)
+          {
+            n -= iov->iov_len;
+            ++iov;
+            --count;
+          }
+          if (count)
+          {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= n;
+          }
+        }
+      }
+
+      int const fatal_signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+      struct sigaction previous_actions[sizeof fatal_signals / sizeof(int)];
+#endif
+    }
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    AsyncLogger::AsyncLogger(int fd,
+                             std::string const& log_level,
+                             Policy policy,
+                             std::size_t capacity,
+                             bool defer)
+      : TextLogger(null_stream(), log_level)
+      , _fd(fd)
+      , _policy(policy)
+      , _mask([capacity]
+              {
+                auto res = std::size_t(2);
+                while (res < capacity)
+                  res *= 2;
+                return res - 1;
+              }())
+      , _cells(new Cell[this->_mask + 1])
+      , _push(0)
+      , _pop(0)
+      , _written(0)
+      , _dropped(0)
+      , _sleeping(false)
+      , _stopping(false)
+    {
+      this->_defer = defer;
+      for (auto i = 0u; i <= this->_mask; ++i)
+        this->_cells[i].sequence.store(i, std::memory_order_relaxed);
+      this->_writer = std::thread([this] { this->_run(); });
+      for (auto& slot: loggers)
+      {
+        auto expected = static_cast<AsyncLogger*>(nullptr);
+        if (slot.compare_exchange_strong(expected, this))
+          break;
+      }
+#ifndef INFINIT_WINDOWS
+      static std::once_flag install;
+      std::call_once(install, []
+        {
+          for (auto i = 0u; i < sizeof fatal_signals / sizeof(int); ++i)
+          {
+            struct sigaction action = {};
+            action.sa_handler = &Self::_crash_handler;
+            sigemptyset(&action.sa_mask);
+            ::sigaction(fatal_signals[i], &action, &previous_actions[i]);
+          }
+        });
+#endif
+    }
+
+    AsyncLogger::~AsyncLogger()
+    {
+      for (auto& slot: loggers)
+      {
+        auto expected = this;
+        if (slot.compare_exchange_strong(expected, nullptr))
+          break;
+      }
+      this->_stopping = true;
+      {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_pushed.notify_one();
+      }
+      this->_writer.join();
+    }
+
+    /*--------.
+    | Writing |
+    `--------*/
+
+    void
+    AsyncLogger::_emit(Level level,
+                       Type type,
+                       std::string const& component,
+                       std::unique_ptr<Deferred> message,
+                       std::string const& file,
+                       unsigned int line,
+                       std::string const& function,
+                       char const* format)
+    {
+      if (this->warn_err_only() && type < Type::warning)
+        return;
+      auto const indentation = int(this->indentation());
+      // Let the synchronous path report the error.
+      if (indentation < 1)
+        return TextLogger::_emit(level, type, component, std::move(message),
+                                 file, line, function, format);
+      this->_enqueue(
+        {},
+        std::unique_ptr<Pending>(new Pending{
+            level, type, component, this->_time(), std::move(message),
+            this->_tags(), indentation - 1, file, line, function, format}));
+    }
+
+    void
+    AsyncLogger::_write(std::string text)
+    {
+      this->_enqueue(std::move(text), nullptr);
+    }
+
+    void
+    AsyncLogger::_enqueue(std::string text, std::unique_ptr<Pending> pending)
+    {
+      auto pos = this->_push.load(std::memory_order_relaxed);
+      while (true)
+      {
+        auto& cell = this->_cells[pos & this->_mask];
+        auto const diff = std::intptr_t(
+          cell.sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+          if (this->_push.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed))
+          {
+            cell.text = std::move(text);
+            cell.pending = std::move(pending);
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            break;
+          }
+        }
+        else if (diff < 0)
+        {
+          // The ring is full.
+          if (this->_policy == Policy::drop)
+          {
+            ++this->_dropped;
+            return;
+          }
+          this->_wake();
+          std::unique_lock<std::mutex> lock(this->_mutex);
+          this->_flushed.wait_for(
+            lock, std::chrono::milliseconds(10),
+            [&]
+            {
+              return std::intptr_t(
+                cell.sequence.load(std::memory_order_acquire) - pos) >= 0;
+            });
+          pos = this->_push.load(std::memory_order_relaxed);
+        }
+        else
+          pos = this->_push.load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      this->_wake();
+    }
+
+    void
+    AsyncLogger::_wake()
+    {
+      if (this->_sleeping.load())
+      {
+        std::lock_guard<std::mutex> lock(this->_mutex);
+        this->_pushed.notify_one();
+      }
+    }
+
+    void
+    AsyncLogger::flush()
+    {
+      auto const target = this->_push.load();
+      std::unique_lock<std::mutex> lock(this->_mutex);
+      this->_pushed.notify_one();
+      this->_flushed.wait(
+        lock, [&] { return this->_written.load() >= target; });
+    }
+
+    std::uint64_t
+    AsyncLogger::dropped() const
+    {
+      return this->_dropped.load();
+    }
+
+    std::pair<std::size_t, std::size_t>
+    AsyncLogger::_claim(std::size_t max)
+    {
+      auto pos = this->_pop.load(std::memory_order_relaxed);
+      while (true)
+      {
+        auto count = std::size_t(0);
+        while (count < max &&
+               this->_cells[(pos + count) & this->_mask].sequence.load(
+                 std::memory_order_acquire) == pos + count + 1)
+          ++count;
+        if (!count ||
+            this->_pop.compare_exchange_weak(
+              pos, pos + count, std::memory_order_relaxed))
+          return {pos, count};
+      }
+    }
+
+    void
+    AsyncLogger::_run()
+    {
+#ifndef INFINIT_WINDOWS
+      auto iov = std::vector<iovec>(batch_size);
+#endif
+      auto const capacity = this->_mask + 1;
+      while (true)
+      {
+        auto const claimed =
+          this->_claim(std::min(batch_size, capacity));
+        auto const pos = claimed.first;
+        auto const count = claimed.second;
+        if (!count)
+        {
+          if (this->_stopping)
+            break;
+          std::unique_lock<std::mutex> lock(this->_mutex);
+          this->_sleeping = true;
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          auto const& next = this->_cells[pos & this->_mask];
+          if (next.sequence.load(std::memory_order_acquire) != pos + 1 &&
+              !this->_stopping)
+            this->_pushed.wait_for(lock, std::chrono::milliseconds(100));
+          this->_sleeping = false;
+          continue;
+        }
+#ifdef INFINIT_WINDOWS
+        for (auto i = 0u; i < count; ++i)
+        {
+          auto const& text =
+            this->_rendered(this->_cells[(pos + i) & this->_mask]);
+          write_all(this->_fd, text.data(), text.size());
+        }
+#else
+        for (auto i = 0u; i < count; ++i)
+        {
+          auto& text = this->_rendered(this->_cells[(pos + i) & this->_mask]);
+          iov[i].iov_base = const_cast<char*>(text.data());
+          iov[i].iov_len = text.size();
+        }
+        writev_all(this->_fd, iov.data(), count);
+#endif
+        for (auto i = 0u; i < count; ++i)
+        {
+          auto& cell = this->_cells[(pos + i) & this->_mask];
+          // Keep the capacity, so steady logging does not allocate here.
+          cell.text.clear();
+          cell.sequence.store(pos + i + capacity, std::memory_order_release);
+        }
+        this->_written.store(pos + count);
+        {
+          std::lock_guard<std::mutex> lock(this->_mutex);
+        }
+        this->_flushed.notify_all();
+      }
+    }
+
+    std::string&
+    AsyncLogger::_rendered(Cell& cell)
+    {
+      if (auto const& p = cell.pending)
+      {
+        cell.text = this->_render(
+          p->level, p->type, p->component, p->time, p->message->render(),
+          p->tags, p->indentation, p->file, p->line, p->function);
+        cell.pending.reset();
+      }
+      return cell.text;
+    }
+
+    /*--------.
+    | Crashes |
+    `--------*/
+
+    void
+    AsyncLogger::_crash_flush()
+    {
+      // Only async-signal-safe operations: atomics and write.
+      while (true)
+      {
+        auto const claimed = this->_claim(this->_mask + 1);
+        if (!claimed.second)
+          return;
+        for (auto i = 0u; i < claimed.second; ++i)
+        {
+          auto const& cell = this->_cells[(claimed.first + i) & this->_mask];
+          if (cell.pending)
+          {
+            if (auto const format = cell.pending->format)
+            {
+              write_all(this->_fd, format, std::strlen(format));
+              write_all(this->_fd, "\n", 1);
+            }
+          }
+          else
+            write_all(this->_fd, cell.text.data(), cell.text.size());
+        }
+      }
+    }
+
+    void
+    AsyncLogger::_crash_handler(int signal)
+    {
+      for (auto& slot: loggers)
+        if (auto logger = slot.load())
+          logger->_crash_flush();
+#ifndef INFINIT_WINDOWS
+      for (auto i = 0u; i < sizeof fatal_signals / sizeof(int); ++i)
+        if (fatal_signals[i] == signal)
+          ::sigaction(signal, &previous_actions[i], nullptr);
+      ::raise(signal);
+#endif
+    }
+  }
+}
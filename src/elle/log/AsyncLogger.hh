@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <elle/log/TextLogger.hh>
+
+namespace elle
+{
+  namespace log
+  {
+    /// A TextLogger that writes from a background thread.
+    ///
+    /// Messages are rendered by the logging thread and pushed into a bounded
+    /// lock-free ring, so logging never waits for the output unless the ring
+    /// is full and the policy is to block.  A writer thread drains the ring
+    /// and writes records in batches, with one writev per batch.
+    ///
+    /// Pending records are written when the logger is destroyed, and on
+    /// fatal signals (SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT) before the
+    /// previous handler is run.
+    ///
+    /// If it defers messages, those whose arguments can be captured by value
+    /// are pushed as is, and both formatted and rendered by the writer:
+    /// logging them only costs a copy of the arguments.  Those not written
+    /// yet on a fatal signal are reduced to their format.
+    class ELLE_API AsyncLogger
+      : public TextLogger
+    {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      using Self = AsyncLogger;
+      /// What to do with records logged when the ring is full.
+      enum class Policy
+      {
+        /// Wait for the writer to make room.
+        block,
+        /// Discard the record and count it in dropped().
+        drop,
+      };
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Create an asynchronous logger.
+      ///
+      /// @param fd        The file descriptor to write to, not closed.
+      /// @param log_level Default level, overriden by $ELLE_LOG_LEVEL.
+      /// @param policy    What to do with records logged when the ring is
+      ///                  full.
+      /// @param capacity  The number of records the ring holds, rounded up
+      ///                  to a power of two.
+      /// @param defer     Whether to render messages from the writer, when
+      ///                  possible.
+      AsyncLogger(int fd,
+                  std::string const& log_level = "",
+                  Policy policy = Policy::block,
+                  std::size_t capacity = 4096,
+                  bool defer = false);
+      /// Write pending records and stop the writer.
+      ~AsyncLogger() override;
+
+    /*--------.
+    | Writing |
+    `--------*/
+    public:
+      /// Wait until every record logged so far is written.
+      void
+      flush();
+      /// Number of records discarded because the ring was full.
+      std::uint64_t
+      dropped() const;
+    protected:
+      void
+      _emit(Level level,
+            Type type,
+            std::string const& component,
+            std::unique_ptr<Deferred> message,
+            std::string const& file,
+            unsigned int line,
+            std::string const& function,
+            char const* format) override;
+      void
+      _write(std::string text) override;
+    private:
+      /// A deferred message, with what to render it.
+      struct Pending
+      {
+        Level level;
+        Type type;
+        std::string component;
+        Time time;
+        std::unique_ptr<Deferred> message;
+        Tags tags;
+        int indentation;
+        std::string file;
+        unsigned int line;
+        std::string function;
+        char const* format;
+      };
+      struct Cell
+      {
+        /// The position this cell can be written at, or the position it
+        /// holds a record for plus one.
+        std::atomic<std::size_t> sequence;
+        std::string text;
+        /// If set, the record is to be rendered from it.
+        std::unique_ptr<Pending> pending;
+      };
+      /// Push a record, rendered or pending.
+      void
+      _enqueue(std::string text, std::unique_ptr<Pending> pending);
+      /// The text of a claimed record, rendering it if pending.
+      std::string&
+      _rendered(Cell& cell);
+      /// Wake the writer if it sleeps.
+      void
+      _wake();
+      /// Writer thread body.
+      void
+      _run();
+      /// Claim up to @a max consecutive records.
+      ///
+      /// @returns The position of the first claimed record and the number of
+      ///          records claimed.
+      std::pair<std::size_t, std::size_t>
+      _claim(std::size_t max);
+      /// Write all pending records synchronously, from a signal handler.
+      void
+      _crash_flush();
+      /// Fatal signal handler flushing all AsyncLoggers.
+      static
+      void
+      _crash_handler(int signal);
+      ELLE_ATTRIBUTE_R(int, fd);
+      ELLE_ATTRIBUTE_R(Policy, policy);
+      ELLE_ATTRIBUTE(std::size_t, mask);
+      ELLE_ATTRIBUTE(std::unique_ptr<Cell[]>, cells);
+      /// Next position to push at.
+      ELLE_ATTRIBUTE(std::atomic<std::size_t>, push);
+      /// Next position to write.
+      ELLE_ATTRIBUTE(std::atomic<std::size_t>, pop);
+      /// Number of records written or given up on.
+      ELLE_ATTRIBUTE(std::atomic<std::size_t>, written);
+      ELLE_ATTRIBUTE(std::atomic<std::uint64_t>, dropped);
+      ELLE_ATTRIBUTE(std::atomic<bool>, sleeping);
+      ELLE_ATTRIBUTE(std::atomic<bool>, stopping);
+      ELLE_ATTRIBUTE(std::mutex, mutex);
+      /// Signaled when records are pushed while the writer sleeps.
+      ELLE_ATTRIBUTE(std::condition_variable, pushed);
+      /// Signaled when records are written.
+      ELLE_ATTRIBUTE(std::condition_variable, flushed);
+      ELLE_ATTRIBUTE(std::thread, writer);
+    };
+  }
+}
@@ -0,0 +1,494 @@
+#include <elle/log/BinaryLogger.hh>
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+#include <boost/date_time/c_local_time_adjustor.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <elle/Exception.hh>
+#include <elle/Plugin.hh>
+#include <elle/printf.hh>
+#include <elle/system/getpid.hh>
+
+namespace elle
+{
+  namespace log
+  {
+    /*-------.
+    | Format |
+    `-------*/
+
+    // A log starts with `magic`, a version byte and the wall-clock time of
+    // its start in microseconds since the epoch.  Then come records, all
+    // integers being LEB128 varints:
+    //
+    // - string:  0, size, bytes.  Strings are numbered from 1 on.
+    // - format:  1, number of literals, then each literal as size, bytes.
+    //            Formats are numbered from 1 on.
+    // - message: 2, level | type << 3, microseconds since the previous
+    //            message, component, indentation, 0 if the tags are those
+    //            of the previous message or their number plus one followed
+    //            by each as name and value, file, line, function, format,
+    //            then either the message if the format is 0 or one value per
+    //            directive.
+    //
+    // Components, tag names, files and functions are string numbers.  Values
+    // are either a string number or 0, size, bytes.  A new header, e.g. from
+    // ELLE_LOG_FILE_APPEND, starts over with fresh strings and formats.
+
+    namespace
+    {
+      char const magic[] = "elle-log";
+      char const version = 1;
+
+      enum Record : char
+      {
+        string_record = 0,
+        format_record = 1,
+        message_record = 2,
+      };
+
+      /// Longest value interned.
+      std::size_t const max_interned = 256;
+      /// Number of strings after which values are not interned anymore.
+      std::size_t const max_strings = 1 << 14;
+      /// Number of formats after which new ones are not split anymore.
+      std::size_t const max_formats = 1 << 12;
+
+      void
+      put(std::string& out, std::uint64_t v)
+      {
+        while (v >= 0x80)
+        {
+          out += static_cast<char>(v | 0x80);
+          v >>= 7;
+        }
+        out += static_cast<char>(v);
+      }
+
+      void
+      put(std::string& out, std::string const& s)
+      {
+        put(out, s.size());
+        out += s;
+      }
+
+      /// Split a format string around its directives.
+      ///
+      /// @returns Whether the format is valid.
+      bool
+      split(char const* format, std::vector<std::string>& literals)
+      {
+        literals.emplace_back();
+        for (auto p = format; *p; ++p)
+          if (*p == '\\' && p[1] && std::strchr("\\{}%", p[1]))
+            literals.back() += *++p;
+          else if (*p == '{')
+          {
+            for (auto depth = 1; depth;)
+            {
+              if (!*++p)
+                return false;
+              if (*p == '\\' && p[1])
+                ++p;
+              else if (*p == '{')
+                ++depth;
+              else if (*p == '}')
+                --depth;
+            }
+            literals.emplace_back();
+          }
+          else if (*p == '%')
+          {
+            if (!*++p)
+              return false;
+            literals.emplace_back();
+          }
+          else if (*p == '}')
+            return false;
+          else
+            literals.back() += *p;
+        return true;
+      }
+
+      std::uint64_t
+      now()
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+      }
+    }
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    BinaryLogger::BinaryLogger(std::ostream& out,
+                               std::string const& log_level)
+      : Logger(log_level)
+      , _output(out)
+      , _next_format(0)
+      , _last(std::chrono::steady_clock::now())
+      , _pid(boost::lexical_cast<std::string>(elle::system::getpid()))
+    {
+      this->_buffer.append(magic, sizeof magic);
+      this->_buffer += version;
+      put(this->_buffer, now());
+      this->_output.write(this->_buffer.data(), this->_buffer.size());
+      this->_output.flush();
+      this->_buffer.clear();
+    }
+
+    /*----------.
+    | Messaging |
+    `----------*/
+
+    void
+    BinaryLogger::_emit(Level level,
+                        Type type,
+                        std::string const& component,
+                        std::string const& message,
+                        std::string const& file,
+                        unsigned int line,
+                        std::string const& function,
+                        char const* format)
+    {
+      int indent = this->indentation();
+      if (indent < 1)
+        return Logger::_emit(
+          level, type, component, message, file, line, function, format);
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_tags.clear();
+      for (auto const& tag: elle::Plugin<Tag>::plugins())
+      {
+        // Spare the rendering of the process and thread ids.
+        auto const name = tag.second->name();
+        if (name == "PID")
+          this->_tags.emplace_back(this->_intern(name), this->_pid);
+        else if (name == "TID")
+        {
+          if (!this->_tid.get())
+            this->_tid.reset(new std::string(
+              boost::lexical_cast<std::string>(std::this_thread::get_id())));
+          this->_tags.emplace_back(this->_intern(name), *this->_tid);
+        }
+        else
+        {
+          auto content = tag.second->content();
+          if (!content.empty())
+            this->_tags.emplace_back(this->_intern(name), std::move(content));
+        }
+      }
+      this->_record(level, type, component, indent - 1,
+                    file, line, function, message, format);
+    }
+
+    void
+    BinaryLogger::_message(Level level,
+                           Type type,
+                           std::string const& component,
+                           Time const&,
+                           std::string const& message,
+                           Tags const& tags,
+                           int indentation,
+                           std::string const& file,
+                           unsigned int line,
+                           std::string const& function)
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_tags.clear();
+      for (auto const& tag: tags)
+        this->_tags.emplace_back(this->_intern(tag.first), tag.second);
+      this->_record(level, type, component, indentation,
+                    file, line, function, message, nullptr);
+    }
+
+    void
+    BinaryLogger::_record(Level level,
+                          Type type,
+                          std::string const& component,
+                          int indentation,
+                          std::string const& file,
+                          unsigned int line,
+                          std::string const& function,
+                          std::string const& message,
+                          char const* format)
+    {
+      auto& body = this->_body;
+      body.clear();
+      body += message_record;
+      body += static_cast<char>(
+        static_cast<int>(level) | static_cast<int>(type) << 3);
+      auto const time = std::chrono::steady_clock::now();
+      put(body, std::chrono::duration_cast<std::chrono::microseconds>(
+            time - this->_last).count());
+      this->_last = time;
+      put(body, this->_intern(component));
+      put(body, indentation);
+      if (this->_tags == this->_previous_tags)
+        put(body, 0);
+      else
+      {
+        put(body, this->_tags.size() + 1);
+        for (auto const& tag: this->_tags)
+        {
+          put(body, tag.first);
+          this->_reference(tag.second);
+        }
+        std::swap(this->_tags, this->_previous_tags);
+      }
+      put(body, this->_intern(file));
+      put(body, line);
+      put(body, this->_intern(function));
+      auto const mark = body.size();
+      auto const& f = this->_format(format);
+      if (f.id)
+      {
+        put(body, f.id);
+        if (!this->_arguments(message, f))
+          body.resize(mark);
+      }
+      if (body.size() == mark)
+      {
+        put(body, 0);
+        this->_reference(message);
+      }
+      this->_buffer += body;
+      this->_output.write(this->_buffer.data(), this->_buffer.size());
+      this->_output.flush();
+      this->_buffer.clear();
+    }
+
+    bool
+    BinaryLogger::_arguments(std::string const& message,
+                             Format const& format)
+    {
+      auto const& literals = format.literals;
+      auto const& first = literals.front();
+      auto const& last = literals.back();
+      if (literals.size() == 1)
+        return message == first;
+      if (message.size() < first.size() + last.size() ||
+          message.compare(0, first.size(), first) != 0 ||
+          message.compare(message.size() - last.size(), last.size(), last))
+        return false;
+      auto const end = message.size() - last.size();
+      auto pos = first.size();
+      for (auto it = literals.begin() + 1; it != literals.end() - 1; ++it)
+      {
+        auto const next = message.find(*it, pos);
+        if (next == std::string::npos || next + it->size() > end)
+          return false;
+        this->_reference(message.substr(pos, next - pos));
+        pos = next + it->size();
+      }
+      this->_reference(message.substr(pos, end - pos));
+      return true;
+    }
+
+    std::uint64_t
+    BinaryLogger::_intern(std::string const& s)
+    {
+      auto it = this->_strings.find(s);
+      if (it != this->_strings.end())
+        return it->second;
+      auto const id = this->_strings.size() + 1;
+      this->_strings.emplace(s, id);
+      this->_buffer += string_record;
+      put(this->_buffer, s);
+      return id;
+    }
+
+    void
+    BinaryLogger::_reference(std::string const& s)
+    {
+      auto it = this->_strings.find(s);
+      if (it != this->_strings.end())
+        put(this->_body, it->second);
+      else if (s.size() <= max_interned &&
+               this->_strings.size() < max_strings)
+        put(this->_body, this->_intern(s));
+      else
+      {
+        put(this->_body, 0);
+        put(this->_body, s);
+      }
+    }
+
+    BinaryLogger::Format const&
+    BinaryLogger::_format(char const* format)
+    {
+      static auto const raw = Format{"", 0, {}};
+      if (!format)
+        return raw;
+      auto it = this->_formats.find(format);
+      // The address may have been reused for another format.
+      if (it != this->_formats.end() && it->second.text == format)
+        return it->second;
+      if (it == this->_formats.end() && this->_formats.size() >= max_formats)
+        return raw;
+      auto f = Format{format, 0, {}};
+      if (split(format, f.literals))
+      {
+        f.id = ++this->_next_format;
+        this->_buffer += format_record;
+        put(this->_buffer, f.literals.size());
+        for (auto const& literal: f.literals)
+          put(this->_buffer, literal);
+      }
+      return this->_formats[format] = std::move(f);
+    }
+
+    /*---------.
+    | Decoding |
+    `---------*/
+
+    namespace
+    {
+      /// Thrown on a truncated record.
+      struct Truncated
+      {};
+
+      std::uint64_t
+      get(std::istream& in)
+      {
+        auto res = std::uint64_t(0);
+        for (auto shift = 0; ; shift += 7)
+        {
+          auto const c = in.get();
+          if (c == std::istream::traits_type::eof())
+            throw Truncated();
+          res |= std::uint64_t(c & 0x7f) << shift;
+          if (!(c & 0x80))
+            return res;
+        }
+      }
+
+      std::string
+      get_string(std::istream& in)
+      {
+        auto res = std::string(get(in), '\0');
+        if (!in.read(&res[0], res.size()))
+          throw Truncated();
+        return res;
+      }
+    }
+
+    void
+    BinaryLogger::decode(std::istream& in, Logger& out)
+    {
+      auto strings = std::vector<std::string>{};
+      auto formats = std::vector<std::vector<std::string>>{};
+      auto time = std::uint64_t(0);
+      auto tags = Tags{};
+      // Logs appended to one another are decoded in turn.
+      auto const header = [&] (int first)
+        {
+          char rest[sizeof magic];
+          if (first != magic[0] ||
+              !in.read(rest, sizeof rest) ||
+              std::memcmp(rest, magic + 1, sizeof magic - 1))
+            elle::err("not a binary log");
+          if (rest[sizeof magic - 1] != version)
+            elle::err("unsupported binary log version: %s",
+                      int(rest[sizeof magic - 1]));
+          strings.clear();
+          formats.clear();
+          tags.clear();
+          time = get(in);
+        };
+      auto const string = [&] (std::uint64_t id) -> std::string const&
+        {
+          if (id == 0 || id > strings.size())
+            elle::err("invalid string in binary log: %s", id);
+          return strings[id - 1];
+        };
+      auto const value = [&] () -> std::string
+        {
+          auto const id = get(in);
+          return id ? string(id) : get_string(in);
+        };
+      using namespace boost::posix_time;
+      using local = boost::date_time::c_local_adjustor<ptime>;
+      auto const epoch = ptime(boost::gregorian::date(1970, 1, 1));
+      try
+      {
+        header(in.get());
+        while (true)
+        {
+          auto const kind = in.get();
+          if (kind == std::istream::traits_type::eof())
+            break;
+          switch (kind)
+          {
+            case string_record:
+              strings.emplace_back(get_string(in));
+              break;
+            case format_record:
+            {
+              auto literals = std::vector<std::string>(get(in));
+              for (auto& literal: literals)
+                literal = get_string(in);
+              formats.emplace_back(std::move(literals));
+              break;
+            }
+            case message_record:
+            {
+              auto const kinds = in.get();
+              if (kinds == std::istream::traits_type::eof())
+                throw Truncated();
+              auto const level = static_cast<Level>(kinds & 7);
+              auto const type = static_cast<Type>(kinds >> 3);
+              time += get(in);
+              auto const& component = string(get(in));
+              auto const indentation = static_cast<int>(get(in));
+              if (auto n = get(in))
+              {
+                tags.clear();
+                for (--n; n; --n)
+                {
+                  auto const& name = string(get(in));
+                  tags.emplace_back(name, value());
+                }
+              }
+              auto const& file = string(get(in));
+              auto const line = static_cast<unsigned int>(get(in));
+              auto const& function = string(get(in));
+              auto message = std::string{};
+              if (auto const format = get(in))
+              {
+                if (format > formats.size())
+                  elle::err("invalid format in binary log: %s", format);
+                auto const& literals = formats[format - 1];
+                message = literals.front();
+                for (auto i = 1u; i < literals.size(); ++i)
+                  message += value() + literals[i];
+              }
+              else
+                message = value();
+              if (!out.component_is_active(component, level))
+                break;
+              auto t = epoch + microseconds(time);
+              if (!out.time_microsec())
+                t = ptime(t.date(), seconds(t.time_of_day().total_seconds()));
+              if (!out.time_universal())
+                t = local::utc_to_local(t);
+              std::lock_guard<std::recursive_mutex> lock(out._mutex);
+              out._message(level, type, component, t, message, tags,
+                           indentation, file, line, function);
+              break;
+            }
+            default:
+              header(kind);
+          }
+        }
+      }
+      catch (Truncated const&)
+      {}
+    }
+  }
+}
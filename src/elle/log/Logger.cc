@@ -20,6 +20,7 @@
 #include <elle/Plugin.hh>
 #include <elle/assert.hh>
 #include <elle/log/Logger.hh>
+#include <elle/log/Send.hh>
 #include <elle/os/environ.hh>
 #include <elle/printf.hh>
 #include <elle/system/getpid.hh>
@@ -107,12 +108,47 @@ namespace elle
         else if (level == "DUMP")  return Logger::Level::dump;
         else elle::err("invalid log level: %s", level);
       }
+
+      /// Source of Logger::Levels serials.
+      std::atomic<std::uint64_t> levels_serial{0};
+
+      /// Count a reader of the levels in scope. Not a SafeFinally, which
+      /// logs.
+      struct Reading
+      {
+        Reading(std::atomic<unsigned int>& readers)
+          : readers(readers)
+        {
+          ++this->readers;
+        }
+
+        ~Reading()
+        {
+          --this->readers;
+        }
+
+        std::atomic<unsigned int>& readers;
+      };
+
+      /// Component stacks, shared by all loggers of a thread.
+      boost::thread_specific_ptr<Logger::component_stack_t>&
+      component_stacks()
+      {
+        static boost::thread_specific_ptr<Logger::component_stack_t> res;
+        return res;
+      }
     }
 
     Logger::Logger(std::string const& log_level)
       : _indentation(std::make_unique<PlainIndentation>())
       , _time_universal(false)
       , _time_microsec(false)
+      , _defer(false)
+      , _levels(nullptr)
+      , _levels_readers(0)
+      , _levels_history()
+      , _levels_mutex()
+      , _levels_cache()
       , _component_max_size(0)
     {
       this->_setup_indentation();
@@ -120,7 +156,7 @@ namespace elle
       elle::Plugin<Indenter>::hook_added().connect(
         [this] (Indenter&) { this->_setup_indentation(); }
       );
-      this->_setup_levels(elle::os::getenv("ELLE_LOG_LEVEL", log_level));
+      this->levels(elle::os::getenv("ELLE_LOG_LEVEL", log_level));
     }
 
     Logger::~Logger() = default;
@@ -142,9 +178,33 @@ namespace elle
       this->_indentation = factory();
     }
 
+    /*-------.
+    | Levels |
+    `-------*/
+
     void
-    Logger::_setup_levels(std::string const& levels)
+    Logger::levels(std::string const& levels)
     {
+      auto parsed = this->_parse_levels(levels);
+      {
+        std::lock_guard<std::mutex> lock(this->_levels_mutex);
+        this->_levels.store(parsed.get());
+        this->_levels_history.emplace_back(std::move(parsed));
+        // Readers register before loading the levels: if none is in
+        // progress, later ones see the new levels and the previous ones can
+        // go.
+        if (this->_levels_readers.load() == 0)
+          this->_levels_history.erase(this->_levels_history.begin(),
+                                      this->_levels_history.end() - 1);
+      }
+      detail::Site::invalidate();
+    }
+
+    std::unique_ptr<Logger::Levels const>
+    Logger::_parse_levels(std::string const& levels)
+    {
+      auto res = std::make_unique<Levels>();
+      res->serial = ++levels_serial;
       using tokenizer = boost::tokenizer<boost::char_separator<char>>;
       auto const sep = boost::char_separator<char>{","};
       for (auto const& level: tokenizer{levels, sep})
@@ -161,19 +221,22 @@ namespace elle
 
         auto m = std::smatch{};
         if (std::regex_match(level, m, re))
-          this->_component_patterns
+          res->filters
             .emplace_back(m[1],
                           m[2].length() ? m[2].str() : "*",
                           parse_level(m[3]));
         else
           elle::err("invalid level specification: %s", level);
       }
+      return res;
     }
 
     /*----------.
     | Messaging |
     `----------*/
 
+    Deferred::~Deferred() = default;
+
     void
     Logger::message(Level level,
                     Type type,
@@ -181,14 +244,31 @@ namespace elle
                     std::string const& msg,
                     std::string const& file,
                     unsigned int line,
-                    std::string const& function)
+                    std::string const& function,
+                    char const* format)
     {
-      std::lock_guard<std::recursive_mutex> lock(_mutex);
+      if (this->component_is_active(component, level))
+        this->_emit(level, type, component, msg, file, line, function, format);
+    }
 
-      if (!this->component_is_active(component, level))
-        return;
+    void
+    Logger::message(Level level,
+                    Type type,
+                    std::string const& component,
+                    std::unique_ptr<Deferred> msg,
+                    std::string const& file,
+                    unsigned int line,
+                    std::string const& function,
+                    char const* format)
+    {
+      if (this->component_is_active(component, level))
+        this->_emit(level, type, component, std::move(msg),
+                    file, line, function, format);
+    }
 
-      int indent = this->indentation();
+    Logger::Tags
+    Logger::_tags() const
+    {
       auto tags = Tags{};
       for (auto const& tag: elle::Plugin<Tag>::plugins())
       {
@@ -196,13 +276,49 @@ namespace elle
         if (!content.empty())
           tags.emplace_back(tag.second->name(), content);
       }
-      auto time = this->_time_microsec ?
+      return tags;
+    }
+
+    Logger::Time
+    Logger::_time() const
+    {
+      return this->_time_microsec ?
          ( this->_time_universal ?
         boost::posix_time::microsec_clock::universal_time() :
         boost::posix_time::microsec_clock::local_time())
          :  ( this->_time_universal ?
         boost::posix_time::second_clock::universal_time() :
         boost::posix_time::second_clock::local_time());
+    }
+
+    void
+    Logger::_emit(Level level,
+                  Type type,
+                  std::string const& component,
+                  std::unique_ptr<Deferred> msg,
+                  std::string const& file,
+                  unsigned int line,
+                  std::string const& function,
+                  char const* format)
+    {
+      this->_emit(level, type, component, msg->render(),
+                  file, line, function, format);
+    }
+
+    void
+    Logger::_emit(Level level,
+                  Type type,
+                  std::string const& component,
+                  std::string const& msg,
+                  std::string const& file,
+                  unsigned int line,
+                  std::string const& function,
+                  char const*)
+    {
+      int indent = this->indentation();
+      auto const tags = this->_tags();
+      auto const time = this->_time();
+      std::lock_guard<std::recursive_mutex> lock(this->_mutex);
       if (indent < 1)
       {
         this->_message(
@@ -263,39 +379,49 @@ namespace elle
     Logger::component_is_active(std::string const& name,
                                 Level level)
     {
-      std::lock_guard<std::recursive_mutex> lock(_mutex);
       auto res = level <= this->component_level(name);
       // Update the max width of displayed component names.
       if (res)
-        this->_component_max_size =
-          std::max(this->_component_max_size,
-                   static_cast<unsigned int>(name.size()));
+      {
+        auto const size = static_cast<unsigned int>(name.size());
+        auto max = this->_component_max_size.load(std::memory_order_relaxed);
+        while (max < size &&
+               !this->_component_max_size.compare_exchange_weak(
+                 max, size, std::memory_order_relaxed))
+          ;
+      }
       return res;
     }
 
     Logger::Level
     Logger::component_level(std::string const& name)
     {
-      std::lock_guard<std::recursive_mutex> lock(_mutex);
-      auto res = Level::log;
-
-      auto i = this->_component_levels.find(name);
-      if (i == this->_component_levels.cend())
+      Reading reading(this->_levels_readers);
+      auto const& levels = *this->_levels.load();
+      if (!this->_levels_cache.get())
+        this->_levels_cache.reset(new Cache);
+      auto& resolved = (*this->_levels_cache)[name];
+      if (resolved.serial != levels.serial)
       {
-        for (auto const& filter: this->_component_patterns)
+        resolved = Resolved{levels.serial, Level::log, false};
+        for (auto const& filter: levels.filters)
           if (filter.match(name))
           {
-            if (filter.match(this->_component_stack))
-              res = filter.level;
-            // If enabled unconditionally, cache it.
             if (filter.context.empty())
               // Several filters might apply (e.g.,
               // $ELLE_LOG_LEVEL="LOG,DUMP"), keep the last one.
-              this->_component_levels[name] = res;
+              resolved.level = filter.level;
+            else
+              resolved.contextual = true;
           }
       }
-      else
-        res = i->second;
+      if (!resolved.contextual)
+        return resolved.level;
+      auto res = Level::log;
+      auto const& stack = this->component_stack();
+      for (auto const& filter: levels.filters)
+        if (filter.match(name, stack))
+          res = filter.level;
       return res;
     }
 
@@ -305,23 +431,39 @@ namespace elle
       return this->component_level(name);
     }
 
+    unsigned int
+    Logger::component_max_size() const
+    {
+      return this->_component_max_size.load(std::memory_order_relaxed);
+    }
+
     /*-------------.
     | Components.  |
     `-------------*/
 
+    Logger::component_stack_t const&
+    Logger::component_stack() const
+    {
+      auto& stacks = component_stacks();
+      if (!stacks.get())
+        stacks.reset(new component_stack_t);
+      return *stacks;
+    }
+
     void
     Logger::component_push(std::string const& name)
     {
-      std::lock_guard<std::recursive_mutex> lock(_mutex);
-      this->_component_stack.emplace_back(name);
+      const_cast<component_stack_t&>(this->component_stack())
+        .emplace_back(name);
     }
 
     void
     Logger::component_pop()
     {
-      std::lock_guard<std::recursive_mutex> lock(_mutex);
-      assert(!this->_component_stack.empty());
-      this->_component_stack.pop_back();
+      auto& stack =
+        const_cast<component_stack_t&>(this->component_stack());
+      assert(!stack.empty());
+      stack.pop_back();
     }
 
 
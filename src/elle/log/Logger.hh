@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -7,6 +9,7 @@
 #include <vector>
 
 #include <boost/noncopyable.hpp>
+#include <boost/thread/tss.hpp>
 
 #include <elle/attribute.hh>
 #include <elle/log/fwd.hh>
@@ -58,6 +61,19 @@ namespace elle
 
     using Tags = std::vector<std::pair<std::string, std::string>>;
 
+    /// A message whose arguments were captured by value, to be rendered
+    /// later, possibly by another thread.
+    class ELLE_API Deferred
+    {
+    public:
+      virtual
+      ~Deferred();
+      /// The message, formatted.
+      virtual
+      std::string
+      render() const = 0;
+    };
+
     class ELLE_API Logger
       : private boost::noncopyable
     {
@@ -99,9 +115,18 @@ namespace elle
       void
       _setup_indentation();
 
-      /// Process a string formatted like $ELLE_LOG_LEVEL.
+    /*-------.
+    | Levels |
+    `-------*/
+    public:
+      /// Replace the component levels.
+      ///
+      /// Threads logging concurrently see either the previous or the new
+      /// levels, and call sites cached as inactive are checked again.
+      ///
+      /// @param levels Component levels, formatted like $ELLE_LOG_LEVEL.
       void
-      _setup_levels(std::string const& levels);
+      levels(std::string const& levels);
 
     /*------------.
     | Indentation |
@@ -118,6 +143,7 @@ namespace elle
       void
       unindent();
     private:
+      /// Serializes _message.
       mutable std::recursive_mutex _mutex;
       std::unique_ptr<Indentation> _indentation;
       ELLE_ATTRIBUTE_RW(bool, time_universal);
@@ -127,7 +153,7 @@ namespace elle
     | Messaging |
     `----------*/
     public:
-      /// Send a log message.
+      /// Send a log message, unless its component is not active.
       ///
       /// @param level   the verbosity level
       /// @param type    the severity
@@ -136,16 +162,67 @@ namespace elle
       /// @param file    the source file from which comes the message
       /// @param line    and its line number
       /// @param function and the name of the calling function
+      /// @param format  the format the message was printed from, if any
       void message(Level level,
                    Type type,
                    std::string const& component,
                    std::string const& message,
                    std::string const& file,
                    unsigned int line,
-                   std::string const& function);
+                   std::string const& function,
+                   char const* format = nullptr);
+      /// Send a message to be rendered by the logger, unless its component
+      /// is not active.
+      ///
+      /// Only sent to loggers that defer(), which render it when they see
+      /// fit.
+      void message(Level level,
+                   Type type,
+                   std::string const& component,
+                   std::unique_ptr<Deferred> message,
+                   std::string const& file,
+                   unsigned int line,
+                   std::string const& function,
+                   char const* format);
+      /// Whether to accept deferred messages, rather than rendered ones.
+      ELLE_ATTRIBUTE_R(bool, defer, protected);
     protected:
       using Tags = std::vector<std::pair<std::string, std::string>>;
       using Time = boost::posix_time::ptime;
+      /// The tags of a message sent now, from this thread.
+      Tags
+      _tags() const;
+      /// The time of a message sent now.
+      Time
+      _time() const;
+      /// Send a message from an active component.
+      ///
+      /// Gather the tags and the time and pass them to _message.  Loggers
+      /// that do not need them as strings can override this to spare the
+      /// cost.
+      virtual
+      void
+      _emit(Level level,
+            Type type,
+            std::string const& component,
+            std::string const& message,
+            std::string const& file,
+            unsigned int line,
+            std::string const& function,
+            char const* format);
+      /// Send a deferred message from an active component.
+      ///
+      /// Render it and _emit it, unless overriden.
+      virtual
+      void
+      _emit(Level level,
+            Type type,
+            std::string const& component,
+            std::unique_ptr<Deferred> message,
+            std::string const& file,
+            unsigned int line,
+            std::string const& function,
+            char const* format);
       virtual
       void
       _message(Level level,
@@ -158,6 +235,7 @@ namespace elle
                std::string const& file,
                unsigned int line,
                std::string const& function) = 0;
+      friend class BinaryLogger;
       friend class CompositeLogger;
 
     /*-----------.
@@ -166,6 +244,9 @@ namespace elle
     public:
       /// Whether participates as a context or as a component for this
       /// level.
+      ///
+      /// Lock free: the levels are resolved once per component and thread,
+      /// only context filters are evaluated on every call.
       bool
       component_is_active(std::string const& name, Level level = Level::log);
 
@@ -178,15 +259,14 @@ namespace elle
       Level
       component_enabled(std::string const& name);
 
-      /// Push this component in the component stack.
+      /// Push this component in the component stack of this thread.
       void
       component_push(std::string const& name);
 
-      /// Pop the top component from the component stack.
+      /// Pop the top component from the component stack of this thread.
       void
       component_pop();
 
-    private:
       /// Nested components.
       ///
       /// Yes, a stack of (copies) of strings.  Cannot use
@@ -194,6 +274,15 @@ namespace elle
       /// component names outlive us.
       using component_stack_t = std::vector<std::string>;
 
+      /// Nested components of this thread.
+      component_stack_t const&
+      component_stack() const;
+
+      /// Width of the widest active component name so far.
+      unsigned int
+      component_max_size() const;
+
+    private:
       /// Rule about components.
       struct Filter
       {
@@ -226,14 +315,42 @@ namespace elle
       };
 
       /// Translation of $ELLE_LOG_LEVEL into ordered filters.
-      std::vector<Filter> _component_patterns;
-      /// A cache of the decoding of $ELLE_LOG_LEVEL: component-name
-      /// => Level.  Filled only for unconditional levels (i.e., when
-      /// $ELLE_LOG_LEVEL uses no context specification).
-      std::unordered_map<std::string, Level> _component_levels;
-      ELLE_ATTRIBUTE_R(unsigned int, component_max_size);
-      /// Nested components.
-      ELLE_ATTRIBUTE_R(component_stack_t, component_stack);
+      ///
+      /// Immutable once published, so it can be read without locking.
+      struct Levels
+      {
+        std::vector<Filter> filters;
+        /// Unique among all Levels ever created, never 0.
+        std::uint64_t serial;
+      };
+
+      /// Level of a component, regardless of the component stack.
+      struct Resolved
+      {
+        /// Serial of the Levels this was resolved with.
+        std::uint64_t serial;
+        /// Level from filters with no context.
+        Level level;
+        /// Whether some filter with a context matches the component.
+        bool contextual;
+      };
+      using Cache = std::unordered_map<std::string, Resolved>;
+
+      /// Process a string formatted like $ELLE_LOG_LEVEL.
+      std::unique_ptr<Levels const>
+      _parse_levels(std::string const& levels);
+
+      /// Current levels.
+      std::atomic<Levels const*> _levels;
+      /// Calls to component_level in progress, which may use previous levels.
+      std::atomic<unsigned int> _levels_readers;
+      /// Levels published since no reader was in progress, the current ones
+      /// last.
+      std::vector<std::unique_ptr<Levels const>> _levels_history;
+      std::mutex _levels_mutex;
+      /// Per thread cache of the levels of components.
+      boost::thread_specific_ptr<Cache> _levels_cache;
+      std::atomic<unsigned int> _component_max_size;
     };
 
     ELLE_API
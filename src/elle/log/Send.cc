@@ -1,7 +1,12 @@
+#include <fcntl.h>
+
+#include <atomic>
 #include <fstream>
 #include <mutex>
 
 #include <elle/Exception.hh>
+#include <elle/log/AsyncLogger.hh>
+#include <elle/log/BinaryLogger.hh>
 #include <elle/log/Send.hh>
 #include <elle/log/SysLogger.hh>
 #include <elle/log/TextLogger.hh>
@@ -22,6 +27,9 @@ namespace elle
         return logger;
       }
 
+      /// The logger owned by _logger, published for lock free access.
+      std::atomic<Logger*> _current{nullptr};
+
       std::mutex&
       log_mutex()
       {
@@ -33,8 +41,9 @@ namespace elle
     Logger&
     logger()
     {
+      if (auto res = _current.load(std::memory_order_acquire))
+        return *res;
       std::unique_lock<std::mutex> ulock{log_mutex()};
-
       if (!_logger())
       {
         // ELLE_LOG_SYSLOG: the name of the logs.
@@ -45,11 +54,51 @@ namespace elle
         else
         {
           auto const path = elle::os::getenv("ELLE_LOG_FILE", "");
-          if (path.empty())
+          bool const append = elle::os::getenv("ELLE_LOG_FILE_APPEND", false);
+          // ELLE_LOG_BINARY: write logs in the binary format, see
+          // elle-log-decode.
+          if (elle::os::getenv("ELLE_LOG_BINARY", false))
+          {
+            if (path.empty())
+              _logger() = std::make_unique<BinaryLogger>(std::cerr);
+            else
+            {
+              static std::ofstream out{
+                path,
+                (append ? std::fstream::app : std::fstream::trunc)
+                  | std::fstream::out | std::fstream::binary
+              };
+              _logger() = std::make_unique<BinaryLogger>(out);
+            }
+          }
+          // ELLE_LOG_ASYNC: write logs from a background thread.
+          else if (elle::os::getenv("ELLE_LOG_ASYNC", false))
+          {
+            auto fd = 2;
+            if (!path.empty())
+            {
+              // Never closed, like the stream below.
+              auto const file = ::open(
+                path.c_str(),
+                O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0644);
+              if (file >= 0)
+                fd = file;
+            }
+            auto const policy =
+              elle::os::getenv("ELLE_LOG_ASYNC_DROP", false)
+              ? AsyncLogger::Policy::drop
+              : AsyncLogger::Policy::block;
+            // ELLE_LOG_ASYNC_DEFER: render messages from the background
+            // thread too, when possible.
+            _logger() = std::make_unique<AsyncLogger>(
+              fd, "", policy,
+              elle::os::getenv("ELLE_LOG_ASYNC_CAPACITY", 4096u),
+              elle::os::getenv("ELLE_LOG_ASYNC_DEFER", false));
+          }
+          else if (path.empty())
             _logger() = std::make_unique<TextLogger>(std::cerr);
           else
           {
-            bool const append = elle::os::getenv("ELLE_LOG_FILE_APPEND", false);
             static std::ofstream out{
               path,
                 (append ? std::fstream::app : std::fstream::trunc)
@@ -58,6 +107,7 @@ namespace elle
             _logger() = std::make_unique<TextLogger>(out);
           }
         }
+        _current.store(_logger().get(), std::memory_order_release);
       }
       return *_logger();
     }
@@ -69,11 +119,55 @@ namespace elle
       if (_logger() && logger)
         logger->_indentation = _logger()->_indentation->clone();
       std::swap(_logger(), logger);
+      _current.store(_logger().get(), std::memory_order_release);
+      detail::Site::invalidate();
       return logger;
     }
 
     namespace detail
     {
+      /*-----.
+      | Site |
+      `-----*/
+
+      std::atomic<unsigned int> Site::_generation{1};
+
+      void
+      Site::invalidate()
+      {
+        ++_generation;
+      }
+
+      bool
+      Site::_update(unsigned int generation,
+                    Logger::Level level,
+                    Logger::Type type,
+                    char const* component)
+      {
+        auto const state = this->_state.load(std::memory_order_relaxed);
+        auto const res = (state & 1) || Send::active(level, type, component);
+        this->_state.store(generation << 1 | res, std::memory_order_relaxed);
+        return res;
+      }
+
+      elle::_details::Format const*
+      Site::_parse(char const* fmt)
+      {
+        auto parsed =
+          std::make_unique<elle::_details::Format>(elle::_details::parse(fmt));
+        auto expected = static_cast<elle::_details::Format const*>(nullptr);
+        // Another thread may have been first.
+        if (this->_format.compare_exchange_strong(
+              expected, parsed.get(), std::memory_order_acq_rel))
+          return parsed.release();
+        else
+          return expected;
+      }
+
+      /*-----.
+      | Send |
+      `-----*/
+
       bool
       Send::active(Logger::Level level,
                    Logger::Type,
@@ -90,9 +184,28 @@ namespace elle
                   char const* file,
                   unsigned int line,
                   char const* function,
-                  const std::string& msg)
+                  const std::string& msg,
+                  char const* fmt)
+      {
+        logger().message(level, type, component, msg, file, line, function,
+                         fmt);
+        if (indent)
+          this->_indent(component);
+      }
+
+      void
+      Send::_send(Logger::Level level,
+                  Logger::Type type,
+                  bool indent,
+                  std::string const& component,
+                  char const* file,
+                  unsigned int line,
+                  char const* function,
+                  std::unique_ptr<Deferred> msg,
+                  char const* fmt)
       {
-        logger().message(level, type, component, msg, file, line, function);
+        logger().message(level, type, component, std::move(msg),
+                         file, line, function, fmt);
         if (indent)
           this->_indent(component);
       }
@@ -1,14 +1,23 @@
 #pragma once
 
+#include <atomic>
+
 #include <elle/compiler.hh>
 #include <elle/log/Logger.hh>
 #include <elle/memory.hh>
 
 namespace elle
 {
+  namespace _details
+  {
+    struct Format;
+  }
+
   namespace log
   {
     /// The current logger.
+    ///
+    /// Lock free once the logger is set up.
     ELLE_API
     Logger&
     logger();
@@ -26,6 +35,55 @@ namespace elle
     /// logging.
     namespace detail
     {
+      /// Whether a log call site is active, cached, and its parsed format.
+      ///
+      /// One per call site in the logging macros.  Constant-initialized, so
+      /// checking it costs two atomic loads: no lock, no static
+      /// initialization guard.  The cache is dropped when a logger is set or
+      /// its levels change.  A site found active once stays active, as the
+      /// static flag it replaces did: the logger still filters its messages,
+      /// but its scopes keep nesting components.
+      class ELLE_API Site
+      {
+      public:
+        constexpr
+        Site()
+          : _format(nullptr)
+          , _state(0)
+        {}
+        /// Whether messages from this site may be reported.
+        bool
+        active(Logger::Level level,
+               Logger::Type type,
+               char const* component);
+        /// Drop the cache of all sites.
+        static
+        void
+        invalidate();
+        /// The format of this site, parsed on first use only.
+        ///
+        /// @returns null if @a fmt is not the format this site was first
+        ///          used with, e.g. if it is computed at runtime.
+        /// @throws elle::Error if @a fmt is invalid.
+        elle::_details::Format const*
+        format(char const* fmt);
+      private:
+        bool
+        _update(unsigned int generation,
+                Logger::Level level,
+                Logger::Type type,
+                char const* component);
+        elle::_details::Format const*
+        _parse(char const* fmt);
+        /// Never freed, like the site itself.
+        std::atomic<elle::_details::Format const*> _format;
+        /// Generation the site was checked at, shifted left once, with
+        /// whether it is active as the low bit.
+        std::atomic<unsigned int> _state;
+        /// Bumped by invalidate, starts at 1 so fresh sites are stale.
+        static std::atomic<unsigned int> _generation;
+      };
+
       struct ELLE_API Send
       {
       public:
@@ -50,6 +108,22 @@ namespace elle
              char const* function,
              char const* fmt,
              Args&&... args);
+        /// Send a log message from a call site.
+        ///
+        /// The format is parsed once per site and, if the logger defers
+        /// messages and the arguments can be captured (see Capture), they
+        /// are copied for the logger to render the message later.
+        template <typename... Args>
+        Send(Site& site,
+             Logger::Level level,
+             Logger::Type type,
+             bool indent,
+             std::string const& component,
+             char const* file,
+             unsigned int line,
+             char const* function,
+             char const* fmt,
+             Args&&... args);
         Send(); // no-op sender
         ~Send();
         /// Whether is enabled.
@@ -70,12 +144,32 @@ namespace elle
       public: // used by macros
         /// Whether messages of this kind are reported.
         ///
-        /// Costly, so cache the result (see macros.hh).
+        /// Costly, so cache the result (see Site).
         static bool active(Logger::Level level,
                            Logger::Type type,
                            std::string const& component);
 
       private:
+        template <typename... Args>
+        void _init(Site* site,
+                   elle::log::Logger::Level level,
+                   elle::log::Logger::Type type,
+                   bool indent,
+                   std::string const& component,
+                   char const* file,
+                   unsigned int line,
+                   char const* function,
+                   char const* fmt,
+                   Args&&... args);
+        void _send(elle::log::Logger::Level level,
+                   elle::log::Logger::Type type,
+                   bool indent,
+                   std::string const& component,
+                   char const* file,
+                   unsigned int line,
+                   char const* function,
+                   const std::string& msg,
+                   char const* fmt = nullptr);
         void _send(elle::log::Logger::Level level,
                    elle::log::Logger::Type type,
                    bool indent,
@@ -83,7 +177,8 @@ namespace elle
                    char const* file,
                    unsigned int line,
                    char const* function,
-                   const std::string& msg);
+                   std::unique_ptr<Deferred> msg,
+                   char const* fmt);
         unsigned int* _indentation = nullptr;
       };
     }
@@ -1,3 +1,9 @@
+#include <cstring>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include <elle/fwd.hh>
 #include <elle/print.hh>
 
@@ -17,6 +23,175 @@ namespace elle
       void
       debug_formats(bool v);
 
+      inline
+      bool
+      Site::active(Logger::Level level,
+                   Logger::Type type,
+                   char const* component)
+      {
+        auto const generation = _generation.load(std::memory_order_acquire);
+        auto const state = this->_state.load(std::memory_order_relaxed);
+        if (state >> 1 == generation)
+          return state & 1;
+        return this->_update(generation, level, type, component);
+      }
+
+      inline
+      elle::_details::Format const*
+      Site::format(char const* fmt)
+      {
+        auto res = this->_format.load(std::memory_order_acquire);
+        if (!res)
+          res = this->_parse(fmt);
+        return std::strcmp(res->text.c_str(), fmt) == 0 ? res : nullptr;
+      }
+
+      /*--------.
+      | Capture |
+      `--------*/
+
+      /// How to capture a log argument by value, for deferred messages.
+      ///
+      /// Only values that render the same later are captured: numbers,
+      /// enums and strings.  Messages with other arguments, such as pointers
+      /// to objects that may change or die meanwhile, are rendered right
+      /// away.  Specialize to capture more types.
+      template <typename T, typename = void>
+      struct Capture
+      {
+        static constexpr bool value = false;
+      };
+
+      template <typename T>
+      struct Capture<
+        T,
+        std::enable_if_t<std::is_arithmetic<T>::value ||
+                         std::is_enum<T>::value>>
+      {
+        static constexpr bool value = true;
+        using type = T;
+        static
+        type
+        capture(T const& v)
+        {
+          return v;
+        }
+      };
+
+      template <>
+      struct Capture<std::string>
+      {
+        static constexpr bool value = true;
+        using type = std::string;
+        static
+        type
+        capture(std::string const& v)
+        {
+          return v;
+        }
+      };
+
+      template <>
+      struct Capture<char const*>
+      {
+        static constexpr bool value = true;
+        using type = std::string;
+        static
+        type
+        capture(char const* v)
+        {
+          return v ? v : "";
+        }
+      };
+
+      template <>
+      struct Capture<char*>
+        : public Capture<char const*>
+      {};
+
+      inline
+      constexpr
+      bool
+      capturable(std::initializer_list<bool> values)
+      {
+        for (auto v: values)
+          if (!v)
+            return false;
+        return true;
+      }
+
+      template <typename... Args>
+      std::string
+      render(elle::_details::Format const& format, Args const&... args)
+      {
+        elle::_details::StringMemory memory;
+        {
+          elle::_details::Output output(memory);
+          elle::_details::run(output, format, args...);
+        }
+        return memory.string();
+      }
+
+      /// A message with its arguments captured by value.
+      template <typename... Args>
+      class Captured
+        : public Deferred
+      {
+      public:
+        template <typename... As>
+        Captured(elle::_details::Format const& format, As const&... args)
+          : _format(format)
+          , _args(Capture<Args>::capture(args)...)
+        {}
+
+        std::string
+        render() const override
+        {
+          return this->_render(std::index_sequence_for<Args...>());
+        }
+
+      private:
+        template <std::size_t... I>
+        std::string
+        _render(std::index_sequence<I...>) const
+        {
+          try
+          {
+            return detail::render(this->_format, std::get<I>(this->_args)...);
+          }
+          catch (...)
+          {
+            return "invalid log: " + this->_format.text;
+          }
+        }
+
+        /// Owned by the Site, which outlives messages.
+        elle::_details::Format const& _format;
+        std::tuple<typename Capture<Args>::type...> _args;
+      };
+
+      template <typename... Args>
+      std::unique_ptr<Deferred>
+      capture(std::true_type,
+              elle::_details::Format const& format,
+              Args const&... args)
+      {
+        return std::make_unique<Captured<Args...>>(format, args...);
+      }
+
+      template <typename... Args>
+      std::unique_ptr<Deferred>
+      capture(std::false_type,
+              elle::_details::Format const&,
+              Args const&...)
+      {
+        return nullptr;
+      }
+
+      /*-----.
+      | Send |
+      `-----*/
+
       inline
       Send::Send()
         : _active(false)
@@ -33,11 +208,59 @@ namespace elle
                  char const* fmt,
                  Args&&... args)
         : _active(true)
+      {
+        this->_init(nullptr, level, type, indent, component, file, line,
+                    function, fmt, std::forward<Args>(args)...);
+      }
+
+      template <typename... Args>
+      Send::Send(Site& site,
+                 elle::log::Logger::Level level,
+                 elle::log::Logger::Type type,
+                 bool indent,
+                 std::string const& component,
+                 char const* file,
+                 unsigned int line,
+                 char const* function,
+                 char const* fmt,
+                 Args&&... args)
+        : _active(true)
+      {
+        this->_init(&site, level, type, indent, component, file, line,
+                    function, fmt, std::forward<Args>(args)...);
+      }
+
+      template <typename... Args>
+      void
+      Send::_init(Site* site,
+                  elle::log::Logger::Level level,
+                  elle::log::Logger::Type type,
+                  bool indent,
+                  std::string const& component,
+                  char const* file,
+                  unsigned int line,
+                  char const* function,
+                  char const* fmt,
+                  Args&&... args)
       {
         try
         {
-          this->_send(level, type, indent, component, file, line, function,
-                      elle::print(fmt, std::forward<Args>(args)...));
+          auto const format = site ? site->format(fmt) : nullptr;
+          if (!format)
+            this->_send(level, type, indent, component, file, line, function,
+                        elle::print(fmt, std::forward<Args>(args)...), fmt);
+          else if (auto deferred = logger().defer()
+                   ? capture(
+                     std::integral_constant<
+                       bool,
+                       capturable({Capture<std::decay_t<Args>>::value...})>{},
+                     *format, static_cast<std::decay_t<Args> const&>(args)...)
+                   : nullptr)
+            this->_send(level, type, indent, component, file, line, function,
+                        std::move(deferred), fmt);
+          else
+            this->_send(level, type, indent, component, file, line, function,
+                        render(*format, args...), fmt);
         }
         // Catching ellipsis to avoid header dependencies. AFAICT only
         // elle::print can throw, and it only throws elle::Error.
@@ -103,6 +103,22 @@ namespace elle
     {
       if (_warn_err_only && type < Type::warning)
         return;
+      this->_write(this->_render(level, type, component, time, message, tags,
+                                 indentation, file, line, function));
+    }
+
+    std::string
+    TextLogger::_render(Level level,
+                        Type type,
+                        std::string const& component,
+                        boost::posix_time::ptime const& time,
+                        std::string const& message,
+                        Tags const& tags,
+                        int indentation,
+                        std::string const& file,
+                        unsigned int line,
+                        std::string const& function)
+    {
       auto const lines = [&message]
       {
         auto res = std::vector<std::string>{};
@@ -158,17 +174,24 @@ namespace elle
         msg = elle::sprintf("%s: %s", time, msg);
 
       auto color_code = get_color_code(level, type);
-      this->_output << color_code << msg << std::endl;
+      auto res = color_code + msg + '\n';
 
       if (lines.size() > 1)
       {
         ELLE_ASSERT_GTE(msg.size(), lines[0].size());
         auto indent = std::string(msg.size() - lines[0].size(), ' ');
         for (auto i = 1u; i < lines.size(); i++)
-          this->_output << indent << lines[i] << std::endl;
+          res += indent + lines[i] + '\n';
       }
       if (!color_code.empty())
-        this->_output << "[0m";
+        res += "[0m";
+      return res;
+    }
+
+    void
+    TextLogger::_write(std::string text)
+    {
+      this->_output << text;
       this->_output.flush();
     }
   }
@@ -33,6 +33,22 @@ namespace elle
                std::string const& file,
                unsigned int line,
                std::string const& function) override;
+      /// Render a message as written to the output.
+      std::string
+      _render(Level level,
+              Type type,
+              std::string const& component,
+              boost::posix_time::ptime const& time,
+              std::string const& message,
+              Tags const& tags,
+              int indentation,
+              std::string const& file,
+              unsigned int line,
+              std::string const& function);
+      /// Write a rendered message to the output.
+      virtual
+      void
+      _write(std::string text);
     private:
       ELLE_ATTRIBUTE_R(std::ostream&, output);
       ELLE_ATTRIBUTE_RW(bool, display_type);
@@ -30,16 +30,15 @@
     _trace_component_ = _component_;
 
 # define ELLE_LOG_VALUE(Lvl, T, ...)                                    \
-  [&] {                                                                 \
-    using Send = ::elle::log::detail::Send;                             \
-    static bool active = Send::active(Lvl, T, _trace_component_);       \
-    return active;}()                                                   \
-  ? ::elle::log::detail::Send(                                          \
-      Lvl,                                                              \
-      T, true, _trace_component_,                                       \
-      __FILE__, __LINE__, ELLE_COMPILER_PRETTY_FUNCTION,                \
-      __VA_ARGS__)                                                      \
-  : ::elle::log::detail::Send()
+  [&] (char const* _trace_function_) {                                  \
+    static ::elle::log::detail::Site site;                              \
+    return site.active(Lvl, T, _trace_component_)                       \
+      ? ::elle::log::detail::Send(                                      \
+          site, Lvl, T, true, _trace_component_,                        \
+          __FILE__, __LINE__, _trace_function_,                         \
+          __VA_ARGS__)                                                  \
+      : ::elle::log::detail::Send();                                    \
+  }(ELLE_COMPILER_PRETTY_FUNCTION)
 
 # define ELLE_LOG_LEVEL_SCOPE(Lvl, T, ...)                              \
   auto BOOST_PP_CAT(__trace_ctx_, __LINE__) =                           \
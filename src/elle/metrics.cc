@@ -0,0 +1,276 @@
+#include <elle/metrics.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+#include <elle/os/environ.hh>
+#include <elle/printf.hh>
+
+namespace elle
+{
+  namespace metrics
+  {
+    namespace _details
+    {
+      int
+      next_shard()
+      {
+        static std::atomic<int> next(0);
+        return next.fetch_add(1, std::memory_order_relaxed) % shards;
+      }
+    }
+
+    namespace
+    {
+      std::atomic<bool>&
+      _enabled()
+      {
+        static std::atomic<bool> res(
+          elle::os::getenv("ELLE_METRICS", false));
+        return res;
+      }
+    }
+
+    bool
+    enabled()
+    {
+      return _enabled().load(std::memory_order_relaxed);
+    }
+
+    void
+    enabled(bool enabled)
+    {
+      _enabled().store(enabled, std::memory_order_relaxed);
+    }
+
+    /*--------.
+    | Counter |
+    `--------*/
+
+    Counter::Counter()
+    {
+      for (auto& shard: this->_shards)
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t
+    Counter::value() const
+    {
+      auto res = std::uint64_t(0);
+      for (auto const& shard: this->_shards)
+        res += shard.value.load(std::memory_order_relaxed);
+      return res;
+    }
+
+    /*------.
+    | Gauge |
+    `------*/
+
+    Gauge::Gauge()
+      : _value(0)
+    {}
+
+    /*----------.
+    | Histogram |
+    `----------*/
+
+    Histogram::Shard::Shard()
+      : count(0)
+      , sum(0)
+      , min(std::numeric_limits<std::uint64_t>::max())
+      , max(0)
+    {
+      for (auto& c: this->counts)
+        c.store(0, std::memory_order_relaxed);
+    }
+
+    Histogram::Histogram()
+    {
+      for (auto& shard: this->_shards)
+        shard.store(nullptr, std::memory_order_relaxed);
+    }
+
+    Histogram::~Histogram()
+    {
+      for (auto& shard: this->_shards)
+        delete shard.load(std::memory_order_relaxed);
+    }
+
+    Histogram::Shard*
+    Histogram::_shard(int index)
+    {
+      auto res = std::make_unique<Shard>();
+      auto expected = static_cast<Shard*>(nullptr);
+      if (this->_shards[index].compare_exchange_strong(
+            expected, res.get(), std::memory_order_acq_rel))
+        return res.release();
+      else
+        return expected;
+    }
+
+    std::uint64_t
+    Histogram::upper(int b)
+    {
+      if (b < (1 << precision))
+        return b;
+      auto const shift = (b >> precision) - 1;
+      auto const mantissa =
+        std::uint64_t((1 << precision) + (b & ((1 << precision) - 1)));
+      return (mantissa << shift) + ((std::uint64_t(1) << shift) - 1);
+    }
+
+    Distribution
+    Histogram::distribution() const
+    {
+      auto res = Distribution{
+        0, 0, std::numeric_limits<std::uint64_t>::max(), 0,
+        std::vector<std::uint64_t>(buckets, 0)};
+      for (auto const& s: this->_shards)
+        if (auto shard = s.load(std::memory_order_acquire))
+        {
+          res.count += shard->count.load(std::memory_order_relaxed);
+          res.sum += shard->sum.load(std::memory_order_relaxed);
+          res.min = std::min(res.min,
+                             shard->min.load(std::memory_order_relaxed));
+          res.max = std::max(res.max,
+                             shard->max.load(std::memory_order_relaxed));
+          for (int b = 0; b < buckets; ++b)
+            res.buckets[b] += shard->counts[b].load(std::memory_order_relaxed);
+        }
+      if (!res.count)
+        res.min = 0;
+      return res;
+    }
+
+    double
+    Distribution::mean() const
+    {
+      return this->count ? double(this->sum) / this->count : 0;
+    }
+
+    std::uint64_t
+    Distribution::percentile(double p) const
+    {
+      if (!this->count)
+        return 0;
+      // Buckets are updated independently from the count, do not trust it.
+      auto total = std::uint64_t(0);
+      for (auto n: this->buckets)
+        total += n;
+      auto const rank = std::max<std::uint64_t>(
+        1, std::uint64_t(std::ceil(total * std::min(p, 100.) / 100)));
+      auto seen = std::uint64_t(0);
+      for (int b = 0; b < int(this->buckets.size()); ++b)
+      {
+        seen += this->buckets[b];
+        if (seen >= rank)
+          return std::min(Histogram::upper(b), this->max);
+      }
+      return this->max;
+    }
+
+    /*---------.
+    | Registry |
+    `---------*/
+
+    Registry&
+    Registry::instance()
+    {
+      // Leaked: metrics may be updated during static destruction.
+      static auto res = new Registry;
+      return *res;
+    }
+
+    namespace
+    {
+      template <typename M>
+      M&
+      get(std::mutex& mutex,
+          std::map<std::string, std::unique_ptr<M>>& metrics,
+          std::string const& name)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& res = metrics[name];
+        if (!res)
+          res = std::make_unique<M>();
+        return *res;
+      }
+    }
+
+    Counter&
+    Registry::counter(std::string const& name)
+    {
+      return get(this->_mutex, this->_counters, name);
+    }
+
+    Gauge&
+    Registry::gauge(std::string const& name)
+    {
+      return get(this->_mutex, this->_gauges, name);
+    }
+
+    Histogram&
+    Registry::histogram(std::string const& name)
+    {
+      return get(this->_mutex, this->_histograms, name);
+    }
+
+    Snapshot
+    Registry::snapshot() const
+    {
+      auto res = Snapshot{};
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      for (auto const& c: this->_counters)
+        res.counters.emplace(c.first, c.second->value());
+      for (auto const& g: this->_gauges)
+        res.gauges.emplace(g.first, g.second->value());
+      for (auto const& h: this->_histograms)
+        res.histograms.emplace(h.first, h.second->distribution());
+      return res;
+    }
+
+    Counter&
+    counter(std::string const& name)
+    {
+      return Registry::instance().counter(name);
+    }
+
+    Gauge&
+    gauge(std::string const& name)
+    {
+      return Registry::instance().gauge(name);
+    }
+
+    Histogram&
+    histogram(std::string const& name)
+    {
+      return Registry::instance().histogram(name);
+    }
+
+    Snapshot
+    snapshot()
+    {
+      return Registry::instance().snapshot();
+    }
+
+    std::ostream&
+    operator <<(std::ostream& output, Snapshot const& snapshot)
+    {
+      for (auto const& c: snapshot.counters)
+        elle::fprintf(output, "%s %s\n", c.first, c.second);
+      for (auto const& g: snapshot.gauges)
+        elle::fprintf(output, "%s %s\n", g.first, g.second);
+      for (auto const& h: snapshot.histograms)
+      {
+        auto const& d = h.second;
+        elle::fprintf(output, "%s %s %s %s %.0f %s %s %s %s\n",
+                      h.first, d.count, d.sum, d.min, d.mean(),
+                      d.percentile(50), d.percentile(90), d.percentile(99),
+                      d.max);
+      }
+      return output;
+    }
+  }
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <elle/attribute.hh>
+#include <elle/compiler.hh>
+
+namespace elle
+{
+  /// Process-wide counters, gauges and latency histograms.
+  ///
+  /// Metrics are created by name in the Registry, once, and then updated
+  /// without locking: cache the returned reference, e.g. in a static.
+  /// Counters and histograms are sharded by thread so threads updating the
+  /// same metric do not contend on a cache line.
+  ///
+  /// @code{.cc}
+  ///
+  /// static auto& requests = elle::metrics::counter("http.requests");
+  /// static auto& latency = elle::metrics::histogram("http.latency");
+  /// requests.increment();
+  /// latency.record(std::chrono::steady_clock::now() - start);
+  ///
+  /// @endcode
+  ///
+  /// ELLE_MEASURE timings are only recorded when metrics are enabled, with
+  /// $ELLE_METRICS=1 or enabled(true).
+  namespace metrics
+  {
+    /// Number of shards of counters and histograms.
+    static constexpr int shards = 8;
+
+    namespace _details
+    {
+      /// Assign a shard to a new thread.
+      ELLE_API
+      int
+      next_shard();
+    }
+
+    /// The shard of the current thread.
+    inline
+    int
+    shard()
+    {
+      static thread_local int const res = _details::next_shard();
+      return res;
+    }
+
+    /*--------.
+    | Counter |
+    `--------*/
+
+    /// A monotonic counter.
+    class ELLE_API Counter
+    {
+    public:
+      Counter();
+      Counter(Counter const&) = delete;
+      void
+      increment(std::uint64_t n = 1)
+      {
+        this->_shards[shard()].value.fetch_add(n, std::memory_order_relaxed);
+      }
+
+      /// The sum of all increments.
+      std::uint64_t
+      value() const;
+
+    private:
+      struct Shard
+      {
+        std::atomic<std::uint64_t> value;
+        char padding[64 - sizeof (std::atomic<std::uint64_t>)];
+      };
+      std::array<Shard, shards> _shards;
+    };
+
+    /*------.
+    | Gauge |
+    `------*/
+
+    /// A value that goes up and down, e.g. a queue size.
+    class ELLE_API Gauge
+    {
+    public:
+      Gauge();
+      Gauge(Gauge const&) = delete;
+
+      void
+      set(std::int64_t value)
+      {
+        this->_value.store(value, std::memory_order_relaxed);
+      }
+
+      void
+      add(std::int64_t n)
+      {
+        this->_value.fetch_add(n, std::memory_order_relaxed);
+      }
+
+      std::int64_t
+      value() const
+      {
+        return this->_value.load(std::memory_order_relaxed);
+      }
+
+    private:
+      std::atomic<std::int64_t> _value;
+    };
+
+    /*----------.
+    | Histogram |
+    `----------*/
+
+    /// The distribution of a histogram at some point.
+    struct ELLE_API Distribution
+    {
+      std::uint64_t count;
+      std::uint64_t sum;
+      std::uint64_t min;
+      std::uint64_t max;
+      /// Number of values per bucket, see Histogram::bucket.
+      std::vector<std::uint64_t> buckets;
+
+      double
+      mean() const;
+      /// An upper bound of the @a p th percentile, at most 1/16 above it.
+      ///
+      /// @param p The percentile, between 0 and 100.
+      std::uint64_t
+      percentile(double p) const;
+    };
+
+    /// A distribution of integers, usually nanoseconds.
+    ///
+    /// As in HdrHistogram, values are counted in logarithmic buckets each
+    /// split in 16 linear ones: the relative error is below 1/16 for any
+    /// value, from nanoseconds to days.
+    class ELLE_API Histogram
+    {
+    public:
+      /// Number of linear buckets per power of two.
+      static constexpr int precision = 4;
+      static constexpr int buckets = (64 - precision + 1) << precision;
+
+      Histogram();
+      Histogram(Histogram const&) = delete;
+      ~Histogram();
+
+      void
+      record(std::uint64_t value)
+      {
+        auto const index = metrics::shard();
+        auto p = this->_shards[index].load(std::memory_order_acquire);
+        if (!p)
+          p = this->_shard(index);
+        auto& shard = *p;
+        shard.counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+        auto min = shard.min.load(std::memory_order_relaxed);
+        while (value < min &&
+               !shard.min.compare_exchange_weak(
+                 min, value, std::memory_order_relaxed))
+          ;
+        auto max = shard.max.load(std::memory_order_relaxed);
+        while (value > max &&
+               !shard.max.compare_exchange_weak(
+                 max, value, std::memory_order_relaxed))
+          ;
+      }
+
+      /// Record a duration, in nanoseconds.
+      template <typename Rep, typename Period>
+      void
+      record(std::chrono::duration<Rep, Period> d)
+      {
+        auto const ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        this->record(std::uint64_t(ns < 0 ? 0 : ns));
+      }
+
+      /// Current distribution.
+      Distribution
+      distribution() const;
+
+      /// The bucket @a value is counted in.
+      static
+      int
+      bucket(std::uint64_t value)
+      {
+        if (value < (1u << precision))
+          return int(value);
+        auto const exponent = 63 - __builtin_clzll(value);
+        return ((exponent - precision + 1) << precision) +
+          int((value >> (exponent - precision)) & ((1u << precision) - 1));
+      }
+
+      /// The highest value counted in bucket @a b.
+      static
+      std::uint64_t
+      upper(int b);
+
+    private:
+      struct Shard
+      {
+        Shard();
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> sum;
+        std::atomic<std::uint64_t> min;
+        std::atomic<std::uint64_t> max;
+        std::array<std::atomic<std::uint64_t>, buckets> counts;
+      };
+      /// Create shard @a index.
+      Shard*
+      _shard(int index);
+      /// Shards are large, they are only created once used.
+      std::array<std::atomic<Shard*>, shards> _shards;
+    };
+
+    /*---------.
+    | Registry |
+    `---------*/
+
+    /// All metrics at some point, by name.
+    struct ELLE_API Snapshot
+    {
+      std::map<std::string, std::uint64_t> counters;
+      std::map<std::string, std::int64_t> gauges;
+      std::map<std::string, Distribution> histograms;
+    };
+
+    /// Print one metric per line: counters and gauges as `name value`,
+    /// histograms as `name count sum min mean p50 p90 p99 max`.
+    ELLE_API
+    std::ostream&
+    operator <<(std::ostream& output, Snapshot const& snapshot);
+
+    /// The metrics of the process.
+    class ELLE_API Registry
+    {
+    public:
+      static
+      Registry&
+      instance();
+      /// The counter named @a name, created if needed.
+      Counter&
+      counter(std::string const& name);
+      /// The gauge named @a name, created if needed.
+      Gauge&
+      gauge(std::string const& name);
+      /// The histogram named @a name, created if needed.
+      Histogram&
+      histogram(std::string const& name);
+      /// The current value of all metrics.
+      Snapshot
+      snapshot() const;
+
+    private:
+      Registry() = default;
+      ELLE_ATTRIBUTE(std::mutex, mutex, mutable);
+      ELLE_ATTRIBUTE((std::map<std::string, std::unique_ptr<Counter>>),
+                     counters);
+      ELLE_ATTRIBUTE((std::map<std::string, std::unique_ptr<Gauge>>),
+                     gauges);
+      ELLE_ATTRIBUTE((std::map<std::string, std::unique_ptr<Histogram>>),
+                     histograms);
+    };
+
+    /// Registry::instance().counter(@a name).
+    ELLE_API
+    Counter&
+    counter(std::string const& name);
+
+    /// Registry::instance().gauge(@a name).
+    ELLE_API
+    Gauge&
+    gauge(std::string const& name);
+
+    /// Registry::instance().histogram(@a name).
+    ELLE_API
+    Histogram&
+    histogram(std::string const& name);
+
+    /// Registry::instance().snapshot().
+    ELLE_API
+    Snapshot
+    snapshot();
+
+    /// Whether timings are measured, $ELLE_METRICS by default.
+    ELLE_API
+    bool
+    enabled();
+
+    /// Set whether timings are measured.
+    ELLE_API
+    void
+    enabled(bool enabled);
+  }
+}
@@ -1,19 +1,15 @@
+#include <algorithm>
 #include <memory>
+#include <vector>
 
-// #pragma GCC diagnostic push
-// #pragma GCC diagnostic ignored "-Wdeprecated"
-#include <boost/bind.hpp>
-#include <boost/config/warning_disable.hpp>
-#include <boost/phoenix.hpp>
-#include <boost/spirit/include/qi.hpp>
-// #pragma GCC diagnostic pop
+#include <boost/thread/tss.hpp>
 
-#include <elle/Printable.hh>
+#include <elle/Buffer.hh>
 #include <elle/assert.hh>
 #include <elle/err.hh>
 #include <elle/log.hh>
-#include <elle/finally.hh>
 #include <elle/print.hh>
+#include <elle/printf.hh>
 #include <elle/utils.hh>
 #include <elle/xalloc.hh>
 
@@ -23,398 +19,402 @@ namespace elle
 {
   namespace _details
   {
-    /*----.
-    | AST |
-    `----*/
-
-    class Expression
-      : public elle::Printable
-    {};
+    /*--------.
+    | Parsing |
+    `--------*/
 
-    class Composite
-      : public Expression
+    Format
+    parse(std::string const& input)
     {
-    public:
-      Composite(std::vector<std::shared_ptr<Expression>> expressions = {})
-        : expressions(std::move(expressions))
-      {}
+      auto const summary =
+        Parser(input.c_str(), input.size(), nullptr).summary();
+      if (!summary.valid)
+        elle::err("invalid format: %s", input);
+      auto res = Format{input, {}, summary};
+      res.program.resize(summary.instructions);
+      Parser(res.text.c_str(), res.text.size(), res.program.data());
+      return res;
+    }
 
-      void
-      print(std::ostream& s) const override
-      {
-        bool first = true;
-        s << "Composite(";
-        for (auto const& e: this->expressions)
-        {
-          if (first)
-            first = false;
-          else
-            s << ", ";
-          s << *e;
-        }
-        s << ')';
-      }
+    /*-------.
+    | Memory |
+    `-------*/
 
-      std::vector<std::shared_ptr<Expression>> expressions;
-    };
+    Memory::int_type
+    Memory::overflow(int_type c)
+    {
+      if (traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+      this->_grow(1);
+      *this->pptr() = traits_type::to_char_type(c);
+      this->pbump(1);
+      return c;
+    }
 
-    class Branch
-      : public Expression
+    std::streamsize
+    Memory::xsputn(char const* data, std::streamsize size)
     {
-    public:
-      Branch(std::shared_ptr<Expression> cond,
-             std::shared_ptr<Expression> then)
-        : cond(std::move(cond))
-        , then(std::move(then))
-      {}
-
-      virtual
-      void
-      print(std::ostream& s) const override
-      {
-        s << "Branch(";
-        this->cond->print(s);
-        s << ", ";
-        this->then->print(s);
-        s << ")";
-      }
+      this->append(data, size);
+      return size;
+    }
 
-      std::shared_ptr<Expression> cond;
-      std::shared_ptr<Expression> then;
-    };
+    BufferMemory::BufferMemory(elle::Buffer& buffer)
+      : _buffer(buffer)
+    {
+      auto const data = reinterpret_cast<char*>(buffer.mutable_contents());
+      this->setp(data, data + buffer.capacity());
+      this->pbump(int(buffer.size()));
+    }
 
-    class Index
-      : public Expression
+    BufferMemory::~BufferMemory()
     {
-    public:
-      Index(int n)
-        : n(n)
-      {}
-
-      static
-      std::shared_ptr<Index>
-      make(int n)
-      {
-        return std::make_shared<Index>(n);
-      }
+      this->_buffer.size(this->pptr() - this->pbase());
+    }
 
-      virtual
-      void
-      print(std::ostream& s) const override
+    void
+    BufferMemory::_grow(std::size_t size)
+    {
+      auto const used = std::size_t(this->pptr() - this->pbase());
+      this->_buffer.size(used + size);
+      auto const data =
+        reinterpret_cast<char*>(this->_buffer.mutable_contents());
+      this->setp(data, data + this->_buffer.capacity());
+      this->pbump(int(used));
+    }
+
+    void
+    StringMemory::_grow(std::size_t size)
+    {
+      auto const used = std::size_t(this->pptr() - this->pbase());
+      auto const capacity = std::max(
+        std::size_t(this->epptr() - this->pbase()) * 2, used + size);
+      if (this->pbase() == this->_local)
       {
-        s << "Index(" << n << ')';
+        this->_heap.resize(capacity);
+        std::memcpy(&this->_heap[0], this->_local, used);
       }
+      else
+        this->_heap.resize(capacity);
+      this->setp(&this->_heap[0], &this->_heap[0] + capacity);
+      this->pbump(int(used));
+    }
 
-      int n;
-    };
+    /*-------.
+    | Output |
+    `-------*/
 
-    class Next
-      : public Expression
+    namespace
     {
-    public:
-      Next()
-      {}
+      /// Streams to print values in memory with, reused as creating a
+      /// stream is costly.
+      using Streams = std::vector<std::unique_ptr<std::ostream>>;
 
-      static
-      std::shared_ptr<Next>
-      make()
+      Streams&
+      streams()
       {
-        return std::make_shared<Next>();
+        static boost::thread_specific_ptr<Streams> res;
+        if (!res.get())
+          res.reset(new Streams);
+        return *res;
       }
+    }
 
-      virtual
-      void
-      print(std::ostream& s) const override
+    Output::~Output()
+    {
+      if (this->_pooled)
       {
-        s << "Next()";
+        auto& s = *this->_stream;
+        s.rdbuf(nullptr);
+        s.clear();
+        s.flags(std::ios::dec | std::ios::skipws);
+        s.precision(6);
+        s.width(0);
+        s.fill(' ');
+        repr(s, false);
+        streams().emplace_back(this->_stream);
       }
-    };
+    }
 
-    /// A formatting request a la printf: %s, %d, etc.
-    ///
-    /// Also supports %r, like in Python, which is for debugging.
-    class Legacy
-      : public Expression
+    std::ostream&
+    Output::stream(char spec)
     {
-    public:
-      Legacy(char fmt)
-        : fmt(fmt)
-      {}
-
-      static
-      std::shared_ptr<Legacy>
-      make(char fmt)
+      if (!this->_stream)
       {
-        return std::make_shared<Legacy>(fmt);
+        auto& pool = streams();
+        if (pool.empty())
+          this->_stream = new std::ostream(this->_memory);
+        else
+        {
+          this->_stream = pool.back().release();
+          pool.pop_back();
+          this->_stream->rdbuf(this->_memory);
+        }
+        this->_pooled = true;
       }
-
-      virtual
-      void
-      print(std::ostream& s) const override
+      auto& s = *this->_stream;
+      if (spec && spec != 's')
       {
-        s << "Legacy(" << this->fmt << ')';
+        if (!this->_pooled)
+        {
+          if (!this->_state)
+            this->_state.reset(new std::ios(nullptr));
+          this->_state->copyfmt(s);
+        }
+        this->_repr = repr(s);
+        switch (spec)
+        {
+          case 'd':
+          case 'i':
+          case 'u':
+            s << std::dec;
+            break;
+          case 'e':
+            s << std::scientific;
+            break;
+          case 'f':
+            s << std::fixed;
+            break;
+          case 'o':
+            s << std::oct;
+            break;
+          case 'p':
+          case 'x':
+            s << std::hex;
+            break;
+          case 'r':
+            repr(s, true);
+            break;
+        }
       }
+      return s;
+    }
 
-      /// The format request: 's' for %s, 'd' for %d, etc.
-      char fmt;
-    };
-
-    class Name
-      : public Expression
+    void
+    Output::done(char spec)
     {
-    public:
-      Name(std::string n)
-        : n(std::move(n))
-      {}
-
-      static
-      std::shared_ptr<Name>
-      make(std::string& n)
+      if (spec && spec != 's')
       {
-        return std::make_shared<Name>(n);
+        auto& s = *this->_stream;
+        if (this->_pooled)
+          s.flags(std::ios::dec | std::ios::skipws);
+        else
+          s.copyfmt(*this->_state);
+        repr(s, this->_repr);
       }
+    }
 
-      virtual
-      void
-      print(std::ostream& s) const override
-      {
-        s << "Name(" << n << ')';
-      }
+    /*-------.
+    | Values |
+    `-------*/
 
-      std::string n;
-    };
+    void
+    write(Output& output, std::string const& value, char spec)
+    {
+      if (output.raw())
+        output.write(value.data(), value.size());
+      else
+        write_stream(output, value, spec);
+    }
 
-    class Literal
-      : public Expression
+    void
+    write(Output& output, char const* value, char spec)
     {
-    public:
-      Literal(std::string text)
-        : text(std::move(text))
-      {}
-
-      static
-      std::shared_ptr<Literal>
-      make(std::string& text)
-      {
-        return std::make_shared<Literal>(text);
-      }
+      if (!output.raw())
+        write_stream(output, value, spec);
+      else if (value)
+        output.write(value, std::strlen(value));
+    }
 
-      virtual
-      void
-      print(std::ostream& s) const override
+    void
+    write(Output& output, bool value, char spec)
+    {
+      if (output.raw())
       {
-        s << "Literal(" << text << ')';
+        if (value)
+          output.write("true", 4);
+        else
+          output.write("false", 5);
       }
+      else
+        write_stream(output, value, spec);
+    }
 
-      std::string text;
-    };
-
-    /*--------.
-    | Helpers |
-    `--------*/
-
-    static
     void
-    push(std::shared_ptr<Composite>& res, std::shared_ptr<Expression> e)
+    write(Output& output, char value, char spec)
     {
-      if (!res)
-        res = std::make_shared<Composite>();
-      res->expressions.emplace_back(std::move(e));
+      if (output.raw())
+        output.write(&value, 1);
+      else
+        write_stream(output, value, spec);
     }
 
-    static
-    std::shared_ptr<Expression>
-    make_fmt(std::shared_ptr<Expression> fmt,
-             boost::optional<std::shared_ptr<Composite>> then = boost::none)
+    void
+    write(Output& output, unsigned long long value, char spec)
     {
-      if (then)
-        return std::make_shared<Branch>(std::move(fmt), std::move(then.get()));
-      else
-        return fmt;
+      if (!output.raw())
+        return write_stream(output, value, spec);
+      auto const base =
+        spec == 'x' || spec == 'p' ? 16u : spec == 'o' ? 8u : 10u;
+      char buffer[24];
+      auto const end = buffer + sizeof buffer;
+      auto digits = end;
+      do
+      {
+        *--digits = "0123456789abcdef"[value % base];
+        value /= base;
+      }
+      while (value);
+      output.write(digits, end - digits);
     }
 
-    static
-    std::shared_ptr<Expression>
-    parse(std::string const& input)
+    void
+    write(Output& output, long long value, char spec)
     {
-      namespace phoenix = boost::phoenix;
-      namespace qi = boost::spirit::qi;
-      namespace ascii = boost::spirit::ascii;
-      using qi::labels::_1;
-      using qi::labels::_2;
-      using qi::labels::_3;
-      using Iterator = decltype(input.begin());
-      qi::rule<Iterator, std::shared_ptr<Composite>()> phrase;
-      qi::rule<Iterator, char()> escape =
-        (qi::char_('\\') >> qi::char_("\\{}%"))[qi::_val = qi::_2];
-      qi::rule<Iterator, std::string()> literal =
-        *(escape | (qi::char_  - '{' - '}' - '\\' - '%') );
-      qi::rule<Iterator, std::shared_ptr<Expression>()> plain =
-        literal[qi::_val = phoenix::bind(&Literal::make, qi::_1)];
-      qi::rule<Iterator, std::string()> identifier =
-        ascii::alpha >> *ascii::alnum;
-      qi::rule<Iterator, std::shared_ptr<Expression>()> var =
-        identifier[qi::_val = phoenix::bind(&Name::make, _1)] |
-        qi::int_[qi::_val = phoenix::bind(&Index::make, _1)] |
-        qi::eps[qi::_val = phoenix::bind(&Next::make)];
-      qi::rule<Iterator, std::shared_ptr<Expression>()> fmt =
-        (var >> -("?" >> phrase))
-        [qi::_val = phoenix::bind(&make_fmt, _1, _2)];
-      qi::rule<Iterator, std::shared_ptr<Expression>()> legacy =
-        ("%" >> qi::char_("cdefgioprsuxCEGSX%")[
-          qi::_val = phoenix::bind(&Legacy::make, _1)]);
-      phrase = plain[phoenix::bind(&push, qi::_val, _1)] >>
-        *(("{" >> fmt[phoenix::bind(&push, qi::_val, _1)] >> "}" |
-           legacy[phoenix::bind(&push, qi::_val, _1)]) >>
-          plain[phoenix::bind(&push, qi::_val, _1)]);
-      std::shared_ptr<Expression> res;
-      auto first = input.begin();
-      auto last = input.end();
-      if (!qi::phrase_parse(first, last, phrase, qi::eoi, res) || first != last)
-        elle::err("invalid format: %s", input);
-      ELLE_ASSERT(res);
-      return res;
+      if (!output.raw())
+        write_stream(output, value, spec);
+      else if (value < 0)
+      {
+        output.write("-", 1);
+        write(output, 0ull - static_cast<unsigned long long>(value), spec);
+      }
+      else
+        write(output, static_cast<unsigned long long>(value), spec);
     }
 
     /*------.
     | Print |
     `------*/
 
-    static
-    void
-    print(std::ostream& s,
-          Expression const& ast,
-          std::vector<Argument> const& args,
-          int& count,
-          bool p,
-          NamedArguments const& named,
-          bool& full_positional)
+    namespace
     {
-      auto const nth = [&] (int n) -> Argument const& {
-        if (n >= signed(args.size()))
-          elle::err(
-            "too few arguments for format: %s, expected at least %s",
-            args.size(), n + 1);
-        return args[n];
-      };
-      auto* id = &typeid(ast);
-      if (id == &typeid(Composite))
-        for (auto const& e:static_cast<Composite const&>(ast).expressions)
-          print(s, *e, args, count, p, named, full_positional);
-      else if (id == &typeid(Literal))
-      {
-        if (p)
-          s.write(static_cast<Literal const&>(ast).text.c_str(),
-                  static_cast<Literal const&>(ast).text.size());
-      }
-      else if (id == &typeid(Next))
+      bool
+      supported(char spec)
       {
-        if (p)
-          nth(count)(s);
-        ++count;
-      }
-      else if (id == &typeid(Legacy))
-      {
-        if (p)
+        switch (spec)
         {
-          auto&& state = std::ios(nullptr);
-          state.copyfmt(s);
-          auto old_repr = repr(s);
-          switch (auto c = static_cast<Legacy const&>(ast).fmt)
-          {
-            case 'd':
-            case 'i':
-            case 'u':
-              s << std::dec;
-              break;
-            case 'e':
-              s << std::scientific;
-              break;
-            case 'f':
-              s << std::fixed;
-              break;
-            case 'o':
-              s << std::oct;
-              break;
-            case 'p':
-            case 'x':
-              s << std::hex;
-              break;
-            case 'r':
-              repr(s, true);
-              break;
-            case 's':
-              break;
-            case '%':
-              s << '%';
-              s.copyfmt(state);
-              repr(s, old_repr);
-              return;
-            default:
-              ELLE_WARN("unsupported legacy format: %s", c)
-              // FIXME
-              break;
-          }
-          nth(count)(s);
-          s.copyfmt(state);
-          repr(s, old_repr);
+          case 0:
+          case 'd':
+          case 'e':
+          case 'f':
+          case 'i':
+          case 'o':
+          case 'p':
+          case 'r':
+          case 's':
+          case 'u':
+          case 'x':
+            return true;
+          default:
+            return false;
         }
-        ++count;
       }
-      else if (id == &typeid(Index))
-      {
-        full_positional = false;
-        if (p)
-          nth(static_cast<Index const&>(ast).n)(s);
-      }
-      else if (id == &typeid(Name))
+
+      void
+      check(std::string const& fmt, Summary const& summary, std::size_t count)
       {
-        auto const& name = static_cast<Name const&>(ast).n;
-        auto const it = named.find(name);
-        if (it == named.end())
-          elle::err("missing named format argument: %s", name);
-        else if (p)
-          it->second(s);
+        if (!summary.indexed && summary.sequential < count)
+          elle::err("too many arguments for format: %s", fmt);
       }
-      else if (id == &typeid(Branch))
-      {
-        auto const& branch = static_cast<Branch const&>(ast);
-        auto const& cond = *branch.cond;
-        auto const* cid = &typeid(cond);
-        if (cid == &typeid(Next))
+    }
+
+    void
+    print(Output& output,
+          char const* text,
+          Instruction const* program,
+          std::size_t size,
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named)
+    {
+      auto const nth = [&] (std::size_t n) -> Value const& {
+        if (n >= count)
+          elle::err(
+            "too few arguments for format: %s, expected at least %s",
+            count, n + 1);
+        return args[n];
+      };
+      auto const find = [&] (Instruction const& i) -> Argument const& {
+        auto const name = std::string(text + i.offset, i.size);
+        if (named)
         {
-          p = p && bool(nth(count));
-          ++count;
+          auto const it = named->find(name);
+          if (it != named->end())
+            return it->second;
         }
-        else if (cid == &typeid(Index))
-          p = p && bool(nth(static_cast<Index const&>(cond).n));
-        else if (cid == &typeid(Name))
+        elle::err("missing named format argument: %s", name);
+      };
+      for (auto i = std::size_t(0); i < size; ++i)
+      {
+        auto const& step = program[i];
+        switch (step.kind)
         {
-          auto const& name = static_cast<Name const&>(cond).n;
-          auto it = named.find(name);
-          if (it != named.end())
-            p = p && bool(it->second);
-          else
-            elle::err("missing named format argument: %s", name);
+          case Instruction::Kind::literal:
+            output.write(text + step.offset, step.size);
+            break;
+          case Instruction::Kind::argument:
+          {
+            if (!supported(step.spec))
+            {
+              ELLE_WARN("unsupported legacy format: %s", step.spec);
+            }
+            auto const& arg = nth(step.index);
+            arg.print(output, arg.value, step.spec);
+            break;
+          }
+          case Instruction::Kind::name:
+            find(step)(output.stream(0));
+            output.done(0);
+            break;
+          case Instruction::Kind::branch:
+          {
+            auto const& arg = nth(step.index);
+            if (!arg.test(arg.value))
+              i = step.next - 1;
+            break;
+          }
+          case Instruction::Kind::branch_name:
+            if (!find(step))
+              i = step.next - 1;
+            break;
         }
-        else
-          elle::err("unexpected condition: %s", elle::type_info(cond));
-        print(s, *branch.then, args, count, p, named, full_positional);
       }
     }
 
     void
-    print(std::ostream& s,
+    print(Output& output,
+          Format const& fmt,
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named)
+    {
+      check(fmt.text, fmt.summary, count);
+      print(output, fmt.text.c_str(), fmt.program.data(), fmt.program.size(),
+            args, count, named);
+    }
+
+    void
+    print(Output& output,
           std::string const& fmt,
-          std::vector<Argument> const& args,
-          NamedArguments const& named)
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named)
     {
-      auto const ast = _details::parse(fmt);
-      int count = 0;
-      bool full_positional = true;
-      _details::print(s, *ast, args, count, true, named, full_positional);
-      if (full_positional && count < signed(args.size()))
-        elle::err("too many arguments for format: %s", fmt);
+      auto const summary = Parser(fmt.c_str(), fmt.size(), nullptr).summary();
+      if (!summary.valid)
+        elle::err("invalid format: %s", fmt);
+      check(fmt, summary, count);
+      // Most formats fit on the stack.
+      Instruction local[32];
+      auto heap = std::vector<Instruction>{};
+      auto program = local;
+      if (summary.instructions > sizeof local / sizeof *local)
+      {
+        heap.resize(summary.instructions);
+        program = heap.data();
+      }
+      Parser(fmt.c_str(), fmt.size(), program);
+      print(output, fmt.c_str(), program, summary.instructions,
+            args, count, named);
     }
   }
 
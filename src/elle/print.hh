@@ -1,9 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
+#include <string>
 
 namespace elle
 {
+  class Buffer;
+
+  namespace _details
+  {
+    template <typename S>
+    class StaticFormat;
+  }
+
   /// Print a formatted string to a given stream.
   ///
   /// @param o The output stream.
@@ -24,6 +34,41 @@ namespace elle
   std::string
   print(std::string const& fmt, Args&& ... args);
 
+  /// Append a formatted string to a buffer.
+  ///
+  /// @param output The buffer to append to.
+  /// @param fmt The un-formatted string specifying how to format and interpret
+  ///            the given data.
+  /// @param args The arguments specifying data to print.
+  template <typename ... Args>
+  void
+  print(elle::Buffer& output, std::string const& fmt, Args&& ... args);
+
+  /// Print a format checked at compile time to a given stream.
+  ///
+  /// @see ELLE_PRINT_FORMAT.
+  template <typename S, typename ... Args>
+  void
+  print(std::ostream& o, _details::StaticFormat<S> fmt, Args&& ... args);
+
+  /// Return a string formatted with a format checked at compile time.
+  ///
+  /// Values are rendered in a stack buffer: numbers and strings directly,
+  /// others through their stream operator.
+  ///
+  /// @see ELLE_PRINT_FORMAT.
+  template <typename S, typename ... Args>
+  std::string
+  print(_details::StaticFormat<S> fmt, Args&& ... args);
+
+  /// Append a string formatted with a format checked at compile time to a
+  /// buffer.
+  ///
+  /// @see ELLE_PRINT_FORMAT.
+  template <typename S, typename ... Args>
+  void
+  print(elle::Buffer& output, _details::StaticFormat<S> fmt, Args&& ... args);
+
   /// Whether a stream is set for debugging output.
   ///
   /// Armed with `%r` in print's format.
@@ -35,4 +80,30 @@ namespace elle
   repr(std::ostream& o, bool debugging);
 }
 
+/// A format string parsed and checked at compile time.
+///
+/// The format must be a literal.  Using it with the wrong number of
+/// arguments, or an invalid format, does not compile.  The syntax is the same
+/// as print's.  Named placeholders such as `{name}` are printed with named
+/// arguments, and cannot be mixed with positional ones.
+///
+/// It is accepted by print and err only: sprintf and fprintf keep the
+/// boost::format syntax, parsed at runtime.
+///
+/// @code{.cc}
+///
+/// elle::print(ELLE_PRINT_FORMAT("{}: read {} bytes"), *this, size);
+/// elle::print(ELLE_PRINT_FORMAT("{n} * {n}"), {{"n", 4}});
+///
+/// @endcode
+#define ELLE_PRINT_FORMAT(Fmt)                                          \
+  ([] {                                                                 \
+    struct _elle_print_format                                           \
+    {                                                                   \
+      static constexpr char const* text() { return "" Fmt; }            \
+      static constexpr std::size_t size() { return sizeof("" Fmt) - 1; } \
+    };                                                                  \
+    return ::elle::_details::StaticFormat<_elle_print_format>{};        \
+  }())
+
 #include <elle/print.hxx>
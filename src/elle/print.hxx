@@ -1,7 +1,9 @@
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <streambuf>
 #include <string>
-#include <sstream>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -224,21 +226,718 @@ namespace elle
       }
     };
 
+    /*--------.
+    | Parsing |
+    `--------*/
+
+    /// A step of a parsed format.
+    struct Instruction
+    {
+      enum class Kind : unsigned char
+      {
+        /// Copy text from the format.
+        literal,
+        /// Print a positional argument.
+        argument,
+        /// Print a named argument.
+        name,
+        /// Skip to next unless a positional argument is true.
+        branch,
+        /// Skip to next unless a named argument is true.
+        branch_name,
+      };
+      Kind kind = Kind::literal;
+      /// The legacy directive of an argument, e.g. 'x' for %x, or 0.
+      char spec = 0;
+      /// The position of a positional argument.
+      std::size_t index = 0;
+      /// The text of a literal or the name of an argument, in the format.
+      std::size_t offset = 0;
+      std::size_t size = 0;
+      /// The instruction following a branch.
+      std::size_t next = 0;
+    };
+
+    /// What a format needs, as found by parse.
+    struct Summary
+    {
+      /// Whether the format is valid.
+      bool valid = true;
+      /// Where parsing stopped.
+      std::size_t position = 0;
+      std::size_t instructions = 0;
+      /// Number of arguments consumed in sequence, by {} and %s.
+      std::size_t sequential = 0;
+      /// Number of positional arguments referred to.
+      std::size_t needed = 0;
+      /// Whether arguments are referred to by index, as in {1}.
+      bool indexed = false;
+      /// Whether arguments are referred to by name, as in {name}.
+      bool named = false;
+    };
+
+    /// Recursive descent parser, usable at compile time.
+    class Parser
+    {
+    public:
+      /// Parse @a text, writing instructions to @a output unless null.
+      constexpr
+      Parser(char const* text, std::size_t size, Instruction* output)
+        : _text(text)
+        , _size(size)
+        , _output(output)
+        , _pos(0)
+        , _summary()
+      {
+        this->_summary.valid = this->_phrase(false);
+        this->_summary.position = this->_pos;
+      }
+
+      constexpr
+      Summary
+      summary() const
+      {
+        return this->_summary;
+      }
+
+    private:
+      static
+      constexpr
+      bool
+      _alpha(char c)
+      {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+      }
+
+      static
+      constexpr
+      bool
+      _digit(char c)
+      {
+        return c >= '0' && c <= '9';
+      }
+
+      static
+      constexpr
+      bool
+      _special(char c)
+      {
+        return c == '{' || c == '}' || c == '\\' || c == '%';
+      }
+
+      static
+      constexpr
+      bool
+      _legacy(char c)
+      {
+        for (auto l: "cdefgioprsuxCEGSX%")
+          if (l && c == l)
+            return true;
+        return false;
+      }
+
+      constexpr
+      std::size_t
+      _emit(Instruction::Kind kind,
+            std::size_t index = 0,
+            std::size_t offset = 0,
+            std::size_t size = 0,
+            char spec = 0)
+      {
+        if (this->_output)
+        {
+          auto& i = this->_output[this->_summary.instructions];
+          i.kind = kind;
+          i.spec = spec;
+          i.index = index;
+          i.offset = offset;
+          i.size = size;
+        }
+        return this->_summary.instructions++;
+      }
+
+      constexpr
+      void
+      _positional(std::size_t index)
+      {
+        if (this->_summary.needed < index + 1)
+          this->_summary.needed = index + 1;
+      }
+
+      /// Parse literals and fields up to the end, or up to a closing brace
+      /// if @a nested.
+      constexpr
+      bool
+      _phrase(bool nested)
+      {
+        while (this->_pos < this->_size)
+        {
+          auto const c = this->_text[this->_pos];
+          if (c == '}')
+            return nested;
+          else if (c == '\\')
+          {
+            if (this->_pos + 1 == this->_size ||
+                !_special(this->_text[this->_pos + 1]))
+              return false;
+            this->_emit(Instruction::Kind::literal, 0, this->_pos + 1, 1);
+            this->_pos += 2;
+          }
+          else if (c == '%')
+          {
+            if (this->_pos + 1 == this->_size ||
+                !_legacy(this->_text[this->_pos + 1]))
+              return false;
+            auto const spec = this->_text[this->_pos + 1];
+            if (spec == '%')
+              this->_emit(Instruction::Kind::literal, 0, this->_pos + 1, 1);
+            else
+            {
+              auto const index = this->_summary.sequential++;
+              this->_positional(index);
+              this->_emit(Instruction::Kind::argument, index, 0, 0, spec);
+            }
+            this->_pos += 2;
+          }
+          else if (c == '{')
+          {
+            ++this->_pos;
+            if (!this->_field())
+              return false;
+            if (this->_pos == this->_size || this->_text[this->_pos] != '}')
+              return false;
+            ++this->_pos;
+          }
+          else
+          {
+            auto const start = this->_pos;
+            while (this->_pos < this->_size &&
+                   !_special(this->_text[this->_pos]))
+              ++this->_pos;
+            this->_emit(Instruction::Kind::literal,
+                        0, start, this->_pos - start);
+          }
+        }
+        return !nested;
+      }
+
+      /// Parse the inside of braces: {}, {1}, {name}, and their branches.
+      constexpr
+      bool
+      _field()
+      {
+        auto named = false;
+        auto index = std::size_t(0);
+        auto const start = this->_pos;
+        if (this->_pos < this->_size && _alpha(this->_text[this->_pos]))
+        {
+          named = true;
+          this->_summary.named = true;
+          while (this->_pos < this->_size &&
+                 (_alpha(this->_text[this->_pos]) ||
+                  _digit(this->_text[this->_pos])))
+            ++this->_pos;
+        }
+        else if (this->_pos < this->_size && _digit(this->_text[this->_pos]))
+        {
+          this->_summary.indexed = true;
+          while (this->_pos < this->_size && _digit(this->_text[this->_pos]))
+          {
+            index = index * 10 + (this->_text[this->_pos] - '0');
+            if (index > 0xffff)
+              return false;
+            ++this->_pos;
+          }
+          this->_positional(index);
+        }
+        else
+        {
+          index = this->_summary.sequential++;
+          this->_positional(index);
+        }
+        auto const size = this->_pos - start;
+        if (this->_pos < this->_size && this->_text[this->_pos] == '?')
+        {
+          ++this->_pos;
+          auto const branch = this->_emit(
+            named ? Instruction::Kind::branch_name : Instruction::Kind::branch,
+            index, start, size);
+          if (!this->_phrase(true))
+            return false;
+          if (this->_output)
+            this->_output[branch].next = this->_summary.instructions;
+        }
+        else
+          this->_emit(
+            named ? Instruction::Kind::name : Instruction::Kind::argument,
+            index, start, size);
+        return true;
+      }
+
+      char const* _text;
+      std::size_t _size;
+      Instruction* _output;
+      std::size_t _pos;
+      Summary _summary;
+    };
+
+    /// A parsed format string, to print repeatedly without parsing it again.
+    struct Format
+    {
+      std::string text;
+      std::vector<Instruction> program;
+      Summary summary;
+    };
+
+    /// Parse a format string.
+    ///
+    /// @throws elle::Error if @a fmt is invalid.
+    Format
+    parse(std::string const& fmt);
+
+    /*-------.
+    | Output |
+    `-------*/
+
+    /// Memory formatted text is appended to.
+    ///
+    /// A streambuf, so values without a direct rendering can be streamed
+    /// in it too.
+    class Memory
+      : public std::streambuf
+    {
+    public:
+      void
+      append(char const* data, std::size_t size)
+      {
+        if (std::size_t(this->epptr() - this->pptr()) < size)
+          this->_grow(size);
+        std::memcpy(this->pptr(), data, size);
+        this->pbump(int(size));
+      }
+
+    protected:
+      /// Make room for @a size more bytes after pptr().
+      virtual
+      void
+      _grow(std::size_t size) = 0;
+      int_type
+      overflow(int_type c) override;
+      std::streamsize
+      xsputn(char const* data, std::streamsize size) override;
+    };
+
+    /// The end of a Buffer.
+    class BufferMemory
+      : public Memory
+    {
+    public:
+      BufferMemory(elle::Buffer& buffer);
+      BufferMemory(BufferMemory const&) = delete;
+      /// Set the buffer size to what was written.
+      ~BufferMemory();
+
+    private:
+      void
+      _grow(std::size_t size) override;
+      elle::Buffer& _buffer;
+    };
+
+    /// A stack buffer, moved to the heap if it gets too small.
+    class StringMemory
+      : public Memory
+    {
+    public:
+      StringMemory()
+      {
+        this->setp(this->_local, this->_local + sizeof this->_local);
+      }
+
+      StringMemory(StringMemory const&) = delete;
+
+      std::string
+      string() const
+      {
+        return std::string(this->pbase(), this->pptr());
+      }
+
+    private:
+      void
+      _grow(std::size_t size) override;
+      char _local[256];
+      std::string _heap;
+    };
+
+    /// Where print writes.
+    ///
+    /// Either memory, which simple values are written to directly, or a
+    /// stream, whose formatting flags are honored.
+    class Output
+    {
+    public:
+      Output(std::ostream& stream)
+        : _memory(nullptr)
+        , _stream(&stream)
+        , _pooled(false)
+      {}
+
+      Output(Memory& memory)
+        : _memory(&memory)
+        , _stream(nullptr)
+        , _pooled(false)
+      {}
+
+      ~Output();
+
+      /// Whether values may be rendered directly, rather than streamed.
+      bool
+      raw() const
+      {
+        return this->_memory;
+      }
+
+      void
+      write(char const* data, std::size_t size)
+      {
+        if (this->_memory)
+          this->_memory->append(data, size);
+        else
+          this->_stream->write(data, size);
+      }
+
+      /// The stream to print a value to, set up for the legacy directive
+      /// @a spec.
+      std::ostream&
+      stream(char spec);
+
+      /// Restore the stream once a value is printed.
+      void
+      done(char spec);
+
+    private:
+      Memory* _memory;
+      std::ostream* _stream;
+      /// Whether _stream is taken from the pool of this thread.
+      bool _pooled;
+      /// The state of the stream before a directive changed it.
+      std::unique_ptr<std::ios> _state;
+      bool _repr;
+    };
+
+    /*-------.
+    | Values |
+    `-------*/
+
+    /// Print a value through its stream operator.
+    template <typename T>
+    void
+    write_stream(Output& output, T const& value, char spec)
+    {
+      print(output.stream(spec), value);
+      output.done(spec);
+    }
+
+    /// Print a value, directly if possible.
+    template <typename T>
+    void
+    write(Output& output, T const& value, char spec)
+    {
+      write_stream(output, value, spec);
+    }
+
     void
-    print(std::ostream& s,
+    write(Output& output, std::string const& value, char spec);
+
+    void
+    write(Output& output, char const* value, char spec);
+
+    inline
+    void
+    write(Output& output, char* value, char spec)
+    {
+      write(output, static_cast<char const*>(value), spec);
+    }
+
+    void
+    write(Output& output, bool value, char spec);
+
+    void
+    write(Output& output, char value, char spec);
+
+    void
+    write(Output& output, long long value, char spec);
+
+    void
+    write(Output& output, unsigned long long value, char spec);
+
+    inline
+    void
+    write(Output& output, signed char value, char spec)
+    {
+      write(output, char(value), spec);
+    }
+
+    inline
+    void
+    write(Output& output, unsigned char value, char spec)
+    {
+      write(output, char(value), spec);
+    }
+
+    template <typename T>
+    void
+    write_signed(Output& output, T value, char spec)
+    {
+      // Streams print negative numbers in base 8 and 16 as unsigned ones of
+      // the same size.
+      if (value < 0 && spec && spec != 'd' && spec != 'i' && spec != 'u')
+        write(output,
+              static_cast<unsigned long long>(
+                static_cast<std::make_unsigned_t<T>>(value)),
+              spec);
+      else
+        write(output, static_cast<long long>(value), spec);
+    }
+
+    inline
+    void
+    write(Output& output, short value, char spec)
+    {
+      write_signed(output, value, spec);
+    }
+
+    inline
+    void
+    write(Output& output, int value, char spec)
+    {
+      write_signed(output, value, spec);
+    }
+
+    inline
+    void
+    write(Output& output, long value, char spec)
+    {
+      write_signed(output, value, spec);
+    }
+
+    inline
+    void
+    write(Output& output, unsigned short value, char spec)
+    {
+      write(output, static_cast<unsigned long long>(value), spec);
+    }
+
+    inline
+    void
+    write(Output& output, unsigned int value, char spec)
+    {
+      write(output, static_cast<unsigned long long>(value), spec);
+    }
+
+    inline
+    void
+    write(Output& output, unsigned long value, char spec)
+    {
+      write(output, static_cast<unsigned long long>(value), spec);
+    }
+
+    /// Whether a value is true, for branches.
+    template <typename T>
+    bool
+    truth(T const& value)
+    {
+      return branch_test(value, 0);
+    }
+
+    inline
+    bool
+    truth(char const* value)
+    {
+      return value && *value;
+    }
+
+    /// A type-erased argument.
+    struct Value
+    {
+      Value()
+        : value(nullptr)
+        , print(nullptr)
+        , test(nullptr)
+      {}
+
+      template <typename T>
+      Value(T const& value)
+        : value(&value)
+        , print(&Value::_print<T>)
+        , test(&Value::_test<T>)
+      {}
+
+      void const* value;
+      void (*print)(Output&, void const*, char);
+      bool (*test)(void const*);
+
+    private:
+      template <typename T>
+      static
+      void
+      _print(Output& output, void const* value, char spec)
+      {
+        write(output, *static_cast<T const*>(value), spec);
+      }
+
+      template <typename T>
+      static
+      bool
+      _test(void const* value)
+      {
+        return truth(*static_cast<T const*>(value));
+      }
+    };
+
+    /// Run a parsed format.
+    ///
+    /// @param text  The format the instructions refer to.
+    /// @param named The named arguments, if any.
+    void
+    print(Output& output,
+          char const* text,
+          Instruction const* program,
+          std::size_t size,
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named);
+
+    /// Parse and run a format.
+    void
+    print(Output& output,
           std::string const& fmt,
-          std::vector<Argument> const& args,
-          NamedArguments const& named);
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named);
 
-    template <typename ... Args>
-    std::vector <Argument>
-    erasure(Args const& ... args)
+    /// Run a parsed format.
+    void
+    print(Output& output,
+          Format const& fmt,
+          Value const* args,
+          std::size_t count,
+          NamedArguments const* named);
+
+    /// Print a runtime format.
+    template <typename F, typename ... Args>
+    void
+    run(Output& output, F const& fmt, Args const& ... args)
     {
-      std::vector<Argument> res;
-      res.reserve(sizeof ... (args));
-      int unused[] __attribute__((unused)) = {(res.emplace_back(args), 0)...};
+      Value const values[sizeof ... (Args) + 1] = {Value(args)..., Value()};
+      print(output, fmt, values, sizeof ... (Args), nullptr);
+    }
+
+    /*---------------.
+    | Static formats |
+    `---------------*/
+
+    /// A format parsed at compile time.
+    template <std::size_t N>
+    struct Program
+    {
+      Instruction instructions[N ? N : 1];
+    };
+
+    template <std::size_t N>
+    constexpr
+    Program<N>
+    compile(char const* text, std::size_t size)
+    {
+      auto res = Program<N>{};
+      Parser(text, size, res.instructions);
       return res;
     }
+
+    /// The instructions of a static format.
+    ///
+    /// @tparam S Has static constexpr text() and size(), see
+    ///           ELLE_PRINT_FORMAT.
+    template <typename S>
+    struct Compiled
+    {
+      static constexpr Summary summary =
+        Parser(S::text(), S::size(), nullptr).summary();
+      static_assert(summary.valid, "invalid format");
+      using Instructions = Program<summary.instructions>;
+      static constexpr Instructions program =
+        compile<summary.instructions>(S::text(), S::size());
+
+      /// Check positional arguments.
+      template <std::size_t N>
+      static
+      constexpr
+      bool
+      check()
+      {
+        static_assert(!summary.named,
+                      "named placeholders in a compile-time format");
+        static_assert(summary.needed <= N,
+                      "too few arguments for format");
+        static_assert(summary.indexed || summary.sequential >= N,
+                      "too many arguments for format");
+        return true;
+      }
+
+      /// Check named arguments.
+      static
+      constexpr
+      bool
+      check_named()
+      {
+        static_assert(summary.needed == 0,
+                      "positional placeholders in a named format");
+        return true;
+      }
+    };
+
+    template <typename S>
+    constexpr Summary Compiled<S>::summary;
+
+    template <typename S>
+    constexpr typename Compiled<S>::Instructions Compiled<S>::program;
+
+    /// A format string parsed and checked at compile time.
+    ///
+    /// Only a tag: it is compiled when printed, so overload resolution
+    /// considering it has no side effect.
+    ///
+    /// @tparam S Has static constexpr text() and size(), see
+    ///           ELLE_PRINT_FORMAT.
+    template <typename S>
+    class StaticFormat
+    {
+    public:
+      /// Print to @a output.
+      template <typename ... Args>
+      static
+      void
+      print(Output& output, Args const& ... args)
+      {
+        using C = Compiled<S>;
+        static_assert(C::template check<sizeof ... (Args)>(),
+                      "invalid arguments");
+        Value const values[sizeof ... (Args) + 1] = {Value(args)..., Value()};
+        _details::print(output, S::text(), C::program.instructions,
+                        C::summary.instructions, values, sizeof ... (Args),
+                        nullptr);
+      }
+
+      /// Print to @a output with named arguments.
+      static
+      void
+      print(Output& output, NamedArguments const& args)
+      {
+        using C = Compiled<S>;
+        static_assert(C::check_named(), "invalid arguments");
+        _details::print(output, S::text(), C::program.instructions,
+                        C::summary.instructions, nullptr, 0, &args);
+      }
+    };
   }
 
   /*-----------.
@@ -249,29 +948,98 @@ namespace elle
   void
   print(std::ostream& o, std::string const& fmt, Args&& ... args)
   {
-    _details::print(o, fmt, _details::erasure(args...), {});
+    _details::Output output(o);
+    _details::run(output, fmt, args...);
   }
 
   template <typename ... Args>
   std::string
   print(std::string const& fmt, Args&& ... args)
   {
-    std::stringstream output;
-    print(output, fmt, std::forward<Args>(args)...);
-    return output.str();
+    _details::StringMemory memory;
+    {
+      _details::Output output(memory);
+      _details::run(output, fmt, args...);
+    }
+    return memory.string();
+  }
+
+  template <typename ... Args>
+  void
+  print(elle::Buffer& buffer, std::string const& fmt, Args&& ... args)
+  {
+    _details::BufferMemory memory(buffer);
+    _details::Output output(memory);
+    _details::run(output, fmt, args...);
+  }
+
+  /*-------------.
+  | Compile time |
+  `-------------*/
+
+  template <typename S, typename ... Args>
+  void
+  print(std::ostream& o, _details::StaticFormat<S>, Args&& ... args)
+  {
+    _details::Output output(o);
+    _details::StaticFormat<S>::print(output, args...);
+  }
+
+  template <typename S, typename ... Args>
+  std::string
+  print(_details::StaticFormat<S>, Args&& ... args)
+  {
+    _details::StringMemory memory;
+    {
+      _details::Output output(memory);
+      _details::StaticFormat<S>::print(output, args...);
+    }
+    return memory.string();
+  }
+
+  template <typename S, typename ... Args>
+  void
+  print(elle::Buffer& buffer, _details::StaticFormat<S>, Args&& ... args)
+  {
+    _details::BufferMemory memory(buffer);
+    _details::Output output(memory);
+    _details::StaticFormat<S>::print(output, args...);
   }
 
   /*------.
   | Named |
   `------*/
 
+  template <typename S>
+  void
+  print(std::ostream& o,
+        _details::StaticFormat<S>,
+        _details::NamedArguments const& args)
+  {
+    _details::Output output(o);
+    _details::StaticFormat<S>::print(output, args);
+  }
+
+  template <typename S>
+  std::string
+  print(_details::StaticFormat<S>, _details::NamedArguments const& args)
+  {
+    _details::StringMemory memory;
+    {
+      _details::Output output(memory);
+      _details::StaticFormat<S>::print(output, args);
+    }
+    return memory.string();
+  }
+
   inline
   void
   print(std::ostream& o,
         std::string const& fmt,
         _details::NamedArguments const& args)
   {
-    _details::print(o, fmt, {}, args);
+    _details::Output output(o);
+    _details::print(output, fmt, nullptr, 0, &args);
   }
 
   inline
@@ -279,8 +1047,11 @@ namespace elle
   print(std::string const& fmt,
         _details::NamedArguments const& args)
   {
-    std::stringstream output;
-    print(output, fmt, args);
-    return output.str();
+    _details::StringMemory memory;
+    {
+      _details::Output output(memory);
+      _details::print(output, fmt, nullptr, 0, &args);
+    }
+    return memory.string();
   }
 }
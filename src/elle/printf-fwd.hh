@@ -4,16 +4,38 @@
 
 namespace elle
 {
+  namespace _details
+  {
+    template <typename S>
+    class StaticFormat;
+  }
+
   namespace
   {
     /// Print on stream.
+    ///
+    /// The format follows boost::format and is parsed at runtime: use print
+    /// with ELLE_PRINT_FORMAT to check it at compile time.
     template <typename F, typename... T>
     std::ostream&
     fprintf(std::ostream& out, F&& fmt, T&&... values);
 
     /// Print in string.
+    ///
+    /// @see fprintf.
     template <typename F, typename... T>
     std::string
     sprintf(F&& fmt, T&&... values);
+
+    /// Compile-time formats follow print's syntax, not boost::format's.
+    template <typename S, typename... T>
+    std::ostream&
+    fprintf(std::ostream& out, _details::StaticFormat<S> fmt, T&&... values)
+      = delete;
+
+    /// Compile-time formats follow print's syntax, not boost::format's.
+    template <typename S, typename... T>
+    std::string
+    sprintf(_details::StaticFormat<S> fmt, T&&... values) = delete;
   }
 }
@@ -5,6 +5,7 @@
 #include <boost/format.hpp>
 
 #include <elle/TypeInfo.hh>
+#include <elle/print.hh>
 #include <elle/utils.hh> // as_const
 
 // Work around Clang 3.5.0 bug where having this helper in the elle namespace
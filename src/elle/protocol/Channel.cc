@@ -2,6 +2,7 @@
 
 #include <elle/algorithm.hh>
 #include <elle/log.hh>
+#include <elle/metrics.hh>
 #include <elle/protocol/ChanneledStream.hh>
 
 ELLE_LOG_COMPONENT("elle.protocol.Channel");
@@ -18,6 +19,9 @@ namespace elle
       : Super(backend.scheduler())
       , _backend(backend)
       , _id(id)
+      , _queued(0)
+      , _consumed(0)
+      , _in_flight(0)
     {
       ELLE_DEBUG_SCOPE("%s: open %s", this->_backend, *this);
       ELLE_ASSERT(!elle::contains(this->_backend._channels, this->_id));
@@ -39,6 +43,10 @@ namespace elle
       , _id(source._id)
       , _packets(std::move(source._packets))
       , _available(std::move(source._available))
+      , _queued(source._queued)
+      , _consumed(source._consumed)
+      , _in_flight(source._in_flight)
+      , _credited(std::move(source._credited))
     {
       source._id = 0;
       ELLE_ASSERT(elle::contains(this->_backend._channels, this->_id));
@@ -63,6 +71,11 @@ namespace elle
                      this->_available.waiters().size());
         ELLE_ASSERT(elle::contains(this->_backend._channels, this->_id));
         this->_backend._channels.erase(this->_id);
+        if (this->_queued)
+        {
+          this->_backend._buffered -= this->_queued;
+          this->_backend._drained.signal();
+        }
       }
     }
 
@@ -94,7 +107,9 @@ namespace elle
     elle::Buffer
     Channel::_read()
     {
-      return this->_packets.get();
+      auto res = this->_packets.get();
+      this->_backend._consume(*this, res.size());
+      return res;
     }
 
     /*--------.
@@ -104,6 +119,33 @@ namespace elle
     void
     Channel::_write(elle::Buffer const& packet)
     {
+      if (auto const window = this->_backend.window())
+      {
+        // The peer credits bytes back by half windows: below that, waiting
+        // could last forever.
+        auto const size = int64_t(packet.size());
+        auto const blocked = [&]
+          {
+            return this->_in_flight >= int64_t(*window / 2) &&
+              this->_in_flight + size > int64_t(*window);
+          };
+        if (blocked())
+        {
+          static auto& stalls =
+            elle::metrics::counter("elle.protocol.Channel.stalls");
+          stalls.increment();
+          ELLE_DEBUG("%s: wait for credit, %s bytes in flight",
+                     *this, this->_in_flight);
+          while (blocked())
+          {
+            // Credits will never come from a broken connection.
+            if (auto e = this->_backend._exception)
+              std::rethrow_exception(e);
+            reactor::wait(this->_credited);
+          }
+        }
+        this->_in_flight += size;
+      }
       this->_backend._write(packet, this->_id);
     }
   }
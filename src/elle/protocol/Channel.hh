@@ -106,6 +106,13 @@ namespace elle
       ELLE_ATTRIBUTE_R(Id, id);
       ELLE_ATTRIBUTE(reactor::Channel<elle::Buffer>, packets);
       ELLE_ATTRIBUTE(elle::reactor::Signal, available);
+      /// Bytes received and not read yet.
+      ELLE_ATTRIBUTE(int64_t, queued);
+      /// Bytes read and not credited back to the peer yet.
+      ELLE_ATTRIBUTE(int64_t, consumed);
+      /// Bytes written and not credited back by the peer yet.
+      ELLE_ATTRIBUTE(int64_t, in_flight);
+      ELLE_ATTRIBUTE(elle::reactor::Signal, credited);
     };
   }
 }
@@ -1,8 +1,14 @@
 #include <iostream>
+#include <limits>
 
+#include <elle/IOStream.hh>
+#include <elle/With.hh>
+#include <elle/finally.hh>
 #include <elle/find.hh>
 #include <elle/log.hh>
+#include <elle/metrics.hh>
 
+#include <elle/reactor/Barrier.hh>
 #include <elle/reactor/scheduler.hh>
 #include <elle/reactor/Thread.hh>
 
@@ -17,25 +23,60 @@ namespace elle
 {
   namespace protocol
   {
+    namespace
+    {
+      /// Channel id reserved for batches, never generated by either side.
+      constexpr int batch_id = std::numeric_limits<int>::min();
+      /// Channel id reserved for credit updates, never generated either.
+      constexpr int credit_id = batch_id + 1;
+    }
+
+    /// Packets written during the same batching window.
+    struct ChanneledStream::Batch
+    {
+      /// The channel ids and payloads, in writing order.
+      std::vector<std::pair<int, elle::ConstWeakBuffer>> packets;
+      /// Opened once the batch is sent, or failed to.
+      reactor::Barrier sent;
+      /// Why sending the batch failed, if it did.
+      std::exception_ptr exception;
+    };
+
+    /// A writer waiting to write to the backend.
+    struct ChanneledStream::Turn
+    {
+      /// Opened once it is this writer's turn.
+      reactor::Barrier go;
+    };
+
     /*-------------.
     | Construction |
     `-------------*/
 
     ChanneledStream::ChanneledStream(elle::reactor::Scheduler& scheduler,
-                                     Stream& backend)
+                                     Stream& backend,
+                                     boost::optional<Size> window)
       : Super(scheduler)
       , _backend(backend)
       , _master(this->_handshake())
       , _id_current(0)
+      , _written(0)
+      , _window(std::move(window))
+      , _buffered(0)
+      , _writing(false)
       , _default(*this)
     {
+      this->_handshake_window();
       this->_thread.reset(
         new reactor::Thread(
           elle::sprintf("%s", this), [this] { this->_read_thread(); }));
     }
 
-    ChanneledStream::ChanneledStream(Stream& backend)
-      : ChanneledStream(*elle::reactor::Scheduler::scheduler(), backend)
+    ChanneledStream::ChanneledStream(Stream& backend,
+                                     boost::optional<Size> window)
+      : ChanneledStream(*elle::reactor::Scheduler::scheduler(),
+                        backend,
+                        std::move(window))
     {}
 
     ChanneledStream::~ChanneledStream()
@@ -59,24 +100,32 @@ namespace elle
       {
         while (true)
         {
+          if (this->_budget && this->_buffered >= *this->_budget)
+          {
+            ELLE_DEBUG("%s: wait for %s buffered bytes to be read",
+                       this, this->_buffered);
+            while (this->_budget && this->_buffered >= *this->_budget)
+              reactor::wait(this->_drained);
+          }
           auto p = this->_backend.read();
           int channel_id = this->uint32_get(p, this->version());
-          // FIXME: The size of the packet isn't adjusted. This is cosmetic
-          // though.
-          if (auto it = elle::find(this->_channels, channel_id))
+          if (channel_id != batch_id)
           {
-            ELLE_DEBUG("received %f on channel %s", p, *it->second);
-            it->second->_packets.put(std::move(p));
+            this->_dispatch(channel_id, std::move(p));
+            continue;
           }
-          else if (this->_master && channel_id > 0
-                   || !this->_master && channel_id < 0)
-            ELLE_TRACE("discard orphaned packet on channel %s", channel_id);
-          else
+          ELLE_DEBUG("received batch of %s bytes", p.size());
+          auto input = elle::IOStream(p.istreambuf());
+          while (input.peek() != std::char_traits<char>::eof())
           {
-            auto res = Channel(*this, channel_id);
-            ELLE_DEBUG("received %f on new channel %s", p, channel_id);
-            res._packets.put(std::move(p));
-            this->_channels_new.put(std::move(res));
+            int id = this->uint32_get(input, this->version());
+            auto const size = this->uint32_get(input, this->version());
+            auto packet = elle::Buffer(size);
+            input.read(reinterpret_cast<char*>(packet.mutable_contents()),
+                       size);
+            if (input.gcount() != signed(size))
+              elle::err("truncated packet in batch on channel %s", id);
+            this->_dispatch(id, std::move(packet));
           }
         }
       }
@@ -88,6 +137,44 @@ namespace elle
         for (auto& c: this->_channels)
           c.second->_packets.raise(std::current_exception());
         this->_exception = std::current_exception();
+        // Writers waiting for credit would wait forever.
+        this->_default._credited.signal();
+        for (auto& c: this->_channels)
+          c.second->_credited.signal();
+        this->_read_failed();
+      }
+    }
+
+    void
+    ChanneledStream::_dispatch(int channel_id, elle::Buffer p)
+    {
+      if (channel_id == credit_id)
+        return this->_credit(std::move(p));
+      // FIXME: The size of the packet isn't adjusted. This is cosmetic
+      // though.
+      if (auto it = elle::find(this->_channels, channel_id))
+      {
+        ELLE_DEBUG("received %f on channel %s", p, *it->second);
+        it->second->_queued += p.size();
+        this->_buffered += p.size();
+        it->second->_packets.put(std::move(p));
+      }
+      else if (this->_master && channel_id > 0
+               || !this->_master && channel_id < 0)
+      {
+        ELLE_TRACE("discard orphaned packet on channel %s", channel_id);
+        // The peer still accounts for these bytes against its window.
+        if (this->_peer_window)
+          this->_credit_back(channel_id, p.size());
+      }
+      else
+      {
+        auto res = Channel(*this, channel_id);
+        ELLE_DEBUG("received %f on new channel %s", p, channel_id);
+        res._queued += p.size();
+        this->_buffered += p.size();
+        res._packets.put(std::move(p));
+        this->_channels_new.put(std::move(res));
       }
     }
 
@@ -123,6 +210,39 @@ namespace elle
       }
     }
 
+    void
+    ChanneledStream::_handshake_window()
+    {
+      if (this->_window &&
+          (*this->_window == 0 ||
+           *this->_window > std::numeric_limits<uint32_t>::max()))
+        elle::err("invalid flow control window: %s", *this->_window);
+      if (this->version() < elle::Version(0, 7, 0))
+      {
+        if (this->_window)
+        {
+          ELLE_TRACE("%s: peer does not credit bytes back, drop window",
+                     *this);
+          this->_window.reset();
+        }
+        return;
+      }
+      // Zero stands for no window.
+      {
+        auto p = elle::Buffer{};
+        this->uint32_put(p, this->_window.value_or(0), this->version());
+        this->_backend.write(p);
+      }
+      {
+        auto p = this->_backend.read();
+        auto const window = this->uint32_get(p, this->version());
+        ELLE_TRACE("%s: windows: %s sent, %s received",
+                   *this, this->_window.value_or(0), window);
+        if (window)
+          this->_peer_window = window;
+      }
+    }
+
     /*----.
     | IDs |
     `----*/
@@ -139,9 +259,10 @@ namespace elle
       }
       else
       {
-        --this->_id_current;
-        if (this->_id_current > 0)
+        if (this->_id_current == credit_id + 1)
           this->_id_current = -1;
+        else
+          --this->_id_current;
       }
       return res;
     }
@@ -175,13 +296,231 @@ namespace elle
 
     void
     ChanneledStream::_write(elle::Buffer const& packet, int id)
+    {
+      // Peers before 0.8.0 would take a batch for a packet on a new channel.
+      if (!this->_batching || this->version() < elle::Version(0, 8, 0))
+        return this->_send(packet, id);
+      ELLE_TRACE_SCOPE("%s: batch %f on channel %s", *this, packet, id);
+      auto batch = this->_batch;
+      auto const leader = !batch;
+      if (leader)
+        batch = this->_batch = std::make_shared<Batch>();
+      batch->packets.emplace_back(id, packet);
+      // The batch refers to the packet: wait until it is sent, whatever
+      // happens. Termination is deferred, other exceptions such as timeouts
+      // are held until then.
+      auto interrupted = std::exception_ptr{};
+      elle::With<reactor::Thread::NonInterruptible>() << [&]
+      {
+        if (leader)
+        {
+          try
+          {
+            if (this->_batching->is_positive())
+              reactor::sleep(*this->_batching);
+            else
+              reactor::yield();
+          }
+          catch (...)
+          {
+            interrupted = std::current_exception();
+          }
+          this->_batch.reset();
+          try
+          {
+            this->_flush(*batch);
+          }
+          catch (elle::Error const&)
+          {
+            batch->exception = std::current_exception();
+          }
+          batch->sent.open();
+        }
+        else
+        {
+          while (!batch->sent.opened())
+            try
+            {
+              reactor::wait(batch->sent);
+            }
+            catch (...)
+            {
+              interrupted = std::current_exception();
+            }
+        }
+      };
+      if (interrupted)
+        std::rethrow_exception(interrupted);
+      if (batch->exception)
+        std::rethrow_exception(batch->exception);
+    }
+
+    void
+    ChanneledStream::_flush(Batch& batch)
+    {
+      if (batch.packets.size() == 1)
+      {
+        auto const& packet = batch.packets.front();
+        return this->_send(packet.second, packet.first);
+      }
+      ELLE_TRACE_SCOPE("%s: send batch of %s packets",
+                       *this, batch.packets.size());
+      static auto& batches =
+        elle::metrics::counter("elle.protocol.ChanneledStream.batches");
+      batches.increment();
+      // Lay out every header first, so the buffers referring to them stay
+      // valid.
+      auto headers = elle::Buffer{};
+      auto offsets = std::vector<elle::Buffer::Size>{};
+      offsets.reserve(batch.packets.size() + 1);
+      this->uint32_put(headers, batch_id, this->version());
+      for (auto const& packet: batch.packets)
+      {
+        offsets.emplace_back(headers.size());
+        this->uint32_put(headers, packet.first, this->version());
+        this->uint32_put(headers, packet.second.size(), this->version());
+      }
+      offsets.emplace_back(headers.size());
+      auto buffers = Buffers{};
+      buffers.reserve(2 * batch.packets.size() + 1);
+      buffers.emplace_back(headers.contents(), offsets[0]);
+      for (unsigned i = 0; i < batch.packets.size(); ++i)
+      {
+        buffers.emplace_back(headers.contents() + offsets[i],
+                             offsets[i + 1] - offsets[i]);
+        buffers.emplace_back(batch.packets[i].second);
+      }
+      this->_backend_write(buffers, batch_id);
+    }
+
+    void
+    ChanneledStream::_send(elle::ConstWeakBuffer packet, int id)
     {
       ELLE_TRACE_SCOPE("%s: send %f on channel %s", *this, packet, id);
 
-      auto backend_packet = elle::Buffer{};
-      this->uint32_put(backend_packet, id, this->version());
-      backend_packet.append(packet.contents(), packet.size());
-      this->_backend.write(backend_packet);
+      // Hand the channel id and the payload separately to the backend, sparing
+      // a copy of the payload.
+      auto header = elle::Buffer{};
+      this->uint32_put(header, id, this->version());
+      this->_backend_write(Buffers{header, packet}, id);
+    }
+
+    void
+    ChanneledStream::_backend_write(Buffers const& buffers, int id)
+    {
+      if (this->_writing)
+      {
+        Turn turn;
+        auto& waiting = this->_waiting[id];
+        waiting.emplace_back(&turn);
+        if (waiting.size() == 1)
+          this->_turns.emplace_back(id);
+        try
+        {
+          reactor::wait(turn.go);
+        }
+        catch (...)
+        {
+          if (turn.go.opened())
+            this->_next_turn();
+          else
+          {
+            auto& waiting = this->_waiting[id];
+            waiting.erase(std::find(waiting.begin(), waiting.end(), &turn));
+            if (waiting.empty())
+            {
+              this->_waiting.erase(id);
+              this->_turns.erase(
+                std::find(this->_turns.begin(), this->_turns.end(), id));
+            }
+          }
+          throw;
+        }
+      }
+      else
+        this->_writing = true;
+      elle::SafeFinally next([this] { this->_next_turn(); });
+      this->_backend.write(buffers);
+      ++this->_written;
+    }
+
+    void
+    ChanneledStream::_next_turn()
+    {
+      if (this->_turns.empty())
+      {
+        this->_writing = false;
+        return;
+      }
+      auto const id = this->_turns.front();
+      this->_turns.pop_front();
+      auto it = this->_waiting.find(id);
+      auto turn = it->second.front();
+      it->second.pop_front();
+      // Other writers on that Channel wait for the next round.
+      if (it->second.empty())
+        this->_waiting.erase(it);
+      else
+        this->_turns.emplace_back(id);
+      turn->go.open();
+    }
+
+    /*-------------.
+    | Flow control |
+    `-------------*/
+
+    void
+    ChanneledStream::_consume(Channel& channel, Size size)
+    {
+      channel._queued -= size;
+      this->_buffered -= size;
+      if (this->_budget)
+        this->_drained.signal();
+      if (!this->_peer_window)
+        return;
+      channel._consumed += size;
+      if (channel._consumed < int64_t(*this->_peer_window / 2))
+        return;
+      auto const credit = channel._consumed;
+      channel._consumed = 0;
+      this->_credit_back(channel.id(), credit);
+    }
+
+    void
+    ChanneledStream::_credit_back(int id, int64_t size)
+    {
+      ELLE_DEBUG("%s: credit %s bytes back on channel %s", *this, size, id);
+      auto packet = elle::Buffer{};
+      this->uint32_put(packet, credit_id, this->version());
+      this->uint32_put(packet, id, this->version());
+      this->uint32_put(packet, size, this->version());
+      // The packet was received already, do not lose its credit.
+      try
+      {
+        elle::With<reactor::Thread::NonInterruptible>() << [&]
+        {
+          this->_backend_write(Buffers{packet}, credit_id);
+        };
+      }
+      catch (elle::Error const& e)
+      {
+        ELLE_TRACE("%s: unable to send credit: %s", *this, e);
+      }
+    }
+
+    void
+    ChanneledStream::_credit(elle::Buffer packet)
+    {
+      int const id = this->uint32_get(packet, this->version());
+      auto const credit = this->uint32_get(packet, this->version());
+      if (auto it = elle::find(this->_channels, id))
+      {
+        ELLE_DEBUG("%s: %s bytes credited on %s", *this, credit, *it->second);
+        it->second->_in_flight -= credit;
+        it->second->_credited.signal();
+      }
+      else
+        ELLE_DEBUG("%s: discard credit for closed channel %s", *this, id);
     }
 
     /*--------.
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <deque>
 #include <unordered_map>
 
+#include <boost/optional.hpp>
+#include <boost/signals2/signal.hpp>
+
+#include <elle/reactor/duration.hh>
+#include <elle/reactor/signal.hh>
+
 #include <elle/protocol/Channel.hh>
 #include <elle/protocol/Stream.hh>
 #include <elle/protocol/fwd.hh>
@@ -47,13 +54,21 @@ namespace elle
       using Self = ChanneledStream;
       using Super = Stream;
       using Channels = std::unordered_map<int, Channel*>;
+      using Size = elle::Buffer::Size;
 
     /*-------------.
     | Construction |
     `-------------*/
     public:
-      ChanneledStream(elle::reactor::Scheduler& scheduler, Stream& backend);
-      ChanneledStream(Stream& backend);
+      /// Construct a ChanneledStream.
+      ///
+      /// @param backend The Stream to multiplex.
+      /// @param window How many bytes a Channel may send ahead of its peer
+      ///               reader, if limited (see window).
+      ChanneledStream(elle::reactor::Scheduler& scheduler,
+                      Stream& backend,
+                      boost::optional<Size> window = {});
+      ChanneledStream(Stream& backend, boost::optional<Size> window = {});
       virtual
       ~ChanneledStream();
     private:
@@ -62,6 +77,10 @@ namespace elle
       ELLE_ATTRIBUTE(Stream&, backend);
       ELLE_ATTRIBUTE(reactor::Thread::unique_ptr, thread);
       ELLE_ATTRIBUTE(std::exception_ptr, exception);
+    public:
+      /// Emitted once reading the backend failed, after every Channel got the
+      /// error.
+      ELLE_ATTRIBUTE_RX(boost::signals2::signal<void ()>, read_failed);
 
     /*--------.
     | Version |
@@ -82,6 +101,9 @@ namespace elle
       /// \return whether is the master.
       bool
       _handshake();
+      /// Exchange flow control windows with the peer.
+      void
+      _handshake_window();
 
     /*----------.
     | Receiving |
@@ -105,6 +127,88 @@ namespace elle
     private:
       void
       _write(elle::Buffer const& packet, int id);
+      void
+      _send(elle::ConstWeakBuffer packet, int id);
+      /// Write @a buffers to the backend on behalf of channel @a id, in turn.
+      void
+      _backend_write(Buffers const& buffers, int id);
+    public:
+      /// Backend packets written so far.
+      ELLE_ATTRIBUTE_R(std::size_t, written);
+
+    /*---------.
+    | Batching |
+    `---------*/
+    public:
+      /// How long packets are held to be sent together, if at all.
+      ///
+      /// When set, packets written on any Channel within that delay, or within
+      /// the same scheduler round if it is null, are coalesced in a single
+      /// backend packet. Writers block until their batch is sent. The peer
+      /// splits batches back into their packets, since 0.8.0: with older
+      /// peers, packets are sent one by one.
+      ELLE_ATTRIBUTE_RW(reactor::DurationOpt, batching);
+    private:
+      struct Batch;
+      void
+      _flush(Batch& batch);
+      ELLE_ATTRIBUTE(std::shared_ptr<Batch>, batch);
+
+    /*-------------.
+    | Flow control |
+    `-------------*/
+    public:
+      /// How many bytes a Channel may send ahead of its peer reader, if
+      /// limited.
+      ///
+      /// When set, writers block once that many bytes they wrote on a Channel
+      /// were not read yet on the other side; readers credit bytes back as
+      /// they consume them, by half windows. A packet larger than the window
+      /// is sent once less than half a window is in flight on its Channel.
+      ///
+      /// Both ends announce their window after agreeing on the version,
+      /// since 0.7.0, so each side may set its own or none. With older
+      /// peers, which would neither credit bytes back nor understand
+      /// credits, the window is dropped.
+      ELLE_ATTRIBUTE_R(boost::optional<Size>, window);
+      /// How many received bytes may wait to be read on all Channels, if
+      /// limited.
+      ///
+      /// When reached, the backend is not read until some Channel is
+      /// consumed, pushing back on the peer. This also holds credits and
+      /// packets for other Channels: keep it above the windows of the
+      /// Channels read concurrently.
+      ELLE_ATTRIBUTE_RW(boost::optional<Size>, budget);
+    private:
+      /// Account for @a size bytes read from @a channel.
+      void
+      _consume(Channel& channel, Size size);
+      /// Credit @a size bytes received on channel @a id back to the peer.
+      void
+      _credit_back(int id, int64_t size);
+      /// Apply a credit update from the peer.
+      void
+      _credit(elle::Buffer packet);
+      /// The window announced by the peer, to credit bytes back by halves.
+      ELLE_ATTRIBUTE(boost::optional<Size>, peer_window);
+      /// Bytes received on all Channels and not read yet.
+      ELLE_ATTRIBUTE(Size, buffered);
+      ELLE_ATTRIBUTE(reactor::Signal, drained);
+
+    /*---------.
+    | Fairness |
+    `---------*/
+    private:
+      /// Channels take turns writing to the backend, one packet each, so a
+      /// busy Channel cannot starve the others.
+      struct Turn;
+      void
+      _next_turn();
+      ELLE_ATTRIBUTE(bool, writing);
+      /// The Channels waiting for their turn, in order.
+      ELLE_ATTRIBUTE(std::deque<int>, turns);
+      /// The writers waiting on each Channel, in order.
+      ELLE_ATTRIBUTE((std::unordered_map<int, std::deque<Turn*>>), waiting);
 
     /*----------.
     | Printable |
@@ -117,6 +221,8 @@ namespace elle
     | Details |
     `--------*/
     private:
+      void
+      _dispatch(int id, elle::Buffer packet);
       friend class Channel;
       ELLE_ATTRIBUTE(Channels, channels);
       ELLE_ATTRIBUTE(reactor::Channel<Channel>, channels_new);
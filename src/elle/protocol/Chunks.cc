@@ -0,0 +1,215 @@
+#include <elle/protocol/Chunks.hh>
+
+#include <elle/err.hh>
+#include <elle/log.hh>
+#include <elle/reactor/Thread.hh>
+#include <elle/reactor/exception.hh>
+
+#include <elle/protocol/Channel.hh>
+#include <elle/protocol/exceptions.hh>
+
+ELLE_LOG_COMPONENT("elle.protocol.Chunks");
+
+namespace elle
+{
+  namespace protocol
+  {
+    /*-------.
+    | Chunks |
+    `-------*/
+
+    Chunks::Chunks()
+      : _source()
+    {}
+
+    Chunks::Chunks(Source source)
+      : _source(std::move(source))
+    {}
+
+    boost::optional<elle::Buffer>
+    Chunks::next()
+    {
+      if (!this->_source)
+        return boost::none;
+      return this->_source();
+    }
+
+    /*----------.
+    | ChunkLink |
+    `----------*/
+
+    int const ChunkLink::window = 8;
+
+    ChunkLink::ChunkLink(std::shared_ptr<Channel> channel, Read read)
+      : _caller(false)
+      , _channel(std::move(channel))
+      , _reader(std::move(read))
+      , _credits(window)
+      , _consumed(0)
+      , _receiving(false)
+      , _ended(false)
+      , _done(false)
+      , _reply()
+    {}
+
+    ChunkLink::~ChunkLink()
+    {
+      if (!this->_caller || !this->_receiving || this->_ended)
+        return;
+      ELLE_TRACE_SCOPE("%s: cancel unfinished chunks", *this->_channel);
+      try
+      {
+        elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
+        {
+          this->_channel->write(elle::Buffer());
+        };
+      }
+      catch (elle::Error const& e)
+      {
+        ELLE_TRACE("unable to cancel: %s", e);
+      }
+    }
+
+    void
+    ChunkLink::send(Chunks& chunks)
+    {
+      ELLE_TRACE_SCOPE("%s: send chunks", *this->_channel);
+      while (true)
+      {
+        auto chunk = boost::optional<elle::Buffer>{};
+        try
+        {
+          chunk = chunks.next();
+        }
+        catch (elle::reactor::Terminate const&)
+        {
+          throw;
+        }
+        catch (...)
+        {
+          auto const message = elle::exception_string();
+          ELLE_TRACE("source failed: %s", message);
+          this->_done = true;
+          this->_write(Tag::error, message);
+          throw;
+        }
+        if (!chunk)
+          break;
+        while (this->_credits == 0)
+        {
+          auto packet = this->_read();
+          if (Tag(packet[0]) == Tag::ack)
+            this->_credits += window / 2;
+          else
+          {
+            ELLE_TRACE("reply before the end of the chunks");
+            this->_reply.emplace(std::move(packet));
+            this->end();
+            return;
+          }
+        }
+        this->_write(Tag::data, *chunk);
+        --this->_credits;
+      }
+      this->end();
+    }
+
+    Chunks
+    ChunkLink::receive()
+    {
+      this->_receiving = true;
+      auto self = this->shared_from_this();
+      return Chunks([self] { return self->_next(); });
+    }
+
+    elle::Buffer
+    ChunkLink::reply()
+    {
+      auto res = this->_reply ? std::move(*this->_reply) : elle::Buffer();
+      this->_reply.reset();
+      // Acknowledgements of the last chunks may precede the reply.
+      while (res.empty() || Tag(res[0]) != Tag::reply)
+      {
+        if (!res.empty() && Tag(res[0]) != Tag::ack)
+          elle::err<Error>("unexpected packet instead of reply: %s",
+                           char(res[0]));
+        res = this->_read();
+      }
+      res.pop_front();
+      return res;
+    }
+
+    void
+    ChunkLink::end()
+    {
+      if (this->_done)
+        return;
+      this->_done = true;
+      this->_write(Tag::end);
+    }
+
+    void
+    ChunkLink::drain()
+    {
+      while (!this->_ended)
+        switch (Tag(this->_read()[0]))
+        {
+          case Tag::end:
+          case Tag::error:
+            this->_ended = true;
+            break;
+          default:
+            break;
+        }
+    }
+
+    boost::optional<elle::Buffer>
+    ChunkLink::_next()
+    {
+      if (this->_ended)
+        return boost::none;
+      auto packet = this->_read();
+      switch (Tag(packet[0]))
+      {
+        case Tag::data:
+          if (++this->_consumed == window / 2)
+          {
+            this->_consumed = 0;
+            this->_write(Tag::ack);
+          }
+          packet.pop_front();
+          return packet;
+        case Tag::end:
+          this->_ended = true;
+          if (this->_caller)
+            this->end();
+          return boost::none;
+        case Tag::error:
+          this->_ended = true;
+          if (this->_caller)
+            this->end();
+          packet.pop_front();
+          elle::err<RPCError>("remote chunks failed: %s", packet.string());
+        default:
+          elle::err<Error>("unexpected packet in chunks: %s", char(packet[0]));
+      }
+    }
+
+    elle::Buffer
+    ChunkLink::_read()
+    {
+      auto res = this->_reader ? this->_reader() : this->_channel->read();
+      if (res.empty())
+        throw Cancelled();
+      return res;
+    }
+
+    void
+    ChunkLink::_write(Tag tag, elle::ConstWeakBuffer payload)
+    {
+      auto const t = char(tag);
+      this->_channel->write(
+        Stream::Buffers{elle::ConstWeakBuffer(&t, 1), payload});
+    }
+  }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <boost/optional.hpp>
+
+#include <elle/Buffer.hh>
+#include <elle/attribute.hh>
+
+#include <elle/protocol/fwd.hh>
+
+namespace elle
+{
+  namespace protocol
+  {
+    /// A stream of Buffers, pulled one at a time from a source.
+    ///
+    /// RPC procedures may take Chunks as their last argument, or return
+    /// Chunks, to exchange any amount of data without holding it all in
+    /// memory: the chunks flow through the call Channel as they are pulled,
+    /// with at most ChunkLink::window of them in flight, so a slow consumer
+    /// slows the producer down.
+    ///
+    /// @code{.cc}
+    ///
+    /// auto i = 0;
+    /// auto chunks = elle::protocol::Chunks(
+    ///   [&] () -> boost::optional<elle::Buffer>
+    ///   {
+    ///     if (i++ < 3)
+    ///       return elle::Buffer("chunk");
+    ///     return boost::none;
+    ///   });
+    /// while (auto chunk = chunks.next())
+    ///   std::cout << *chunk;
+    ///
+    /// @endcode
+    class Chunks
+    {
+    public:
+      /// Produce the next chunk, or none once exhausted.
+      using Source = std::function<boost::optional<elle::Buffer> ()>;
+
+    public:
+      /// No chunks.
+      Chunks();
+      /// Chunks produced by @a source.
+      Chunks(Source source);
+
+    public:
+      /// The next chunk, or none once exhausted.
+      boost::optional<elle::Buffer>
+      next();
+
+    private:
+      ELLE_ATTRIBUTE(Source, source);
+    };
+
+    /// The packets of a streaming RPC call, following its question.
+    ///
+    /// Every packet starts with a Tag. The sender of Chunks may have
+    /// `window` data packets unacknowledged; the receiver acknowledges every
+    /// half window it consumes. Empty packets still cancel the call.
+    ///
+    /// The caller sends its last packet once the call is over, with the end
+    /// or the failure of the chunks it sends, or by acknowledging the end of
+    /// the ones it receives. The callee drains the Channel up to it before
+    /// closing, so no stray packet outlives the call.
+    class ChunkLink
+      : public std::enable_shared_from_this<ChunkLink>
+    {
+    public:
+      enum class Tag: char
+      {
+        /// A chunk.
+        data = 'd',
+        /// The end of the chunks.
+        end = 'e',
+        /// The source of the chunks failed, followed by the message.
+        error = 'x',
+        /// The receiver consumed half a window.
+        ack = 'a',
+        /// The answer to the call.
+        reply = 'r',
+      };
+      /// Read the next packet of the call.
+      using Read = std::function<elle::Buffer ()>;
+      /// Maximum number of chunks sent ahead of the receiver.
+      static int const window;
+
+    public:
+      /// Exchange chunks on @a channel.
+      ///
+      /// @param read How to read packets, from the channel by default.
+      ChunkLink(std::shared_ptr<Channel> channel, Read read = {});
+      /// Cancel the call if the caller drops chunks before their end.
+      ~ChunkLink();
+
+    public:
+      /// Send @a chunks followed by the end marker.
+      ///
+      /// Stop early if the reply comes while waiting for acknowledgements,
+      /// see reply.
+      ///
+      /// @throws Whatever the source throws, once the receiver is told.
+      void
+      send(Chunks& chunks);
+      /// The chunks sent by the peer, valid as long as the call.
+      ///
+      /// @throws RPCError from Chunks::next if the peer source failed.
+      Chunks
+      receive();
+      /// The answer to the call, without its tag.
+      elle::Buffer
+      reply();
+      /// Tell the peer we are done, unless already done.
+      void
+      end();
+      /// Discard packets until the peer is done.
+      void
+      drain();
+      /// Whether we issued the call.
+      ELLE_ATTRIBUTE_RW(bool, caller);
+
+    private:
+      elle::Buffer
+      _read();
+      void
+      _write(Tag tag, elle::ConstWeakBuffer payload = {});
+      boost::optional<elle::Buffer>
+      _next();
+      ELLE_ATTRIBUTE(std::shared_ptr<Channel>, channel);
+      ELLE_ATTRIBUTE(Read, reader);
+      /// Chunks we may send before the next acknowledgement.
+      ELLE_ATTRIBUTE(int, credits);
+      /// Chunks consumed since the last acknowledgement.
+      ELLE_ATTRIBUTE(int, consumed);
+      /// Whether receive was called.
+      ELLE_ATTRIBUTE(bool, receiving);
+      /// Whether the peer is done.
+      ELLE_ATTRIBUTE(bool, ended);
+      /// Whether we are done.
+      ELLE_ATTRIBUTE(bool, done);
+      ELLE_ATTRIBUTE(boost::optional<elle::Buffer>, reply);
+    };
+  }
+}
@@ -9,7 +9,9 @@
 #include <elle/Printable.hh>
 
 #include <elle/reactor/Thread.hh>
+#include <elle/reactor/duration.hh>
 
+#include <elle/protocol/Chunks.hh>
 #include <elle/protocol/fwd.hh>
 
 namespace elle
@@ -26,6 +28,17 @@ namespace elle
 
     using ExceptionHandler = std::function<void(std::exception_ptr)>;
 
+    /// The Chunks of a call being served.
+    struct CallChunks
+    {
+      /// Where chunks flow, if the call streams.
+      std::shared_ptr<ChunkLink> link;
+      /// The chunks streamed by the caller.
+      Chunks argument;
+      /// The chunks returned by the procedure.
+      boost::optional<Chunks> result;
+    };
+
     template <typename ISerializer, typename OSerializer>
     class BaseProcedure
       : public boost::noncopyable
@@ -41,7 +54,7 @@ namespace elle
 
       virtual
       void
-      _call(ISerializer& in, OSerializer& out) = 0;
+      _call(ISerializer& in, OSerializer& out, CallChunks& chunks) = 0;
 
     private:
       ELLE_ATTRIBUTE(std::string, name);
@@ -64,7 +77,7 @@ namespace elle
 
     protected:
       void
-      _call(ISerializer& in, OSerializer& out) override;
+      _call(ISerializer& in, OSerializer& out, CallChunks& chunks) override;
 
     private:
       template <typename I, typename O>
@@ -99,6 +112,12 @@ namespace elle
       run(ExceptionHandler handler = {}) = 0;
 
     protected:
+      /// Set in the procedure id of calls that want the backtrace of errors.
+      static constexpr uint32_t backtrace_request = 1u << 31;
+      /// Set in the procedure id of calls streaming Chunks, whose further
+      /// packets are tagged, see ChunkLink.
+      static constexpr uint32_t stream_request = 1u << 30;
+
       template <typename ISerializer,
                 typename OSerializer,
                 typename R,
@@ -109,6 +128,27 @@ namespace elle
       ELLE_ATTRIBUTE(uint32_t, id, protected);
     };
 
+    /// Remote procedure calls over a ChanneledStream.
+    ///
+    /// Every call gets its own Channel, whose id identifies the request: any
+    /// number of calls, from any number of Threads, can be in flight on the
+    /// same connection and answers are routed back to their caller as they
+    /// come, in any order.
+    ///
+    /// A caller that gives up on a call, because it is terminated or its
+    /// deadline expired, sends an empty packet on the call Channel: a server
+    /// running parallel_run terminates the procedure and sends no answer.
+    /// This requires protocol version 0.6.0: with older peers, abandoned
+    /// calls run to completion.
+    ///
+    /// Small calls are dominated by the cost of each packet: enable
+    /// ChanneledStream::batching on both sides to send the calls, and the
+    /// answers, issued together in a single packet, with peers since 0.8.0.
+    ///
+    /// A procedure can take one Chunks argument, by value, or return Chunks,
+    /// to stream data of any size with flat memory usage: the chunks follow
+    /// the question or the answer on the call Channel, with flow control.
+    /// Dropping returned Chunks before their end cancels the call.
     template <typename ISerializer, typename OSerializer>
     class RPC
       : public BaseRPC
@@ -126,6 +166,10 @@ namespace elle
       public:
         RemoteProcedure(std::string const& name,
                         RPC<ISerializer, OSerializer>& owner);
+        /// Call the remote procedure.
+        ///
+        /// @throws reactor::Timeout if no answer came before the deadline,
+        ///         see timeout.
         R operator() (Args ...);
         void operator = (std::function<R (Args...)> const& implem);
         template <typename I, typename O>
@@ -133,7 +177,12 @@ namespace elle
         RemoteProcedure(std::string const& name,
                         RPC<ISerializer, OSerializer>& owner,
                         uint32_t id);
+        /// Deadline of calls, overriding the RPC one.
+        ELLE_ATTRIBUTE_RW(reactor::DurationOpt, timeout);
       private:
+        /// Let the peer abandon a call we gave up on.
+        void
+        _cancel(Channel& channel);
         ELLE_ATTRIBUTE(uint32_t, id);
         ELLE_ATTRIBUTE(std::string, name);
         ELLE_ATTRIBUTE(Owner&, owner);
@@ -156,9 +205,26 @@ namespace elle
       void
       run(ExceptionHandler = {}) override;
 
+      /// Serve calls concurrently, each in its own Thread, until the
+      /// connection is closed or a handler throws a LastMessageException.
+      ///
+      /// Calls the peer cancels are terminated. When a LastMessageException
+      /// is thrown, no new call is accepted and the ones in flight are
+      /// completed.
+      ///
+      /// @param handler See run.
       virtual
       void
-      parallel_run();
+      parallel_run(ExceptionHandler handler = {});
+
+      /// Default deadline of remote calls, none by default.
+      ELLE_ATTRIBUTE_RW(reactor::DurationOpt, timeout);
+      /// Whether failed calls bring back the remote backtrace.
+      ///
+      /// Off by default: errors carry their message, RPCError::code and
+      /// RPCError::type, and the peer neither symbolizes nor sends its
+      /// backtrace. Peers from before this option reject such calls.
+      ELLE_ATTRIBUTE_RW(bool, backtraces);
 
     protected:
       using LocalProcedure = BaseProcedure<ISerializer, OSerializer>;
@@ -169,6 +235,27 @@ namespace elle
       ELLE_ATTRIBUTE(Procedures, procedures, protected);
       ELLE_ATTRIBUTE(std::vector<BaseRPC*>, rpcs, protected);
 
+      /// Run the call in @a question.
+      ///
+      /// @param question The serialized procedure id and arguments.
+      /// @param handler See run.
+      /// @param answer Where to serialize the result or the error.
+      /// @param channel The call Channel, for streaming calls.
+      /// @param read How to read the packets following the question.
+      /// @param chunks Filled for streaming calls.
+      /// @returns Whether the handler requested to stop serving.
+      bool
+      _serve(elle::Buffer const& question,
+             ExceptionHandler& handler,
+             elle::Buffer& answer,
+             std::shared_ptr<Channel> const& channel,
+             ChunkLink::Read read,
+             CallChunks& chunks);
+      /// Finish a streaming call after its answer: send the Chunks returned
+      /// by the procedure, if any, and wait for the caller to be done.
+      void
+      _stream(CallChunks& chunks);
+
     /*----------.
     | Printable |
     `----------*/
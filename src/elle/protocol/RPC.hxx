@@ -1,6 +1,7 @@
 #include <type_traits>
 
 #include <elle/Backtrace.hh>
+#include <elle/Measure.hh>
 #include <elle/log.hh>
 #include <elle/printf.hh>
 #include <elle/memory.hh>
@@ -9,11 +10,15 @@
 #include <elle/reactor/Scope.hh>
 #include <elle/reactor/scheduler.hh>
 #include <elle/reactor/Thread.hh>
+#include <elle/reactor/TimeoutGuard.hh>
+#include <elle/reactor/exception.hh>
 
 #include <elle/protocol/Channel.hh>
 #include <elle/protocol/ChanneledStream.hh>
 #include <elle/protocol/exceptions.hh>
 
+#include <elle/serialization/Error.hh>
+
 namespace elle
 {
   namespace protocol
@@ -63,10 +68,57 @@ namespace elle
     Procedure<IS, OS, R, Args ...>::~Procedure()
     {}
 
+    /*---------------.
+    | Chunks helpers |
+    `---------------*/
+
+    template <typename T>
+    using is_chunks = std::is_same<std::decay_t<T>, Chunks>;
+
+    template <typename ... Types>
+    struct any_chunks
+      : std::false_type
+    {};
+
+    template <typename First, typename ... Types>
+    struct any_chunks<First, Types...>
+      : std::integral_constant<bool,
+                               is_chunks<First>::value ||
+                               any_chunks<Types...>::value>
+    {};
+
+    template <typename ... Types>
+    struct chunks_reference
+      : std::false_type
+    {};
+
+    template <typename First, typename ... Types>
+    struct chunks_reference<First, Types...>
+      : std::integral_constant<bool,
+                               (is_chunks<First>::value &&
+                                !std::is_same<First, Chunks>::value) ||
+                               chunks_reference<Types...>::value>
+    {};
+
     /*------------------------.
     | RemoteProcedure helpers |
     `------------------------*/
 
+    template <typename OS, typename T>
+    static
+    void
+    put_arg(OS& output, T const& a)
+    {
+      output << a;
+    }
+
+    /// Chunks are sent after the question.
+    template <typename OS>
+    static
+    void
+    put_arg(OS&, Chunks const&)
+    {}
+
     template <typename OS>
     static
     void
@@ -80,15 +132,38 @@ namespace elle
     void
     put_args(OS& output, T a, Args ... args)
     {
-      output << a;
+      put_arg(output, a);
       put_args<OS, Args...>(output, args...);
     }
 
+    static inline
+    Chunks*
+    find_chunks()
+    {
+      return nullptr;
+    }
+
+    template <typename T, typename ... Args>
+    static
+    Chunks*
+    find_chunks(T&, Args& ... args)
+    {
+      return find_chunks(args...);
+    }
+
+    template <typename ... Args>
+    static
+    Chunks*
+    find_chunks(Chunks& chunks, Args& ...)
+    {
+      return &chunks;
+    }
+
     template <typename IS,
               typename R>
     struct GetRes
     {
-      static inline R get_res(IS& input)
+      static inline R get_res(IS& input, std::shared_ptr<ChunkLink> const&)
       {
         R res;
         input >> res;
@@ -101,13 +176,24 @@ namespace elle
     {
       static
       void
-      get_res(IS& input)
+      get_res(IS& input, std::shared_ptr<ChunkLink> const&)
       {
         char c;
         input >> c;
       }
     };
 
+    template <typename IS>
+    struct GetRes<IS, Chunks>
+    {
+      static
+      Chunks
+      get_res(IS&, std::shared_ptr<ChunkLink> const& link)
+      {
+        return link->receive();
+      }
+    };
+
     /*----------------.
     | RemoteProcedure |
     `----------------*/
@@ -130,7 +216,8 @@ namespace elle
       std::string const& name,
       RPC<IS, OS>& owner,
       uint32_t id)
-      : _id(id)
+      : _timeout()
+      , _id(id)
       , _name(name)
       , _owner(owner)
     {}
@@ -146,9 +233,9 @@ namespace elle
       auto proc = this->_owner._procedures.find(this->_id);
       assert(proc != this->_owner._procedures.end());
       assert(proc->second.second == nullptr);
-      proc->second.second =
-        std::make_unique<Procedure<IS, OS, R, Args...>>(
-          this->_name, this->_owner, this->_id, f);
+      proc->second.second.reset(
+        new Procedure<IS, OS, R, Args...>(
+          this->_name, this->_owner, this->_id, f));
     }
 
 
@@ -164,32 +251,89 @@ namespace elle
 
       ELLE_TRACE_SCOPE("%s: call remote procedure: %s",
                        this->_owner, this->_name);
-
-      Channel channel(this->_owner._channels);
+      ELLE_MEASURE_SCOPE("elle.protocol.RPC.call");
+      static_assert(!is_chunks<R>::value || !any_chunks<Args...>::value,
+                    "procedures cannot both take and return Chunks");
+      static_assert(!chunks_reference<Args...>::value,
+                    "Chunks arguments must be taken by value");
+
+      auto channel = std::make_shared<Channel>(this->_owner._channels);
+      auto const streaming = is_chunks<R>::value || any_chunks<Args...>::value;
+      auto link = streaming ? std::make_shared<ChunkLink>(channel) : nullptr;
+      if (link)
+        link->caller(true);
+      auto const timeout =
+        this->_timeout ? this->_timeout : this->_owner.timeout();
+      auto const start = boost::posix_time::microsec_clock::universal_time();
+      auto response = [&]
       {
-        elle::Buffer question;
+        // Only wait for the answer under the deadline: a timeout, unlike a
+        // termination, would cut a write short and leave a partial packet on
+        // the connection shared by every call.
+        auto guard = std::unique_ptr<elle::reactor::TimeoutGuard>{};
+        auto const deadline = [&]
+        {
+          if (!timeout)
+            return;
+          auto left = *timeout -
+            (boost::posix_time::microsec_clock::universal_time() - start);
+          if (left.is_negative())
+            left = reactor::Duration();
+          guard = std::make_unique<elle::reactor::TimeoutGuard>(left);
+        };
+        try
+        {
+          elle::Buffer question;
+          {
+            elle::IOStream outs(question.ostreambuf());
+            OS output(outs);
+            auto id = this->_id;
+            if (this->_owner.backtraces())
+              id |= BaseRPC::backtrace_request;
+            if (streaming)
+              id |= BaseRPC::stream_request;
+            output << id;
+            put_args<OS, Args...>(output, args...);
+          }
+          channel->write(question);
+          if (!streaming)
+          {
+            deadline();
+            return channel->read();
+          }
+          if (auto chunks = find_chunks(args...))
+            link->send(*chunks);
+          deadline();
+          return link->reply();
+        }
+        catch (elle::reactor::Timeout const&)
         {
-          elle::IOStream outs(question.ostreambuf());
-          OS output(outs);
-          output << this->_id;
-          put_args<OS, Args...>(output, args...);
+          ELLE_TRACE("%s: remote procedure %s timed out",
+                     this->_owner, this->_name);
+          this->_cancel(*channel);
+          throw;
         }
-        channel.write(question);
-      }
+        catch (elle::reactor::Terminate const&)
+        {
+          this->_cancel(*channel);
+          throw;
+        }
+      }();
       {
-        elle::Buffer response(channel.read());
         elle::IOStream ins(response.istreambuf());
         IS input(ins);
         bool res;
         input >> res;
         if (res)
-          return GetRes<IS, R>::get_res(input);
+          return GetRes<IS, R>::get_res(input, link);
         else
         {
           std::string error;
           input >> error;
           ELLE_TRACE_SCOPE("%s: remote procedure call failed: %s",
                            this->_owner, error);
+          if (link)
+            link->end();
           uint16_t bt_size;
           input >> bt_size;
           std::vector<elle::StackFrame> frames;
@@ -203,22 +347,88 @@ namespace elle
             input >> frame.offset;
             frames.push_back(frame);
           }
-          elle::Backtrace bt(frames);
+          // Older peers send neither code nor type.
+          auto code = RPCError::Code::unknown;
+          auto type = std::string{};
+          if (ins.peek() != std::char_traits<char>::eof())
+          {
+            uint8_t c;
+            input >> c;
+            code = RPCError::Code(c);
+            input >> type;
+          }
           // FIXME: only protocol error should throw this, not remote
           // exceptions.
-          RPCError e
-            (elle::sprintf("remote procedure '%s' failed with '%s'", this->_name, error));
-          elle::Exception inner_exception(bt, error);
-          e.inner_exception(std::make_exception_ptr(inner_exception));
+          RPCError e(
+            elle::sprintf("remote procedure '%s' failed with '%s'",
+                          this->_name, error),
+            code, std::move(type));
+          e.inner_exception(std::make_exception_ptr(
+            elle::Exception(elle::Backtrace(frames), error)));
           throw e;
         }
       }
     }
 
+    template <typename IS,
+              typename OS>
+    template <typename R,
+              typename ... Args>
+    void
+    RPC<IS, OS>::RemoteProcedure<R, Args...>::_cancel(Channel& channel)
+    {
+      ELLE_LOG_COMPONENT("elle.protocol.RPC");
+      ELLE_TRACE_SCOPE("%s: cancel call to %s on %s",
+                       this->_owner, this->_name, channel);
+      // Peers before 0.6.0 would take the cancel for an empty question.
+      if (channel.version() < elle::Version(0, 6, 0))
+      {
+        ELLE_TRACE("%s: peer version %s cannot cancel calls",
+                   this->_owner, channel.version());
+        return;
+      }
+      try
+      {
+        elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
+        {
+          channel.write(elle::Buffer());
+        };
+      }
+      catch (elle::Error const& e)
+      {
+        ELLE_TRACE("%s: unable to cancel call: %s", this->_owner, e);
+      }
+    }
+
     /*------------------.
     | Procedure helpers |
     `------------------*/
 
+    template <typename Input,
+              typename T>
+    struct GetArg
+    {
+      static
+      T
+      get(Input& input, CallChunks&)
+      {
+        auto res = T{};
+        input >> res;
+        return res;
+      }
+    };
+
+    template <typename Input>
+    struct GetArg<Input, Chunks>
+    {
+      static
+      Chunks
+      get(Input&, CallChunks& chunks)
+      {
+        return std::move(chunks.argument);
+      }
+    };
+
     template <typename Input,
               typename R,
               typename ... Types>
@@ -232,6 +442,7 @@ namespace elle
       static
       R
       call(Input&,
+           CallChunks&,
            S const& f,
            Given&... args)
       {
@@ -250,12 +461,12 @@ namespace elle
       static
       R
       call(Input& input,
+           CallChunks& chunks,
            S const& f,
            Given&&... args)
       {
-        auto a = std::remove_const_t<std::remove_reference_t<First>>{};
-        input >> a;
-        return Call<Input, R, Types...>::call(input, f,
+        auto a = GetArg<Input, std::decay_t<First>>::get(input, chunks);
+        return Call<Input, R, Types...>::call(input, chunks, f,
                                               std::forward<Given>(args)..., a);
       }
     };
@@ -272,9 +483,10 @@ namespace elle
         void
         call(IS& in,
              OS& out,
+             CallChunks& chunks,
              std::function<R (Args...)> const& f)
         {
-          R res(Call<IS, R, Args...>::template call<>(in, f));
+          R res(Call<IS, R, Args...>::template call<>(in, chunks, f));
           out << true;
           out << res;
         }
@@ -289,14 +501,34 @@ namespace elle
         void
         call(IS& in,
              OS& out,
+             CallChunks& chunks,
              std::function<void (Args...)> const& f)
         {
-          Call<IS, void, Args...>::template call<>(in, f);
+          Call<IS, void, Args...>::template call<>(in, chunks, f);
           out << true;
           unsigned char c(42);
           out << c;
         }
       };
+
+      /// Returned chunks follow the answer, see RPC::_stream.
+      template <typename IS,
+                typename OS,
+                typename ... Args>
+      struct VoidSwitch<IS, OS, Chunks, Args ...>
+      {
+        static
+        void
+        call(IS& in,
+             OS& out,
+             CallChunks& chunks,
+             std::function<Chunks (Args...)> const& f)
+        {
+          chunks.result.emplace(
+            Call<IS, Chunks, Args...>::template call<>(in, chunks, f));
+          out << true;
+        }
+      };
     }
 
     /*----------.
@@ -308,11 +540,11 @@ namespace elle
               typename R,
               typename ... Args>
     void
-    Procedure<IS, OS, R, Args...>::_call(IS& in, OS& out)
+    Procedure<IS, OS, R, Args...>::_call(IS& in, OS& out, CallChunks& chunks)
     {
       std::string err;
       VoidSwitch<IS, OS, R, Args ...>::call(
-        in, out, this->_function);
+        in, out, chunks, this->_function);
     }
 
     /*----.
@@ -348,13 +580,63 @@ namespace elle
               typename OS>
     RPC<IS, OS>::RPC(ChanneledStream& channels)
       : BaseRPC(channels)
+      , _timeout()
+      , _backtraces(false)
     {}
 
+    /// Reply with an error.
+    ///
+    /// The backtrace is only symbolized and sent if given. The code and type
+    /// trail the legacy reply, older peers ignore them.
+    template <typename OS>
+    void
+    put_error(OS& output,
+              RPCError::Code code,
+              std::string const& message,
+              std::string const& type,
+              elle::Backtrace const* backtrace)
+    {
+      output << false;
+      output << message;
+      if (backtrace)
+      {
+        output << uint16_t(backtrace->frames().size());
+        for (auto const& frame: backtrace->frames())
+        {
+          output << frame.symbol;
+          output << frame.symbol_mangled;
+          output << frame.symbol_demangled;
+          output << frame.address;
+          output << frame.offset;
+        }
+      }
+      else
+        output << uint16_t(0);
+      output << uint8_t(code);
+      output << type;
+    }
+
+    /// The code reporting @a e to the caller.
+    inline
+    RPCError::Code
+    error_code(std::exception const& e)
+    {
+      if (dynamic_cast<elle::reactor::Timeout const*>(&e))
+        return RPCError::Code::timeout;
+      else if (dynamic_cast<Cancelled const*>(&e))
+        return RPCError::Code::cancelled;
+      else if (dynamic_cast<elle::serialization::Error const*>(&e))
+        return RPCError::Code::serialization;
+      else
+        return RPCError::Code::failed;
+    }
+
     template<typename T>
     bool
     handle_exception(ExceptionHandler & handler,
                      T& output,
-                     std::exception_ptr ex)
+                     std::exception_ptr ex,
+                     bool backtrace)
     {
       ELLE_LOG_COMPONENT("elle.protocol.RPC");
       bool res = false;
@@ -371,91 +653,149 @@ namespace elle
           res = true;
         ELLE_TRACE_SCOPE("RPC procedure failed: %s (stop_request = %s)",
           e.what(), res);
-        output << false;
-        output << std::string(e.what());
-        output << uint16_t(e.backtrace().frames().size());
-        for (auto const& frame: e.backtrace().frames())
-        {
-          output << frame.symbol;
-          output << frame.symbol_mangled;
-          output << frame.symbol_demangled;
-          output << frame.address;
-          output << frame.offset;
-        }
+        put_error(output, error_code(e), e.what(),
+                  elle::demangle(typeid(e).name()),
+                  backtrace ? &e.backtrace() : nullptr);
       }
       catch (std::exception& e)
       {
         ELLE_TRACE_SCOPE("RPC procedure failed: %s", e.what());
-        output << false;
-        output << std::string(e.what());
-        output << uint16_t(0);
+        put_error(output, error_code(e), e.what(),
+                  elle::demangle(typeid(e).name()), nullptr);
       }
       catch (...)
       {
         ELLE_TRACE_SCOPE("RPC procedure failed: unknown error");
-        output << false;
-        output << std::string("unknown error");
-        output << uint16_t(0);
+        put_error(output, RPCError::Code::failed, "unknown error", "",
+                  nullptr);
       }
       return res;
     }
 
     template <typename IS,
               typename OS>
-    void
-    RPC<IS, OS>::run(ExceptionHandler handler)
+    bool
+    RPC<IS, OS>::_serve(elle::Buffer const& question,
+                        ExceptionHandler& handler,
+                        elle::Buffer& answer,
+                        std::shared_ptr<Channel> const& channel,
+                        ChunkLink::Read read,
+                        CallChunks& chunks)
     {
       ELLE_LOG_COMPONENT("elle.protocol.RPC");
 
       using elle::sprintf;
       using elle::Exception;
-      bool stop_request = false;
-      try
+      elle::IOStream ins(question.istreambuf());
+      IS input(ins);
+      uint32_t id;
+      input >> id;
+      auto const backtrace = bool(id & BaseRPC::backtrace_request);
+      auto const streaming = bool(id & BaseRPC::stream_request);
+      id &= ~(BaseRPC::backtrace_request | BaseRPC::stream_request);
+      if (streaming)
       {
-        while (!stop_request)
+        chunks.link = std::make_shared<ChunkLink>(channel, std::move(read));
+        chunks.argument = chunks.link->receive();
+        auto const tag = char(ChunkLink::Tag::reply);
+        answer.append(&tag, 1);
+      }
+      ELLE_TRACE_SCOPE("%s: Processing request for %s...", *this, id);
+      auto proc = this->_procedures.find(id);
+      auto stop_request = false;
+      {
+        elle::IOStream outs(answer.ostreambuf());
+        OS output(outs);
+        try
         {
-          ELLE_TRACE_SCOPE("%s: Accepting new request...", *this);
-          Channel c(this->_channels.accept());
-          elle::Buffer question(c.read());
-          elle::IOStream ins(question.istreambuf());
-          IS input(ins);
-          uint32_t id;
-          input >> id;
-          ELLE_TRACE_SCOPE("%s: Processing request for %s...", *this, id);
-          auto proc = this->_procedures.find(id);
-
-          elle::Buffer answer;
-          elle::IOStream outs(answer.ostreambuf());
-          OS output(outs);
-          try
+          if (proc == this->_procedures.end())
           {
-            if (proc == this->_procedures.end())
-              throw Exception(sprintf("call to unknown procedure: %s", id));
-            else if (proc->second.second == nullptr)
-            {
-              throw Exception(sprintf("remote call to non-local procedure: %s",
-                                      proc->second.first));
-            }
-            else
-            {
-              auto const &name = proc->second.first;
-
-              ELLE_TRACE("%s: remote procedure called: %s", *this, name)
-                proc->second.second->_call(input, output);
-              ELLE_TRACE("%s: procedure %s succeeded", *this, name);
-            }
+            auto const message = sprintf("call to unknown procedure: %s", id);
+            ELLE_TRACE("%s: %s", *this, message);
+            put_error(output, RPCError::Code::unknown_procedure, message, "",
+                      nullptr);
           }
-          catch (elle::reactor::Terminate const&)
+          else if (proc->second.second == nullptr)
           {
-            ELLE_TRACE("%s: terminating as requested", *this);
-            throw;
+            auto const message = sprintf(
+              "remote call to non-local procedure: %s", proc->second.first);
+            ELLE_TRACE("%s: %s", *this, message);
+            put_error(output, RPCError::Code::non_local_procedure, message, "",
+                      nullptr);
           }
-          catch (...)
-          { // Pass exception through handler if present, reply with an error
-            stop_request = handle_exception(handler, output, std::current_exception());
+          else
+          {
+            auto const &name = proc->second.first;
+            ELLE_MEASURE_SCOPE("elle.protocol.RPC.serve");
+
+            ELLE_TRACE("%s: remote procedure called: %s", *this, name)
+              proc->second.second->_call(input, output, chunks);
+            ELLE_TRACE("%s: procedure %s succeeded", *this, name);
           }
-          outs.flush();
-          c.write(answer);
+        }
+        catch (elle::reactor::Terminate const&)
+        {
+          ELLE_TRACE("%s: terminating as requested", *this);
+          throw;
+        }
+        catch (...)
+        { // Pass exception through handler if present, reply with an error
+          stop_request = handle_exception(
+            handler, output, std::current_exception(), backtrace);
+        }
+      }
+      return stop_request;
+    }
+
+    template <typename IS,
+              typename OS>
+    void
+    RPC<IS, OS>::_stream(CallChunks& chunks)
+    {
+      ELLE_LOG_COMPONENT("elle.protocol.RPC");
+
+      if (!chunks.link)
+        return;
+      try
+      {
+        if (chunks.result)
+          chunks.link->send(*chunks.result);
+        chunks.link->drain();
+      }
+      catch (elle::reactor::Terminate const&)
+      {
+        throw;
+      }
+      catch (...)
+      {
+        ELLE_TRACE("%s: streaming call failed: %s",
+                   *this, elle::exception_string());
+      }
+    }
+
+    template <typename IS,
+              typename OS>
+    void
+    RPC<IS, OS>::run(ExceptionHandler handler)
+    {
+      ELLE_LOG_COMPONENT("elle.protocol.RPC");
+
+      bool stop_request = false;
+      try
+      {
+        while (!stop_request)
+        {
+          ELLE_TRACE_SCOPE("%s: Accepting new request...", *this);
+          auto c = std::make_shared<Channel>(this->_channels.accept());
+          elle::Buffer question(c->read());
+          // A late cancellation, for a call that was already answered.
+          if (question.empty())
+            continue;
+          elle::Buffer answer;
+          auto chunks = CallChunks{};
+          stop_request = this->_serve(question, handler, answer, c, {}, chunks);
+          c->write(answer);
+          this->_stream(chunks);
         }
       }
       catch (elle::reactor::network::ConnectionClosed const& e)
@@ -466,98 +806,103 @@ namespace elle
       ELLE_TRACE("%s: end of RPCs: normal exit", *this);
     }
 
-    // XXX: factor with run().
-    // XXX: unsafe, rpc calls must finish in the order they were started,
-    // there is no mechanism to match a rpc call with associated return
     template <typename IS,
               typename OS>
     void
-    RPC<IS, OS>::parallel_run()
+    RPC<IS, OS>::parallel_run(ExceptionHandler handler)
     {
       ELLE_LOG_COMPONENT("elle.protocol.RPC");
 
-      using elle::sprintf;
-      using elle::Exception;
       try
       {
         elle::With<elle::reactor::Scope>("RPC // run") << [&] (elle::reactor::Scope& scope)
         {
-          int i = 0;
-          while (true)
-          {
-            auto chan = std::make_shared<Channel>(this->_channels.accept());
-            ++i;
-
-            auto call_procedure = [&, chan] {
-              ELLE_LOG_COMPONENT("elle.protocol.RPC");
-
-              elle::Buffer question(chan->read());
-              elle::IOStream ins(question.istreambuf());
-              IS input(ins);
-              uint32_t id;
-              input >> id;
-              auto proc = this->_procedures.find(id);
-
-              elle::Buffer answer;
-              elle::IOStream outs(answer.ostreambuf());
-              OS output(outs);
-              try
-              {
-                if (proc == _procedures.end())
-                  throw Exception(sprintf("call to unknown procedure: %s", id));
-                else if (proc->second.second == nullptr)
-                {
-                  throw Exception(sprintf("remote call to non-local procedure: %s",
-                                          proc->second.first));
-                }
-                else
-                {
-                  auto const &name = proc->second.first;
-
-                  ELLE_TRACE("%s: remote procedure called: %s", *this, name)
-                    proc->second.second->_call(input, output);
-                  ELLE_TRACE("%s: procedure %s succeeded", *this, name);
-                }
-              }
-              catch (elle::Error const& e)
+          auto stopping = false;
+          elle::reactor::Thread* accept = nullptr;
+          accept = &scope.run_background(
+            "RPC accept",
+            [&]
+            {
+              while (true)
               {
-                ELLE_TRACE("%s: procedure failed: %s", *this, e.what());
-                output << false;
-                output << std::string(e.what());
-                output << uint16_t(e.backtrace().frames().size());
-                for (auto const& frame: e.backtrace().frames())
+                auto chan = std::make_shared<Channel>(this->_channels.accept());
+                auto call_procedure = [&, chan]
                 {
-                  output << frame.symbol;
-                  output << frame.symbol_mangled;
-                  output << frame.symbol_demangled;
-                  output << frame.address;
-                  output << frame.offset;
-                }
-              }
-              catch (elle::reactor::Terminate const&)
-              {
-                ELLE_TRACE("%s: terminating as requested", *this);
-                throw;
-              }
-              catch (std::exception& e)
-              {
-                ELLE_TRACE("%s: procedure failed: %s", *this, e.what());
-                output << false;
-                output << std::string(e.what());
-                output << uint16_t(0);
+                  ELLE_LOG_COMPONENT("elle.protocol.RPC");
+                  elle::Buffer question(chan->read());
+                  if (question.empty())
+                    return;
+                  // An empty packet on the Channel cancels the call, others
+                  // carry the chunks of streaming calls.
+                  auto& self = *elle::reactor::scheduler().current();
+                  auto done = false;
+                  auto cancelled = false;
+                  elle::reactor::Channel<elle::Buffer> inbox;
+                  elle::reactor::Thread canceller(
+                    elle::sprintf("%s canceller", self.name()),
+                    [&]
+                    {
+                      try
+                      {
+                        while (true)
+                        {
+                          auto packet = chan->read();
+                          if (packet.empty())
+                            break;
+                          inbox.put(std::move(packet));
+                        }
+                      }
+                      catch (elle::Error const&)
+                      {
+                        return;
+                      }
+                      if (!done)
+                      {
+                        ELLE_TRACE("%s: call on %s cancelled by peer",
+                                   *this, *chan);
+                        cancelled = true;
+                        self.terminate();
+                      }
+                    });
+                  elle::Buffer answer;
+                  auto chunks = CallChunks{};
+                  bool stop_request;
+                  try
+                  {
+                    stop_request = this->_serve(
+                      question, handler, answer, chan,
+                      [&] { return inbox.get(); }, chunks);
+                    // Finish streaming calls while the peer can still cancel.
+                    if (chunks.link)
+                    {
+                      chan->write(answer);
+                      this->_stream(chunks);
+                    }
+                  }
+                  catch (elle::reactor::Terminate const&)
+                  {
+                    if (!cancelled)
+                      canceller.terminate_now();
+                    throw;
+                  }
+                  done = true;
+                  canceller.terminate_now();
+                  if (cancelled)
+                    return;
+                  if (!chunks.link)
+                    chan->write(answer);
+                  if (stop_request && !stopping)
+                  {
+                    ELLE_TRACE("%s: stop accepting requests", *this);
+                    stopping = true;
+                    accept->terminate();
+                  }
+                };
+                scope.run_background(elle::sprintf("RPC %s", chan->id()),
+                                     call_procedure);
               }
-              catch (...)
-              {
-                ELLE_TRACE("%s: procedure failed: unknown error", *this);
-                output << false;
-                output << std::string("unknown error");
-                output << uint16_t(0);
-              }
-              outs.flush();
-              chan->write(answer);
-            };
-            scope.run_background(elle::sprintf("RPC %s", i), call_procedure);
-          }
+            });
+          elle::reactor::wait(scope);
         };
       }
       catch (elle::reactor::network::ConnectionClosed const& e)
@@ -565,6 +910,10 @@ namespace elle
         ELLE_TRACE("%s: end of RPCs: connection closed", *this);
         return;
       }
+      catch (elle::reactor::Terminate const&)
+      {
+        throw;
+      }
       catch (elle::Exception& e)
       {
         ELLE_WARN("%s: end of RPCs: %s", *this, e);
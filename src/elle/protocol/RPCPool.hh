@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <elle/Printable.hh>
+#include <elle/Version.hh>
+
+#include <elle/reactor/Barrier.hh>
+#include <elle/reactor/Thread.hh>
+#include <elle/reactor/network/fwd.hh>
+#include <elle/reactor/signal.hh>
+
+#include <elle/protocol/fwd.hh>
+
+namespace elle
+{
+  namespace protocol
+  {
+    /// A pool of connections to the same endpoint, each with its own RPC.
+    ///
+    /// Keep `size` connections open, each with a Serializer, a ChanneledStream
+    /// and an @a R, and run every call on the least loaded of the ready ones:
+    /// a connection that stalls piles up calls and stops getting new ones.
+    ///
+    /// Every connection is kept alive by a Thread that reconnects with an
+    /// exponential reactor::Backoff when it breaks. A connection breaks when
+    /// reading from it fails, when a call on it fails with a
+    /// reactor::network::Error or, given a ping period and timeout, when the
+    /// peer misses a pong. It is torn down once the calls in flight on it are
+    /// over. A call that failed before its connection wrote anything is
+    /// retried on another one: the peer cannot have run it. Other failed
+    /// calls are not retried, as they may have run.
+    ///
+    /// @code{.cc}
+    ///
+    /// auto pool = elle::protocol::RPCPool<MyRPC>(
+    ///   [] { return std::make_unique<TCPSocket>("server", 4242); }, 4);
+    /// auto res = pool.call([] (MyRPC& rpc) { return rpc.lookup("key"); });
+    ///
+    /// @endcode
+    ///
+    /// @tparam R The RPC class, constructible from a ChanneledStream.
+    template <typename R>
+    class RPCPool
+      : public elle::Printable
+      , public boost::noncopyable
+    {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      using Self = RPCPool<R>;
+      /// Open a new connection to the endpoint, e.g. a
+      /// reactor::network::Socket or a reactor::network::UTPSocket.
+      using Connect = std::function<std::unique_ptr<std::iostream> ()>;
+      /// Configure a new connection, its ChanneledStream and its RPC.
+      using Setup = std::function<void (ChanneledStream&, R&)>;
+      using Duration = std::chrono::milliseconds;
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Open connections in the background.
+      ///
+      /// @param connect How to open a connection.
+      /// @param size The number of connections.
+      /// @param version The protocol version, at least 0.3.0 for pings.
+      /// @param checksum Whether packets are checksummed.
+      /// @param ping_period How often to check connections, if ever.
+      /// @param ping_timeout How long a pong may take before the connection
+      ///                     is deemed broken.
+      /// @param setup Configure every new connection.
+      RPCPool(Connect connect,
+              int size,
+              elle::Version version = elle::Version(0, 1, 0),
+              bool checksum = true,
+              boost::optional<Duration> ping_period = {},
+              boost::optional<Duration> ping_timeout = {},
+              Setup setup = {});
+      /// Close every connection. No call must be in flight.
+      ~RPCPool();
+
+    /*------.
+    | Calls |
+    `------*/
+    public:
+      /// Run @a f with the RPC of the least loaded ready connection.
+      ///
+      /// Wait for a connection to be ready if none is. Run @a f again on
+      /// another connection if it failed before anything was written.
+      ///
+      /// @returns What @a f returns.
+      template <typename F>
+      auto
+      call(F const& f) -> decltype(f(std::declval<R&>()));
+      /// Number of connections ready for calls.
+      int
+      ready() const;
+      /// Minimum and maximum delays between reconnection attempts.
+      ELLE_ATTRIBUTE_RW(Duration, backoff_min);
+      ELLE_ATTRIBUTE_RW(Duration, backoff_max);
+
+    /*------------.
+    | Connections |
+    `------------*/
+    private:
+      struct Connection;
+      /// Keep @a c connected, forever.
+      void
+      _keep(Connection& c);
+      void
+      _break(Connection& c);
+      ELLE_ATTRIBUTE(Connect, connect);
+      ELLE_ATTRIBUTE(elle::Version, version);
+      ELLE_ATTRIBUTE(bool, checksum);
+      ELLE_ATTRIBUTE(boost::optional<Duration>, ping_period);
+      ELLE_ATTRIBUTE(boost::optional<Duration>, ping_timeout);
+      ELLE_ATTRIBUTE(Setup, setup);
+      ELLE_ATTRIBUTE(std::vector<std::unique_ptr<Connection>>, connections);
+      /// Signaled when a connection gets ready.
+      ELLE_ATTRIBUTE(reactor::Signal, connected);
+
+    /*----------.
+    | Printable |
+    `----------*/
+    public:
+      void
+      print(std::ostream& stream) const override;
+    };
+  }
+}
+
+#include <elle/protocol/RPCPool.hxx>
@@ -0,0 +1,264 @@
+#include <algorithm>
+
+#include <boost/signals2/connection.hpp>
+
+#include <elle/finally.hh>
+#include <elle/log.hh>
+#include <elle/printf.hh>
+
+#include <elle/reactor/Backoff.hh>
+#include <elle/reactor/network/Error.hh>
+#include <elle/reactor/network/socket.hh>
+#include <elle/reactor/network/utp-socket.hh>
+#include <elle/reactor/scheduler.hh>
+
+#include <elle/protocol/ChanneledStream.hh>
+#include <elle/protocol/Serializer.hh>
+
+namespace elle
+{
+  namespace protocol
+  {
+    template <typename R>
+    struct RPCPool<R>::Connection
+    {
+      int index;
+      std::unique_ptr<std::iostream> stream;
+      std::unique_ptr<Serializer> serializer;
+      std::unique_ptr<ChanneledStream> channels;
+      std::unique_ptr<R> rpc;
+      /// Whether it accepts new calls.
+      bool ready = false;
+      /// Calls in flight.
+      int load = 0;
+      /// Signaled when the last call in flight is over.
+      reactor::Signal idle;
+      /// Opened when it must be reconnected.
+      reactor::Barrier broken;
+      boost::signals2::scoped_connection ping_timeout;
+      boost::signals2::scoped_connection read_failed;
+      reactor::Thread::unique_ptr keeper;
+    };
+
+    namespace _details
+    {
+      /// Close @a stream, if it is a kind of socket, so whoever is reading
+      /// or writing it fails.
+      inline
+      void
+      close(std::iostream& stream)
+      {
+        if (auto socket = dynamic_cast<reactor::network::Socket*>(&stream))
+          socket->close();
+        else if (auto socket =
+                 dynamic_cast<reactor::network::UTPSocket*>(&stream))
+          socket->close();
+      }
+    }
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    template <typename R>
+    RPCPool<R>::RPCPool(Connect connect,
+                        int size,
+                        elle::Version version,
+                        bool checksum,
+                        boost::optional<Duration> ping_period,
+                        boost::optional<Duration> ping_timeout,
+                        Setup setup)
+      : _backoff_min(std::chrono::milliseconds(100))
+      , _backoff_max(std::chrono::seconds(10))
+      , _connect(std::move(connect))
+      , _version(std::move(version))
+      , _checksum(checksum)
+      , _ping_period(std::move(ping_period))
+      , _ping_timeout(std::move(ping_timeout))
+      , _setup(std::move(setup))
+    {
+      for (int i = 0; i < size; ++i)
+      {
+        this->_connections.emplace_back(std::make_unique<Connection>());
+        auto& c = *this->_connections.back();
+        c.index = i;
+        c.keeper.reset(
+          new reactor::Thread(elle::sprintf("%s connection %s", *this, i),
+                              [this, &c] { this->_keep(c); }));
+      }
+    }
+
+    template <typename R>
+    RPCPool<R>::~RPCPool()
+    {
+      for (auto& c: this->_connections)
+        c->keeper->terminate_now();
+      for (auto& c: this->_connections)
+      {
+        ELLE_ASSERT_EQ(c->load, 0);
+        c->ping_timeout.disconnect();
+        c->read_failed.disconnect();
+        c->rpc.reset();
+        c->channels.reset();
+        c->serializer.reset();
+        c->stream.reset();
+      }
+    }
+
+    /*------.
+    | Calls |
+    `------*/
+
+    template <typename R>
+    template <typename F>
+    auto
+    RPCPool<R>::call(F const& f) -> decltype(f(std::declval<R&>()))
+    {
+      ELLE_LOG_COMPONENT("elle.protocol.RPCPool");
+      while (true)
+      {
+        Connection* c = nullptr;
+        while (true)
+        {
+          for (auto& candidate: this->_connections)
+            if (candidate->ready && (!c || candidate->load < c->load))
+              c = candidate.get();
+          if (c)
+            break;
+          ELLE_TRACE("%s: wait for a connection", *this);
+          reactor::wait(this->_connected);
+        }
+        ELLE_DEBUG("%s: call on connection %s, %s calls in flight",
+                   *this, c->index, c->load);
+        ++c->load;
+        elle::SafeFinally done(
+          [c]
+          {
+            if (--c->load == 0)
+              c->idle.signal();
+          });
+        auto const written = c->channels->written();
+        try
+        {
+          return f(*c->rpc);
+        }
+        catch (reactor::network::Error const& e)
+        {
+          ELLE_TRACE("%s: connection %s failed: %s", *this, c->index, e);
+          this->_break(*c);
+          if (c->channels->written() != written)
+            throw;
+          ELLE_TRACE("%s: nothing was written, retry", *this);
+        }
+      }
+    }
+
+    template <typename R>
+    int
+    RPCPool<R>::ready() const
+    {
+      return std::count_if(
+        this->_connections.begin(), this->_connections.end(),
+        [] (std::unique_ptr<Connection> const& c) { return c->ready; });
+    }
+
+    /*------------.
+    | Connections |
+    `------------*/
+
+    template <typename R>
+    void
+    RPCPool<R>::_keep(Connection& c)
+    {
+      ELLE_LOG_COMPONENT("elle.protocol.RPCPool");
+      auto backoff = std::make_unique<reactor::Backoff>(
+        this->_backoff_min, this->_backoff_max);
+      while (true)
+      {
+        try
+        {
+          ELLE_TRACE_SCOPE("%s: open connection %s", *this, c.index);
+          c.stream = this->_connect();
+          c.serializer = std::make_unique<Serializer>(
+            *c.stream, this->_version, this->_checksum,
+            this->_ping_period, this->_ping_timeout);
+          c.ping_timeout = c.serializer->ping_timeout().connect(
+            [this, &c]
+            {
+              ELLE_LOG_COMPONENT("elle.protocol.RPCPool");
+              ELLE_TRACE("%s: connection %s missed a pong", *this, c.index);
+              this->_break(c);
+            });
+          c.channels = std::make_unique<ChanneledStream>(*c.serializer);
+          c.read_failed = c.channels->read_failed().connect(
+            [this, &c]
+            {
+              ELLE_LOG_COMPONENT("elle.protocol.RPCPool");
+              ELLE_TRACE("%s: connection %s dropped", *this, c.index);
+              this->_break(c);
+            });
+          c.rpc = std::make_unique<R>(*c.channels);
+          if (this->_setup)
+            this->_setup(*c.channels, *c.rpc);
+        }
+        catch (elle::Error const& e)
+        {
+          ELLE_TRACE("%s: unable to open connection %s: %s",
+                     *this, c.index, e);
+          c.ping_timeout.disconnect();
+          c.read_failed.disconnect();
+          c.rpc.reset();
+          c.channels.reset();
+          c.serializer.reset();
+          c.stream.reset();
+          backoff->backoff();
+          continue;
+        }
+        backoff = std::make_unique<reactor::Backoff>(
+          this->_backoff_min, this->_backoff_max);
+        c.ready = true;
+        this->_connected.signal();
+        reactor::wait(c.broken);
+        ELLE_TRACE_SCOPE("%s: close connection %s", *this, c.index);
+        c.ready = false;
+        c.read_failed.disconnect();
+        try
+        {
+          _details::close(*c.stream);
+        }
+        catch (elle::Error const& e)
+        {
+          ELLE_DEBUG("error closing connection: %s", e);
+        }
+        // Calls in flight fail with the closed socket.
+        while (c.load)
+          reactor::wait(c.idle);
+        c.ping_timeout.disconnect();
+        c.rpc.reset();
+        c.channels.reset();
+        c.serializer.reset();
+        c.stream.reset();
+        c.broken.close();
+      }
+    }
+
+    template <typename R>
+    void
+    RPCPool<R>::_break(Connection& c)
+    {
+      c.ready = false;
+      c.broken.open();
+    }
+
+    /*----------.
+    | Printable |
+    `----------*/
+
+    template <typename R>
+    void
+    RPCPool<R>::print(std::ostream& stream) const
+    {
+      elle::fprintf(stream, "RPCPool(%x)", (void*)this);
+    }
+  }
+}
@@ -4,8 +4,14 @@
 # include <arpa/inet.h>
 #endif
 
+#include <cstring>
+#include <limits>
+
 #include <elle/Buffer.hh>
+#include <elle/crc32c.hh>
+#include <elle/format/deflate.hh>
 #include <elle/log.hh>
+#include <elle/metrics.hh>
 
 #include <elle/cryptography/hash.hh>
 
@@ -42,8 +48,8 @@ namespace elle
          uint32_t size,
          uint32_t offset = 0)
     {
-      ELLE_DEBUG_SCOPE("read %s bytes from %s at offset %s",
-                       size, stream, offset);
+      ELLE_DUMP_SCOPE("read %s bytes from %s at offset %s",
+                      size, stream, offset);
       // read the full packet even if terminated to keep the stream
       // in a consistent state
       int nread = 0;
@@ -51,7 +57,6 @@ namespace elle
       while (nread < signed(size))
       {
         char* where = beginning + nread;
-        ELLE_DUMP_SCOPE("read from %s", nread);
         elle::IOStreamClear clearer(stream);
         nread += std::readsome(stream, where, size - nread);
         if (stream.eof())
@@ -59,21 +64,6 @@ namespace elle
       }
     }
 
-    static
-    elle::Buffer
-    read(std::istream& stream,
-         elle::Version const& version,
-         boost::optional<uint32_t> size = boost::none)
-    {
-      ELLE_DEBUG_SCOPE("read %s (size: %s)", stream, size);
-      if (!size)
-        size = Serializer::Super::uint32_get(stream, version);
-      ELLE_DUMP("expected size: %s", *size);
-      elle::Buffer content(*size);
-      read(stream, content, *size);
-      return content;
-    }
-
     // Return the sha1 of a given buffer.
     static
     elle::Buffer
@@ -88,6 +78,24 @@ namespace elle
       return hash;
     }
 
+    // Return the sha1 of the concatenation of the given buffers.
+    static
+    elle::Buffer
+    compute_checksum(Serializer::Buffers const& content)
+    {
+      auto it = content.begin();
+      auto hash = elle::cryptography::hash(
+        [&] () -> elle::ConstWeakBuffer
+        {
+          if (it == content.end())
+            return {};
+          return *it++;
+        },
+        elle::cryptography::Oneway::sha1);
+      ELLE_DUMP("checksum: '%x'", hash);
+      return hash;
+    }
+
     // Make sure the given buffer checksum match the given checksum.
     static
     void
@@ -105,21 +113,50 @@ namespace elle
       }
     }
 
+    // Decode a big endian uint32_t, used for the CRC-32C sent after the
+    // packet since 0.4.0, for sizes before 0.3.0 and for the raw size of
+    // compressed packets since 0.5.0.
+    static
+    uint32_t
+    big_endian(elle::Buffer::Byte const* bytes)
+    {
+      return
+        uint32_t(bytes[0]) << 24 | uint32_t(bytes[1]) << 16 |
+        uint32_t(bytes[2]) << 8 | uint32_t(bytes[3]);
+    }
+
+    // Append a big endian uint32_t, as decoded by big_endian.
     static
     void
-    write(std::ostream& stream,
-          elle::Version const& version,
-          elle::Buffer const& content,
-          bool write_size = true,
-          elle::Buffer::Size offset = 0,
-          boost::optional<elle::Buffer::Size> size = boost::none)
+    big_endian(elle::Buffer& buffer, uint32_t value)
     {
-      elle::Buffer::Size to_send = size ? size.get() : content.size();
-      if (write_size)
-        Serializer::Super::uint32_put(stream, to_send, version);
-      stream.write(
-        reinterpret_cast<char*>(content.mutable_contents()) + offset,
-        to_send);
+      char const bytes[] = {
+        char(value >> 24), char(value >> 16), char(value >> 8), char(value)};
+      buffer.append(bytes, sizeof bytes);
+    }
+
+    // Append to res the pieces of packet covering size bytes from offset.
+    static
+    void
+    slice(Serializer::Buffers const& packet,
+          elle::Buffer::Size offset,
+          elle::Buffer::Size size,
+          Serializer::Buffers& res)
+    {
+      for (auto const& b: packet)
+      {
+        if (!size)
+          break;
+        if (offset >= b.size())
+        {
+          offset -= b.size();
+          continue;
+        }
+        auto const n = std::min(b.size() - offset, size);
+        res.emplace_back(b.contents() + offset, n);
+        offset = 0;
+        size -= n;
+      }
     }
 
     enum Control: unsigned char
@@ -132,12 +169,193 @@ namespace elle
       max = pong,
     };
 
+    // Leading byte of packets once compression is agreed on. Compressed
+    // packets follow it with their raw size, as a big endian uint32_t.
+    enum Packing: unsigned char
+    {
+      raw = 0,
+      compressed = 1,
+    };
+
+    // Input through a std::istream.
+    class StreamInput
+    {
+    public:
+      StreamInput(std::istream& stream)
+        : _stream(stream)
+      {}
+
+      unsigned char
+      byte()
+      {
+        if (this->_stream.peek() == std::iostream::traits_type::eof())
+          throw Serializer::EOF();
+        char c = 0;
+        this->_stream.read(&c, 1);
+        return static_cast<unsigned char>(c);
+      }
+
+      uint32_t
+      uint32(elle::Version const& version)
+      {
+        return Serializer::Super::uint32_get(this->_stream, version);
+      }
+
+      void
+      read(elle::Buffer& content, uint32_t size, uint32_t offset = 0)
+      {
+        elle::protocol::read(this->_stream, content, size, offset);
+      }
+
+    private:
+      std::istream& _stream;
+    };
+
+    // Input straight from a socket, bypassing its std::istream: bytes are
+    // parsed from a receive buffer reused for the lifetime of the Serializer
+    // and large reads land directly at their destination.
+    //
+    // Bytes buffered ahead are lost with the input.
+    class SocketInput
+    {
+    public:
+      SocketInput(std::istream& stream, reactor::network::Socket& socket)
+        : _socket(socket)
+        , _buffer(reactor::network::Socket::buffer_size)
+        , _begin(0)
+        , _end(0)
+      {
+        // Take over whatever the stream read ahead, e.g. while negotiating
+        // the version.
+        auto const available = stream.rdbuf()->in_avail();
+        if (available > 0)
+        {
+          if (elle::Buffer::Size(available) > this->_buffer.size())
+            this->_buffer.size(available);
+          this->_end = stream.readsome(
+            reinterpret_cast<char*>(this->_buffer.mutable_contents()),
+            available);
+        }
+      }
+
+      unsigned char
+      byte()
+      {
+        if (this->_begin == this->_end)
+          this->_fill();
+        return this->_buffer[this->_begin++];
+      }
+
+      uint32_t
+      uint32(elle::Version const& version)
+      {
+        if (version >= elle::Version(0, 3, 0))
+        {
+          // See serialization::binary::SerializerIn::serialize_number.
+          auto const c = this->byte();
+          int64_t value = 0;
+          if (!(c & 0x40))
+            value = c & 0x3f;
+          else if (!(c & 0x20))
+            value = ((c & 0x1f) << 8) + this->byte();
+          else if (!(c & 0x10))
+          {
+            auto const c2 = this->byte();
+            auto const c3 = this->byte();
+            value = ((c & 0x0f) << 16) + (c2 << 8) + c3;
+          }
+          else
+            this->_read(reinterpret_cast<elle::Buffer::Byte*>(&value), 8);
+          if (c & 0x80)
+            value = -value;
+          if (value < 0 || std::numeric_limits<uint32_t>::max() < value)
+            elle::err<Error>("unexpected uint32_t: %s", value);
+          return uint32_t(value);
+        }
+        else
+        {
+          elle::Buffer::Byte bytes[4];
+          this->_read(bytes, 4);
+          return big_endian(bytes);
+        }
+      }
+
+      void
+      read(elle::Buffer& content, uint32_t size, uint32_t offset = 0)
+      {
+        ELLE_DUMP("read %s bytes at offset %s", size, offset);
+        this->_read(content.mutable_contents() + offset, size);
+      }
+
+    private:
+      void
+      _read(elle::Buffer::Byte* data, elle::Buffer::Size size)
+      {
+        while (size)
+        {
+          if (this->_begin == this->_end)
+          {
+            // Spare a copy of large reads.
+            if (size >= this->_buffer.size() / 2)
+            {
+              this->_socket.read(elle::WeakBuffer(data, size));
+              return;
+            }
+            this->_fill();
+          }
+          auto const n = std::min(size, this->_end - this->_begin);
+          std::memcpy(data, this->_buffer.contents() + this->_begin, n);
+          this->_begin += n;
+          data += n;
+          size -= n;
+        }
+      }
+
+      void
+      _fill()
+      {
+        this->_begin = this->_end = 0;
+        int read = 0;
+        try
+        {
+          this->_end = this->_socket.read_some(
+            elle::WeakBuffer(this->_buffer.mutable_contents(),
+                             this->_buffer.size()),
+            {}, &read);
+        }
+        catch (...)
+        {
+          // Keep what was received before the error.
+          this->_end = read;
+          throw;
+        }
+      }
+
+      reactor::network::Socket& _socket;
+      elle::Buffer _buffer;
+      elle::Buffer::Size _begin;
+      elle::Buffer::Size _end;
+    };
+
+    template <typename Input>
+    static
+    elle::Buffer
+    read(Input& input, elle::Version const& version)
+    {
+      auto const size = input.uint32(version);
+      ELLE_DUMP("expected size: %s", size);
+      elle::Buffer content(size);
+      input.read(content, size);
+      return content;
+    }
+
+    template <typename Input>
     static
     void
-    ignore_message(std::istream& stream, elle::Version const& version)
+    ignore_message(Input& input, elle::Version const& version)
     {
       // Version 0.2.0 handle but ignores messages.
-      auto res = elle::protocol::read(stream, version);
+      auto res = elle::protocol::read(input, version);
       ELLE_WARN("%f was ignored", res);
     }
 
@@ -149,7 +367,9 @@ namespace elle
            bool checksum,
            elle::Version const& version,
            boost::optional<std::chrono::milliseconds> ping_period,
-           boost::optional<std::chrono::milliseconds> ping_timeout)
+           boost::optional<std::chrono::milliseconds> ping_timeout,
+           Compression::Algorithm algorithm,
+           Compression const& compression)
         : _broken(false)
         , _scheduler(reactor::scheduler())
         , _pings(0)
@@ -172,12 +392,26 @@ namespace elle
             }
           })
         , _stream(stream)
+        , _socket(dynamic_cast<reactor::network::Socket*>(&stream))
+        , _stream_input(stream)
+        , _socket_input(this->_socket
+                        ? std::make_unique<SocketInput>(stream, *this->_socket)
+                        : nullptr)
         , _chunk_size(chunk_size)
         , _checksum(checksum)
         , _version(version)
         , _lock_write()
         , _lock_read()
+        , _threshold(compression.threshold)
       {
+        if (algorithm == Compression::Algorithm::deflate)
+        {
+          this->_compressor = std::make_unique<format::deflate::Compressor>(
+            compression.level, compression.dictionary);
+          this->_decompressor =
+            std::make_unique<format::deflate::Decompressor>(
+              compression.dictionary);
+        }
         if (bool(this->_ping_period) != bool(this->_ping_delay))
           elle::err("specify either both ping period and timeout or neither");
         if (this->_ping_period && this->version() >= elle::Version(0, 3, 0))
@@ -201,7 +435,12 @@ namespace elle
             if (this->_broken)
               elle::err("stream is broken by a previous interrupted read");
             elle::IOStreamClear clearer(this->_stream);
-            return this->_read();
+            auto packet = this->_socket_input
+              ? this->_read(*this->_socket_input)
+              : this->_read(this->_stream_input);
+            if (this->_decompressor)
+              return this->_decompress(std::move(packet));
+            return packet;
           }
           catch (InterruptionError const&)
           {}
@@ -211,56 +450,77 @@ namespace elle
       /// Whether the stream is broken by a previous interrupted read.
       ELLE_ATTRIBUTE_R(bool, broken);
 
+      template <typename Input>
       elle::Buffer
-      _read()
+      _read(Input& input)
       {
         if (this->version() >= elle::Version(0, 3, 0))
-          while (!this->read_control())
+          while (!this->read_control(input))
             ;
         try
         {
         // return elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
         // {
+          // Since 0.4.0, a CRC-32C of the packet is computed as chunks are
+          // read and checked against the one sent after the last chunk.
+          auto const crc = this->_checksum &&
+            this->version() >= elle::Version(0, 4, 0);
           elle::Buffer hash;
-          if (this->_checksum)
+          if (this->_checksum && !crc)
           {
             ELLE_DEBUG("read checksum")
               if (this->version() >= elle::Version(0, 2, 0))
-                hash = elle::protocol::read(this->_stream, this->version(), {});
+                hash = elle::protocol::read(input, this->version());
               else
-                hash = elle::protocol::read(this->_stream, {});
+                hash = elle::protocol::read(input, elle::Version());
           }
           auto packet = [&]
           {
             if (this->version() >= elle::Version(0, 2, 0))
             {
               // Get the total size.
-              uint32_t total_size =
-                Serializer::Super::uint32_get(this->_stream, this->version());
+              uint32_t total_size = input.uint32(this->version());
               ELLE_DEBUG("packet size: %s", total_size);
               elle::Buffer packet(static_cast<std::size_t>(total_size));
               elle::Buffer::Size offset = 0;
+              uint32_t checksum = 0;
               while (true)
               {
                 uint32_t size =
                   std::min(total_size - offset, this->_chunk_size);
-                ELLE_DEBUG("read chunk of size %s", size);
-                elle::protocol::read(this->_stream, packet, size, offset);
+                ELLE_DUMP("read chunk of size %s", size);
+                input.read(packet, size, offset);
+                if (crc)
+                  checksum =
+                    elle::crc32c(packet.contents() + offset, size, checksum);
                 offset += size;
                 ELLE_ASSERT_LTE(offset, total_size);
                 if (offset >= total_size)
                   break;
-                if (!this->read_control())
+                if (!this->read_control(input))
                   throw InterruptionError();
               }
+              if (crc)
+              {
+                auto crc = elle::Buffer(4);
+                input.read(crc, 4);
+                auto const expected = big_endian(crc.contents());
+                ELLE_DUMP("checksum: 0x%08x, expected 0x%08x",
+                          checksum, expected);
+                if (checksum != expected)
+                {
+                  ELLE_ERR("wrong packet checksum")
+                    throw ChecksumError();
+                }
+              }
               return packet;
             }
             else
-              return elle::protocol::read(this->_stream, {});
+              return elle::protocol::read(input, elle::Version());
           }();
           ELLE_DUMP("packet content: %s", packet);
           // Check checksums match.
-          if (this->_checksum)
+          if (this->_checksum && !crc)
             enforce_checksums_equal(packet, hash);
           return packet;
         }
@@ -278,11 +538,95 @@ namespace elle
       }
 
       void
-      write(elle::Buffer const& packet)
+      write(Buffers const& packet)
       {
-        elle::reactor::Lock lock(this->_lock_write);
-        elle::IOStreamClear clearer(this->_stream);
-        this->_write(packet);
+        if (this->_compressor)
+        {
+          auto header = elle::Buffer{};
+          auto compressed = elle::Buffer{};
+          auto packed = this->_compress(packet, header, compressed);
+          elle::reactor::Lock lock(this->_lock_write);
+          elle::IOStreamClear clearer(this->_stream);
+          this->_write(packed);
+        }
+        else
+        {
+          elle::reactor::Lock lock(this->_lock_write);
+          elle::IOStreamClear clearer(this->_stream);
+          this->_write(packet);
+        }
+      }
+
+      /// Prefix @a packet with its Packing, compressing it if worth it.
+      ///
+      /// @param header Storage for the prefix.
+      /// @param compressed Storage for the compressed packet.
+      /// @returns The packet to send, referring to the storages.
+      Buffers
+      _compress(Buffers const& packet,
+                elle::Buffer& header,
+                elle::Buffer& compressed)
+      {
+        auto size = elle::Buffer::Size(0);
+        for (auto const& b: packet)
+          size += b.size();
+        if (size >= this->_threshold)
+        {
+          static auto& raw = elle::metrics::counter(
+            "elle.protocol.Serializer.compression.raw");
+          static auto& sent = elle::metrics::counter(
+            "elle.protocol.Serializer.compression.sent");
+          static auto& duration = elle::metrics::histogram(
+            "elle.protocol.Serializer.compression.compress");
+          auto const start = std::chrono::steady_clock::now();
+          compressed = this->_compressor->compress(packet);
+          duration.record(std::chrono::steady_clock::now() - start);
+          raw.increment(size);
+          // Incompressible packets are sent raw, at the cost of one byte.
+          if (compressed.size() + 4 < size)
+          {
+            ELLE_DEBUG("compressed %s bytes to %s", size, compressed.size());
+            sent.increment(1 + 4 + compressed.size());
+            char const packing = Packing::compressed;
+            header.append(&packing, 1);
+            big_endian(header, size);
+            return Buffers{header, compressed};
+          }
+          sent.increment(1 + size);
+        }
+        static unsigned char const packing = Packing::raw;
+        auto res = Buffers{elle::ConstWeakBuffer(&packing, 1)};
+        res.insert(res.end(), packet.begin(), packet.end());
+        return res;
+      }
+
+      /// Strip the Packing of @a packet, decompressing it if needed.
+      elle::Buffer
+      _decompress(elle::Buffer packet)
+      {
+        if (packet.empty())
+          elle::err<Error>("missing packing byte");
+        switch (packet[0])
+        {
+          case Packing::raw:
+            packet.pop_front();
+            return packet;
+          case Packing::compressed:
+          {
+            if (packet.size() < 5)
+              elle::err<Error>("truncated compressed packet");
+            static auto& duration = elle::metrics::histogram(
+              "elle.protocol.Serializer.compression.decompress");
+            auto const start = std::chrono::steady_clock::now();
+            auto res = this->_decompressor->decompress(
+              elle::ConstWeakBuffer(packet.contents() + 5, packet.size() - 5),
+              big_endian(packet.contents() + 1));
+            duration.record(std::chrono::steady_clock::now() - start);
+            return res;
+          }
+          default:
+            elle::err<Error>("invalid packing byte: 0x%x", int(packet[0]));
+        }
       }
 
       void
@@ -315,16 +659,13 @@ namespace elle
         }
       }
 
+      template <typename Input>
       bool
-      read_control()
+      read_control(Input& input)
       {
         while (true)
         {
-          ELLE_DUMP_SCOPE("read control");
-          if (this->_stream.peek() == std::iostream::traits_type::eof())
-            throw Serializer::EOF();
-          char control = static_cast<char>(Control::max + 1);
-          this->_stream.read(&control, 1);
+          auto const control = input.byte();
           if (control > Control::max)
           {
             ELLE_ERR("%s: invalid control byte: 0x%x",
@@ -341,7 +682,7 @@ namespace elle
             case Control::interrupt:
               return false;
             case Control::message:
-              ignore_message(this->_stream, this->version());
+              ignore_message(input, this->version());
               break;
             case Control::ping:
               this->pinged();
@@ -401,66 +742,106 @@ namespace elle
       ELLE_ATTRIBUTE(std::list<Timer>, ping_timers);
       ELLE_ATTRIBUTE_RX(boost::signals2::signal<void ()>, ping_timeout);
 
+      /// Write @a buffers and flush them.
+      ///
+      /// Sockets get them with a single gather write, other streams through
+      /// their stream buffer.
       void
-      _write(elle::Buffer const& packet)
+      _send(Buffers const& buffers)
       {
+        if (this->_socket)
+        {
+          // Controls may be pending in the stream buffer.
+          this->_stream.flush();
+          this->_socket->writev(buffers);
+        }
+        else
+        {
+          for (auto const& b: buffers)
+            this->_stream.write(
+              reinterpret_cast<char const*>(b.contents()), b.size());
+          this->_stream.flush();
+        }
+      }
+
+      void
+      _write(Buffers const& packet)
+      {
+        auto size = elle::Buffer::Size(0);
+        for (auto const& b: packet)
+          size += b.size();
+        // Since 0.4.0, a CRC-32C of the packet is computed as chunks are sent
+        // and sent after the last one, instead of a SHA-1 sent ahead.
+        auto const crc = this->_checksum &&
+          this->version() >= elle::Version(0, 4, 0);
+        // Everything preceding the first chunk: control, checksum and size.
+        auto header = elle::Buffer{};
         if (this->version() >= elle::Version(0, 3, 0))
-          this->write_control(Control::keep_going);
-        if (this->_checksum)
         {
-          // Compute and send checksum.
+          this->write_pings_pongs(false);
+          char const control = Control::keep_going;
+          header.append(&control, 1);
+        }
+        if (this->_checksum && !crc)
+        {
           auto hash = compute_checksum(packet);
-          elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
-          {
-            ELLE_DEBUG("send checksum: 0x%x", hash)
-              elle::protocol::write(this->_stream, this->version(), hash);
-          };
+          ELLE_DEBUG("send checksum: 0x%x", hash);
+          Serializer::Super::uint32_put(header, hash.size(), this->version());
+          header.append(hash.contents(), hash.size());
         }
+        ELLE_DEBUG("send packet size %s", size);
+        Serializer::Super::uint32_put(header, size, this->version());
         if (this->version() >= elle::Version(0, 2, 0))
         {
           elle::Buffer::Size offset = 0;
+          uint32_t checksum = 0;
+          auto trailer = elle::Buffer{};
           try
           {
-            auto send = [&]
+            auto send = [&] (elle::ConstWeakBuffer header)
               {
-                auto to_send = std::min(this->_chunk_size, packet.size() - offset);
+                auto to_send = std::min(this->_chunk_size, size - offset);
                 ELLE_DEBUG_SCOPE("send %s bytes of data at offset %s",
                                  to_send, offset);
-                elle::protocol::write(
-                  this->_stream,
-                  this->version(), packet, false, offset, to_send);
+                auto buffers = Buffers{header};
+                slice(packet, offset, to_send, buffers);
+                if (crc)
+                  for (auto it = buffers.begin() + 1; it != buffers.end(); ++it)
+                    checksum = elle::crc32c(*it, checksum);
                 offset += to_send;
-                this->_stream.flush();
-              };
-            {
-              elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
-              {
-                // Send the size.
+                // The checksum must follow the last chunk uninterrupted.
+                if (crc && offset == size)
                 {
-                  auto size = packet.size();
-                  ELLE_DEBUG("send packet size %s", size)
-                    Serializer::Super::uint32_put(this->_stream, size, this->version());
+                  ELLE_DEBUG("send checksum: 0x%08x", checksum)
+                  {
+                    big_endian(trailer, checksum);
+                    buffers.emplace_back(trailer);
+                  }
                 }
-                // Send first chunk
-                send();
+                this->_send(buffers);
               };
-            }
-            while (offset < packet.size())
+            // Send the size and the first chunk.
+            elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
+            {
+              send(header);
+            };
+            while (offset < size)
             {
               elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
               {
-                this->write_control(Control::keep_going);
-                send();
+                this->write_pings_pongs(false);
+                char const control = Control::keep_going;
+                send(elle::ConstWeakBuffer(&control, 1));
               };
               this->write_pings_pongs(true);
             }
           }
           catch (elle::reactor::Terminate const&)
           {
-            if (offset < packet.size())
+            if (offset < size)
             {
               ELLE_DEBUG("interrupted after sending %s bytes over %s",
-                         offset, packet.size());
+                         offset, size);
               this->write_control(Control::interrupt);
               this->write_pings_pongs(true);
             }
@@ -473,17 +854,28 @@ namespace elle
           elle::With<elle::reactor::Thread::NonInterruptible>() << [&]
           {
             ELLE_DEBUG("send actual data")
-              elle::protocol::write(this->_stream, this->version(), packet);
-            this->_stream.flush();
+            {
+              auto buffers = Buffers{header};
+              buffers.insert(buffers.end(), packet.begin(), packet.end());
+              this->_send(buffers);
+            }
           };
       }
     private:
       ELLE_ATTRIBUTE_RX(std::iostream&, stream, protected);
+      /// The stream as a socket, to read from and write to it directly.
+      ELLE_ATTRIBUTE(reactor::network::Socket*, socket, protected);
+      ELLE_ATTRIBUTE(StreamInput, stream_input);
+      ELLE_ATTRIBUTE(std::unique_ptr<SocketInput>, socket_input);
       ELLE_ATTRIBUTE(elle::Buffer::Size, chunk_size, protected);
       ELLE_ATTRIBUTE(bool, checksum, protected);
       ELLE_ATTRIBUTE_R(elle::Version, version);
       ELLE_ATTRIBUTE(elle::reactor::Mutex, lock_write, protected);
       ELLE_ATTRIBUTE(elle::reactor::Mutex, lock_read, protected);
+      ELLE_ATTRIBUTE(elle::Buffer::Size, threshold);
+      ELLE_ATTRIBUTE(std::unique_ptr<format::deflate::Compressor>, compressor);
+      ELLE_ATTRIBUTE(std::unique_ptr<format::deflate::Decompressor>,
+                     decompressor);
     };
 
     /*------.
@@ -504,12 +896,14 @@ namespace elle
       bool checksum,
       boost::optional<std::chrono::milliseconds> ping_period,
       boost::optional<std::chrono::milliseconds> ping_timeout,
-      elle::Buffer::Size chunk_size)
+      elle::Buffer::Size chunk_size,
+      Compression compression)
       : Super(*elle::reactor::Scheduler::scheduler())
       , _stream(stream)
       , _version(version)
       , _chunk_size(chunk_size)
       , _checksum(checksum)
+      , _compression(Compression::Algorithm::none)
     {
       if (this->version() >= elle::Version(0, 2, 0))
       {
@@ -526,9 +920,31 @@ namespace elle
         }
       }
       ELLE_TRACE("using version: '%s'", this->version());
+      if (this->version() >= elle::Version(0, 5, 0))
+      {
+        ELLE_TRACE("%s: negotiate compression", *this)
+        {
+          auto local = elle::Buffer{};
+          local.append(&compression.algorithm, 1);
+          big_endian(local, elle::crc32c(compression.dictionary));
+          stream.write(reinterpret_cast<char const*>(local.contents()),
+                       local.size());
+          stream.flush();
+          auto peer = elle::Buffer(local.size());
+          elle::protocol::read(stream, peer, peer.size());
+          if (peer[0] != local[0])
+            ELLE_DEBUG("peer algorithm differs: %s", int(peer[0]));
+          else if (peer != local)
+            ELLE_WARN("%s: peer compression dictionary differs", *this);
+          else
+            this->_compression = compression.algorithm;
+          ELLE_TRACE("using compression: %s", int(this->_compression));
+        }
+      }
       this->_impl.reset(
-        new Impl(stream, this->_chunk_size, checksum, version,
-                 std::move(ping_period), std::move(ping_timeout)));
+        new Impl(stream, this->_chunk_size, checksum, this->version(),
+                 std::move(ping_period), std::move(ping_timeout),
+                 this->_compression, compression));
       this->_impl->ping_timeout().connect(this->_ping_timeout);
     }
 
@@ -552,7 +968,13 @@ namespace elle
     void
     Serializer::_write(elle::Buffer const& packet)
     {
-      this->_impl->write(packet);
+      this->_impl->write(Buffers{packet});
+    }
+
+    void
+    Serializer::_write(Buffers const& buffers)
+    {
+      this->_impl->write(buffers);
     }
 
     /*----------.
@@ -5,6 +5,7 @@
 
 #include <elle/reactor/mutex.hh>
 
+#include <elle/Buffer.hh>
 #include <elle/attribute.hh>
 #include <elle/compiler.hh>
 
@@ -18,22 +19,55 @@ namespace elle
 {
   namespace protocol
   {
+    /// How a Serializer compresses packets.
+    ///
+    /// Both ends send the algorithm they want and a CRC-32C of their
+    /// dictionary after agreeing on the version. Packets are compressed if
+    /// both match, and sent raw otherwise.
+    struct Compression
+    {
+      enum class Algorithm: unsigned char
+      {
+        none = 0,
+        /// Raw DEFLATE, see elle::format::deflate.
+        deflate = 1,
+      };
+      Algorithm algorithm = Algorithm::none;
+      /// Packets smaller than this are sent raw.
+      elle::Buffer::Size threshold = 256;
+      /// The zlib compression level, from 1 (fastest) to 9 (smallest).
+      int level = 1;
+      /// Byte strings common to packets, to compress small ones better.
+      elle::Buffer dictionary = {};
+    };
+
     /// A serializer that wrap a std::iostream and is in charge of:
     /// - negotiating the version of the protocol.
     /// - splitting packets into small chunks.
     /// - write and read control bytes (e. Transfer is interrupted without
     ///   closing the connection).
-    /// - ensuring data integrity (via a checksum).
+    /// - ensuring data integrity (via a checksum): up to 0.3.0, the SHA-1 of
+    ///   the packet is sent ahead of it; since 0.4.0, a CRC-32C is computed
+    ///   as chunks are sent and follows the last one.
+    /// - compressing packets, since 0.5.0 and if both ends agree on it (see
+    ///   Compression): packets are compressed before being chunked, and the
+    ///   checksum covers the compressed bytes.
     /// - etc.
     ///
     /// When a serializer is constructed on top a std::iostream, it will push
     /// its version and read the peer version in order to agree what version to
     /// use (actually, the smaller of the versions).
     ///
+    /// The layers above follow the agreed version too:
+    /// - 0.6.0: RPC callers cancel the calls they give up on, see RPC.
+    /// - 0.7.0: ChanneledStreams announce their flow control windows, see
+    ///   ChanneledStream::window.
+    /// - 0.8.0: ChanneledStreams batch packets, see ChanneledStream::batching.
+    ///
     /// \code{.cc}
     ///
     /// elle::reactor::network::TCPSocket socket("127.0.0.1", 8182);
-    /// elle::protocol::Serializer serializer(socket, elle::Version{0, 3, 0},
+    /// elle::protocol::Serializer serializer(socket, elle::Version{0, 4, 0},
     ///                                       true);
     /// // On top of that Serializer, you can create a ChanneledStream.
     /// elle::protocol::ChanneledStream cstream(serializer);
@@ -64,12 +98,14 @@ namespace elle
       /// @param version The version of the protocol.
       /// @param checksum Whether it should read and write the checksum of
       ///                 packets sent.
+      /// @param compression How to compress packets, if the peer agrees.
       Serializer(std::iostream& stream,
                  elle::Version const& version = elle::Version(0, 1, 0),
                  bool checksum = true,
                  boost::optional<std::chrono::milliseconds> ping_period = {},
                  boost::optional<std::chrono::milliseconds> ping_timeout = {},
-                 elle::Buffer::Size chunk_size = 2 << 16);
+                 elle::Buffer::Size chunk_size = 2 << 16,
+                 Compression compression = {});
       ~Serializer();
 
     /*----------.
@@ -91,6 +127,15 @@ namespace elle
       /// @param packet The packet to write.
       void
       _write(elle::Buffer const& packet) override;
+      /// Write a packet made of several pieces to the stream.
+      ///
+      /// If the stream is a reactor::network::Socket, headers and pieces are
+      /// sent with a single gather write per chunk instead of being copied in
+      /// the stream buffer.
+      ///
+      /// @param buffers The pieces of the packet.
+      void
+      _write(Buffers const& buffers) override;
 
     /*----------.
     | Printable |
@@ -106,6 +151,8 @@ namespace elle
       ELLE_ATTRIBUTE_R(elle::Version, version, override);
       ELLE_ATTRIBUTE_R(elle::Buffer::Size, chunk_size);
       ELLE_ATTRIBUTE_R(bool, checksum);
+      /// The compression agreed with the peer.
+      ELLE_ATTRIBUTE_R(Compression::Algorithm, compression);
       ELLE_ATTRIBUTE_RX(boost::signals2::signal<void ()>, ping_timeout);
     public:
       class Impl;
@@ -59,6 +59,26 @@ namespace elle
       this->_write(packet);
     }
 
+    void
+    Stream::write(Buffers const& buffers)
+    {
+      ELLE_TRACE_SCOPE("%s: write packet (%s pieces)", this, buffers.size());
+      this->_write(buffers);
+    }
+
+    void
+    Stream::_write(Buffers const& buffers)
+    {
+      auto size = elle::Buffer::Size(0);
+      for (auto const& b: buffers)
+        size += b.size();
+      auto packet = elle::Buffer{};
+      packet.capacity(size);
+      for (auto const& b: buffers)
+        packet.append(b.contents(), b.size());
+      this->_write(packet);
+    }
+
     /*------------------.
     | Int serialization |
     `------------------*/
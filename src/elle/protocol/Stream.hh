@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <vector>
 
 #include <elle/Buffer.hh>
 #include <elle/Printable.hh>
@@ -16,6 +17,13 @@ namespace elle
     class Stream
       : public elle::Printable
     {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      /// Pieces of a packet, sent back to back.
+      using Buffers = std::vector<elle::ConstWeakBuffer>;
+
     /*-------------.
     | Construction |
     `-------------*/
@@ -63,10 +71,24 @@ namespace elle
       /// @param packet The buffer to write.
       void
       write(elle::Buffer const& packet);
+      /// Write a packet made of the concatenation of @a buffers.
+      ///
+      /// Lets layers prepend headers without copying the payload: the pieces
+      /// reach the transport as is when it supports gather writes.
+      ///
+      /// @param buffers The pieces of the packet.
+      void
+      write(Buffers const& buffers);
     protected:
       virtual
       void
       _write(elle::Buffer const& packet) = 0;
+      /// Write a packet made of several pieces.
+      ///
+      /// Concatenate them and call _write(elle::Buffer const&) by default.
+      virtual
+      void
+      _write(Buffers const& buffers);
 
     /*------------------.
     | Int serialization |
@@ -1,5 +1,7 @@
 #include <elle/protocol/exceptions.hh>
 
+#include <ostream>
+
 namespace elle
 {
   namespace protocol
@@ -16,8 +18,43 @@ namespace elle
       Super("peer has interrupted sending")
     {}
 
+    Cancelled::Cancelled():
+      Super("call cancelled by peer")
+    {}
+
     RPCError::RPCError(std::string const& message):
-      Super(message)
+      RPCError(message, Code::unknown, {})
     {}
+
+    RPCError::RPCError(std::string const& message,
+                       Code code,
+                       std::string type):
+      Super(message),
+      _code(code),
+      _type(std::move(type))
+    {}
+
+    std::ostream&
+    operator <<(std::ostream& output, RPCError::Code code)
+    {
+      switch (code)
+      {
+        case RPCError::Code::unknown:
+          return output << "unknown";
+        case RPCError::Code::failed:
+          return output << "failed";
+        case RPCError::Code::unknown_procedure:
+          return output << "unknown procedure";
+        case RPCError::Code::non_local_procedure:
+          return output << "non local procedure";
+        case RPCError::Code::timeout:
+          return output << "timeout";
+        case RPCError::Code::cancelled:
+          return output << "cancelled";
+        case RPCError::Code::serialization:
+          return output << "serialization";
+      }
+      return output << "RPCError::Code(" << int(code) << ")";
+    }
   }
 }
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <typeinfo>
+
 #include <elle/Exception.hh>
+#include <elle/TypeInfo.hh>
 
 namespace elle
 {
@@ -33,14 +37,59 @@ namespace elle
       InterruptionError();
     };
 
+    /// An operation failure because the peer cancelled the call.
+    class Cancelled:
+      public Error
+    {
+    public:
+      using Super = Error;
+      Cancelled();
+    };
+
     /// A remote RPC could not be called.
     class RPCError:
       public Error
     {
     public:
       using Super = Error;
+      /// Why the call failed, as reported by the peer.
+      enum class Code: uint8_t
+      {
+        /// The peer did not tell.
+        unknown = 0,
+        /// The procedure threw.
+        failed = 1,
+        /// The peer has no such procedure.
+        unknown_procedure = 2,
+        /// The procedure is not implemented by the peer.
+        non_local_procedure = 3,
+        /// The procedure timed out.
+        timeout = 4,
+        /// The call was cancelled.
+        cancelled = 5,
+        /// The procedure failed to serialize or deserialize a value.
+        serialization = 6,
+      };
       RPCError(std::string const& message);
+      /// An RPCError reported by the peer.
+      ///
+      /// @param message The description of the error.
+      /// @param code Why the call failed.
+      /// @param type The demangled type of the remote exception, if any.
+      RPCError(std::string const& message, Code code, std::string type);
+      /// Whether the remote exception was an @a E.
+      template <typename E>
+      bool
+      is() const
+      {
+        return this->_type == elle::type_info<E>().name();
+      }
+      ELLE_ATTRIBUTE_R(Code, code);
+      ELLE_ATTRIBUTE_R(std::string, type);
     };
+
+    std::ostream&
+    operator <<(std::ostream& output, RPCError::Code code);
   }
 }
 
@@ -0,0 +1,284 @@
+#include <elle/reactor/Profiler.hh>
+
+#include <algorithm>
+#include <ostream>
+
+#include <elle/log.hh>
+#include <elle/printf.hh>
+#include <elle/reactor/Thread.hh>
+
+ELLE_LOG_COMPONENT("elle.reactor.Profiler");
+
+namespace elle
+{
+  namespace reactor
+  {
+    namespace
+    {
+      /// Make @a name a single collapsed stack frame.
+      std::string
+      frame(std::string name)
+      {
+        std::replace(name.begin(), name.end(), ';', ':');
+        std::replace(name.begin(), name.end(), '\n', ' ');
+        return name;
+      }
+
+      /// Write @a s as a JSON string.
+      void
+      json_string(std::ostream& output, std::string const& s)
+      {
+        output << '"';
+        for (auto c: s)
+          switch (c)
+          {
+            case '"':
+              output << "\\\"";
+              break;
+            case '\\':
+              output << "\\\\";
+              break;
+            case '\n':
+              output << "\\n";
+              break;
+            case '\t':
+              output << "\\t";
+              break;
+            default:
+              if (static_cast<unsigned char>(c) < 0x20)
+                elle::fprintf(output, "\\u%04x", int(c));
+              else
+                output << c;
+          }
+        output << '"';
+      }
+
+      std::int64_t
+      us(Profiler::Duration d)
+      {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+      }
+    }
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    Profiler::Statistics::Statistics()
+      : running(0)
+      , steps(0)
+      , step_max(0)
+      , frozen()
+      , wakeup(0)
+      , wakeups(0)
+      , wakeup_max(0)
+    {}
+
+    Profiler::Profiler(std::size_t capacity)
+      : _statistics()
+      , _dropped(0)
+      , _start(Clock::now())
+      , _capacity(capacity)
+    {}
+
+    /*--------.
+    | Results |
+    `--------*/
+
+    void
+    Profiler::collapsed(std::ostream& output) const
+    {
+      for (auto const& s: this->_statistics)
+      {
+        auto const thread = frame(s.first);
+        auto const& stats = s.second;
+        if (auto const n = us(stats.running))
+          elle::fprintf(output, "%s;running %s\n", thread, n);
+        for (auto const& f: stats.frozen)
+          if (auto const n = us(f.second))
+            elle::fprintf(output, "%s;frozen;%s %s\n",
+                          thread, frame(f.first), n);
+        if (auto const n = us(stats.wakeup))
+          elle::fprintf(output, "%s;wakeup %s\n", thread, n);
+      }
+    }
+
+    void
+    Profiler::chrome_trace(std::ostream& output) const
+    {
+      static char const* const kinds[] = {"running", "frozen", "wakeup"};
+      output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+      auto first = true;
+      auto const separate = [&]
+        {
+          if (!first)
+            output << ",\n";
+          first = false;
+        };
+      for (std::size_t track = 0; track < this->_tracks.size(); ++track)
+      {
+        separate();
+        elle::fprintf(output,
+                      "{\"ph\":\"M\",\"pid\":1,\"tid\":%s,"
+                      "\"name\":\"thread_name\",\"args\":{\"name\":",
+                      track);
+        json_string(output, this->_tracks[track]);
+        output << "}}";
+      }
+      for (auto const& e: this->_events)
+      {
+        separate();
+        auto const name = e.kind == Kind::frozen
+          ? this->_names[e.name] : std::string(kinds[int(e.kind)]);
+        output << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << e.track << ",\"name\":";
+        json_string(output, name);
+        elle::fprintf(output, ",\"cat\":\"%s\",\"ts\":%.3f,\"dur\":%.3f}",
+                      kinds[int(e.kind)],
+                      e.start / 1000., e.duration.count() / 1000.);
+      }
+      output << "]}\n";
+    }
+
+    void
+    Profiler::clear()
+    {
+      this->_statistics.clear();
+      this->_dropped = 0;
+      this->_start = Clock::now();
+      this->_live.clear();
+      this->_events.clear();
+      this->_tracks.clear();
+    }
+
+    /*------.
+    | Hooks |
+    `------*/
+
+    void
+    Profiler::_stepped(Thread& thread, Clock::time_point start)
+    {
+      auto const end = Clock::now();
+      auto& live = this->_thread(thread);
+      auto& stats = *live.statistics;
+      if (live.unfrozen != Clock::time_point())
+      {
+        auto const latency = std::max(Duration(start - live.unfrozen),
+                                      Duration(0));
+        stats.wakeup += latency;
+        ++stats.wakeups;
+        stats.wakeup_max = std::max(stats.wakeup_max, latency);
+        this->_event(Kind::wakeup, live.track, 0, live.unfrozen, start);
+        live.unfrozen = Clock::time_point();
+      }
+      auto const running = Duration(end - start);
+      stats.running += running;
+      ++stats.steps;
+      stats.step_max = std::max(stats.step_max, running);
+      this->_event(Kind::running, live.track, 0, start, end);
+    }
+
+    void
+    Profiler::_frozen(Thread& thread)
+    {
+      auto& live = this->_thread(thread);
+      live.frozen = Clock::now();
+      // The Thread stops waiting for its Waitables before being unfrozen:
+      // name them now.
+      auto names = std::vector<std::string>{};
+      for (auto w: thread.waited())
+        names.emplace_back(this->_waitable_name(*w));
+      std::sort(names.begin(), names.end());
+      live.waited.clear();
+      for (auto const& name: names)
+      {
+        if (!live.waited.empty())
+          live.waited += ", ";
+        live.waited += name;
+      }
+      if (live.waited.empty())
+        live.waited = "nothing";
+    }
+
+    void
+    Profiler::_unfrozen(Thread& thread)
+    {
+      auto const now = Clock::now();
+      auto it = this->_live.find(&thread);
+      if (it == this->_live.end())
+        return;
+      auto& live = it->second;
+      if (live.frozen != Clock::time_point())
+      {
+        live.statistics->frozen[live.waited] += now - live.frozen;
+        this->_event(Kind::frozen, live.track, this->_intern(live.waited),
+                     live.frozen, now);
+        live.frozen = Clock::time_point();
+      }
+      live.unfrozen = now;
+    }
+
+    void
+    Profiler::_finished(Thread& thread)
+    {
+      this->_live.erase(&thread);
+    }
+
+    /*--------.
+    | Details |
+    `--------*/
+
+    Profiler::Live&
+    Profiler::_thread(Thread& thread)
+    {
+      auto it = this->_live.find(&thread);
+      if (it != this->_live.end())
+        return it->second;
+      auto const track = std::uint32_t(this->_tracks.size());
+      this->_tracks.emplace_back(thread.name());
+      auto& live = this->_live[&thread];
+      live.track = track;
+      live.statistics = &this->_statistics[thread.name()];
+      return live;
+    }
+
+    std::uint32_t
+    Profiler::_intern(std::string const& name)
+    {
+      auto it = this->_names_index.find(name);
+      if (it != this->_names_index.end())
+        return it->second;
+      auto const res = std::uint32_t(this->_names.size());
+      this->_names.emplace_back(name);
+      this->_names_index.emplace(name, res);
+      return res;
+    }
+
+    void
+    Profiler::_event(Kind kind, std::uint32_t track, std::uint32_t name,
+                     Clock::time_point start, Clock::time_point end)
+    {
+      if (this->_events.size() >= this->_capacity)
+      {
+        if (!this->_dropped++)
+        {
+          ELLE_WARN("timeline is full, dropping further spans");
+        }
+        return;
+      }
+      this->_events.emplace_back(
+        Event{kind, track, name, Duration(start - this->_start).count(),
+              Duration(end - start)});
+    }
+
+    std::string const&
+    Profiler::_waitable_name(Waitable const& waitable)
+    {
+      if (!waitable.name().empty())
+        return waitable.name();
+      auto& res = this->_types[elle::type_info(waitable)];
+      if (res.empty())
+        res = elle::type_info(waitable).name();
+      return res;
+    }
+  }
+}
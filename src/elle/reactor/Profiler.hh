@@ -0,0 +1,188 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <elle/TypeInfo.hh>
+#include <elle/attribute.hh>
+#include <elle/reactor/fwd.hh>
+
+namespace elle
+{
+  namespace reactor
+  {
+    /// Where the Threads of a Scheduler spend their time.
+    ///
+    /// Once enabled with Scheduler::profile, the Scheduler reports every
+    /// Thread step, freeze and wake up. For each Thread, by name, the profiler
+    /// accounts:
+    ///
+    /// - the time spent running, from the Thread being stepped to it yielding;
+    /// - the time spent frozen, per Waitable the Thread was waiting for;
+    /// - the wakeup latency, from the Thread being unfrozen to it being
+    ///   stepped again.
+    ///
+    /// Totals are exact. Individual spans are also kept, up to a limit, to
+    /// export a timeline.
+    ///
+    /// @code{.cc}
+    ///
+    /// scheduler.profile(true);
+    /// scheduler.run();
+    /// std::ofstream flame("reactor.collapsed");
+    /// scheduler.profiler()->collapsed(flame);
+    /// std::ofstream trace("reactor.json");
+    /// scheduler.profiler()->chrome_trace(trace);
+    ///
+    /// @endcode
+    ///
+    /// The profiler is not thread safe: use it from its Scheduler.
+    class Profiler
+    {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      using Clock = std::chrono::steady_clock;
+      using Duration = std::chrono::nanoseconds;
+      /// The accumulated profile of all Threads with a given name.
+      struct Statistics
+      {
+        Statistics();
+        /// Time spent running.
+        Duration running;
+        /// Number of steps.
+        std::uint64_t steps;
+        /// Longest step.
+        Duration step_max;
+        /// Time spent frozen, by Waitable name.
+        std::map<std::string, Duration> frozen;
+        /// Time spent runnable after being unfrozen.
+        Duration wakeup;
+        /// Number of wakeups.
+        std::uint64_t wakeups;
+        /// Longest wakeup latency.
+        Duration wakeup_max;
+      };
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Create a profiler.
+      ///
+      /// @param capacity Maximum number of spans kept for the timeline.
+      Profiler(std::size_t capacity = 1 << 20);
+
+    /*--------.
+    | Results |
+    `--------*/
+    public:
+      /// Accumulated profile, by Thread name.
+      ELLE_ATTRIBUTE_R((std::map<std::string, Statistics>), statistics);
+      /// Number of spans dropped from the timeline.
+      ELLE_ATTRIBUTE_R(std::uint64_t, dropped);
+    public:
+      /// Write the profile in the collapsed stack format of flamegraph.pl.
+      ///
+      /// One line per Thread and state, e.g. `worker;frozen;socket 1234`,
+      /// weighted in microseconds.
+      ///
+      /// @param output The stream to write to.
+      void
+      collapsed(std::ostream& output) const;
+      /// Write the timeline as Chrome trace event JSON.
+      ///
+      /// Each Thread is a track of running, frozen and wakeup spans. Load it
+      /// in chrome://tracing or Perfetto.
+      ///
+      /// @param output The stream to write to.
+      void
+      chrome_trace(std::ostream& output) const;
+      /// Forget everything recorded so far.
+      void
+      clear();
+
+    /*------.
+    | Hooks |
+    `------*/
+    private:
+      friend class Scheduler;
+      /// @a thread was stepped from @a start until now.
+      void
+      _stepped(Thread& thread, Clock::time_point start);
+      /// @a thread is being frozen on its waited Waitables.
+      void
+      _frozen(Thread& thread);
+      /// @a thread is being unfrozen.
+      void
+      _unfrozen(Thread& thread);
+      /// @a thread is done.
+      void
+      _finished(Thread& thread);
+
+    /*--------.
+    | Details |
+    `--------*/
+    private:
+      enum class Kind
+      {
+        running,
+        frozen,
+        wakeup,
+      };
+      /// A span of the timeline.
+      struct Event
+      {
+        Kind kind;
+        /// Track, see Live::track.
+        std::uint32_t track;
+        /// Interned name of the Waitable(s), for frozen spans.
+        std::uint32_t name;
+        /// Start, in nanoseconds since the profiler creation.
+        std::int64_t start;
+        Duration duration;
+      };
+      /// What is known of a live Thread.
+      struct Live
+      {
+        /// Timeline track.
+        std::uint32_t track;
+        /// Statistics of the Thread name.
+        Statistics* statistics;
+        /// When the Thread was last frozen, if it is.
+        Clock::time_point frozen;
+        /// The Waitables it is frozen on.
+        std::string waited;
+        /// When the Thread was last unfrozen, if it was not stepped since.
+        Clock::time_point unfrozen;
+      };
+      /// The state of @a thread, created if needed.
+      Live&
+      _thread(Thread& thread);
+      std::uint32_t
+      _intern(std::string const& name);
+      void
+      _event(Kind kind, std::uint32_t track, std::uint32_t name,
+             Clock::time_point start, Clock::time_point end);
+      /// The name of @a waitable, or its type if it is anonymous.
+      std::string const&
+      _waitable_name(Waitable const& waitable);
+      ELLE_ATTRIBUTE(Clock::time_point, start);
+      ELLE_ATTRIBUTE(std::size_t, capacity);
+      ELLE_ATTRIBUTE((std::unordered_map<Thread const*, Live>), live);
+      ELLE_ATTRIBUTE(std::vector<Event>, events);
+      /// Thread name of each track.
+      ELLE_ATTRIBUTE(std::vector<std::string>, tracks);
+      ELLE_ATTRIBUTE(std::vector<std::string>, names);
+      ELLE_ATTRIBUTE((std::unordered_map<std::string, std::uint32_t>),
+                     names_index);
+      ELLE_ATTRIBUTE((std::unordered_map<TypeInfo, std::string>), types);
+    };
+  }
+}
@@ -26,8 +26,15 @@ namespace elle
                    std::string const& name,
                    Action action,
                    bool dispose)
-      : _dispose(dispose)
-      , _managed(false)
+      : Thread(scheduler, name, std::move(action), Options{dispose, false, 0})
+    {}
+
+    Thread::Thread(Scheduler& scheduler,
+                   std::string const& name,
+                   Action action,
+                   Options const& options)
+      : _dispose(options.dispose)
+      , _managed(options.managed)
       , _state(State::running)
       , _injection()
       , _exception()
@@ -36,8 +43,11 @@ namespace elle
       , _timeout_timer(scheduler.io_service())
       , _thread(scheduler._manager->make_thread(
                   name,
-                  [this, a=std::move(action)] { this->_action_wrapper(a); }))
+                  [this, a=std::move(action)] { this->_action_wrapper(a); },
+                  options.stack_size))
       , _scheduler(scheduler)
+      , _scheduler_hook()
+      , _starting(false)
       , _terminating(false)
       , _interruptible(true)
     {
@@ -50,6 +60,12 @@ namespace elle
       : Thread(reactor::scheduler(), name, std::move(action), dispose)
     {}
 
+    Scheduler&
+    Thread::_current_scheduler()
+    {
+      return reactor::scheduler();
+    }
+
     ThreadPtr
     Thread::make_tracked(const std::string& name,
                          Action action)
@@ -472,8 +488,13 @@ namespace elle
         if (this->_waited.empty())
         {
           ELLE_TRACE("%s: nothing to wait on, waking up", *this);
+          // Only describe the waitable if anyone listens: printing it is
+          // costly, and waking up is on every hot path.
           this->_scheduler._unfreeze(
-            *this, elle::sprintf("wait for %s ended", *waitable));
+            *this,
+            this->_unfrozen.empty()
+            ? std::string()
+            : elle::sprintf("wait for %s ended", *waitable));
           this->_state = State::running;
         }
         else
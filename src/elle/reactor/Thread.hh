@@ -1,5 +1,6 @@
 #pragma once
 
+#include <boost/intrusive/list_hook.hpp>
 #include <boost/signals2.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -22,6 +23,7 @@ namespace elle
 
     ELLE_DAS_SYMBOL(dispose);
     ELLE_DAS_SYMBOL(managed);
+    ELLE_DAS_SYMBOL(stack_size);
 
     /// Thread represent a coroutine in a Scheduler environment.
     ///
@@ -124,11 +126,30 @@ namespace elle
       /// @param scheduler The Scheduler in charge of the Thread.
       /// @param name A descriptive name of Thread to be spawn.
       /// @param action The action to execute.
-      /// @param args The named arguments `dispose` and `managed`.
+      /// @param args The named arguments `dispose`, `managed` and
+      ///        `stack_size`, the latter being the coroutine stack size in
+      ///        bytes (0 for the backend default). Small stacks save memory
+      ///        for numerous shallow Threads such as network handlers.
       template <typename ... Args>
       Thread(std::string const& name,
              Action action,
              Args&& ... args);
+    private:
+      struct Options
+      {
+        bool dispose;
+        bool managed;
+        std::size_t stack_size;
+      };
+      Thread(Scheduler& scheduler,
+             std::string const& name,
+             Action action,
+             Options const& options);
+      /// The current Scheduler, for inline constructors.
+      static
+      Scheduler&
+      _current_scheduler();
+    public:
 
       /// Create a Thread.
       ///
@@ -367,6 +388,12 @@ namespace elle
       friend class Scheduler;
       ELLE_ATTRIBUTE(std::unique_ptr<backend::Thread>, thread);
       ELLE_ATTRIBUTE(Scheduler&, scheduler);
+      /// Link in the Scheduler queue this Thread currently belongs to.
+      using SchedulerHook = boost::intrusive::list_member_hook<
+        boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+      ELLE_ATTRIBUTE(SchedulerHook, scheduler_hook);
+      /// Whether this Thread is registered but did not join a round yet.
+      ELLE_ATTRIBUTE(bool, starting);
       ELLE_ATTRIBUTE_R(bool, terminating);
       /// If set to false, do not rethrow Terminate exception.
       ELLE_ATTRIBUTE_Rw(bool, interruptible);
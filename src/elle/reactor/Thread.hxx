@@ -12,16 +12,16 @@ namespace elle
     Thread::Thread(std::string const& name,
                    Action action,
                    Args&& ... args)
-      : Thread(name, std::move(action))
-    {
-      elle::das::named::prototype(reactor::dispose = false,
-                                  reactor::managed = false)
-        .call([&] (bool dispose, bool managed)
+      : Thread(
+        _current_scheduler(), name, std::move(action),
+        elle::das::named::prototype(reactor::dispose = false,
+                                    reactor::managed = false,
+                                    reactor::stack_size = std::size_t(0))
+        .call([] (bool dispose, bool managed, std::size_t stack_size)
               {
-                this->_dispose = dispose;
-                this->_managed = managed;
-              }, std::forward<Args>(args)...);
-    }
+                return Options{dispose, managed, stack_size};
+              }, std::forward<Args>(args)...))
+    {}
 
     template <typename R>
     static
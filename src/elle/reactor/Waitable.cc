@@ -72,7 +72,7 @@ namespace elle
       if (_waiters.empty())
       {
         _exception = std::exception_ptr{}; // An empty one.
-        this->on_signaled()();
+        this->_signaled();
         return false;
       }
       for (auto& thread: this->_waiters)
@@ -83,7 +83,7 @@ namespace elle
       int res = _waiters.size();
       _waiters.clear();
       _exception = std::exception_ptr{}; // An empty one.
-      this->on_signaled()();
+      this->_signaled();
       return res;
     }
 
@@ -93,7 +93,7 @@ namespace elle
       if (this->_waiters.empty())
       {
         this->_exception = std::exception_ptr{}; // An empty one.
-        this->on_signaled()();
+        this->_signaled();
         return nullptr;
       }
       auto thread = *this->_waiters.begin();
@@ -119,7 +119,7 @@ namespace elle
       this->_waiters.get<1>().erase(thread.first);
       this->_exception = std::exception_ptr{}; // An empty one.
       if (this->_waiters.empty())
-        this->on_signaled()();
+        this->_signaled();
     }
 
     bool
@@ -147,6 +147,26 @@ namespace elle
       this->_exception = e;
     }
 
+    /*-------.
+    | Events |
+    `-------*/
+
+    boost::signals2::signal<void ()>&
+    Waitable::on_signaled()
+    {
+      if (!this->_on_signaled)
+        this->_on_signaled =
+          std::make_unique<boost::signals2::signal<void ()>>();
+      return *this->_on_signaled;
+    }
+
+    void
+    Waitable::_signaled()
+    {
+      if (this->_on_signaled)
+        (*this->_on_signaled)();
+    }
+
     /*----------.
     | Printable |
     `----------*/
@@ -202,7 +202,16 @@ namespace elle
     `-------*/
     public:
       /// Signal triggered when the waitable wakes its waiting threads.
-      ELLE_ATTRIBUTE_RX(boost::signals2::signal<void ()>, on_signaled);
+      ///
+      /// Created on first use, as few Waitables are ever observed.
+      boost::signals2::signal<void ()>&
+      on_signaled();
+    private:
+      /// Trigger on_signaled, if it was ever used.
+      void
+      _signaled();
+      ELLE_ATTRIBUTE(std::unique_ptr<boost::signals2::signal<void ()>>,
+                     on_signaled);
 
     /*----------.
     | Printable |
@@ -35,10 +35,15 @@ namespace elle
       `--------*/
       public:
         /// Create a new thread.
+        ///
+        /// @param name       A descriptive name.
+        /// @param action     The action to run.
+        /// @param stack_size The stack size in bytes, 0 for the default.
         virtual
         std::unique_ptr<backend::Thread>
         make_thread(const std::string& name,
-                    Action action) = 0;
+                    Action action,
+                    std::size_t stack_size = 0) = 0;
         /// The currently running thread.
         virtual
         Thread*
@@ -19,7 +19,9 @@
 #include <elle/Backtrace.hh>
 #include <elle/assert.hh>
 #include <elle/log.hh>
+#include <elle/os/environ.hh>
 #include <elle/reactor/backend/boost/backend.hh>
+#include <elle/reactor/backend/boost/stack-pool.hh>
 #include <elle/reactor/exception.hh>
 
 ELLE_LOG_COMPONENT("elle.reactor.backend.boost");
@@ -35,41 +37,43 @@ namespace elle
         /*----------------.
         | Stack Allocator |
         `----------------*/
-        template <std::size_t Max, std::size_t Default, std::size_t Min>
+        /// Stacks of any size above Min are supported: the StackPool maps
+        /// those above its largest size class on their own.
+        template <std::size_t Default, std::size_t Min>
         class TemplatedStackAllocator
         {
         public:
+          /// The default stack size, overridable with ELLE_REACTOR_STACK_SIZE.
           static
           std::size_t
-          maximum_stack_size()
+          default_stack_size()
           {
-            return Max;
+            static auto const res = std::size_t(
+              elle::os::getenv("ELLE_REACTOR_STACK_SIZE", int(Default)));
+            return res;
           }
 
           static
           std::size_t
-          default_stack_size()
+          minimum_stack_size()
           {
-            return Default;
+            return Min;
           }
 
+          /// The actual size of a stack of at least @a size bytes, or of
+          /// the default size if @a size is 0.
           static
           std::size_t
-          minimum_stack_size()
+          stack_size(std::size_t size)
           {
-            return Min;
+            return StackPool::round(size ? size : default_stack_size());
           }
 
           void*
           allocate(std::size_t size) const
           {
             ELLE_ASSERT(minimum_stack_size() <= size);
-            ELLE_ASSERT(maximum_stack_size() >= size);
-
-            if (auto limit = std::malloc(size))
-              return static_cast<char*>(limit) + size;
-            else
-              throw std::bad_alloc();
+            return StackPool::instance().allocate(size);
           }
 
           void
@@ -77,10 +81,7 @@ namespace elle
           {
             ELLE_ASSERT(vp);
             ELLE_ASSERT(minimum_stack_size() <= size);
-            ELLE_ASSERT(maximum_stack_size() >= size);
-
-            void* limit = static_cast<char*>(vp) - size;
-            std::free(limit);
+            StackPool::instance().deallocate(vp, size);
           }
         };
 
@@ -89,7 +90,6 @@ namespace elle
         `-------*/
         /// Default allocator type.
         using StackAllocator = TemplatedStackAllocator<
-          8 * 1024 * 1024,  // Max: 8 MiB
           4 * 128 * 1024,   // Default: 128 kiB
           8 * 1024          // Min: 8 kiB
           >;
@@ -122,9 +122,11 @@ namespace elle
         public:
           Thread(Backend& backend,
                  const std::string& name,
-                 Action action)
+                 Action action,
+                 std::size_t stack_size = 0)
             : Super(name, std::move(action))
             , _backend(backend)
+            , _stack_size(StackAllocator::stack_size(stack_size))
             , _stack_pointer(stack_allocator.allocate(this->_stack_size))
             , _context(make_fcontext(this->_stack_pointer,
                                      this->_stack_size, wrapped_run))
@@ -313,7 +315,7 @@ namespace elle
           /// Owning backend.
           Backend& _backend;
           /// Context stack size.
-          std::size_t const _stack_size = StackAllocator::default_stack_size();
+          std::size_t const _stack_size;
           /// Context stack pointer.
           void* _stack_pointer;
           /// Underlying IO context.
@@ -350,10 +352,12 @@ namespace elle
         = default;
 
         std::unique_ptr<backend::Thread>
-        Backend::make_thread(const std::string& name, Action action)
+        Backend::make_thread(const std::string& name,
+                             Action action,
+                             std::size_t stack_size)
         {
           return std::unique_ptr<backend::Thread>(
-            new Thread(*this, name, std::move(action)));
+            new Thread(*this, name, std::move(action), stack_size));
         }
 
         Thread*
@@ -36,7 +36,8 @@ namespace elle
         public:
           std::unique_ptr<backend::Thread>
           make_thread(const std::string& name,
-                      Action action) override;
+                      Action action,
+                      std::size_t stack_size = 0) override;
           backend::Thread*
           current() const override;
 
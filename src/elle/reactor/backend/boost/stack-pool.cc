@@ -0,0 +1,284 @@
+#include <elle/reactor/backend/boost/stack-pool.hh>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <ostream>
+
+#include <elle/assert.hh>
+#include <elle/log.hh>
+#include <elle/os/environ.hh>
+
+#ifndef MAP_NORESERVE
+# define MAP_NORESERVE 0
+#endif
+
+ELLE_LOG_COMPONENT("elle.reactor.backend.boost.StackPool");
+
+namespace elle
+{
+  namespace reactor
+  {
+    namespace backend
+    {
+      namespace boost
+      {
+        namespace
+        {
+          /// The smallest size class is 1 << min_shift bytes.
+          constexpr int min_shift = 13;
+          /// Address space mapped at once for a size class.
+          constexpr std::size_t slab_size = 2 * 1024 * 1024;
+          /// Released stacks per size class whose pages are kept resident.
+          constexpr std::size_t hot_max = 16;
+
+          /// How many stacks may have a guard page.
+          ///
+          /// A guard page splits the mapping of its slab twice, so only guard
+          /// stacks within a quarter of the mapping limit, leaving the rest to
+          /// the process.
+          std::size_t
+          guard_budget()
+          {
+            auto limit = std::numeric_limits<std::size_t>::max();
+            std::ifstream("/proc/sys/vm/max_map_count") >> limit;
+            return limit / 4;
+          }
+        }
+
+        /*-------------.
+        | Construction |
+        `-------------*/
+
+        StackPool&
+        StackPool::instance()
+        {
+          static auto res = new StackPool;
+          return *res;
+        }
+
+        StackPool::StackPool()
+          : _page_size(::sysconf(_SC_PAGESIZE))
+          , _guard(elle::os::getenv("ELLE_REACTOR_STACK_GUARD", true))
+          , _guard_budget(guard_budget())
+          , _hot()
+          , _cold()
+          , _slabs()
+          , _unpooled()
+          , _statistics()
+        {}
+
+        /*-----------.
+        | Allocation |
+        `-----------*/
+
+        constexpr int StackPool::classes;
+
+        std::size_t
+        StackPool::round(std::size_t size)
+        {
+          return std::size_t(1) << (Self::_class(size) + min_shift);
+        }
+
+        int
+        StackPool::_class(std::size_t size)
+        {
+          auto res = 0;
+          while ((std::size_t(1) << (res + min_shift)) < size)
+            ++res;
+          return res;
+        }
+
+        void*
+        StackPool::allocate(std::size_t size)
+        {
+          auto const c = Self::_class(size);
+          std::unique_lock<std::mutex> lock(this->_mutex);
+          auto& stats = this->_statistics;
+          void* res = nullptr;
+          if (c < classes)
+          {
+            auto& hot = this->_hot[c];
+            auto& cold = this->_cold[c];
+            auto& pool = hot.empty() ? cold : hot;
+            if (pool.empty())
+              this->_grow(c);
+            res = pool.back();
+            pool.pop_back();
+            stats.pooled -= 1;
+          }
+          else
+            res = this->_map(Self::round(size));
+          stats.stacks += 1;
+          stats.used += Self::round(size);
+          stats.peak_stacks = std::max(stats.peak_stacks, stats.stacks);
+          stats.peak_used = std::max(stats.peak_used, stats.used);
+          return res;
+        }
+
+        void
+        StackPool::deallocate(void* top, std::size_t size)
+        {
+          ELLE_ASSERT(top);
+          auto const c = Self::_class(size);
+          auto const rounded = Self::round(size);
+          std::unique_lock<std::mutex> lock(this->_mutex);
+          auto& stats = this->_statistics;
+          if (c >= classes)
+            this->_unmap(top);
+          else
+          {
+            auto& hot = this->_hot[c];
+            if (hot.size() < hot_max)
+              hot.push_back(top);
+            else
+            {
+              // Let the system reclaim the pages.
+              ::madvise(static_cast<char*>(top) - rounded, rounded,
+                        MADV_DONTNEED);
+              this->_cold[c].push_back(top);
+            }
+            stats.pooled += 1;
+          }
+          stats.stacks -= 1;
+          stats.used -= rounded;
+        }
+
+        void
+        StackPool::_grow(int c)
+        {
+          auto const size = std::size_t(1) << (c + min_shift);
+          auto guard = this->_guard ? this->_page_size : 0;
+          auto count = std::max<std::size_t>(1, slab_size / (size + guard));
+          if (guard && this->_guard_budget < count)
+          {
+            ELLE_WARN("too many stacks to guard them all, "
+                      "further stacks are unguarded (see vm.max_map_count)");
+            this->_guard = false;
+            guard = 0;
+            count = std::max<std::size_t>(1, slab_size / size);
+          }
+          else if (guard)
+            this->_guard_budget -= count;
+          auto const stride = size + guard;
+          auto const length = count * stride;
+          auto const slab = static_cast<char*>(
+            ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+          if (slab == MAP_FAILED)
+            throw std::bad_alloc();
+          ELLE_DEBUG("map %s stacks of %s bytes at %s", count, size,
+                     static_cast<void*>(slab));
+          this->_slabs.emplace_back(slab, length);
+          this->_statistics.mapped += length;
+          auto& pool = this->_cold[c];
+          pool.reserve(pool.size() + count);
+          this->_hot[c].reserve(hot_max);
+          // Push the highest stacks first so the lowest are used first.
+          for (auto i = count; i > 0; --i)
+          {
+            auto const base = slab + (i - 1) * stride;
+            if (guard && ::mprotect(base, guard, PROT_NONE))
+              throw std::bad_alloc();
+            pool.push_back(base + stride);
+          }
+          this->_statistics.pooled += count;
+        }
+
+        void*
+        StackPool::_map(std::size_t size)
+        {
+          auto const guard =
+            this->_guard && this->_guard_budget ? this->_page_size : 0;
+          auto const length = size + guard;
+          auto const base = static_cast<char*>(
+            ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+          if (base == MAP_FAILED)
+            throw std::bad_alloc();
+          if (guard)
+          {
+            if (::mprotect(base, guard, PROT_NONE))
+            {
+              ::munmap(base, length);
+              throw std::bad_alloc();
+            }
+            this->_guard_budget -= 1;
+          }
+          ELLE_DEBUG("map an unpooled stack of %s bytes at %s", size,
+                     static_cast<void*>(base));
+          this->_unpooled.push_back(Mapping{Slab(base, length), guard != 0});
+          this->_statistics.mapped += length;
+          return base + length;
+        }
+
+        void
+        StackPool::_unmap(void* top)
+        {
+          auto const it = std::find_if(
+            this->_unpooled.begin(), this->_unpooled.end(),
+            [top] (Mapping const& m)
+            {
+              return m.slab.first + m.slab.second == top;
+            });
+          ELLE_ASSERT(it != this->_unpooled.end());
+          auto const slab = it->slab;
+          // Give back the guard page, if any.
+          if (it->guard)
+            this->_guard_budget += 1;
+          this->_unpooled.erase(it);
+          ELLE_DEBUG("unmap an unpooled stack at %s",
+                     static_cast<void*>(slab.first));
+          ::munmap(slab.first, slab.second);
+          this->_statistics.mapped -= slab.second;
+        }
+
+        /*-----------.
+        | Statistics |
+        `-----------*/
+
+        StackPool::Statistics
+        StackPool::statistics() const
+        {
+          std::unique_lock<std::mutex> lock(this->_mutex);
+          auto res = this->_statistics;
+          res.resident = 0;
+          auto pages = std::vector<unsigned char>{};
+          auto mapped = this->_slabs;
+          for (auto const& m: this->_unpooled)
+            mapped.emplace_back(m.slab);
+          for (auto const& slab: mapped)
+          {
+            pages.resize(slab.second / this->_page_size);
+#ifdef INFINIT_MACOSX
+            auto const vec = reinterpret_cast<char*>(pages.data());
+#else
+            auto const vec = pages.data();
+#endif
+            if (::mincore(slab.first, slab.second, vec))
+              continue;
+            res.resident += this->_page_size *
+              std::count_if(pages.begin(), pages.end(),
+                            [] (unsigned char p) { return p & 1; });
+          }
+          return res;
+        }
+
+        std::ostream&
+        operator <<(std::ostream& s, StackPool::Statistics const& stats)
+        {
+          return s << "stacks(" << stats.stacks
+                   << " used, peak " << stats.peak_stacks
+                   << ", " << stats.pooled << " pooled; "
+                   << stats.used << " bytes used, peak " << stats.peak_used
+                   << ", " << stats.mapped << " mapped, "
+                   << stats.resident << " resident)";
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <elle/attribute.hh>
+
+namespace elle
+{
+  namespace reactor
+  {
+    namespace backend
+    {
+      namespace boost
+      {
+        /// Pool of coroutine stacks.
+        ///
+        /// Stacks are carved out of large mmap'd slabs, rounded up to a power
+        /// of two, and never given back to the system: a stack released by a
+        /// finished coroutine is kept for the next coroutine of the same size
+        /// class, so short-lived Threads cost no system call. A few released
+        /// stacks per size class are kept hot, the pages of the others are
+        /// discarded with madvise, so only pages actually used by live
+        /// coroutines stay resident and many idle coroutines with small
+        /// stacks fit in bounded memory. Stacks above the largest size class,
+        /// 8 MiB, are rare: each is mapped on its own and unmapped when
+        /// released.
+        ///
+        /// Unless disabled with ELLE_REACTOR_STACK_GUARD=0, every stack sits
+        /// above an inaccessible guard page so overflows fault instead of
+        /// corrupting a neighbour. Each guard page costs a memory mapping: a
+        /// million coroutines with guard pages require raising
+        /// vm.max_map_count on Linux: past a quarter of that limit, further
+        /// stacks are unguarded.
+        ///
+        /// The pool is shared by all Schedulers of the process.
+        class StackPool
+        {
+        /*------.
+        | Types |
+        `------*/
+        public:
+          using Self = StackPool;
+          /// Stack memory statistics, in bytes unless stated otherwise.
+          struct Statistics
+          {
+            /// Stacks in use by coroutines.
+            std::size_t stacks;
+            /// Highest number of stacks simultaneously in use.
+            std::size_t peak_stacks;
+            /// Memory reserved for stacks in use.
+            std::size_t used;
+            /// Highest memory simultaneously reserved for stacks in use.
+            std::size_t peak_used;
+            /// Stacks pooled for reuse.
+            std::size_t pooled;
+            /// Address space mapped for stacks, guard pages included.
+            std::size_t mapped;
+            /// Stack memory actually resident.
+            std::size_t resident;
+          };
+
+        /*-------------.
+        | Construction |
+        `-------------*/
+        public:
+          /// The process-wide pool.
+          static
+          StackPool&
+          instance();
+        private:
+          StackPool();
+
+        /*-----------.
+        | Allocation |
+        `-----------*/
+        public:
+          /// The size of the stack allocate(@a size) returns.
+          static
+          std::size_t
+          round(std::size_t size);
+          /// Get a stack of round(@a size) bytes.
+          ///
+          /// @param size The minimum size of the stack.
+          /// @returns The top of the stack, stacks grow downward.
+          void*
+          allocate(std::size_t size);
+          /// Give back a stack.
+          ///
+          /// @param top  The top of the stack, as returned by allocate.
+          /// @param size The size given to allocate.
+          void
+          deallocate(void* top, std::size_t size);
+          /// Current statistics.
+          Statistics
+          statistics() const;
+        private:
+          static constexpr int classes = 11;
+          using Slab = std::pair<char*, std::size_t>;
+          /// Index of the size class of round(@a size) bytes.
+          static
+          int
+          _class(std::size_t size);
+          /// Map a new slab for size class @a c and pool its stacks.
+          void
+          _grow(int c);
+          /// Map a stack of @a size bytes out of the pool.
+          void*
+          _map(std::size_t size);
+          /// Unmap a stack from _map.
+          void
+          _unmap(void* top);
+          ELLE_ATTRIBUTE(std::mutex, mutex, mutable);
+          ELLE_ATTRIBUTE(std::size_t, page_size);
+          ELLE_ATTRIBUTE_R(bool, guard);
+          /// Number of stacks that may still be guarded.
+          ELLE_ATTRIBUTE(std::size_t, guard_budget);
+          using Pool = std::array<std::vector<void*>, classes>;
+          /// Recently released stack tops, per size class.
+          ELLE_ATTRIBUTE(Pool, hot);
+          /// Unused stack tops whose pages are not resident, per size class.
+          ELLE_ATTRIBUTE(Pool, cold);
+          /// All slabs mapped so far.
+          ELLE_ATTRIBUTE(std::vector<Slab>, slabs);
+          /// A stack mapped out of the pool.
+          struct Mapping
+          {
+            /// The whole mapping, guard page included.
+            Slab slab;
+            /// Whether its lowest page is a guard page.
+            bool guard;
+          };
+          /// Stacks mapped out of the pool.
+          ELLE_ATTRIBUTE(std::vector<Mapping>, unpooled);
+          ELLE_ATTRIBUTE(Statistics, statistics);
+        };
+
+        std::ostream&
+        operator <<(std::ostream& s, StackPool::Statistics const& stats);
+      }
+    }
+  }
+}
@@ -39,12 +39,16 @@ namespace elle
         public:
           Thread(Backend& backend,
                  const std::string& name,
-                 Action action)
+                 Action action,
+                 std::size_t stack_size = 0)
             : Super(name, std::move(action))
             , _backend(backend)
             , _coro(Coro_new())
             , _root(false)
-          {}
+          {
+            if (stack_size)
+              Coro_setStackSize_(this->_coro, stack_size);
+          }
 
           ~Thread()
           {
@@ -212,10 +216,12 @@ namespace elle
         {}
 
         std::unique_ptr<backend::Thread>
-        Backend::make_thread(const std::string& name, Action action)
+        Backend::make_thread(const std::string& name,
+                             Action action,
+                             std::size_t stack_size)
         {
           return std::unique_ptr<backend::Thread>(
-            new Thread(*this, name, std::move(action)));
+            new Thread(*this, name, std::move(action), stack_size));
         }
 
         Thread*
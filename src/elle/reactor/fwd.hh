@@ -14,7 +14,9 @@ namespace elle
   {
     class Barrier;
     class Mutex;
+    class MultiScheduler;
     class Operation;
+    class Profiler;
     class Scheduler;
     class Semaphore;
     class Signal;
@@ -0,0 +1,334 @@
+#include <elle/reactor/multi-scheduler.hh>
+
+#include <algorithm>
+
+#include <elle/assert.hh>
+#include <elle/finally.hh>
+#include <elle/log.hh>
+
+ELLE_LOG_COMPONENT("elle.reactor.MultiScheduler");
+
+namespace elle
+{
+  namespace reactor
+  {
+    /*-------.
+    | Worker |
+    `-------*/
+
+    class MultiScheduler::Worker
+      : public Scheduler
+    {
+    public:
+      struct Job
+      {
+        std::string name;
+        Thread::Action action;
+      };
+
+      Worker(MultiScheduler& owner, int index)
+        : _owner(owner)
+        , _index(index)
+        , _jobs()
+        , _load(0)
+        , _waiting(false)
+      {}
+
+      /// Start the oldest job queued on this worker, if any is left.
+      ///
+      /// @returns Whether a job was started.
+      bool
+      start_job()
+      {
+        auto job = Job{};
+        {
+          std::unique_lock<std::mutex> lock(this->_jobs_mutex);
+          // The job may have been stolen in the meantime.
+          if (this->_jobs.empty())
+            return false;
+          job = std::move(this->_jobs.front());
+          this->_jobs.pop_front();
+        }
+        ELLE_DEBUG("%s: start %s", *this, job.name);
+        new Thread(*this, job.name, this->_owner._job(std::move(job.action)),
+                   true);
+        return true;
+      }
+
+      void
+      print(std::ostream& s) const override
+      {
+        s << "worker " << this->_index << " of " << this->_owner;
+      }
+
+    protected:
+      /// Start one job, queued here or stolen, once no Thread is runnable.
+      bool
+      _idle() override
+      {
+        if (this->_eptr || this->_owner._finished)
+          return false;
+        auto const started = this->start_job() ||
+          (this->_owner._steal(*this) && this->start_job());
+        this->_waiting = !started;
+        return true;
+      }
+
+      ELLE_ATTRIBUTE(MultiScheduler&, owner);
+      ELLE_ATTRIBUTE_R(int, index);
+      ELLE_ATTRIBUTE(std::mutex, jobs_mutex);
+      /// Unstarted jobs, the owner pops the front, thieves the back.
+      ELLE_ATTRIBUTE(std::deque<Job>, jobs);
+      /// Jobs queued or running on this worker.
+      ELLE_ATTRIBUTE(std::atomic<int>, load);
+      /// Whether the worker found no job to start last time it was idle.
+      ELLE_ATTRIBUTE(std::atomic<bool>, waiting);
+      friend class MultiScheduler;
+    };
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+
+    MultiScheduler::MultiScheduler(int workers)
+      : _workers()
+      , _live(0)
+      , _finished(false)
+      , _stolen(0)
+      , _exception()
+    {
+      workers = std::max(workers, 1);
+      for (int i = 0; i < workers; ++i)
+        this->_workers.emplace_back(std::make_unique<Worker>(*this, i));
+    }
+
+    MultiScheduler::~MultiScheduler() = default;
+
+    /*--------.
+    | Workers |
+    `--------*/
+
+    int
+    MultiScheduler::size() const
+    {
+      return this->_workers.size();
+    }
+
+    Scheduler&
+    MultiScheduler::worker(int i)
+    {
+      ELLE_ASSERT_GTE(i, 0);
+      ELLE_ASSERT_LT(i, this->size());
+      return *this->_workers[i];
+    }
+
+    int
+    MultiScheduler::current() const
+    {
+      auto const sched = Scheduler::scheduler();
+      for (auto const& w: this->_workers)
+        if (w.get() == sched)
+          return w->index();
+      return -1;
+    }
+
+    MultiScheduler::Worker&
+    MultiScheduler::_least_loaded()
+    {
+      auto res = this->_workers.front().get();
+      for (auto const& w: this->_workers)
+        if (w->_load < res->_load)
+          res = w.get();
+      return *res;
+    }
+
+    /*-----.
+    | Jobs |
+    `-----*/
+
+    void
+    MultiScheduler::spawn(std::string const& name, Thread::Action action)
+    {
+      ELLE_ASSERT(!this->_finished);
+      auto& w = this->_least_loaded();
+      ELLE_DEBUG("%s: queue %s on %s", *this, name, w);
+      ++this->_live;
+      ++w._load;
+      {
+        std::unique_lock<std::mutex> lock(w._jobs_mutex);
+        w._jobs.push_back(Worker::Job{name, std::move(action)});
+      }
+      // Wake the worker up in case it is idle, and an idle sibling to steal
+      // the job if it is not.
+      w.io_service().post([] {});
+      if (!w._waiting)
+        for (auto const& sibling: this->_workers)
+          if (sibling->_waiting)
+          {
+            sibling->io_service().post([] {});
+            break;
+          }
+    }
+
+    void
+    MultiScheduler::spawn(std::string const& name,
+                          Thread::Action action,
+                          int worker)
+    {
+      ELLE_ASSERT(!this->_finished);
+      ELLE_ASSERT_GTE(worker, 0);
+      ELLE_ASSERT_LT(worker, this->size());
+      auto& w = *this->_workers[worker];
+      ELLE_DEBUG("%s: pin %s on %s", *this, name, w);
+      ++this->_live;
+      ++w._load;
+      w.io_service().post(
+        [&w, name, action = this->_job(std::move(action))]
+        {
+          new Thread(w, name, action, true);
+        });
+    }
+
+    int
+    MultiScheduler::stolen() const
+    {
+      return this->_stolen;
+    }
+
+    Thread::Action
+    MultiScheduler::_job(Thread::Action action)
+    {
+      return [this, action = std::move(action)]
+      {
+        auto& w = *this->_workers[this->current()];
+        elle::SafeFinally done(
+          [&]
+          {
+            --w._load;
+            this->_job_done();
+          });
+        action();
+      };
+    }
+
+    bool
+    MultiScheduler::_steal(Worker& thief)
+    {
+      auto const n = this->size();
+      for (int i = 1; i < n; ++i)
+      {
+        auto& victim = *this->_workers[(thief.index() + i) % n];
+        auto jobs = std::vector<Worker::Job>{};
+        {
+          std::unique_lock<std::mutex> lock(victim._jobs_mutex);
+          // Take the newest half, the victim starts the oldest ones first.
+          for (auto count = (victim._jobs.size() + 1) / 2; count; --count)
+          {
+            jobs.emplace_back(std::move(victim._jobs.back()));
+            victim._jobs.pop_back();
+          }
+        }
+        if (!jobs.empty())
+        {
+          ELLE_DEBUG("%s: steal %s jobs from %s", thief, jobs.size(), victim);
+          auto const count = int(jobs.size());
+          victim._load -= count;
+          thief._load += count;
+          this->_stolen += count;
+          // Queue them in order, for the thief to start them one at a time
+          // and its own siblings to steal them in turn.
+          std::unique_lock<std::mutex> lock(thief._jobs_mutex);
+          for (auto& job: jobs)
+            thief._jobs.push_front(std::move(job));
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void
+    MultiScheduler::_job_done()
+    {
+      if (--this->_live == 0)
+        this->_finish();
+    }
+
+    void
+    MultiScheduler::_finish()
+    {
+      ELLE_TRACE("%s: all jobs are done", *this);
+      this->_finished = true;
+      // Wake idle workers up so they notice.
+      for (auto const& w: this->_workers)
+        w->io_service().post([] {});
+    }
+
+    /*----.
+    | Run |
+    `----*/
+
+    void
+    MultiScheduler::run()
+    {
+      ELLE_TRACE_SCOPE("%s: run with %s workers", *this, this->size());
+      if (!this->_live)
+        this->_finish();
+      auto run = [this] (Worker& w)
+        {
+          try
+          {
+            w.run();
+          }
+          catch (...)
+          {
+            ELLE_TRACE("%s: %s failed: %s",
+                       *this, w, elle::exception_string());
+            {
+              std::unique_lock<std::mutex> lock(this->_exception_mutex);
+              if (!this->_exception)
+                this->_exception = std::current_exception();
+            }
+            this->terminate_later();
+          }
+        };
+      auto threads = std::vector<std::thread>{};
+      for (int i = 1; i < this->size(); ++i)
+        threads.emplace_back([&, i] { run(*this->_workers[i]); });
+      run(*this->_workers.front());
+      for (auto& t: threads)
+        t.join();
+      ELLE_TRACE("%s: done, %s jobs stolen", *this, this->stolen());
+      if (this->_exception)
+        std::rethrow_exception(this->_exception);
+    }
+
+    void
+    MultiScheduler::terminate_later()
+    {
+      ELLE_TRACE_SCOPE("%s: terminate", *this);
+      this->_finished = true;
+      for (auto const& w: this->_workers)
+      {
+        {
+          std::unique_lock<std::mutex> lock(w->_jobs_mutex);
+          auto const discarded = int(w->_jobs.size());
+          w->_load -= discarded;
+          this->_live -= discarded;
+          w->_jobs.clear();
+        }
+        auto worker = w.get();
+        w->io_service().post([worker] { worker->terminate_later(); });
+      }
+    }
+
+    /*----------.
+    | Printable |
+    `----------*/
+
+    void
+    MultiScheduler::print(std::ostream& s) const
+    {
+      s << "MultiScheduler " << this;
+    }
+  }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <elle/Printable.hh>
+#include <elle/attribute.hh>
+#include <elle/reactor/Thread.hh>
+#include <elle/reactor/fwd.hh>
+#include <elle/reactor/scheduler.hh>
+
+namespace elle
+{
+  namespace reactor
+  {
+    /// A pool of Schedulers, each running on its own system thread.
+    ///
+    /// Every worker is a regular Scheduler with its own run queue and
+    /// io_service: a Thread always runs on the worker it was created on, so
+    /// Thread, Waitable and wait() keep their single-threaded semantics within
+    /// a worker. Threads spawned by a Thread through the usual constructors
+    /// stay on the same worker as their parent.
+    ///
+    /// Jobs are submitted with MultiScheduler::spawn. Unpinned jobs are queued
+    /// on the least loaded worker, which starts them one at a time whenever
+    /// it runs out of runnable Threads. A worker with no job left steals half
+    /// of the jobs a sibling did not start yet, and idle workers are woken up
+    /// as jobs are spawned. Jobs that rely on single-threaded invariants with
+    /// other Threads can be pinned to a given worker, in which case they are
+    /// never stolen.
+    ///
+    /// Objects shared between workers must be protected accordingly, e.g. by
+    /// running the critical operations on the owning worker with
+    /// Scheduler::mt_run.
+    ///
+    /// @code{.cc}
+    ///
+    /// auto pool = elle::reactor::MultiScheduler{4};
+    /// for (int i = 0; i < 1000; ++i)
+    ///   pool.spawn(elle::sprintf("job %s", i), [i] { process(i); });
+    /// // Pinned: always runs on worker 0.
+    /// pool.spawn("stats", [] { dump_stats(); }, 0);
+    /// // Block until all jobs are done.
+    /// pool.run();
+    ///
+    /// @endcode
+    class MultiScheduler
+      : public elle::Printable
+    {
+    /*------.
+    | Types |
+    `------*/
+    public:
+      using Self = MultiScheduler;
+      class Worker;
+      using Workers = std::vector<std::unique_ptr<Worker>>;
+
+    /*-------------.
+    | Construction |
+    `-------------*/
+    public:
+      /// Create a pool of @a workers Schedulers.
+      ///
+      /// @param workers The number of workers, one per core by default.
+      MultiScheduler(int workers = std::thread::hardware_concurrency());
+      ~MultiScheduler();
+
+    /*--------.
+    | Workers |
+    `--------*/
+    public:
+      /// The number of workers.
+      int
+      size() const;
+      /// The Scheduler of worker @a i.
+      Scheduler&
+      worker(int i);
+      /// The worker the calling Thread runs on, or -1 if none.
+      int
+      current() const;
+    private:
+      /// The worker with the fewest pending jobs.
+      Worker&
+      _least_loaded();
+      ELLE_ATTRIBUTE(Workers, workers);
+
+    /*-----.
+    | Jobs |
+    `-----*/
+    public:
+      /// Spawn a job on the least loaded worker.
+      ///
+      /// The job may be stolen by an idle worker until it starts.
+      ///
+      /// @param name   A descriptive name of the job Thread.
+      /// @param action The action to run.
+      void
+      spawn(std::string const& name, Thread::Action action);
+      /// Spawn a job pinned to a given worker.
+      ///
+      /// @param name   A descriptive name of the job Thread.
+      /// @param action The action to run.
+      /// @param worker The index of the worker to run it on.
+      void
+      spawn(std::string const& name, Thread::Action action, int worker);
+      /// The number of jobs moved from a worker's queue to another's.
+      int
+      stolen() const;
+    private:
+      /// Wrap @a action to account for its completion.
+      Thread::Action
+      _job(Thread::Action action);
+      /// Move pending jobs from a sibling of @a thief to its queue.
+      ///
+      /// @returns Whether any job was stolen.
+      bool
+      _steal(Worker& thief);
+      /// Account for the completion of a job.
+      void
+      _job_done();
+      /// Stop all idle workers.
+      void
+      _finish();
+      /// Jobs spawned and not finished yet.
+      ELLE_ATTRIBUTE(std::atomic<int>, live);
+      /// Whether workers may stop once they have no Thread left.
+      ELLE_ATTRIBUTE(std::atomic<bool>, finished);
+      ELLE_ATTRIBUTE(std::atomic<int>, stolen);
+
+    /*----.
+    | Run |
+    `----*/
+    public:
+      /// Run all workers until all jobs are done.
+      ///
+      /// The first worker runs on the calling system thread. If an exception
+      /// escapes from any worker, all workers are terminated and it is
+      /// rethrown.
+      void
+      run();
+      /// Terminate all workers.
+      ///
+      /// Pending jobs are discarded and running Threads are terminated.
+      void
+      terminate_later();
+    private:
+      ELLE_ATTRIBUTE(std::mutex, exception_mutex);
+      ELLE_ATTRIBUTE(std::exception_ptr, exception);
+
+    /*----------.
+    | Printable |
+    `----------*/
+    public:
+      void
+      print(std::ostream& s) const override;
+    };
+  }
+}
@@ -2,6 +2,7 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <elle/metrics.hh>
 #include <elle/os/environ.hh>
 #include <elle/reactor/network/Error.hh>
 #include <elle/reactor/network/http-server.hh>
@@ -340,6 +341,20 @@ namespace elle
         this->_routes[route][method] = function;
       }
 
+      void
+      HttpServer::register_metrics(std::string const& route)
+      {
+        this->register_route(
+          route, http::Method::GET,
+          [] (Headers const&,
+              Cookies const&,
+              Parameters const&,
+              elle::Buffer const&)
+          {
+            return elle::sprintf("%s", elle::metrics::snapshot());
+          });
+      }
+
       bool
       HttpServer::is_json(Headers const& headers) const
       {
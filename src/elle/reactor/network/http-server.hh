@@ -193,6 +193,11 @@ namespace elle
         register_route(std::string const& route,
                        http::Method method,
                        Function const& function);
+        /// Serve elle::metrics snapshots as text.
+        ///
+        /// \param route The route to serve them on, with GET.
+        void
+        register_metrics(std::string const& route = "/metrics");
         /// Check if content-type is application/json.
         ///
         /// \param headers The headers of the Request.
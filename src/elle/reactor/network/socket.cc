@@ -4,6 +4,7 @@
 #include <elle/Lazy.hh>
 #include <elle/format/hexadecimal.hh>
 #include <elle/log.hh>
+#include <elle/metrics.hh>
 #include <elle/reactor/lockable.hh>
 #include <elle/reactor/network/SocketOperation.hh>
 #include <elle/reactor/network/Error.hh>
@@ -107,6 +108,11 @@ namespace elle
             Size size = pptr() - pbase();
             ELLE_TRACE_SCOPE("%s: sync %s bytes", *this, size);
             setp(nullptr, nullptr);
+            // Everything written through the stream interface was copied in
+            // the write buffer, as opposed to Socket::writev.
+            static auto& buffered = elle::metrics::counter(
+              "elle.reactor.network.Socket.write.buffered");
+            buffered.increment(size);
             if (size > 0 && !this->_pacified)
               this->_socket->write(
                 elle::ConstWeakBuffer(this->write_buffer, size));
@@ -130,6 +136,17 @@ namespace elle
       Socket::~Socket()
       = default;
 
+      /*------.
+      | Write |
+      `------*/
+
+      void
+      Socket::writev(std::vector<elle::ConstWeakBuffer> const& buffers)
+      {
+        for (auto const& buffer: buffers)
+          this->write(buffer);
+      }
+
       std::unique_ptr<Socket>
       Socket::create(Protocol protocol,
                      const std::string& hostname,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <elle/Buffer.hh>
 #include <elle/IOStream.hh>
 #include <elle/attribute.hh>
@@ -86,6 +88,16 @@ namespace elle
         virtual
         void
         write(elle::ConstWeakBuffer buffer) = 0;
+        /// Write the concatenation of the given buffers to the Socket.
+        ///
+        /// Stream sockets send them at once with a gather write, without
+        /// copying them. Data buffered by the std::iostream interface is not
+        /// flushed beforehand.
+        ///
+        /// @param buffers The payloads to write, in order.
+        virtual
+        void
+        writev(std::vector<elle::ConstWeakBuffer> const& buffers);
 
       /*-----.
       | Read |
@@ -342,6 +354,9 @@ namespace elle
         /// @Socket::write.
         void
         write(elle::ConstWeakBuffer buffer) override;
+        /// @Socket::writev.
+        void
+        writev(std::vector<elle::ConstWeakBuffer> const& buffers) override;
       protected:
         void
         _final_flush();
@@ -1,3 +1,5 @@
+#include <elle/Measure.hh>
+#include <elle/metrics.hh>
 #include <elle/reactor/network/SocketOperation.hxx>
 
 namespace elle
@@ -354,6 +356,9 @@ namespace elle
                          some ? "up to " : "",
                          buf.size(),
                          timeout ? elle::sprintf(" in %s", timeout.get()): "");
+        ELLE_MEASURE_SCOPE("elle.reactor.network.Socket.read");
+        static auto& bytes =
+          elle::metrics::counter("elle.reactor.network.Socket.read.bytes");
         if (this->_streambuffer.size())
         {
           std::istream s(&this->_streambuffer);
@@ -364,6 +369,7 @@ namespace elle
           {
             ELLE_DEBUG("%s: completed read of %s (cached) bytes: %s",
                        *this, size, buf);
+            bytes.increment(size);
             if (bytes_read)
               *bytes_read = size;
             return size;
@@ -395,6 +401,7 @@ namespace elle
           throw TimeOut();
         }
         ELLE_TRACE("%s: completed read of %s bytes", *this, read.read());
+        bytes.increment(read.read());
         ELLE_DUMP(": %s", buf);
 
         auto data = elle::ConstWeakBuffer(buf.contents(), read.read());
@@ -502,7 +509,12 @@ namespace elle
       | Write |
       `------*/
 
-      template <typename PlainSocket, typename AsioSocket>
+      /// Write a sequence of buffers.
+      ///
+      /// @tparam Buffers An asio ConstBufferSequence.
+      template <typename PlainSocket,
+                typename AsioSocket,
+                typename Buffers = boost::asio::const_buffers_1>
       class Write:
         public DataOperation<typename SocketSpecialization<AsioSocket>::Socket>
       {
@@ -512,10 +524,10 @@ namespace elle
         using Spe = SocketSpecialization<AsioSocket>;
         Write(PlainSocket& plain,
               AsioSocket& socket,
-              elle::ConstWeakBuffer buffer)
+              Buffers buffers)
           : Super(Spe::socket(socket))
           , _socket(plain)
-          , _buffer(std::move(buffer))
+          , _buffers(std::move(buffers))
           , _written(0)
         {}
 
@@ -525,7 +537,7 @@ namespace elle
         {
           boost::asio::async_write(
             *this->_socket.socket(),
-            boost::asio::buffer(this->_buffer.contents(), this->_buffer.size()),
+            this->_buffers,
             [this](const boost::system::error_code& error,
                    std::size_t written)
             {
@@ -548,7 +560,7 @@ namespace elle
         }
 
         ELLE_ATTRIBUTE(PlainSocket const&, socket);
-        ELLE_ATTRIBUTE(elle::ConstWeakBuffer, buffer);
+        ELLE_ATTRIBUTE(Buffers, buffers);
         ELLE_ATTRIBUTE_R(Size, written);
       };
 
@@ -557,12 +569,18 @@ namespace elle
       StreamSocket<AsioSocket, EndPoint>::write(elle::ConstWeakBuffer buffer)
       {
         ELLE_LOG_COMPONENT("elle.reactor.network.Socket");
+        static auto& bytes =
+          elle::metrics::counter("elle.reactor.network.Socket.write.bytes");
+        bytes.increment(buffer.size());
         if (reactor::scheduler().current())
         {
+          ELLE_MEASURE_SCOPE("elle.reactor.network.Socket.write");
           {
             Lock lock(this->_write_mutex);
             ELLE_TRACE_SCOPE("%s: write %s bytes", this, buffer.size());
-            Write<Self, AsioSocket> write(*this, *this->socket(), buffer);
+            Write<Self, AsioSocket> write(
+              *this, *this->socket(),
+              boost::asio::buffer(buffer.contents(), buffer.size()));
             write.run();
           }
           this->_async_write();
@@ -574,6 +592,48 @@ namespace elle
         }
       }
 
+      template <typename AsioSocket, typename EndPoint>
+      void
+      StreamSocket<AsioSocket, EndPoint>::writev(
+        std::vector<elle::ConstWeakBuffer> const& buffers)
+      {
+        ELLE_LOG_COMPONENT("elle.reactor.network.Socket");
+        static auto& bytes =
+          elle::metrics::counter("elle.reactor.network.Socket.write.bytes");
+        auto asio_buffers = std::vector<boost::asio::const_buffer>{};
+        asio_buffers.reserve(buffers.size());
+        auto size = Size(0);
+        for (auto const& b: buffers)
+        {
+          asio_buffers.emplace_back(b.contents(), b.size());
+          size += b.size();
+        }
+        bytes.increment(size);
+        if (reactor::scheduler().current())
+        {
+          ELLE_MEASURE_SCOPE("elle.reactor.network.Socket.write");
+          {
+            Lock lock(this->_write_mutex);
+            ELLE_TRACE_SCOPE("%s: write %s bytes from %s buffers",
+                             this, size, buffers.size());
+            Write<Self, AsioSocket, std::vector<boost::asio::const_buffer>>
+              write(*this, *this->socket(), std::move(asio_buffers));
+            write.run();
+          }
+          this->_async_write();
+        }
+        else
+        {
+          // Asynchronous writes outlive the caller buffers, copy them.
+          auto buffer = elle::Buffer{};
+          buffer.capacity(size);
+          for (auto const& b: buffers)
+            buffer.append(b.contents(), b.size());
+          this->_async_writes.emplace_back(std::move(buffer));
+          this->_async_write();
+        }
+      }
+
       template <typename AsioSocket, typename EndPoint>
       void
       StreamSocket<AsioSocket, EndPoint>::_async_write()
@@ -1,13 +1,15 @@
+#include <atomic>
+#include <fstream>
+
 #include <elle/Measure.hh>
 #include <elle/Plugin.hh>
 #include <elle/assert.hh>
 #include <elle/attribute.hh>
 #include <elle/finally.hh>
-#include <elle/find.hh>
 #include <elle/log.hh>
-#include <elle/make-vector.hh>
 #include <elle/memory.hh>
 #include <elle/os/environ.hh>
+#include <elle/printf.hh>
 #include <elle/reactor/BackgroundOperation.hh>
 #include <elle/reactor/backend/backend.hh>
 #if defined REACTOR_CORO_BACKEND_IO
@@ -17,6 +19,7 @@
 #endif
 #include <elle/reactor/exception.hh>
 #include <elle/reactor/Operation.hh>
+#include <elle/reactor/Profiler.hh>
 #include <elle/reactor/scheduler.hh>
 #include <elle/reactor/Thread.hh>
 
@@ -25,6 +28,20 @@ ELLE_LOG_COMPONENT("elle.reactor.Scheduler");
 namespace
 {
   auto const DBG = elle::os::getenv("REACTOR_SCHEDULER_DEBUG", false);
+
+  /// Where to save the profile, unique per Scheduler.
+  std::string
+  profile_path()
+  {
+    static auto const prefix = elle::os::getenv("ELLE_REACTOR_PROFILE", "");
+    static std::atomic<int> count(0);
+    if (prefix.empty())
+      return prefix;
+    else if (auto const n = count++)
+      return elle::sprintf("%s.%s", prefix, n);
+    else
+      return prefix;
+  }
 }
 
 namespace elle
@@ -42,7 +59,9 @@ namespace elle
     `-------------*/
 
     Scheduler::Scheduler()
-      : _done(false)
+      : _profiler()
+      , _profile_path(profile_path())
+      , _done(false)
       , _shallstop(false)
       , _current(nullptr)
       , _background_service_work(
@@ -72,6 +91,18 @@ namespace elle
             this->dump_state();
           });
 #endif
+      if (!this->_profile_path.empty())
+      {
+        this->profile(true);
+#ifndef INFINIT_WINDOWS
+        this->signal_handle(
+          SIGUSR2,
+          [this]
+          {
+            this->_profile_save();
+          });
+#endif
+      }
     }
 
     Scheduler::~Scheduler() = default;
@@ -166,20 +197,54 @@ namespace elle
       if (!this->_frozen.empty())
       {
         std::cerr << "== FROZEN THREADS ==" << std::endl;
-        for (auto thread: this->_frozen)
-          print_thread(*thread);
+        for (auto& thread: this->_frozen)
+          print_thread(thread);
       }
-      if (!this->_running.empty())
+      if (!this->_running.empty() || !this->_round.empty())
       {
         std::cerr << "== RUNNING THREADS ==" << std::endl;
-        for (auto thread: this->_running)
-          print_thread(*thread);
+        for (auto& thread: this->_round)
+          print_thread(thread);
+        for (auto& thread: this->_running)
+          print_thread(thread);
       }
       if (!this->_starting.empty())
       {
         std::cerr << "== STARTING THREADS ==" << std::endl;
-        for (auto thread: this->_starting)
-          print_thread(*thread);
+        for (auto& thread: this->_starting)
+          print_thread(thread);
+      }
+    }
+
+    void
+    Scheduler::profile(bool enable)
+    {
+      if (enable && !this->_profiler)
+        this->_profiler = std::make_unique<Profiler>();
+      else if (!enable)
+        this->_profiler.reset();
+    }
+
+    Profiler*
+    Scheduler::profiler() const
+    {
+      return this->_profiler.get();
+    }
+
+    void
+    Scheduler::_profile_save() const
+    {
+      if (!this->_profiler)
+        return;
+      ELLE_LOG("%s: save profile to %s.{collapsed,json}",
+               *this, this->_profile_path);
+      {
+        std::ofstream output(this->_profile_path + ".collapsed");
+        this->_profiler->collapsed(output);
+      }
+      {
+        std::ofstream output(this->_profile_path + ".json");
+        this->_profiler->chrome_trace(output);
       }
     }
 
@@ -228,10 +293,18 @@ namespace elle
         ELLE_TRACE("%s: done", *this);
       }
       ELLE_ASSERT(this->_frozen.empty());
+      if (!this->_profile_path.empty())
+        this->_profile_save();
       if (this->_eptr)
         this->_rethrow_exception(this->_eptr);
     }
 
+    bool
+    Scheduler::_idle()
+    {
+      return false;
+    }
+
     void
     Scheduler::_rethrow_exception(std::exception_ptr e) const
     {
@@ -245,29 +318,28 @@ namespace elle
       // Could avoid locking if no jobs are pending with a boolean.
       {
         std::unique_lock<std::mutex> lock(this->_starting_mtx);
-        auto& ordered = this->_starting.get<1>();
-        this->_running.insert(ordered.begin(), ordered.end());
-        this->_starting.clear();
-      }
-      auto& ordered = this->_running.get<1>();
-      auto running = make_vector(ordered);
-      ELLE_TRACE_SCOPE("Scheduler: new round with %s jobs", running.size());
-
-      ELLE_DUMP("%s: starting: %s", this, this->_starting);
-      ELLE_DUMP("%s: running: %s", this, this->_running);
-      ELLE_DUMP("%s: frozen: %s", this, this->_frozen);
-      ELLE_MEASURE("Scheduler round")
-        for (Thread* t: running)
-          // If the thread was stopped during this round, skip. Can be caused by
-          // terminate_now, for instance.
-          if (elle::find(this->_running, t))
-          {
-            ELLE_TRACE("Scheduler: schedule %s", *t);
-            this->_step(t);
-          }
+        for (auto& t: this->_starting)
+          t._starting = false;
+        this->_running.splice(this->_running.end(), this->_starting);
+      }
+      // Only run Threads that are runnable when the round starts. They are
+      // moved back to the run queue one by one as they are stepped: Threads
+      // frozen or terminated during the round unlink themselves and are thus
+      // skipped, Threads woken up during the round wait for the next one.
+      this->_round.splice(this->_round.end(), this->_running);
+      ELLE_TRACE_SCOPE("Scheduler: new round");
+      ELLE_MEASURE("elle.reactor.Scheduler.round")
+        while (!this->_round.empty())
+        {
+          auto& t = this->_round.front();
+          this->_round.pop_front();
+          this->_running.push_back(t);
+          ELLE_TRACE("Scheduler: schedule %s", t);
+          this->_step(&t);
+        }
       ELLE_TRACE("%s: run asynchronous jobs", *this)
       {
-        ELLE_MEASURE_SCOPE("Asio callbacks");
+        ELLE_MEASURE_SCOPE("elle.reactor.Scheduler.asio");
         try
         {
           this->_io_service.reset();
@@ -290,7 +362,7 @@ namespace elle
       }
       if (this->_running.empty() && this->_starting.empty())
       {
-        if (this->_frozen.empty())
+        if (!this->_idle() && this->_frozen.empty())
         {
           ELLE_TRACE_SCOPE("%s: no threads left, we're done", *this);
           return false;
@@ -316,6 +388,8 @@ namespace elle
             }
             else if (this->_shallstop)
               break;
+            else if (!this->_idle() && this->_frozen.empty())
+              break;
           }
       }
       else
@@ -331,6 +405,8 @@ namespace elle
       ELLE_ASSERT_EQ(thread->state(), Thread::State::running);
       Thread* previous = this->_current;
       this->_current = thread;
+      auto const start = this->_profiler
+        ? Profiler::Clock::now() : Profiler::Clock::time_point();
       try
       {
         thread->_step();
@@ -347,10 +423,16 @@ namespace elle
         this->_eptr = std::current_exception();
         this->terminate();
       }
+      // Profiling may have been started or stopped by the step itself.
+      auto const profiler = this->_profiler.get();
+      if (profiler && start != Profiler::Clock::time_point())
+        profiler->_stepped(*thread, start);
       if (thread->state() == Thread::State::done)
       {
         ELLE_TRACE("%s: %s finished", *this, *thread);
-        this->_running.erase(thread);
+        if (profiler)
+          profiler->_finished(*thread);
+        thread->_scheduler_hook.unlink();
         thread->_scheduler_release();
       }
     }
@@ -369,9 +451,11 @@ namespace elle
     Scheduler::_freeze(Thread& thread)
     {
       ELLE_ASSERT_EQ(thread.state(), Thread::State::running);
-      ELLE_ASSERT_NEQ(this->_running.find(&thread), this->_running.end());
-      this->_running.erase(&thread);
-      this->_frozen.insert(&thread);
+      ELLE_ASSERT(thread._scheduler_hook.is_linked());
+      thread._scheduler_hook.unlink();
+      this->_frozen.push_back(thread);
+      if (this->_profiler)
+        this->_profiler->_frozen(thread);
       thread.frozen()();
     }
 
@@ -381,20 +465,36 @@ namespace elle
       // FIXME: be thread safe only if needed
       {
         std::unique_lock<std::mutex> lock(this->_starting_mtx);
-        this->_starting.insert(&thread);
+        thread._starting = true;
+        this->_starting.push_back(thread);
         // Wake the scheduler.
         this->_io_service.post([]{});
       }
     }
 
+    bool
+    Scheduler::_discard_starting(Thread& thread)
+    {
+      std::unique_lock<std::mutex> lock(this->_starting_mtx);
+      if (!thread._starting)
+        return false;
+      thread._starting = false;
+      thread._scheduler_hook.unlink();
+      return true;
+    }
+
     void
     Scheduler::_unfreeze(Thread& thread, std::string const& reason)
     {
       ELLE_ASSERT_EQ(thread.state(), Thread::State::frozen);
-      this->_frozen.erase(&thread);
-      this->_running.insert(&thread);
-      thread.unfrozen()(reason);
-      if (this->_running.size() == 1)
+      thread._scheduler_hook.unlink();
+      auto const wake = this->_running.empty();
+      this->_running.push_back(thread);
+      if (this->_profiler)
+        this->_profiler->_unfrozen(thread);
+      if (!thread.unfrozen().empty())
+        thread.unfrozen()(reason);
+      if (wake)
         this->_io_service.post([]{});
     }
 
@@ -410,25 +510,26 @@ namespace elle
     {
       ELLE_TRACE_SCOPE("%s: terminate", *this);
       Threads terminated;
-      for (Thread* t: this->_starting)
+      while (!this->_starting.empty())
       {
+        auto& t = this->_starting.front();
+        this->_starting.pop_front();
+        t._starting = false;
         // Threads expect to be done when deleted. For this very
         // particuliar case, hack the state before deletion.
-        t->_state = Thread::State::done;
-        t->_scheduler_release();
-      }
-      this->_starting.clear();
-      for (Thread* t: Threads(this->_running))
-        if (t != this->_current)
-        {
-          t->terminate();
-          terminated.insert(t);
-        }
-      for (Thread* t: Threads(this->_frozen))
-      {
+        t._state = Thread::State::done;
+        t._scheduler_release();
+      }
+      // Terminating a Thread moves it between queues, collect them first.
+      for (auto& t: this->_round)
+        terminated.insert(&t);
+      for (auto& t: this->_running)
+        if (&t != this->_current)
+          terminated.insert(&t);
+      for (auto& t: this->_frozen)
+        terminated.insert(&t);
+      for (auto t: terminated)
         t->terminate();
-        terminated.insert(t);
-      }
       return terminated;
     }
 
@@ -451,7 +552,7 @@ namespace elle
         throw Terminate(thread->name());
       }
       // If the underlying coroutine was never run, nothing to do.
-      else if (this->_starting.erase(thread))
+      else if (this->_discard_starting(*thread))
       {
         ELLE_DEBUG("thread was starting, discard it");
         thread->_state = Thread::State::done;
@@ -812,6 +913,14 @@ namespace
     static CXAThreadMap _cxa_thread_map;
     return _cxa_thread_map;
   }
+
+  /// Several schedulers may run on different system threads.
+  std::mutex&
+  cxa_thread_map_mutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
 }
 
 namespace __cxxabiv1
@@ -829,6 +938,7 @@ namespace __cxxabiv1
         t = sched->manager().current();
       if (sched == nullptr)
       {
+        std::unique_lock<std::mutex> lock(cxa_thread_map_mutex());
         auto &res = map[std::this_thread::get_id()];
         if (!res)
           res.reset(new __cxa_eh_globals());
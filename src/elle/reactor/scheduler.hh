@@ -4,6 +4,7 @@
 #include <mutex>
 #include <thread>
 
+#include <boost/intrusive/list.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/identity.hpp>
@@ -17,6 +18,7 @@
 #include <elle/Printable.hh>
 #include <elle/attribute.hh>
 #include <elle/reactor/asio.hh>
+#include <elle/reactor/Thread.hh>
 #include <elle/reactor/duration.hh>
 #include <elle/reactor/fwd.hh>
 #include <elle/reactor/backend/fwd.hh>
@@ -104,6 +106,25 @@ namespace elle
       void
       dump_state();
 
+      /// Start or stop profiling Threads, see Profiler.
+      ///
+      /// Profiling starts with $ELLE_REACTOR_PROFILE set to a path prefix, in
+      /// which case the profile is saved to `<prefix>.collapsed` and
+      /// `<prefix>.json` on SIGUSR2 and when the Scheduler is done. Further
+      /// Schedulers of the process use `<prefix>.1`, `<prefix>.2`, ...
+      ///
+      /// @param enable Whether to profile. Stopping discards the profile.
+      void
+      profile(bool enable);
+      /// The profiler, if profiling.
+      Profiler*
+      profiler() const;
+    private:
+      ELLE_ATTRIBUTE(std::unique_ptr<Profiler>, profiler);
+      ELLE_ATTRIBUTE(std::string, profile_path);
+      void
+      _profile_save() const;
+
     /*----.
     | Run |
     `----*/
@@ -115,6 +136,16 @@ namespace elle
       /// Perfom cycle of the Scheduler.
       bool
       step();
+    protected:
+      /// Called when no Thread is runnable, before blocking on asio.
+      ///
+      /// Subclasses may make new Threads runnable from here, for instance by
+      /// taking work from other schedulers.
+      ///
+      /// @returns Whether to keep running even if no Thread is left.
+      virtual
+      bool
+      _idle();
     private:
       virtual
       void
@@ -162,6 +193,11 @@ namespace elle
       _freeze(Thread& thread);
       void
       _thread_register(Thread& thread);
+      /// Remove @a thread from the starting Threads.
+      ///
+      /// @returns Whether @a thread was starting.
+      bool
+      _discard_starting(Thread& thread);
       void
       _unfreeze(Thread& thread, std::string const& reason);
     private:
@@ -182,11 +218,22 @@ namespace elle
       void
       _terminate_now(Thread* thread,
                      bool suicide);
+      /// An intrusive list of Threads, linked through Thread::_scheduler_hook.
+      ///
+      /// A Thread belongs to at most one queue at a time and unlinks itself
+      /// from it, so moving it between queues neither allocates nor hashes.
+      using Queue = boost::intrusive::list<
+        Thread,
+        boost::intrusive::member_hook<
+          Thread, Thread::SchedulerHook, &Thread::_scheduler_hook>,
+        boost::intrusive::constant_time_size<false>>;
       ELLE_ATTRIBUTE(Thread*, current);
-      ELLE_ATTRIBUTE(Threads, starting);
+      ELLE_ATTRIBUTE(Queue, starting);
       ELLE_ATTRIBUTE(std::mutex, starting_mtx);
-      ELLE_ATTRIBUTE(Threads, running);
-      ELLE_ATTRIBUTE(Threads, frozen);
+      /// Threads left to run in the current round.
+      ELLE_ATTRIBUTE(Queue, round);
+      ELLE_ATTRIBUTE(Queue, running);
+      ELLE_ATTRIBUTE(Queue, frozen);
 
     /*-------------------------.
     | Thread Exception Handler |
@@ -1,4 +1,5 @@
 #include <elle/serialization/Serializer.hh>
+#include <elle/serialization/Error.hh>
 #include <elle/serialization/SerializerIn.hh>
 #include <elle/serialization/SerializerOut.hh>
 
@@ -10,6 +11,8 @@ namespace elle
   {
     Serializer::Serializer(bool versioned)
       : _versioned(versioned)
+      , _named(true)
+      , _binary_buffer(nullptr)
     {
       static_assert(Details::api<int>() == Details::pod, "");
       static_assert(Details::api<unsigned long>() == Details::pod, "");
@@ -18,6 +21,8 @@ namespace elle
     Serializer::Serializer(Versions versions, bool versioned)
       : _versioned(versioned)
       , _versions(std::move(versions))
+      , _named(true)
+      , _binary_buffer(nullptr)
     {}
 
     /*--------------.
@@ -26,22 +31,25 @@ namespace elle
 
     Serializer::Entry::Entry(Serializer& s, std::string const& name)
       : _serializer(s)
-      , _log(ELLE_LOG_VALUE(
+      , _log(s._named
+             ? ELLE_LOG_VALUE(
                elle::log::Logger::Level::trace,
                elle::log::Logger::Type::info,
-               "%s: %sserialize \"%s\"", s, s.in() ? "de" : "", name))
+               "%s: %sserialize \"%s\"", s, s.in() ? "de" : "", name)
+             : elle::log::detail::Send())
       , _name(name)
       , _entered(this->_serializer._enter(name))
     {
-      if (this->_entered)
-        s._names.emplace_back(name);
+      if (this->_entered && s._named)
+        s._names.emplace_back(&name);
     }
 
     Serializer::Entry::~Entry()
     {
       if (this->_entered)
       {
-        this->_serializer._names.pop_back();
+        if (this->_serializer._named)
+          this->_serializer._names.pop_back();
         this->_serializer._leave(this->_name);
       }
     }
@@ -67,10 +75,11 @@ namespace elle
     Serializer::_leave(std::string const&)
     {}
 
-    std::string
+    std::string const&
     Serializer::current_name() const
     {
-      return this->_names.empty() ? "" : this->_names.back();
+      static auto const none = std::string();
+      return this->_names.empty() ? none : *this->_names.back();
     }
 
     void
@@ -95,6 +104,15 @@ namespace elle
       return !this->out();
     }
 
+    void
+    Serializer::_serialize_pod(double& v)
+    {
+      if (this->_binary_buffer)
+        this->_binary_buffer->append(&v, sizeof v);
+      else
+        this->_serialize(v);
+    }
+
     void
     Serializer::_serialize(elle::WeakBuffer& v)
     {
@@ -113,6 +131,19 @@ namespace elle
       }
     }
 
+    void
+    Serializer::_serialize(elle::ConstWeakBuffer& v)
+    {
+      if (this->in())
+        elle::err<Error>("%s: unable to borrow \"%s\" from this input",
+                         *this, this->current_name());
+      else
+      {
+        auto buf = elle::Buffer(v);
+        this->_serialize(buf);
+      }
+    }
+
     void
     Serializer::set_context(Context const& context)
     {
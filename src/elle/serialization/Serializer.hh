@@ -576,7 +576,7 @@ namespace elle
       Entry
       enter(std::string const& name);
       /// Get the name of the current Entry.
-      std::string
+      std::string const&
       current_name() const;
     protected:
       /// Call when entering an entry or a collection.
@@ -596,7 +596,14 @@ namespace elle
       virtual
       void
       _leave(std::string const& name);
-      ELLE_ATTRIBUTE(std::vector<std::string>, names, protected);
+      /// The names of the entries we are in, which outlive them.
+      ELLE_ATTRIBUTE(std::vector<std::string const*>, names, protected);
+      /// Whether entry names are tracked and logged. Formats that never
+      /// write them may skip that bookkeeping.
+      ELLE_ATTRIBUTE(bool, named, protected);
+      /// The Buffer a binary SerializerOut appends to, if any, to write
+      /// fundamental values without virtual calls.
+      ELLE_ATTRIBUTE(elle::Buffer*, binary_buffer, protected);
 
     protected:
       /// XXX[doc].
@@ -704,10 +711,30 @@ namespace elle
       /// Serialize or deserialize a elle::WeakBuffer.
       void
       _serialize(elle::WeakBuffer& v);
+      /// Serialize a elle::ConstWeakBuffer like a elle::Buffer, or
+      /// deserialize one borrowed from the input.
+      ///
+      /// @throws Error when deserializing, unless the input can lend it.
+      virtual
+      void
+      _serialize(elle::ConstWeakBuffer& v);
       /// Serialize or deserialize a boost::posix_time::ptime.
       virtual
       void
       _serialize(boost::posix_time::ptime& v) = 0;
+      /// Serialize or deserialize an integer, directly in _binary_buffer if
+      /// set.
+      template <typename T>
+      std::enable_if_t<std::is_integral<T>::value>
+      _serialize_pod(T& v);
+      /// Serialize or deserialize a double, directly in _binary_buffer if
+      /// set.
+      void
+      _serialize_pod(double& v);
+      /// Serialize or deserialize any other value.
+      template <typename T>
+      std::enable_if_t<!std::is_integral<T>::value>
+      _serialize_pod(T& v);
       /// Serialize or deserialize an elle::Duration.
       template <typename Repr, typename Ratio>
       void
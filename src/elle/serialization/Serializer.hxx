@@ -13,6 +13,7 @@
 # include <elle/serialization/Error.hh>
 # include <elle/serialization/SerializerIn.hh>
 # include <elle/serialization/SerializerOut.hh>
+# include <elle/serialization/binary/number.hh>
 # include <elle/utils.hh>
 
 namespace elle
@@ -487,7 +488,7 @@ namespace elle
         {
           ELLE_LOG_COMPONENT("elle.serialization.Serializer");
           ELLE_DUMP("API: POD");
-          s._serialize(v);
+          s._serialize_pod(v);
         }
       };
 
@@ -734,6 +735,25 @@ namespace elle
       }
     }
 
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value>
+    Serializer::_serialize_pod(T& v)
+    {
+      // Same encoding as binary::SerializerOut::_serialize, minus the
+      // virtual call.
+      if (this->_binary_buffer)
+        binary::append_number(*this->_binary_buffer, v);
+      else
+        this->_serialize(v);
+    }
+
+    template <typename T>
+    std::enable_if_t<!std::is_integral<T>::value>
+    Serializer::_serialize_pod(T& v)
+    {
+      this->_serialize(v);
+    }
+
     /*--------------.
     | Serialization |
     `--------------*/
@@ -1581,6 +1601,52 @@ namespace elle
         input, std::string(name), version);
     }
 
+    namespace _details
+    {
+      ELLE_STATIC_PREDICATE(has_memory_input, decltype(T::memory_input));
+
+      /// What Serialization::SerializerIn reads a Buffer from: a stream on
+      /// it.
+      template <typename Serialization,
+                bool = has_memory_input<Serialization>()>
+      class BufferInput
+      {
+      public:
+        BufferInput(elle::Buffer const& buffer)
+          : _stream(buffer.istreambuf())
+        {}
+
+        std::istream&
+        get()
+        {
+          return this->_stream;
+        }
+
+      private:
+        elle::IOStream _stream;
+      };
+
+      /// What Serialization::SerializerIn reads a Buffer from: the memory
+      /// itself, when it can.
+      template <typename Serialization>
+      class BufferInput<Serialization, true>
+      {
+      public:
+        BufferInput(elle::Buffer const& buffer)
+          : _buffer(buffer)
+        {}
+
+        elle::ConstWeakBuffer
+        get()
+        {
+          return this->_buffer;
+        }
+
+      private:
+        elle::ConstWeakBuffer _buffer;
+      };
+    }
+
     template <typename Serialization, typename T, typename Serializer = void>
     T
     deserialize(elle::Buffer const& input,
@@ -1588,9 +1654,13 @@ namespace elle
                 bool versioned = true,
                 boost::optional<Context const&> context = {})
     {
-      elle::IOStream s(input.istreambuf());
-      return deserialize<Serialization, T, Serializer>(
-        s, version, versioned, context);
+      auto versions = get_serialization_versions
+        <typename _details::serialization_tag<T>::type>(version);
+      _details::BufferInput<Serialization> in(input);
+      typename Serialization::SerializerIn s(in.get(), versions, versioned);
+      if (context)
+        s.set_context(context.get());
+      return s.template deserialize<T, Serializer>();
     }
 
     template <typename Serialization, typename T, typename Serializer = void>
@@ -1598,8 +1668,11 @@ namespace elle
     deserialize(elle::Buffer const& input, bool version = true,
                 boost::optional<Context const&> context = {})
     {
-      elle::IOStream s(input.istreambuf());
-      return deserialize<Serialization, T, Serializer>(s, version, context);
+      _details::BufferInput<Serialization> in(input);
+      typename Serialization::SerializerIn s(in.get(), version);
+      if (context)
+        s.set_context(context.get());
+      return s.template deserialize<T, Serializer>();
     }
 
     template <typename Serialization, typename T, typename Serializer = void>
@@ -1607,8 +1680,9 @@ namespace elle
     deserialize(elle::Buffer const& input, std::string const& name,
                 bool version = true)
     {
-      elle::IOStream s(input.istreambuf());
-      return deserialize<Serialization, T, Serializer>(s, name, version);
+      _details::BufferInput<Serialization> in(input);
+      typename Serialization::SerializerIn s(in.get(), version);
+      return s.template deserialize<T, Serializer>(name);
     }
 
     // Prevent literal string from being converted to boolean and triggerring
@@ -1713,6 +1787,77 @@ namespace elle
       s.template serialize_forward<Serializer>(o);
     }
 
+    namespace _details
+    {
+      /// Whether Serialization::SerializerOut can append to a Buffer
+      /// directly, given the rest of the constructor arguments.
+      template <typename Serialization, typename ... Args>
+      using to_buffer = std::is_constructible<
+        typename Serialization::SerializerOut, elle::Buffer&, Args&& ...>;
+
+      template <typename Serialization,
+                typename Serializer,
+                typename T,
+                typename ... Args>
+      void
+      serialize_named_buffer(std::true_type,
+                             elle::Buffer& res,
+                             T const& o,
+                             std::string const& name,
+                             Args&& ... args)
+      {
+        typename Serialization::SerializerOut s(
+          res, std::forward<Args>(args)...);
+        s.template serialize<Serializer>(name, o);
+      }
+
+      template <typename Serialization,
+                typename Serializer,
+                typename T,
+                typename ... Args>
+      void
+      serialize_named_buffer(std::false_type,
+                             elle::Buffer& res,
+                             T const& o,
+                             std::string const& name,
+                             Args&& ... args)
+      {
+        elle::IOStream s(res.ostreambuf());
+        elle::serialization::serialize<Serialization, Serializer, T>(
+          o, name, s, std::forward<Args>(args)...);
+      }
+
+      template <typename Serialization,
+                typename Serializer,
+                typename T,
+                typename ... Args>
+      void
+      serialize_buffer(std::true_type,
+                       elle::Buffer& res,
+                       T const& o,
+                       Args&& ... args)
+      {
+        typename Serialization::SerializerOut s(
+          res, std::forward<Args>(args)...);
+        s.template serialize_forward<Serializer>(o);
+      }
+
+      template <typename Serialization,
+                typename Serializer,
+                typename T,
+                typename ... Args>
+      void
+      serialize_buffer(std::false_type,
+                       elle::Buffer& res,
+                       T const& o,
+                       Args&& ... args)
+      {
+        elle::IOStream s(res.ostreambuf());
+        elle::serialization::serialize<Serialization, Serializer, T>(
+          o, s, std::forward<Args>(args)...);
+      }
+    }
+
     // Buffer, named
     template <typename Serialization,
               typename Serializer = void,
@@ -1724,11 +1869,9 @@ namespace elle
               Args&& ... args)
     {
       elle::Buffer res;
-      {
-        elle::IOStream s(res.ostreambuf());
-        serialize<Serialization, Serializer, T>(
-          o, name, s, std::forward<Args>(args)...);
-      }
+      _details::serialize_named_buffer<Serialization, Serializer>(
+        _details::to_buffer<Serialization, Args...>(),
+        res, o, name, std::forward<Args>(args)...);
       return res;
     }
 
@@ -1754,11 +1897,9 @@ namespace elle
     serialize(T const& o, Args&& ... args)
     {
       elle::Buffer res;
-      {
-        elle::IOStream s(res.ostreambuf());
-        serialize<Serialization, Serializer, T>(
-          o, s, std::forward<Args>(args)...);
-      }
+      _details::serialize_buffer<Serialization, Serializer>(
+        _details::to_buffer<Serialization, Args...>(),
+        res, o, std::forward<Args>(args)...);
       return res;
     }
 
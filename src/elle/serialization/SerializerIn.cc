@@ -18,5 +18,19 @@ namespace elle
     {
       return false;
     }
+
+    bool
+    SerializerIn::deserialize_keys(
+      std::function<void (std::string const&)> const& f)
+    {
+      return this->_deserialize_keys(f);
+    }
+
+    bool
+    SerializerIn::_deserialize_keys(
+      std::function<void (std::string const&)> const&)
+    {
+      return false;
+    }
   }
 }
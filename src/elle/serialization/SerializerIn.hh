@@ -83,12 +83,28 @@ namespace elle
       template <typename T, typename Serializer = void>
       T
       deserialize();
+      /// Deserialize the entries of the current object in input order.
+      ///
+      /// @a f is called with the key of every entry, entered. It may leave
+      /// the entry unread to skip it.
+      ///
+      /// @param f The function to deserialize an entry.
+      /// @returns Whether the format has keys, or false without calling @a f,
+      ///          like binary.
+      bool
+      deserialize_keys(std::function<void (std::string const&)> const& f);
 
     /*--------.
     | Details |
     `--------*/
     protected:
       friend class Serializer;
+      /// Call deserialize_keys.
+      ///
+      /// Return false.
+      virtual
+      bool
+      _deserialize_keys(std::function<void (std::string const&)> const& f);
     };
   }
 }
@@ -12,6 +12,8 @@ namespace elle
     public:
       using SerializerIn = binary::SerializerIn;
       using SerializerOut = binary::SerializerOut;
+      /// SerializerIn reads an elle::ConstWeakBuffer directly.
+      static constexpr bool memory_input = true;
     };
 
     namespace binary
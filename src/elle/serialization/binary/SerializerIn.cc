@@ -1,5 +1,8 @@
 #include <elle/serialization/binary/SerializerIn.hh>
 
+#include <cstring>
+
+#include <elle/assert.hh>
 #include <elle/meta.hh> // static_if
 
 #include <elle/serialization/json/Error.hh>
@@ -12,35 +15,82 @@ namespace elle
   {
     namespace binary
     {
+      /*-------------.
+      | Construction |
+      `-------------*/
+
       SerializerIn::SerializerIn(std::istream& input,
                                  bool versioned)
         : Super(versioned)
-        , _input(input)
+        , _stream(&input)
+        , _position(nullptr)
+        , _end(nullptr)
       {
-        this->_check_magic(input);
+        this->_check_magic();
       }
 
       SerializerIn::SerializerIn(std::istream& input,
                                  Versions versions,
                                  bool versioned)
         : Super(std::move(versions), versioned)
-        , _input(input)
+        , _stream(&input)
+        , _position(nullptr)
+        , _end(nullptr)
+      {
+        this->_check_magic();
+      }
+
+      SerializerIn::SerializerIn(elle::ConstWeakBuffer input,
+                                 bool versioned)
+        : Super(versioned)
+        , _stream(nullptr)
+        , _position(input.contents())
+        , _end(input.contents() + input.size())
+      {
+        this->_check_magic();
+      }
+
+      SerializerIn::SerializerIn(elle::ConstWeakBuffer input,
+                                 Versions versions,
+                                 bool versioned)
+        : Super(std::move(versions), versioned)
+        , _stream(nullptr)
+        , _position(input.contents())
+        , _end(input.contents() + input.size())
       {
-        this->_check_magic(input);
+        this->_check_magic();
       }
 
       void
-      SerializerIn::_check_magic(std::istream& input)
+      SerializerIn::_check_magic()
       {
         char magic;
-        input.read(&magic, 1);
-        if (input.gcount() != 1)
+        if (this->_stream)
+        {
+          this->_stream->read(&magic, 1);
+          if (this->_stream->gcount() != 1)
+            err<Error>("unable to read magic");
+        }
+        else if (this->_position == this->_end)
           err<Error>("unable to read magic");
+        else
+          magic = *this->_position++;
         if (magic != 0)
           err<Error>("wrong magic for binary serialization: 0x%2x (expected 0)",
                      int(static_cast<unsigned char>(magic)));
       }
 
+      std::istream&
+      SerializerIn::input() const
+      {
+        ELLE_ASSERT(this->_stream);
+        return *this->_stream;
+      }
+
+      /*--------------.
+      | Serialization |
+      `--------------*/
+
       bool
       SerializerIn::_text() const
       {
@@ -135,7 +185,7 @@ namespace elle
       void
       SerializerIn::_serialize(double& v)
       {
-        input().read((char*)(void*)&v, sizeof(double));
+        this->_read(&v, sizeof(double));
       }
 
       void
@@ -169,22 +219,34 @@ namespace elle
       void
       SerializerIn::_serialize(std::string& v)
       {
-        elle::Buffer b;
-        this->_serialize(b);
-        v = b.string();
+        auto const size = this->_serialize_size();
+        if (this->_stream)
+        {
+          v.resize(size);
+          this->_read(&v[0], size);
+        }
+        else
+          v.assign(reinterpret_cast<char const*>(this->_take(size).contents()),
+                   size);
       }
 
       void
       SerializerIn::_serialize(elle::Buffer& buffer)
       {
-        int sz = _serialize_number();
-        ELLE_DEBUG("%s: deserialize size: %s", *this, sz);
-        buffer.size(sz);
-        input().read((char*)buffer.mutable_contents(), sz);
-        if (input().gcount() != sz)
-          err<Error>("%s: short read when deserializing \"%s\":"
-                     " expected %s, got %s",
-                     *this, this->current_name(), sz, input().gcount());
+        auto const size = this->_serialize_size();
+        ELLE_DEBUG("%s: deserialize size: %s", *this, size);
+        if (this->_stream)
+        {
+          buffer.size(size);
+          this->_read(buffer.mutable_contents(), size);
+        }
+        else
+        {
+          // Check the size before allocating.
+          auto const data = this->_take(size);
+          buffer.size(size);
+          std::memcpy(buffer.mutable_contents(), data.contents(), size);
+        }
       }
 
       void
@@ -294,20 +356,15 @@ namespace elle
         return res;
       }
 
-      int64_t
-      SerializerIn::_serialize_number()
-      {
-        int64_t res;
-        SerializerIn::serialize_number(this->input(), res);
-        return res;
-      }
-
+      /// Decode a number, reading bytes one by one with @a get, or eight at
+      /// once with @a read.
+      template <typename Get, typename Read>
+      static
       size_t
-      SerializerIn::serialize_number(std::istream& input,
-                                     int64_t& res)
+      decode_number(int64_t& res, Get const& get, Read const& read)
       {
         ELLE_DEBUG_SCOPE("deserialize number");
-        unsigned char c = get(input);
+        unsigned char c = get();
         int64_t value;
         bool negative = c & 0x80;
         size_t size = 0;
@@ -320,34 +377,125 @@ namespace elle
         else if (! (c&0x20))
         {
           ELLE_DUMP("2-bytes coding");
-          unsigned char c2 = get(input);
+          unsigned char c2 = get();
           value = ((c&0x1F) << 8) + c2;
           size = 2;
         }
         else if (! (c&0x10))
         {
           ELLE_DUMP("4-bytes coding");
-          unsigned char c2 = get(input);
-          unsigned char c3 = get(input);
+          unsigned char c2 = get();
+          unsigned char c3 = get();
           value = ((c&0x0F) << 16) + (c2 << 8) + c3;
           size = 3;
         }
         else
         {
           ELLE_DUMP("8-bytes coding");
-          input.read((char*)(void*)&value, 8);
+          read(&value, 8);
           size = 9;
-          /*
-          unsigned char elems[8];
-          input.read((char*)elems, 8);
-          value = 0;
-          for (int i=0; i<8; ++i)
-            value += uint64_t(elems[i]) << (8*i);*/
         }
         res = negative ? - (int64_t)value : value;
         ELLE_DEBUG("value: %s", res);
         return size;
       }
+
+      int64_t
+      SerializerIn::_serialize_number()
+      {
+        int64_t res;
+        if (this->_stream)
+          SerializerIn::serialize_number(*this->_stream, res);
+        else
+          decode_number(
+            res,
+            [this]
+            {
+              if (this->_position == this->_end)
+                err<Error>("end of stream while reading number");
+              return *this->_position++;
+            },
+            [this] (void* data, std::size_t size)
+            {
+              this->_read(data, size);
+            });
+        return res;
+      }
+
+      std::size_t
+      SerializerIn::_serialize_size()
+      {
+        auto const size = this->_serialize_number();
+        if (size < 0)
+          err<Error>("%s: negative size when deserializing \"%s\": %s",
+                     *this, this->current_name(), size);
+        return size;
+      }
+
+      void
+      SerializerIn::_read(void* data, std::size_t size)
+      {
+        if (this->_stream)
+        {
+          this->_stream->read(static_cast<char*>(data), size);
+          if (std::size_t(this->_stream->gcount()) != size)
+            err<Error>("%s: short read when deserializing \"%s\":"
+                       " expected %s, got %s",
+                       *this, this->current_name(), size,
+                       this->_stream->gcount());
+        }
+        else
+          std::memcpy(data, this->_take(size).contents(), size);
+      }
+
+      elle::ConstWeakBuffer
+      SerializerIn::_take(std::size_t size)
+      {
+        ELLE_ASSERT(!this->_stream);
+        auto const left = std::size_t(this->_end - this->_position);
+        if (size > left)
+          err<Error>("%s: short read when deserializing \"%s\":"
+                     " expected %s, got %s",
+                     *this, this->current_name(), size, left);
+        auto res = elle::ConstWeakBuffer(this->_position, size);
+        this->_position += size;
+        return res;
+      }
+
+      size_t
+      SerializerIn::serialize_number(std::istream& input,
+                                     int64_t& res)
+      {
+        return decode_number(
+          res,
+          [&] { return get(input); },
+          [&] (void* data, std::size_t size)
+          {
+            input.read(static_cast<char*>(data), size);
+          });
+      }
+
+      /*----------------------.
+      | BorrowingSerializerIn |
+      `----------------------*/
+
+      BorrowingSerializerIn::BorrowingSerializerIn(elle::ConstWeakBuffer input,
+                                                   bool versioned)
+        : Super(input, versioned)
+      {}
+
+      BorrowingSerializerIn::BorrowingSerializerIn(elle::ConstWeakBuffer input,
+                                                   Versions versions,
+                                                   bool versioned)
+        : Super(input, std::move(versions), versioned)
+      {}
+
+      void
+      BorrowingSerializerIn::_serialize(elle::ConstWeakBuffer& v)
+      {
+        v = this->_take(this->_serialize_size());
+        ELLE_DEBUG("%s: borrow %s bytes", *this, v.size());
+      }
     }
   }
 }
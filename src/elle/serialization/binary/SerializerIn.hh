@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include <elle/Buffer.hh>
 #include <elle/attribute.hh>
 #include <elle/serialization/SerializerIn.hh>
 
@@ -15,7 +16,12 @@ namespace elle
       ///
       /// Deserialize objects from their binary representations.
       ///
-      ///
+      /// Constructed on an elle::ConstWeakBuffer, it reads the memory directly
+      /// instead of going through a std::istream, and checks sizes against
+      /// what is left before allocating anything. The Buffer overloads of
+      /// elle::serialization::deserialize pick this constructor at compile
+      /// time. Deserialized values are still copies: see
+      /// BorrowingSerializerIn to reference the input instead.
       class ELLE_API SerializerIn
         : public serialization::SerializerIn
       {
@@ -33,9 +39,22 @@ namespace elle
         SerializerIn(std::istream& input, bool versioned = true);
         SerializerIn(std::istream& input,
                      Versions versions, bool versioned = true);
+        /// Construct a SerializerIn reading @a input from memory.
+        ///
+        /// @a input must outlive the SerializerIn.
+        SerializerIn(elle::ConstWeakBuffer input, bool versioned = true);
+        /// Construct a SerializerIn reading @a input from memory.
+        ///
+        /// @a input must outlive the SerializerIn.
+        SerializerIn(elle::ConstWeakBuffer input,
+                     Versions versions, bool versioned = true);
+        /// A temporary would not outlive the SerializerIn.
+        SerializerIn(elle::Buffer&& input, bool versioned = true) = delete;
+        SerializerIn(elle::Buffer&& input,
+                     Versions versions, bool versioned = true) = delete;
       private:
         void
-        _check_magic(std::istream& input);
+        _check_magic();
 
       /*--------------.
       | Serialization |
@@ -98,13 +117,63 @@ namespace elle
         size_t
         serialize_number(std::istream& output,
                          int64_t& value);
-        ELLE_ATTRIBUTE_R(std::istream&, input);
+        /// The stream read from, if not constructed on memory.
+        std::istream&
+        input() const;
+      protected:
+        /// The next @a size bytes of the memory input, skipped over.
+        ///
+        /// @throws Error if fewer bytes are left.
+        elle::ConstWeakBuffer
+        _take(std::size_t size);
+        /// Deserialize the size of a string, Buffer, ...
+        std::size_t
+        _serialize_size();
       private:
         int64_t _serialize_number();
         template <typename T>
         void
         _serialize_int(T& v);
-    };
+        void
+        _read(void* data, std::size_t size);
+        ELLE_ATTRIBUTE(std::istream*, stream);
+        ELLE_ATTRIBUTE(elle::Buffer::Byte const*, position);
+        ELLE_ATTRIBUTE(elle::Buffer::Byte const*, end);
+      };
+
+      /// A binary SerializerIn on memory that lends parts of it.
+      ///
+      /// Besides what SerializerIn does, it deserializes
+      /// elle::ConstWeakBuffer as slices of its input, without any allocation
+      /// or copy. They are valid as long as the input is: the caller keeps
+      /// it alive, which is why temporaries are refused.
+      ///
+      /// @code{.cc}
+      ///
+      /// auto s = elle::serialization::binary::BorrowingSerializerIn(block);
+      /// auto payload = s.deserialize<elle::ConstWeakBuffer>("payload");
+      /// assert(block.contents() <= payload.contents());
+      ///
+      /// @endcode
+      class ELLE_API BorrowingSerializerIn
+        : public SerializerIn
+      {
+      public:
+        using Self = BorrowingSerializerIn;
+        using Super = binary::SerializerIn;
+        BorrowingSerializerIn(elle::ConstWeakBuffer input,
+                              bool versioned = true);
+        BorrowingSerializerIn(elle::ConstWeakBuffer input,
+                              Versions versions, bool versioned = true);
+        BorrowingSerializerIn(elle::Buffer&& input,
+                              bool versioned = true) = delete;
+        BorrowingSerializerIn(elle::Buffer&& input,
+                              Versions versions,
+                              bool versioned = true) = delete;
+      protected:
+        void
+        _serialize(elle::ConstWeakBuffer& v) override;
+      };
+    }
   }
 }
-}
@@ -1,10 +1,13 @@
 #include <elle/serialization/binary/SerializerOut.hh>
 
+#include <cstring>
+
 #include <elle/assert.hh>
 #include <elle/finally.hh>
 #include <elle/format/base64.hh>
 #include <elle/json/json.hh>
 #include <elle/meta.hh>
+#include <elle/serialization/binary/number.hh>
 
 ELLE_LOG_COMPONENT("elle.serialization.binary.SerializerOut")
 
@@ -20,25 +23,47 @@ namespace elle
 
       SerializerOut::SerializerOut(std::ostream& output, bool versioned)
         : Super(versioned)
-        , _output(output)
+        , _stream(&output)
       {
-        this->_write_magic(output);
+        this->_named = false;
+        this->_write_magic();
       }
 
       SerializerOut::SerializerOut(std::ostream& output,
                                    Versions versions,
                                    bool versioned)
         : Super(std::move(versions), versioned)
-        , _output(output)
+        , _stream(&output)
       {
-        this->_write_magic(output);
+        this->_named = false;
+        this->_write_magic();
+      }
+
+      SerializerOut::SerializerOut(elle::Buffer& output, bool versioned)
+        : Super(versioned)
+        , _stream(nullptr)
+      {
+        this->_named = false;
+        this->_binary_buffer = &output;
+        this->_write_magic();
+      }
+
+      SerializerOut::SerializerOut(elle::Buffer& output,
+                                   Versions versions,
+                                   bool versioned)
+        : Super(std::move(versions), versioned)
+        , _stream(nullptr)
+      {
+        this->_named = false;
+        this->_binary_buffer = &output;
+        this->_write_magic();
       }
 
       void
-      SerializerOut::_write_magic(std::ostream& output)
+      SerializerOut::_write_magic()
       {
         static char const magic = 0;
-        output.write(&magic, 1);
+        this->_write(&magic, 1);
       }
 
       SerializerOut::~SerializerOut()
@@ -60,61 +85,39 @@ namespace elle
         return false;
       }
 
+      inline
       void
-      SerializerOut::_serialize_number(int64_t n_)
+      SerializerOut::_write(void const* data, std::size_t size)
       {
-        SerializerOut::serialize_number(this->output(), n_);
+        if (this->_binary_buffer)
+          this->_binary_buffer->append(data, size);
+        else
+          this->_stream->write(static_cast<char const*>(data), size);
+      }
+
+      void
+      SerializerOut::_serialize_number(int64_t n)
+      {
+        ELLE_DUMP("serialize %s", n);
+        unsigned char ser[9];
+        this->_write(ser, encode_number(n, ser));
       }
 
       size_t
       SerializerOut::serialize_number(std::ostream& output,
-                                      int64_t n_)
+                                      int64_t n)
       {
-        int64_t n = n_;
-        bool neg = n < 0;
-        if (neg)
-          n = -n;
-        if (n <= 0x3f)
-        { // sgn 0 val
-          unsigned char ser = (neg ? 0x80 : 0) + n;
-          ELLE_DUMP("serialize %s as 0x%02x", n_, int(ser));
-          output.write((const char*)&ser, 1);
-          return 1;
-        }
-        else if (n <= 0x1fff)
-        { // sgn 1 0 val val2
-          unsigned char ser[2];
-          ser[0] = (neg ? 0xC0 : 0x40) + (n >> 8);
-          ser[1] = n;
-          ELLE_DUMP("serialize %s as 0x%02x%02x", n_, int(ser[0]), int(ser[1]));
-          output.write((const char*)ser, 2);
-          return 2;
-        } // sgn 1 1 0 val val2 val3
-        else if (n <= 0x0fffff)
-        {
-          unsigned char ser[3];
-          ser[0] = (neg ? 0xe0 : 0x60) + (n >> 16);
-          ser[1] = n >> 8;
-          ser[2] = n;
-          ELLE_DUMP("serialize %s as 0x%02x%02x%02x",
-                    n_, int(ser[0]), int(ser[1]), int(ser[2]));
-          output.write((const char*)ser, 3);
-          return 3;
-        }
-        else
-        {
-          unsigned char c = neg? 0xFF : 0x7F;
-          output.write((const char*)&c, 1);
-          output.write((const char*)(const void*)&n, 8);
-          ELLE_DUMP("serialize %s as 0x%02x%08x", n_, int(c), n);
-          return 9;
-          /*
-          unsigned char ser[9];
-          ser[0] = neg? 0xFF : 0x7F;
-          for (int i=1; i<9; ++i)
-            ser[i] = n >> ((i-1)*8);
-          output.write((const char*)ser, 9);*/
-        }
+        unsigned char ser[9];
+        auto const size = encode_number(n, ser);
+        output.write(reinterpret_cast<char const*>(ser), size);
+        return size;
+      }
+
+      size_t
+      SerializerOut::serialize_number(elle::Buffer& output,
+                                      int64_t n)
+      {
+        return append_number(output, n);
       }
 
       void
@@ -199,7 +202,7 @@ namespace elle
       void
       SerializerOut::_serialize(double& v)
       {
-        output().write((const char*)&v, sizeof(double));
+        this->_write(&v, sizeof(double));
       }
 
       void
@@ -211,8 +214,8 @@ namespace elle
       void
       SerializerOut::_serialize(std::string& v)
       {
-        elle::Buffer buffer(v.c_str(), v.size());
-        this->_serialize(buffer);
+        this->_serialize_number(v.size());
+        this->_write(v.data(), v.size());
       }
 
       void
@@ -221,7 +224,14 @@ namespace elle
         ELLE_DEBUG("serialize size: %s", buffer.size())
           this->_serialize_number(buffer.size());
         ELLE_DEBUG("serialize content: %f", buffer)
-          output().write((const char*)buffer.contents(), buffer.size());
+          this->_write(buffer.contents(), buffer.size());
+      }
+
+      void
+      SerializerOut::_serialize(elle::ConstWeakBuffer& buffer)
+      {
+        this->_serialize_number(buffer.size());
+        this->_write(buffer.contents(), buffer.size());
       }
 
       void
@@ -19,6 +19,14 @@ namespace elle
       /// - In binary, order matters. Do not reorder members afterward,
       ///   otherwise the existing serialized version won't be deserializable
       ///   anymore.
+      /// - Constructed on an elle::Buffer, it appends to it directly instead
+      ///   of going through a std::ostream; the bytes are the same. The
+      ///   Buffer overloads of elle::serialization::serialize pick this
+      ///   constructor at compile time.
+      /// - Entry names are never written, so they are not tracked: they are
+      ///   not logged and current_name is empty. On a Buffer, fundamental
+      ///   values are appended without going through the virtual
+      ///   _serialize hooks.
       class ELLE_API SerializerOut
         : public serialization::SerializerOut
       {
@@ -42,11 +50,20 @@ namespace elle
         /// @see elle::serialization::SerializerOut.
         SerializerOut(std::ostream& output,
                       Versions versions, bool versioned = true);
+        /// Construct a SerializerOut for binary appending to @a output.
+        ///
+        /// @see elle::serialization::SerializerOut.
+        SerializerOut(elle::Buffer& output, bool versioned = true);
+        /// Construct a SerializerOut for binary appending to @a output.
+        ///
+        /// @see elle::serialization::SerializerOut.
+        SerializerOut(elle::Buffer& output,
+                      Versions versions, bool versioned = true);
         virtual
         ~SerializerOut();
       private:
         void
-        _write_magic(std::ostream& output);
+        _write_magic();
 
       /*--------------.
       | Serialization |
@@ -89,6 +106,8 @@ namespace elle
         void
         _serialize(elle::Buffer& v) override;
         void
+        _serialize(elle::ConstWeakBuffer& v) override;
+        void
         _serialize(boost::posix_time::ptime& v) override;
         void
         _serialize_time_duration(std::int64_t& ticks,
@@ -106,10 +125,17 @@ namespace elle
         size_t
         serialize_number(std::ostream& output,
                          int64_t number);
-        ELLE_ATTRIBUTE_R(std::ostream&, output);
+        static
+        size_t
+        serialize_number(elle::Buffer& output,
+                         int64_t number);
       private:
         void
         _serialize_number(int64_t number);
+        void
+        _write(void const* data, std::size_t size);
+        /// The stream written to, unless constructed on a Buffer.
+        ELLE_ATTRIBUTE(std::ostream*, stream);
       };
     }
   }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <elle/Buffer.hh>
+
+namespace elle
+{
+  namespace serialization
+  {
+    namespace binary
+    {
+      /// Encode @a n_ on at most 9 bytes.
+      ///
+      /// @param n_ The number to encode.
+      /// @param ser Where to encode it, at least 9 bytes long.
+      /// @returns The encoded size.
+      inline
+      std::size_t
+      encode_number(int64_t n_, unsigned char* ser)
+      {
+        int64_t n = n_;
+        bool neg = n < 0;
+        if (neg)
+          n = -n;
+        if (n <= 0x3f)
+        { // sgn 0 val
+          ser[0] = (neg ? 0x80 : 0) + n;
+          return 1;
+        }
+        else if (n <= 0x1fff)
+        { // sgn 1 0 val val2
+          ser[0] = (neg ? 0xC0 : 0x40) + (n >> 8);
+          ser[1] = n;
+          return 2;
+        } // sgn 1 1 0 val val2 val3
+        else if (n <= 0x0fffff)
+        {
+          ser[0] = (neg ? 0xe0 : 0x60) + (n >> 16);
+          ser[1] = n >> 8;
+          ser[2] = n;
+          return 3;
+        }
+        else
+        {
+          ser[0] = neg? 0xFF : 0x7F;
+          std::memcpy(ser + 1, &n, 8);
+          return 9;
+        }
+      }
+
+      /// Append @a n encoded to @a output.
+      ///
+      /// @returns The encoded size.
+      inline
+      std::size_t
+      append_number(elle::Buffer& output, int64_t n)
+      {
+        unsigned char ser[9];
+        auto const size = encode_number(n, ser);
+        output.append(ser, size);
+        return size;
+      }
+    }
+  }
+}
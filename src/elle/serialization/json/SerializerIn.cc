@@ -4,6 +4,7 @@
 
 #include <elle/Backtrace.hh>
 #include <elle/chrono.hh>
+#include <elle/err.hh>
 #include <elle/finally.hh>
 #include <elle/format/base64.hh>
 #include <elle/json/exceptions.hh>
@@ -21,23 +22,50 @@ namespace elle
   {
     namespace json
     {
+      using Event = elle::json::Reader::Event;
+
+      namespace
+      {
+        /// Run @a f, reporting invalid JSON as a serialization Error.
+        template <typename F>
+        auto
+        parse(F const& f)
+          -> decltype(f())
+        {
+          try
+          {
+            return f();
+          }
+          catch (elle::json::ParseError const& e)
+          {
+            Error exception("json parse error");
+            exception.inner_exception(std::current_exception());
+            throw exception;
+          }
+        }
+      }
+
       /*-------------.
       | Construction |
       `-------------*/
 
       SerializerIn::SerializerIn(std::istream& input,
-                                 bool versioned)
+                                 bool versioned,
+                                 bool incremental)
         : Super(versioned)
         , _partial(false)
+        , _incremental(incremental)
       {
         this->_load_json(input);
       }
 
       SerializerIn::SerializerIn(std::istream& input,
                                  Versions versions,
-                                 bool versioned)
+                                 bool versioned,
+                                 bool incremental)
         : Super(std::move(versions), versioned)
         , _partial(false)
+        , _incremental(incremental)
       {
         this->_load_json(input);
       }
@@ -45,6 +73,7 @@ namespace elle
       SerializerIn::SerializerIn(elle::json::Json input, bool versioned)
         : Super(versioned)
         , _partial(false)
+        , _incremental(false)
         , _json(std::move(input))
       {
         this->_current.push_back(&this->_json);
@@ -53,16 +82,16 @@ namespace elle
       void
       SerializerIn::_load_json(std::istream& input)
       {
-        try
+        if (this->_incremental)
         {
-          this->_json = elle::json::read(input);
-          this->_current.push_back(&this->_json);
+          this->_reader = std::make_unique<elle::json::Reader>(input);
+          this->_streams.emplace_back();
+          this->_current.push_back(&this->_streams.back().value);
         }
-        catch (elle::json::ParseError const& e)
+        else
         {
-          Error exception("json parse error");
-          exception.inner_exception(std::current_exception());
-          throw exception;
+          this->_json = parse([&] { return elle::json::read(input); });
+          this->_current.push_back(&this->_json);
         }
       }
 
@@ -167,6 +196,14 @@ namespace elle
                                             bool,
                                             std::function<void ()> const& f)
       {
+        if (auto s = this->_object())
+        {
+          if (this->_seek(*s, name))
+            f();
+          else
+            ELLE_DEBUG("skip option as JSON key is missing");
+          return;
+        }
         auto& object = this->_check_type<elle::json::Object>();
         auto it = object.find(name);
         if (it != object.end())
@@ -179,6 +216,14 @@ namespace elle
       SerializerIn::_serialize_option(bool,
                                       std::function<void ()> const& f)
       {
+        if (auto s = this->_stream())
+          if (s->state == Stream::State::pending &&
+              parse([&] { return this->_reader->peek(); }) == Event::null)
+          {
+            this->_reader->next();
+            s->value = elle::json::NullType();
+            s->state = Stream::State::done;
+          }
         if (this->_current.back()->type() != typeid(elle::json::NullType))
           f();
         else
@@ -266,13 +311,34 @@ namespace elle
       bool
       SerializerIn::_enter(std::string const& name)
       {
+        if (auto s = this->_object())
+        {
+          if (!this->_seek(*s, name))
+          {
+            if (this->_partial)
+              return false;
+            else
+              throw MissingKey(name);
+          }
+          auto it = s->ahead.find(name);
+          if (it != s->ahead.end())
+            this->_current.push_back(&it->second);
+          else
+          {
+            s->key.reset();
+            this->_push(name);
+          }
+          return true;
+        }
         auto& object = this->_check_type<elle::json::Object>();
         auto it = object.find(name);
         if (it == object.end())
+        {
           if (this->_partial)
             return false;
           else
             throw MissingKey(name);
+        }
         else
         {
           this->_current.push_back(&it->second);
@@ -283,7 +349,10 @@ namespace elle
       void
       SerializerIn::_leave(std::string const& name)
       {
-        this->_current.pop_back();
+        if (this->_current.size() == this->_streams.size())
+          this->_pop();
+        else
+          this->_current.pop_back();
       }
 
       void
@@ -291,6 +360,27 @@ namespace elle
         int size,
         std::function<void ()> const& serialize_element)
       {
+        auto s = this->_stream();
+        if (s && s->state == Stream::State::pending &&
+            parse([&] { return this->_reader->peek(); }) == Event::array_begin)
+        {
+          auto& reader = *this->_reader;
+          reader.next();
+          s->state = Stream::State::array;
+          while (parse([&]
+                       {
+                         this->_catch_up(*s);
+                         return reader.peek();
+                       }) != Event::array_end)
+          {
+            this->_push({});
+            elle::SafeFinally pop([&] { this->_pop(); });
+            serialize_element();
+          }
+          reader.next();
+          s->state = Stream::State::streamed;
+          return;
+        }
         auto& array = this->_check_type<elle::json::Array>();
         for (auto& elt: array)
         {
@@ -304,16 +394,56 @@ namespace elle
       SerializerIn::_deserialize_dict_key(
         std::function<void (std::string const&)> const& f)
       {
+        if (auto s = this->_object())
+        {
+          // Entries are not kept for later.
+          s->state = Stream::State::streamed;
+          for (auto& elt: s->ahead)
+          {
+            this->_current.push_back(&elt.second);
+            elle::SafeFinally leave([&] { this->_current.pop_back(); });
+            f(elt.first);
+          }
+          s->ahead.clear();
+          auto& reader = *this->_reader;
+          while (true)
+          {
+            auto key = std::string{};
+            if (s->key)
+            {
+              key = std::move(*s->key);
+              s->key.reset();
+            }
+            else if (s->closed)
+              break;
+            else if (parse([&]
+                           {
+                             this->_catch_up(*s);
+                             return reader.next();
+                           }) == Event::key)
+              key = std::move(reader.string());
+            else
+            {
+              s->closed = true;
+              break;
+            }
+            this->_push(key);
+            elle::SafeFinally leave([&] { this->_pop(); });
+            f(key);
+          }
+          return;
+        }
         auto& current = *this->_current.back();
         if (current.type() == typeid(elle::json::Object))
         {
-          const auto& object = boost::any_cast<elle::json::Object>(current);
+          // Enter entries as they come, rather than looking them up.
+          auto& object = boost::any_cast<elle::json::Object&>(current);
           for (auto& elt: object)
-            if (this->_enter(elt.first))
-            {
-              elle::SafeFinally leave([&] { this->_leave(elt.first); });
-              f(elt.first);
-            }
+          {
+            this->_current.push_back(&elt.second);
+            elle::SafeFinally leave([&] { this->_current.pop_back(); });
+            f(elt.first);
+          }
         }
         else if (current.type() == typeid(elle::json::Array))
         {
@@ -336,6 +466,27 @@ namespace elle
         }
       }
 
+      bool
+      SerializerIn::_deserialize_keys(
+        std::function<void (std::string const&)> const& f)
+      {
+        auto s = this->_object();
+        // Report anything but an object as such.
+        if (!s)
+          this->_check_type<elle::json::Object>();
+        this->_deserialize_dict_key(
+          [&] (std::string const& key)
+          {
+            this->_names.emplace_back(&key);
+            elle::SafeFinally leave([&] { this->_names.pop_back(); });
+            f(key);
+          });
+        // Let the keys that did not come be looked up, and found missing.
+        if (s)
+          s->state = Stream::State::object;
+        return true;
+      }
+
       template <typename T, typename ... Types>
       struct
       any_casts
@@ -370,12 +521,190 @@ namespace elle
       T&
       SerializerIn::_check_type()
       {
+        this->_materialize();
         auto& current = *this->_current.back();
-        auto name = this->_names.empty() ? "" : this->_names.back();
+        auto const& name = this->current_name();
         if (current.type() == typeid(T))
           return boost::any_cast<T&>(current);
         return any_casts<T, Alternatives ...>::cast(name, current);
       }
+
+      /*------------.
+      | Incremental |
+      `------------*/
+
+      SerializerIn::Stream*
+      SerializerIn::_stream()
+      {
+        if (this->_current.size() != this->_streams.size())
+          return nullptr;
+        auto& s = this->_streams.back();
+        if (s.state == Stream::State::done)
+          return nullptr;
+        return &s;
+      }
+
+      SerializerIn::Stream*
+      SerializerIn::_object()
+      {
+        auto s = this->_stream();
+        if (!s)
+          return nullptr;
+        if (s->state == Stream::State::pending &&
+            parse([&] { return this->_reader->peek(); }) == Event::object_begin)
+        {
+          this->_reader->next();
+          s->state = Stream::State::object;
+        }
+        if (s->state == Stream::State::object)
+          return s;
+        this->_materialize();
+        return nullptr;
+      }
+
+      void
+      SerializerIn::_materialize()
+      {
+        auto s = this->_stream();
+        if (!s)
+          return;
+        auto& reader = *this->_reader;
+        switch (s->state)
+        {
+          case Stream::State::pending:
+            s->value = parse([&] { return elle::json::read(reader); });
+            break;
+          case Stream::State::object:
+            parse([&]
+                  {
+                    this->_catch_up(*s);
+                    if (s->key)
+                    {
+                      auto key = std::move(*s->key);
+                      s->key.reset();
+                      s->ahead[std::move(key)] = elle::json::read(reader);
+                    }
+                    while (!s->closed)
+                      if (reader.next() == Event::key)
+                      {
+                        auto key = std::move(reader.string());
+                        s->ahead[std::move(key)] = elle::json::read(reader);
+                      }
+                      else
+                        s->closed = true;
+                  });
+            s->value = std::move(s->ahead);
+            break;
+          case Stream::State::array:
+          case Stream::State::streamed:
+            elle::err<Error>("%s: \"%s\" was already read from the input",
+                             *this, this->current_name());
+          case Stream::State::done:
+            elle::unreachable();
+        }
+        s->state = Stream::State::done;
+      }
+
+      bool
+      SerializerIn::_seek(Stream& s, std::string const& name)
+      {
+        if (s.ahead.find(name) != s.ahead.end() || (s.key && *s.key == name))
+          return true;
+        if (s.streamed.find(name) != s.streamed.end())
+          elle::err<Error>("%s: \"%s\" was already read from the input",
+                           *this, name);
+        auto& reader = *this->_reader;
+        return parse(
+          [&]
+          {
+            this->_catch_up(s);
+            if (s.key)
+            {
+              auto key = std::move(*s.key);
+              s.key.reset();
+              s.ahead[std::move(key)] = elle::json::read(reader);
+            }
+            while (!s.closed)
+            {
+              if (reader.next() != Event::key)
+              {
+                s.closed = true;
+                break;
+              }
+              auto key = std::move(reader.string());
+              if (key == name)
+              {
+                s.key = std::move(key);
+                return true;
+              }
+              s.ahead[std::move(key)] = elle::json::read(reader);
+            }
+            return false;
+          });
+      }
+
+      void
+      SerializerIn::_catch_up(Stream& s)
+      {
+        auto const skip = s.skip;
+        auto nesting = s.behind;
+        s.skip = false;
+        s.behind = 0;
+        auto& reader = *this->_reader;
+        if (skip)
+          reader.skip();
+        while (nesting > 0)
+          switch (reader.next())
+          {
+            case Event::object_begin:
+            case Event::array_begin:
+              ++nesting;
+              break;
+            case Event::object_end:
+            case Event::array_end:
+              --nesting;
+              break;
+            default:
+              break;
+          }
+      }
+
+      void
+      SerializerIn::_push(std::string const& name)
+      {
+        this->_streams.emplace_back();
+        auto& s = this->_streams.back();
+        s.name = name;
+        this->_current.push_back(&s.value);
+      }
+
+      void
+      SerializerIn::_pop()
+      {
+        // Do not read here: this runs when leaving scopes, where errors
+        // cannot be thrown. The parent skips what is left before reading on.
+        auto& s = this->_streams.back();
+        auto const size = this->_streams.size();
+        if (size > 1)
+        {
+          auto& parent = this->_streams[size - 2];
+          if (s.state == Stream::State::pending)
+            parent.skip = true;
+          else if (s.state == Stream::State::array ||
+                   (s.state == Stream::State::object && !s.closed))
+            // Close the child, and whatever it left open itself.
+            parent.behind = 1 + s.behind;
+          if (parent.state == Stream::State::object)
+          {
+            if (s.state == Stream::State::done)
+              parent.ahead[s.name] = std::move(s.value);
+            else
+              parent.streamed.insert(s.name);
+          }
+        }
+        this->_current.pop_back();
+        this->_streams.pop_back();
+      }
     }
   }
 }
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <unordered_set>
+
+#include <boost/optional.hpp>
+
+#include <elle/json/Reader.hh>
 #include <elle/json/json.hh>
 #include <elle/serialization/SerializerIn.hh>
 
@@ -12,6 +19,14 @@ namespace elle
       /// A specialized SerializerIn for JSON.
       ///
       /// Deserialize objects from their JSON representations.
+      ///
+      /// By default the whole document is read in memory first.
+      /// Incrementally, it is read as it is deserialized instead: arrays and
+      /// objects element by element, so that documents larger than memory can
+      /// be deserialized as long as their elements are not. Keys deserialized
+      /// out of order are read ahead and kept, and so are scalars once read,
+      /// but an array or an object can only be deserialized once. The input is
+      /// only read as far as deserialization goes.
       class ELLE_API SerializerIn
         : public serialization::SerializerIn
       {
@@ -29,12 +44,20 @@ namespace elle
         /// Construct a SerializerIn for JSON.
         ///
         /// @see elle::serialization::SerializerIn.
-        SerializerIn(std::istream& input, bool versioned = true);
+        ///
+        /// @param incremental Whether to read the input as it is deserialized.
+        SerializerIn(std::istream& input,
+                     bool versioned = true,
+                     bool incremental = false);
         /// Construct a SerializerIn for JSON.
         ///
         /// @see elle::serialization::SerializerIn.
+        ///
+        /// @param incremental Whether to read the input as it is deserialized.
         SerializerIn(std::istream& input,
-                     Versions versions, bool versioned = true);
+                     Versions versions,
+                     bool versioned = true,
+                     bool incremental = false);
         /// Construct a SerializerIn from a JSON object.
         ///
         /// @param input A json object.
@@ -50,6 +73,7 @@ namespace elle
       `--------------*/
       public:
         ELLE_ATTRIBUTE_RW(bool, partial);
+        ELLE_ATTRIBUTE_R(bool, incremental);
 
       /*--------------.
       | Serialization |
@@ -101,6 +125,9 @@ namespace elle
         _deserialize_dict_key(
           std::function<void (std::string const&)> const& f) override;
         bool
+        _deserialize_keys(
+          std::function<void (std::string const&)> const& f) override;
+        bool
         _enter(std::string const& name) override;
         void
         _leave(std::string const& name) override;
@@ -114,6 +141,72 @@ namespace elle
         template <typename T>
         void
         _serialize_int(T& v);
+
+      /*------------.
+      | Incremental |
+      `------------*/
+      private:
+        /// A value being read from the input.
+        struct Stream
+        {
+          enum class State
+          {
+            /// Nothing read yet.
+            pending,
+            /// Being read key by key.
+            object,
+            /// Being read element by element.
+            array,
+            /// Read in memory, in value.
+            done,
+            /// Read and gone.
+            streamed,
+          };
+          State state = State::pending;
+          /// The key of this value, in its object.
+          std::string name;
+          boost::any value;
+          /// The members of an object read ahead of the one deserialized.
+          elle::json::Object ahead;
+          /// A key read, whose value comes next in the input.
+          boost::optional<std::string> key;
+          /// Whether the end of the object was read.
+          bool closed = false;
+          /// The keys whose value was read and is gone.
+          std::unordered_set<std::string> streamed;
+          /// Whether the last child was left unread.
+          bool skip = false;
+          /// How many containers the last child, and its own last child
+          /// recursively, left open.
+          int behind = 0;
+        };
+        /// The current value, if it is being read from the input.
+        Stream*
+        _stream();
+        /// The current value, if it is an object being read from the input.
+        ///
+        /// Any other value being read from the input is read in memory.
+        Stream*
+        _object();
+        /// Read the current value in memory.
+        void
+        _materialize();
+        /// Whether the object @a s has key @a name.
+        ///
+        /// Read the members before it ahead, if needed.
+        bool
+        _seek(Stream& s, std::string const& name);
+        /// Read what is left of the last child of @a s.
+        void
+        _catch_up(Stream& s);
+        /// Start reading the next value of the input, as @a name.
+        void
+        _push(std::string const& name);
+        /// Stop reading the current value.
+        void
+        _pop();
+        ELLE_ATTRIBUTE(std::unique_ptr<elle::json::Reader>, reader);
+        ELLE_ATTRIBUTE(std::deque<Stream>, streams);
       };
     }
   }
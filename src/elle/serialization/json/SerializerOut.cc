@@ -1,5 +1,8 @@
 #include <elle/serialization/json/SerializerOut.hh>
 
+#include <exception>
+#include <type_traits>
+
 #include <elle/Lazy.hh>
 #include <elle/assert.hh>
 #include <elle/format/base64.hh>
@@ -15,34 +18,92 @@ namespace elle
   {
     namespace json
     {
+      namespace
+      {
+        void
+        emit(elle::json::Writer& writer, bool v)
+        {
+          writer.boolean(v);
+        }
+
+        void
+        emit(elle::json::Writer& writer, double v)
+        {
+          writer.real(v);
+        }
+
+        void
+        emit(elle::json::Writer& writer, std::string const& v)
+        {
+          writer.string(v);
+        }
+
+        template <typename T>
+        std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>
+        emit(elle::json::Writer& writer, T v)
+        {
+          writer.integer(v);
+        }
+
+        template <typename T>
+        std::enable_if_t<std::is_integral<T>::value &&
+                         std::is_unsigned<T>::value>
+        emit(elle::json::Writer& writer, T v)
+        {
+          writer.unsigned_integer(v);
+        }
+      }
+
       /*-------------.
       | Construction |
       `-------------*/
 
       SerializerOut::SerializerOut(std::ostream& output,
                                    bool versioned,
-                                   bool pretty)
+                                   bool pretty,
+                                   bool incremental)
         : Super(versioned)
         , _pretty(pretty)
         , _output(output)
+        , _incremental(incremental)
       {
+        if (incremental)
+          this->_writer.emplace(output, pretty);
         this->_current.push_back(&this->_json);
+        this->_frames.push_back(Frame{Frame::Kind::empty, {}, false});
       }
 
       SerializerOut::SerializerOut(std::ostream& output,
                                    Versions versions,
                                    bool versioned,
-                                   bool pretty)
+                                   bool pretty,
+                                   bool incremental)
         : Super(std::move(versions), versioned)
         , _pretty(pretty)
         , _output(output)
+        , _incremental(incremental)
       {
+        if (incremental)
+          this->_writer.emplace(output, pretty);
         this->_current.push_back(&this->_json);
+        this->_frames.push_back(Frame{Frame::Kind::empty, {}, false});
       }
 
       SerializerOut::~SerializerOut() noexcept(false)
       {
         ELLE_TRACE_SCOPE("%s: write JSON %s", this, this->output());
+        if (this->_incremental)
+        {
+          // Do not write more after an error.
+          if (std::uncaught_exception())
+            return;
+          ELLE_ASSERT_EQ(this->_frames.size(), 1u);
+          this->_close();
+          if (!this->_pretty)
+            this->output() << '\n';
+          this->output().flush();
+          return;
+        }
         ELLE_DUMP(
           "%s",
           elle::lazy([&] { return elle::json::pretty_print(this->_json); }));
@@ -59,6 +120,37 @@ namespace elle
       bool
       SerializerOut::_enter(std::string const& name)
       {
+        if (this->_incremental)
+        {
+          if (this->_frames.back().kind == Frame::Kind::empty)
+          {
+            ELLE_DEBUG("create current object");
+            this->_open(Frame::Kind::object);
+          }
+          auto& current = this->_frames.back();
+          if (current.kind == Frame::Kind::object)
+          {
+            ELLE_DEBUG_SCOPE("insert key \"%s\"", name);
+            // FIXME: hackish way to not serialize version twice when
+            // serialize_forward is used.
+            if (name == ".version")
+            {
+              if (current.versioned)
+                return false;
+              current.versioned = true;
+            }
+            this->_frames.push_back(Frame{Frame::Kind::empty, name, false});
+          }
+          else if (current.kind == Frame::Kind::array)
+          {
+            ELLE_DEBUG_SCOPE("insert array element");
+            this->_frames.push_back(Frame{Frame::Kind::empty, {}, false});
+          }
+          else
+            ELLE_ABORT("cannot serialize a composite and a fundamental object "
+                       "in key %s", name);
+          return true;
+        }
         ELLE_ASSERT(!this->_current.empty());
         auto& current = *this->_current.back();
         if (current.empty())
@@ -95,6 +187,14 @@ namespace elle
       void
       SerializerOut::_leave(std::string const& name)
       {
+        if (this->_incremental)
+        {
+          ELLE_ASSERT_GT(this->_frames.size(), 1u);
+          if (!std::uncaught_exception())
+            this->_close();
+          this->_frames.pop_back();
+          return;
+        }
         ELLE_ASSERT(!this->_current.empty());
         this->_current.pop_back();
       }
@@ -103,6 +203,12 @@ namespace elle
       SerializerOut::_serialize_array(int size,
                                       std::function<void ()> const& f)
       {
+        if (this->_incremental)
+        {
+          this->_open(Frame::Kind::array);
+          f();
+          return;
+        }
         ELLE_ASSERT(!this->_current.empty());
         auto& current = *this->_current.back();
         ELLE_ASSERT(current.empty());
@@ -123,29 +229,25 @@ namespace elle
       void
       SerializerOut::_serialize(int64_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(uint64_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(int32_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(uint32_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
@@ -154,8 +256,7 @@ namespace elle
         meta::static_if<need_unsigned_long>
           ([this](unsigned long& v)
            {
-             auto& current = this->_get_current();
-             current = v;
+             this->_value(v);
            },
            [](auto& v)
            {
@@ -167,50 +268,43 @@ namespace elle
       void
       SerializerOut::_serialize(int16_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(uint16_t& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(int8_t& v)
       {
-        auto& current = this->_get_current();
-        current = int(v);
+        this->_value(int(v));
       }
 
       void
       SerializerOut::_serialize(uint8_t& v)
       {
-        auto& current = this->_get_current();
-        current = int(v);
+        this->_value(int(v));
       }
 
       void
       SerializerOut::_serialize(double& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(bool& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
       SerializerOut::_serialize(std::string& v)
       {
-        auto& current = this->_get_current();
-        current = v;
+        this->_value(v);
       }
 
       void
@@ -222,8 +316,7 @@ namespace elle
           base64.write(reinterpret_cast<char*>(buffer.contents()),
                        buffer.size());
         }
-        auto& current = this->_get_current();
-        current = encoded.str();
+        this->_value(encoded.str());
       }
 
       void
@@ -236,7 +329,7 @@ namespace elle
         output_facet->format("%Y-%m-%dT%H:%M:%S%F%q");
         ss.imbue(std::locale(ss.getloc(), output_facet.release()));
         ss << time;
-        this->_get_current() = ss.str();
+        this->_value(ss.str());
       }
 
       void
@@ -290,8 +383,7 @@ namespace elle
             }
           }
         }
-        auto& current = this->_get_current();
-        current = elle::sprintf("%s%s", ticks, orders[order]);
+        this->_value(elle::sprintf("%s%s", ticks, orders[order]));
       }
 
       void
@@ -309,6 +401,18 @@ namespace elle
       {
         if (filled)
           f();
+        else if (this->_incremental)
+        {
+          auto const size = this->_frames.size();
+          if (!this->_names.empty() && size > 1 &&
+              this->_frames[size - 2].kind == Frame::Kind::object)
+            this->_frames.back().kind = Frame::Kind::omitted;
+          else
+          {
+            this->_open(Frame::Kind::scalar);
+            this->_writer->null();
+          }
+        }
         else
         {
           *this->_current.back() = elle::json::NullType();
@@ -318,7 +422,7 @@ namespace elle
             auto& last = *this->_current[this->_current.size() - 2];
             if (last.type() == typeid(elle::json::Object))
               ELLE_ENFORCE(boost::any_cast<elle::json::Object&>(last).erase(
-                             this->_names.back()));
+                             *this->_names.back()));
           }
         }
       }
@@ -335,6 +439,62 @@ namespace elle
         }
         return current;
       }
+
+      template <typename T>
+      void
+      SerializerOut::_value(T const& v)
+      {
+        if (this->_incremental)
+        {
+          if (this->_frames.back().kind != Frame::Kind::empty)
+            ELLE_ABORT("%s: serializing in-place to an already filled object",
+                       *this);
+          this->_open(Frame::Kind::scalar);
+          emit(*this->_writer, v);
+        }
+        else
+          this->_get_current() = v;
+      }
+
+      /*------------.
+      | Incremental |
+      `------------*/
+
+      void
+      SerializerOut::_open(Frame::Kind kind)
+      {
+        auto const size = this->_frames.size();
+        auto& frame = this->_frames.back();
+        ELLE_ASSERT(frame.kind == Frame::Kind::empty);
+        if (size > 1 && this->_frames[size - 2].kind == Frame::Kind::object)
+          this->_writer->key(frame.key);
+        frame.kind = kind;
+        if (kind == Frame::Kind::object)
+          this->_writer->object_begin();
+        else if (kind == Frame::Kind::array)
+          this->_writer->array_begin();
+      }
+
+      void
+      SerializerOut::_close()
+      {
+        switch (this->_frames.back().kind)
+        {
+          case Frame::Kind::empty:
+            this->_open(Frame::Kind::scalar);
+            this->_writer->null();
+            break;
+          case Frame::Kind::object:
+            this->_writer->object_end();
+            break;
+          case Frame::Kind::array:
+            this->_writer->array_end();
+            break;
+          case Frame::Kind::scalar:
+          case Frame::Kind::omitted:
+            break;
+        }
+      }
     }
   }
 }
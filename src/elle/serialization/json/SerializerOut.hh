@@ -3,8 +3,10 @@
 #include <vector>
 
 #include <boost/any.hpp>
+#include <boost/optional.hpp>
 
 #include <elle/attribute.hh>
+#include <elle/json/Writer.hh>
 #include <elle/serialization/SerializerOut.hh>
 
 namespace elle
@@ -22,6 +24,12 @@ namespace elle
       /// - unordered_map and map are serialized dict {x: y}.
       /// - unordered_multimap are serialized list of list [[x, x], [x, y]].
       /// - empty maps and unordered_multimap are serialized as null.
+      ///
+      /// By default the whole document is built in memory and written, with
+      /// sorted keys, when the SerializerOut is destroyed. Incrementally, every
+      /// token is written as soon as it is serialized instead, keys in the
+      /// order they are serialized, and memory does not grow with the
+      /// document.
       class ELLE_API SerializerOut
         : public serialization::SerializerOut
       {
@@ -41,18 +49,22 @@ namespace elle
         /// @see elle::serialization::SerializerOut
         ///
         /// @param pretty Whether the JSON should be formatted.
+        /// @param incremental Whether to write tokens as they are serialized.
         SerializerOut(std::ostream& output,
                       bool versioned = true,
-                      bool pretty = false);
+                      bool pretty = false,
+                      bool incremental = false);
         /// Construct a SerializerOut for JSON.
         ///
         /// @see elle::serialization::SerializerOut
         ///
         /// @param pretty Whether the JSON should be formatted.
+        /// @param incremental Whether to write tokens as they are serialized.
         SerializerOut(std::ostream& output,
                       Versions versions,
                       bool versioned = true,
-                      bool pretty = false);
+                      bool pretty = false,
+                      bool incremental = false);
         ~SerializerOut() noexcept(false);
 
       /*--------------.
@@ -132,6 +144,10 @@ namespace elle
       private:
         boost::any&
         _get_current();
+        /// Serialize a scalar in the current value.
+        template <typename T>
+        void
+        _value(T const& v);
 
       /*-----.
       | JSON |
@@ -141,6 +157,39 @@ namespace elle
         ELLE_ATTRIBUTE(std::vector<boost::any*>, current);
         ELLE_ATTRIBUTE(bool, pretty);
         ELLE_ATTRIBUTE_R(std::ostream&, output);
+        ELLE_ATTRIBUTE_R(bool, incremental);
+
+      /*------------.
+      | Incremental |
+      `------------*/
+      private:
+        /// A value being written.
+        struct Frame
+        {
+          enum class Kind
+          {
+            /// Nothing written yet, not even its key.
+            empty,
+            object,
+            array,
+            scalar,
+            /// A null optional, left out of its object.
+            omitted,
+          };
+          Kind kind;
+          /// The key of the value, if in an object.
+          std::string key;
+          /// Whether the object has a version already.
+          bool versioned;
+        };
+        /// Write the key of the current value, and make it a @a kind.
+        void
+        _open(Frame::Kind kind);
+        /// Write the end of the current value.
+        void
+        _close();
+        ELLE_ATTRIBUTE(boost::optional<elle::json::Writer>, writer);
+        ELLE_ATTRIBUTE(std::vector<Frame>, frames);
       };
     }
   }
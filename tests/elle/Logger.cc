@@ -3,6 +3,8 @@
 
 #include <elle/finally.hh>
 #include <elle/log.hh>
+#include <elle/log/AsyncLogger.hh>
+#include <elle/log/BinaryLogger.hh>
 #include <elle/log/Logger.hh>
 #include <elle/log/TextLogger.hh>
 #include <elle/memory.hh>
@@ -13,9 +15,15 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <algorithm>
+#include <future>
 #include <sstream>
 #include <thread>
 
+#ifndef INFINIT_WINDOWS
+# include <unistd.h>
+#endif
+
 template<bool b>
 void
 _message_test(bool env)
@@ -389,6 +397,86 @@ parallel_write()
   BOOST_CHECK_GE(c2, 64);
 }
 
+/// Check that levels can be changed while call sites are cached.
+static
+void
+runtime_levels()
+{
+  std::stringstream output;
+  elle::os::setenv("ELLE_LOG_LEVEL", "LOG");
+  auto logger = new elle::log::TextLogger(output);
+  elle::log::logger(std::unique_ptr<elle::log::Logger>(logger));
+  ELLE_LOG_COMPONENT("runtime");
+  auto generate_log = [] { ELLE_TRACE("trace"); };
+  generate_log();
+  BOOST_CHECK_EQUAL(output.str(), "");
+  logger->levels("runtime:TRACE");
+  generate_log();
+  BOOST_CHECK_EQUAL(output.str(), "[runtime] trace\n");
+  output.str("");
+  logger->levels("LOG");
+  generate_log();
+  BOOST_CHECK_EQUAL(output.str(), "");
+  elle::os::setenv("ELLE_LOG_LEVEL", "TRACE");
+  elle::log::logger(std::make_unique<elle::log::TextLogger>(output));
+  generate_log();
+  BOOST_CHECK_EQUAL(output.str(), "[runtime] trace\n");
+  elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+}
+
+/// Check that context filters only consider the components of the logging
+/// thread.
+static
+void
+parallel_context()
+{
+  std::stringstream output;
+  elle::os::setenv("ELLE_LOG_LEVEL", "outer inner:TRACE");
+  elle::log::logger(std::make_unique<elle::log::TextLogger>(output));
+  auto const count = 256;
+  auto nested = [&]
+    {
+      for (int i = 0; i < count; ++i)
+      {
+        ELLE_LOG_COMPONENT("outer");
+        ELLE_LOG("outer")
+        {
+          ELLE_LOG_COMPONENT("inner");
+          ELLE_TRACE("nested");
+        }
+      }
+    };
+  auto flat = [&]
+    {
+      for (int i = 0; i < count; ++i)
+      {
+        ELLE_LOG_COMPONENT("inner");
+        ELLE_TRACE("flat");
+      }
+    };
+  {
+    std::thread t1(nested);
+    std::thread t2(flat);
+    std::thread t3(nested);
+    std::thread t4(flat);
+    t1.join();
+    t2.join();
+    t3.join();
+    t4.join();
+  }
+  auto lines = std::vector<std::string>{};
+  auto const out = output.str();
+  boost::algorithm::split(lines, out, boost::is_any_of("\n"),
+                          boost::token_compress_on);
+  auto const nested_count =
+    std::count_if(lines.begin(), lines.end(),
+                  [] (std::string const& l)
+                  { return boost::algorithm::ends_with(l, "nested"); });
+  BOOST_CHECK_EQUAL(nested_count, 2 * count);
+  BOOST_CHECK_EQUAL(out.find("flat"), std::string::npos);
+  elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+}
+
 static
 void
 multiline()
@@ -549,6 +637,181 @@ error()
   }
 }
 
+static
+void
+binary()
+{
+  elle::os::setenv("ELLE_LOG_LEVEL", "DUMP");
+  auto const log = [] (std::unique_ptr<elle::log::Logger> logger)
+    {
+      elle::log::logger(std::move(logger));
+      {
+        ELLE_LOG_COMPONENT("binary");
+        ELLE_LOG_SCOPE("start %s", 42);
+        for (int i = 0; i < 100; ++i)
+        {
+          ELLE_LOG_COMPONENT("binary.loop");
+          ELLE_TRACE("iteration {} of {}", i, 100);
+          ELLE_DEBUG("multiple\nlines: %s", "indented");
+        }
+        ELLE_WARN("escaped \\{\\} and 100\\%");
+        ELLE_ERR("%s: %s", "same", "same");
+        ELLE_DUMP("no arguments");
+        ELLE_TRACE("done: %s", "last");
+      }
+      elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+    };
+  std::stringstream text;
+  log(std::make_unique<elle::log::TextLogger>(text, "", true));
+  std::stringstream binary;
+  log(std::make_unique<elle::log::BinaryLogger>(binary));
+  BOOST_CHECK_LT(binary.str().size(), text.str().size());
+  {
+    std::stringstream decoded;
+    elle::log::TextLogger out(decoded, "", true);
+    elle::log::BinaryLogger::decode(binary, out);
+    BOOST_CHECK_EQUAL(decoded.str(), text.str());
+  }
+  // A truncated record is ignored.
+  {
+    auto const truncated = binary.str();
+    std::stringstream in(truncated.substr(0, truncated.size() - 1));
+    std::stringstream decoded;
+    elle::log::TextLogger out(decoded, "", true);
+    elle::log::BinaryLogger::decode(in, out);
+    auto expected = text.str();
+    expected = expected.substr(0, expected.rfind('\n', expected.size() - 2) + 1);
+    BOOST_CHECK_EQUAL(decoded.str(), expected);
+  }
+  {
+    std::stringstream in("not a log");
+    std::stringstream decoded;
+    elle::log::TextLogger out(decoded);
+    BOOST_CHECK_THROW(elle::log::BinaryLogger::decode(in, out), elle::Error);
+  }
+}
+
+#ifndef INFINIT_WINDOWS
+namespace
+{
+  std::string
+  read_all(int fd)
+  {
+    auto res = std::string{};
+    char buffer[4096];
+    while (true)
+    {
+      auto const n = ::read(fd, buffer, sizeof buffer);
+      if (n <= 0)
+        return res;
+      res.append(buffer, n);
+    }
+  }
+}
+
+static
+void
+async_block()
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  elle::os::setenv("ELLE_LOG_LEVEL", "TRACE");
+  auto const count = 1000;
+  auto reader = std::async(std::launch::async, [&] { return read_all(fds[0]); });
+  {
+    auto logger = std::make_unique<elle::log::AsyncLogger>(
+      fds[1], "", elle::log::AsyncLogger::Policy::block, 16);
+    auto& async = *logger;
+    elle::log::logger(std::move(logger));
+    ELLE_LOG_COMPONENT("async");
+    for (int i = 0; i < count; ++i)
+      ELLE_TRACE("message %s", i);
+    async.flush();
+    BOOST_CHECK_EQUAL(async.dropped(), 0);
+    elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+  }
+  ::close(fds[1]);
+  auto const output = reader.get();
+  ::close(fds[0]);
+  auto expected = std::string{};
+  for (int i = 0; i < count; ++i)
+    expected += elle::sprintf("[async] message %s\n", i);
+  BOOST_CHECK_EQUAL(output, expected);
+}
+
+static
+void
+async_defer()
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  elle::os::setenv("ELLE_LOG_LEVEL", "TRACE");
+  auto const count = 100;
+  auto reader = std::async(std::launch::async, [&] { return read_all(fds[0]); });
+  auto expected = std::string{};
+  {
+    auto logger = std::make_unique<elle::log::AsyncLogger>(
+      fds[1], "", elle::log::AsyncLogger::Policy::block, 16, true);
+    auto& async = *logger;
+    elle::log::logger(std::move(logger));
+    ELLE_LOG_COMPONENT("async");
+    char const* formats[] = {"even %s", "odd %s"};
+    for (int i = 0; i < count; ++i)
+    {
+      auto value = elle::sprintf("value %s", i);
+      {
+        // Captured and rendered by the writer.
+        ELLE_TRACE_SCOPE("message %s: %s", i, value);
+        value = "overwritten";
+        // Not captured, rendered right away.
+        ELLE_TRACE("pointer %s", &i);
+      }
+      // Not the format the site was first used with.
+      ELLE_TRACE(formats[i % 2], i);
+      expected += elle::sprintf("[async] message %s: value %s\n", i, i);
+      expected += elle::sprintf("[async]   pointer %s\n", i);
+      expected += elle::sprintf("[async] %s %s\n", i % 2 ? "odd" : "even", i);
+    }
+    async.flush();
+    elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+  }
+  ::close(fds[1]);
+  auto const output = reader.get();
+  ::close(fds[0]);
+  BOOST_CHECK_EQUAL(output, expected);
+}
+
+static
+void
+async_drop()
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(::pipe(fds), 0);
+  elle::os::setenv("ELLE_LOG_LEVEL", "TRACE");
+  auto const count = 64;
+  // Large enough for the writer to fill the unread pipe and block.
+  auto const payload = std::string(16384, 'x');
+  auto logger = std::make_unique<elle::log::AsyncLogger>(
+    fds[1], "", elle::log::AsyncLogger::Policy::drop, 4);
+  auto& async = *logger;
+  elle::log::logger(std::move(logger));
+  {
+    ELLE_LOG_COMPONENT("async");
+    for (int i = 0; i < count; ++i)
+      ELLE_TRACE("%s", payload);
+  }
+  BOOST_CHECK_GT(async.dropped(), 0);
+  auto const dropped = async.dropped();
+  auto reader = std::async(std::launch::async, [&] { return read_all(fds[0]); });
+  elle::log::logger(std::unique_ptr<elle::log::Logger>(nullptr));
+  ::close(fds[1]);
+  auto const output = reader.get();
+  ::close(fds[0]);
+  BOOST_CHECK_EQUAL(
+    std::count(output.begin(), output.end(), '\n') + dropped, count);
+}
+#endif
+
 ELLE_TEST_SUITE()
 {
   elle::log::detail::debug_formats(false);
@@ -564,6 +827,7 @@ ELLE_TEST_SUITE()
   boost::unit_test::test_suite* concurrency = BOOST_TEST_SUITE("concurrency");
   suite.add(concurrency);
   concurrency->add(BOOST_TEST_CASE(std::bind(parallel_write)));
+  concurrency->add(BOOST_TEST_CASE(parallel_context));
 
   boost::unit_test::test_suite* format = BOOST_TEST_SUITE("format");
   suite.add(format);
@@ -572,5 +836,18 @@ ELLE_TEST_SUITE()
   format->add(BOOST_TEST_CASE(trim));
   format->add(BOOST_TEST_CASE(component_width));
   format->add(BOOST_TEST_CASE(nested));
+  format->add(BOOST_TEST_CASE(runtime_levels));
+#endif
+
+  boost::unit_test::test_suite* binary = BOOST_TEST_SUITE("binary");
+  suite.add(binary);
+  binary->add(BOOST_TEST_CASE(::binary));
+
+#ifndef INFINIT_WINDOWS
+  boost::unit_test::test_suite* async = BOOST_TEST_SUITE("async");
+  suite.add(async);
+  async->add(BOOST_TEST_CASE(async_block));
+  async->add(BOOST_TEST_CASE(async_defer));
+  async->add(BOOST_TEST_CASE(async_drop));
 #endif
 }
@@ -0,0 +1,64 @@
+#include <string>
+#include <vector>
+
+#include <elle/Buffer.hh>
+#include <elle/crc32c.hh>
+#include <elle/test.hh>
+
+namespace
+{
+  /// Bitwise reference implementation.
+  std::uint32_t
+  reference(unsigned char const* data, std::size_t size)
+  {
+    auto crc = ~std::uint32_t(0);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      crc ^= data[i];
+      for (int b = 0; b < 8; ++b)
+        crc = (crc >> 1) ^ (0x82f63b78 & (0u - (crc & 1)));
+    }
+    return ~crc;
+  }
+}
+
+static
+void
+vectors()
+{
+  BOOST_TEST(elle::crc32c("", 0) == 0u);
+  BOOST_TEST(elle::crc32c("123456789", 9) == 0xe3069283u);
+  // RFC 3720, B.4.
+  auto const zeros = std::vector<unsigned char>(32, 0x00);
+  BOOST_TEST(elle::crc32c(zeros.data(), zeros.size()) == 0x8a9136aau);
+  auto const ones = std::vector<unsigned char>(32, 0xff);
+  BOOST_TEST(elle::crc32c(ones.data(), ones.size()) == 0x62a8ab43u);
+  BOOST_TEST(elle::crc32c(elle::ConstWeakBuffer("123456789")) == 0xe3069283u);
+}
+
+static
+void
+incremental()
+{
+  auto data = std::vector<unsigned char>(1031);
+  for (std::size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<unsigned char>(i * 7 + 3);
+  // Every alignment and size, in one go or split in two.
+  for (std::size_t offset = 0; offset < 8; ++offset)
+    for (std::size_t size = 0; size + offset <= data.size(); size += 13)
+    {
+      auto const p = data.data() + offset;
+      auto const expected = reference(p, size);
+      BOOST_TEST(elle::crc32c(p, size) == expected);
+      auto const half = size / 2;
+      BOOST_TEST(elle::crc32c(p + half, size - half,
+                              elle::crc32c(p, half)) == expected);
+    }
+}
+
+ELLE_TEST_SUITE()
+{
+  auto& master = boost::unit_test::framework::master_test_suite();
+  master.add(BOOST_TEST_CASE(vectors), 0, 1);
+  master.add(BOOST_TEST_CASE(incremental), 0, 1);
+}
@@ -1,8 +1,13 @@
+#include <sstream>
 #include <string>
 
+#include <boost/optional.hpp>
+
 #include <elle/json/json.hh>
 #include <elle/serialization/Serializer.hh>
+#include <elle/serialization/binary.hh>
 #include <elle/serialization/json.hh>
+#include <elle/serialization/json/Error.hh>
 #include <elle/test.hh>
 
 #include <elle/das/printer.hh>
@@ -16,6 +21,7 @@ namespace symbol
   ELLE_DAS_SYMBOL(device);
   ELLE_DAS_SYMBOL(id);
   ELLE_DAS_SYMBOL(name);
+  ELLE_DAS_SYMBOL(owner);
 }
 
 using elle::das::operator <<;
@@ -102,9 +108,27 @@ struct User
                                                            symbol::device))>;
 };
 
+/// A struct with an optional field.
+struct Share
+{
+  bool
+  operator ==(Share const& rhs) const
+  {
+    return this->id == rhs.id && this->owner == rhs.owner;
+  }
+
+  int id;
+  boost::optional<std::string> owner;
+
+  using Model = elle::das::Model<Share,
+                                 decltype(elle::meta::list(symbol::id,
+                                                           symbol::owner))>;
+};
+
 ELLE_DAS_SERIALIZE(DevicePOD);
 ELLE_DAS_SERIALIZE(Device);
 ELLE_DAS_SERIALIZE(User);
+ELLE_DAS_SERIALIZE(Share);
 
 static
 void
@@ -155,9 +179,95 @@ composite()
   }
 }
 
+static
+void
+keys()
+{
+  auto const& keys = elle::das::Serializer<User>::keys();
+  BOOST_CHECK_EQUAL(keys.name(0), "name");
+  BOOST_CHECK_EQUAL(keys.name(1), "device");
+  BOOST_CHECK_EQUAL(keys.index("name"), 0);
+  BOOST_CHECK_EQUAL(keys.index("device"), 1);
+  BOOST_CHECK_EQUAL(keys.index("devices"), -1);
+  BOOST_CHECK_EQUAL(keys.index(""), -1);
+}
+
+template <typename T>
+T
+from_json(std::string const& json, bool incremental)
+{
+  std::stringstream input(json);
+  elle::serialization::json::SerializerIn s(input, false, incremental);
+  return s.deserialize<T>();
+}
+
+static
+void
+dispatch()
+{
+  for (auto incremental: {false, true})
+  {
+    ELLE_LOG("%s", incremental ? "incrementally" : "in a tree")
+    {
+      ELLE_LOG("keys in any order, unknown ones skipped")
+      {
+        auto const json =
+          R"({"extra": [1, {"id": 2}], "name": "towel", "id": 42})";
+        BOOST_CHECK_EQUAL(from_json<DevicePOD>(json, incremental),
+                          (DevicePOD{42, "towel"}));
+        BOOST_CHECK_EQUAL(from_json<Device>(json, incremental),
+                          Device(42, "towel"));
+        BOOST_CHECK_EQUAL(
+          from_json<User>(
+            R"({"device": [{"name": "arthur", "id": 42}], "name": "Doug"})",
+            incremental),
+          User("Doug", {Device(42, "arthur")}));
+      }
+      ELLE_LOG("missing optional field")
+        BOOST_CHECK_EQUAL(from_json<Share>(R"({"id": 42})", incremental),
+                          (Share{42, boost::none}));
+      ELLE_LOG("null optional field")
+        BOOST_CHECK_EQUAL(
+          from_json<Share>(R"({"owner": null, "id": 42})", incremental),
+          (Share{42, boost::none}));
+      ELLE_LOG("missing field")
+      {
+        BOOST_CHECK_THROW(
+          from_json<DevicePOD>(R"({"name": "towel"})", incremental),
+          elle::serialization::MissingKey);
+        BOOST_CHECK_THROW(
+          from_json<Device>(R"({"name": "towel"})", incremental),
+          elle::serialization::MissingKey);
+      }
+      ELLE_LOG("not an object")
+        BOOST_CHECK_THROW(from_json<Device>("[42]", incremental),
+                          elle::serialization::Error);
+    }
+  }
+}
+
+static
+void
+binary()
+{
+  using elle::serialization::binary::serialize;
+  using elle::serialization::binary::deserialize;
+  {
+    auto const d = Device{42, "towel"};
+    BOOST_CHECK_EQUAL(deserialize<Device>(serialize(d)), d);
+  }
+  {
+    auto const s = Share{42, std::string("ford")};
+    BOOST_CHECK_EQUAL(deserialize<Share>(serialize(s)), s);
+  }
+}
+
 ELLE_TEST_SUITE()
 {
   auto& suite = boost::unit_test::framework::master_test_suite();
   suite.add(BOOST_TEST_CASE(simple), 0, valgrind(1));
   suite.add(BOOST_TEST_CASE(composite), 0, valgrind(1));
+  suite.add(BOOST_TEST_CASE(keys), 0, valgrind(1));
+  suite.add(BOOST_TEST_CASE(dispatch), 0, valgrind(1));
+  suite.add(BOOST_TEST_CASE(binary), 0, valgrind(1));
 }
@@ -0,0 +1,134 @@
+#include <elle/format/deflate.hh>
+#include <elle/test.hh>
+
+static
+std::string
+records(int count)
+{
+  auto res = std::string{};
+  for (int i = 0; i < count; ++i)
+    res += elle::sprintf("{\"id\": %s, \"name\": \"user %s\"},", i, i);
+  return res;
+}
+
+static
+void
+round_trip()
+{
+  elle::format::deflate::Compressor c;
+  elle::format::deflate::Decompressor d;
+  for (auto const& message: {std::string(), std::string("a"), records(1000)})
+  {
+    auto const compressed = c.compress(elle::ConstWeakBuffer(message));
+    BOOST_CHECK_EQUAL(d.decompress(compressed, message.size()), message);
+  }
+  auto const message = records(1000);
+  BOOST_CHECK_LT(c.compress(elle::ConstWeakBuffer(message)).size(),
+                 message.size() / 4);
+}
+
+// Empty messages still end the stream.
+static
+void
+empty()
+{
+  elle::format::deflate::Compressor c;
+  elle::format::deflate::Decompressor d;
+  auto const compressed = c.compress(std::vector<elle::ConstWeakBuffer>{});
+  BOOST_CHECK(!compressed.empty());
+  BOOST_CHECK_EQUAL(d.decompress(compressed, 0), "");
+  BOOST_CHECK_EQUAL(compressed, c.compress(elle::ConstWeakBuffer()));
+}
+
+// Incompressible data fed in many pieces may outgrow deflateBound.
+static
+void
+incompressible()
+{
+  auto message = std::string(1 << 16, 0);
+  auto state = uint32_t(1);
+  for (auto& c: message)
+  {
+    state = state * 1103515245 + 12345;
+    c = char(state >> 24);
+  }
+  auto pieces = std::vector<elle::ConstWeakBuffer>{};
+  for (auto i = 0u; i < message.size(); i += 7)
+    pieces.emplace_back(message.data() + i,
+                        std::min<std::size_t>(7, message.size() - i));
+  for (auto level: {0, 1, 9})
+  {
+    elle::format::deflate::Compressor c(level);
+    elle::format::deflate::Decompressor d;
+    auto const compressed = c.compress(pieces);
+    BOOST_CHECK_EQUAL(d.decompress(compressed, message.size()), message);
+  }
+}
+
+static
+void
+pieces()
+{
+  elle::format::deflate::Compressor c(9);
+  elle::format::deflate::Decompressor d;
+  auto const message = records(100);
+  auto const cut = message.size() / 3;
+  auto const compressed = c.compress(
+    std::vector<elle::ConstWeakBuffer>{
+      elle::ConstWeakBuffer(message.data(), cut),
+      elle::ConstWeakBuffer(),
+      elle::ConstWeakBuffer(message.data() + cut, message.size() - cut)});
+  BOOST_CHECK_EQUAL(compressed, c.compress(elle::ConstWeakBuffer(message)));
+  BOOST_CHECK_EQUAL(d.decompress(compressed, message.size()), message);
+}
+
+static
+void
+dictionary()
+{
+  auto const dictionary = elle::Buffer("{\"id\": , \"name\": \"user \"},");
+  elle::format::deflate::Compressor plain;
+  elle::format::deflate::Compressor c(1, dictionary);
+  elle::format::deflate::Decompressor d(dictionary);
+  auto const message = records(1);
+  auto const compressed = c.compress(elle::ConstWeakBuffer(message));
+  BOOST_CHECK_LT(compressed.size(),
+                 plain.compress(elle::ConstWeakBuffer(message)).size());
+  BOOST_CHECK_EQUAL(d.decompress(compressed, message.size()), message);
+  // The dictionary is required.
+  elle::format::deflate::Decompressor other;
+  BOOST_CHECK_THROW(other.decompress(compressed, message.size()),
+                    elle::Error);
+}
+
+static
+void
+corruption()
+{
+  elle::format::deflate::Compressor c;
+  elle::format::deflate::Decompressor d;
+  auto const message = records(100);
+  auto compressed = c.compress(elle::ConstWeakBuffer(message));
+  BOOST_CHECK_THROW(d.decompress(compressed, message.size() - 1),
+                    elle::Error);
+  BOOST_CHECK_THROW(d.decompress(compressed, message.size() + 1),
+                    elle::Error);
+  BOOST_CHECK_THROW(
+    d.decompress(elle::ConstWeakBuffer(compressed.contents(),
+                                       compressed.size() / 2),
+                 message.size()),
+    elle::Error);
+  // The Decompressor recovers.
+  BOOST_CHECK_EQUAL(d.decompress(compressed, message.size()), message);
+}
+
+ELLE_TEST_SUITE()
+{
+  auto& suite = boost::unit_test::framework::master_test_suite();
+  suite.add(BOOST_TEST_CASE(round_trip));
+  suite.add(BOOST_TEST_CASE(empty));
+  suite.add(BOOST_TEST_CASE(incompressible));
+  suite.add(BOOST_TEST_CASE(pieces));
+  suite.add(BOOST_TEST_CASE(dictionary));
+  suite.add(BOOST_TEST_CASE(corruption));
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+
+#include <elle/json/Reader.hh>
+#include <elle/json/json.hh>
+#include <elle/printf.hh>
+#include <elle/serialization/json.hh>
+
+// Not an automated test: measure the throughput of JSON.
+//
+// Usage: json-bench [rounds]
+//
+// Generate a configuration and an API listing of a few megabytes, then
+// read them into a tree from memory and from a stream, walk them with the
+// Reader alone, write them back and report the throughput. Then serialize and
+// deserialize a listing of records in a tree and incrementally.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  /// A deep, mostly textual configuration.
+  elle::json::Json
+  configuration(int sections)
+  {
+    auto res = elle::json::Object{};
+    for (int i = 0; i < sections; ++i)
+    {
+      auto section = elle::json::Object{};
+      section["name"] = elle::sprintf("section %s", i);
+      section["enabled"] = i % 3 != 0;
+      section["path"] = elle::sprintf("/var/lib/storage/%s/blocks", i);
+      auto options = elle::json::Object{};
+      for (int j = 0; j < 16; ++j)
+        options[elle::sprintf("option_%s", j)] =
+          elle::sprintf("value \"%s\" for\toption %s", i * j, j);
+      section["options"] = std::move(options);
+      auto peers = elle::json::Array{};
+      for (int j = 0; j < 8; ++j)
+        peers.emplace_back(elle::sprintf("10.0.%s.%s:9000", i % 256, j));
+      section["peers"] = std::move(peers);
+      res[elle::sprintf("section_%s", i)] = std::move(section);
+    }
+    return res;
+  }
+
+  /// A flat listing of numerical records.
+  elle::json::Json
+  listing(int count)
+  {
+    auto res = elle::json::Array{};
+    for (int i = 0; i < count; ++i)
+    {
+      auto record = elle::json::Object{};
+      record["id"] = int64_t(i);
+      record["size"] = int64_t(i) * 4096 + 17;
+      record["mtime"] = int64_t(1500000000) + i;
+      record["ratio"] = i / 7.;
+      record["owner"] = elle::sprintf("user-%s", i % 100);
+      record["tags"] = elle::json::Array{std::string("a"), std::string("b")};
+      res.emplace_back(std::move(record));
+    }
+    return res;
+  }
+
+  /// A record of a listing, to serialize.
+  struct Record
+  {
+    Record(int i)
+      : id(i)
+      , size(int64_t(i) * 4096 + 17)
+      , owner(elle::sprintf("user-%s", i % 100))
+      , tags{"a", "b"}
+    {}
+
+    Record(elle::serialization::SerializerIn& s)
+    {
+      this->serialize(s);
+    }
+
+    void
+    serialize(elle::serialization::Serializer& s)
+    {
+      s.serialize("id", this->id);
+      s.serialize("size", this->size);
+      s.serialize("owner", this->owner);
+      s.serialize("tags", this->tags);
+    }
+
+    int id;
+    int64_t size;
+    std::string owner;
+    std::vector<std::string> tags;
+  };
+
+  template <typename F>
+  void
+  bench(char const* name, int rounds, std::size_t size, F const& f)
+  {
+    auto const start = Clock::now();
+    for (int i = 0; i < rounds; ++i)
+      f();
+    auto const time =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    elle::fprintf(std::cout, "  %-26s %8.1f MB/s\n",
+                  name, size * rounds / time / 1e6);
+  }
+
+  void
+  bench_document(char const* name, int rounds, elle::json::Json const& json)
+  {
+    std::stringstream serialized;
+    elle::json::write(serialized, json);
+    auto const text = serialized.str();
+    elle::fprintf(std::cout, "%s: %s bytes\n", name, text.size());
+    bench("read from memory", rounds, text.size(),
+          [&] { elle::json::read(text); });
+    bench("read from stream", rounds, text.size(),
+          [&]
+          {
+            std::stringstream input(text);
+            elle::json::read(input);
+          });
+    bench("walk with the Reader", rounds, text.size(),
+          [&]
+          {
+            elle::json::Reader r{elle::ConstWeakBuffer(text)};
+            while (r.next() != elle::json::Reader::Event::end)
+              ;
+          });
+    bench("write", rounds, text.size(),
+          [&]
+          {
+            std::stringstream output;
+            elle::json::write(output, json);
+          });
+    bench("pretty print", rounds, text.size(),
+          [&] { elle::json::pretty_print(json); });
+  }
+
+  void
+  bench_serialization(int rounds, int count)
+  {
+    using elle::serialization::json::SerializerIn;
+    using elle::serialization::json::SerializerOut;
+    auto records = std::vector<Record>{};
+    for (int i = 0; i < count; ++i)
+      records.emplace_back(i);
+    std::stringstream serialized;
+    {
+      SerializerOut s(serialized, false);
+      s.serialize_forward(records);
+    }
+    auto const text = serialized.str();
+    elle::fprintf(std::cout, "records: %s bytes\n", text.size());
+    for (auto incremental: {false, true})
+    {
+      bench(incremental ? "serialize incrementally" : "serialize in a tree",
+            rounds, text.size(),
+            [&]
+            {
+              std::stringstream output;
+              SerializerOut s(output, false, false, incremental);
+              s.serialize_forward(records);
+            });
+      bench(incremental ? "deserialize incrementally" : "deserialize a tree",
+            rounds, text.size(),
+            [&]
+            {
+              std::stringstream input(text);
+              SerializerIn s(input, false, incremental);
+              s.deserialize<std::vector<Record>>();
+            });
+    }
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const rounds =
+    argc > 1 ? boost::lexical_cast<int>(argv[1]) : 10;
+  bench_document("configuration", rounds, configuration(4000));
+  bench_document("listing", rounds, listing(40000));
+  bench_serialization(rounds, 40000);
+  return 0;
+}
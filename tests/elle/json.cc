@@ -1,5 +1,9 @@
+#include <limits>
 #include <sstream>
 
+#include <elle/json/Reader.hh>
+#include <elle/json/Writer.hh>
+#include <elle/json/exceptions.hh>
 #include <elle/json/json.hh>
 #include <elle/test.hh>
 #include <elle/log.hh>
@@ -145,6 +149,153 @@ pretty_printer_utf_8()
   BOOST_CHECK_EQUAL(boost::any_cast<std::string>(read_object["utf-8"]), name);
 }
 
+static
+void
+reader()
+{
+  using Event = elle::json::Reader::Event;
+  std::stringstream input(
+    "{\"a\": [1, -2, 3.5, true, null, \"x\"], \"b\": {},} rest");
+  elle::json::Reader r(input);
+  BOOST_CHECK_EQUAL(r.next(), Event::object_begin);
+  BOOST_CHECK_EQUAL(r.next(), Event::key);
+  BOOST_CHECK_EQUAL(r.string(), "a");
+  BOOST_CHECK_EQUAL(r.next(), Event::array_begin);
+  BOOST_CHECK_EQUAL(r.depth(), 2);
+  BOOST_CHECK_EQUAL(r.next(), Event::integer);
+  BOOST_CHECK_EQUAL(r.integer(), 1);
+  BOOST_CHECK_EQUAL(r.next(), Event::integer);
+  BOOST_CHECK_EQUAL(r.integer(), -2);
+  BOOST_CHECK_EQUAL(r.next(), Event::real);
+  BOOST_CHECK_EQUAL(r.real(), 3.5);
+  BOOST_CHECK_EQUAL(r.next(), Event::boolean);
+  BOOST_CHECK(r.boolean());
+  BOOST_CHECK_EQUAL(r.next(), Event::null);
+  BOOST_CHECK_EQUAL(r.next(), Event::string);
+  BOOST_CHECK_EQUAL(r.string(), "x");
+  BOOST_CHECK_EQUAL(r.next(), Event::array_end);
+  BOOST_CHECK_EQUAL(r.next(), Event::key);
+  BOOST_CHECK_EQUAL(r.string(), "b");
+  BOOST_CHECK_EQUAL(r.next(), Event::object_begin);
+  BOOST_CHECK_EQUAL(r.next(), Event::object_end);
+  BOOST_CHECK_EQUAL(r.next(), Event::object_end);
+  BOOST_CHECK_EQUAL(r.depth(), 0);
+  // The rest of the stream is left untouched.
+  std::string rest;
+  std::getline(input, rest);
+  BOOST_CHECK_EQUAL(rest, " rest");
+  BOOST_CHECK_EQUAL(r.next(), Event::end);
+}
+
+static
+void
+read_numbers()
+{
+  auto const read = [] (std::string const& json)
+    {
+      return elle::json::read(json);
+    };
+  using lim = std::numeric_limits<int64_t>;
+  BOOST_CHECK_EQUAL(boost::any_cast<int64_t>(read(std::to_string(lim::min()))),
+                    lim::min());
+  BOOST_CHECK_EQUAL(boost::any_cast<int64_t>(read(std::to_string(lim::max()))),
+                    lim::max());
+  // Unsigned values are wrapped.
+  BOOST_CHECK_EQUAL(
+    uint64_t(boost::any_cast<int64_t>(read("18446744073709551615"))),
+    std::numeric_limits<uint64_t>::max());
+  BOOST_CHECK_EQUAL(boost::any_cast<double>(read("18446744073709551616")),
+                    18446744073709551616.);
+  BOOST_CHECK_EQUAL(boost::any_cast<double>(read("-1.5e3")), -1500);
+  BOOST_CHECK_EQUAL(boost::any_cast<double>(read("0.1")), 0.1);
+}
+
+static
+void
+read_errors()
+{
+  for (auto json: {"", "{", "[1,", "{\"a\" 1}", "{1: 2}", "tru", "\"abc",
+                   "[1 2]", "[1}", "-", "1.", "\"\\x\""})
+    BOOST_CHECK_THROW(elle::json::read(json), elle::json::ParseError);
+  BOOST_CHECK_THROW(elle::json::read("1 2"), elle::Error);
+}
+
+static
+void
+write_strings()
+{
+  auto const value =
+    std::string("\"quoted\" \\ \b\f\n\r\t \x01 / Средня \xf0\x9f\x98\x98");
+  std::stringstream output;
+  elle::json::write(output, value, false);
+  BOOST_CHECK_EQUAL(
+    output.str(),
+    "\"\\\"quoted\\\" \\\\ \\b\\f\\n\\r\\t \\u0001 / Средня "
+    "\xf0\x9f\x98\x98\"");
+  BOOST_CHECK_EQUAL(boost::any_cast<std::string>(elle::json::read(output)),
+                    value);
+}
+
+static
+void
+write_reals()
+{
+  auto const write = [] (double v)
+    {
+      std::stringstream output;
+      elle::json::write(output, v, false);
+      return output.str();
+    };
+  BOOST_CHECK_EQUAL(write(0.5), "0.5");
+  BOOST_CHECK_EQUAL(write(1), "1.0");
+  BOOST_CHECK_EQUAL(write(-1e300), "-1e+300");
+  for (auto v: {0.1, 1. / 3, 123456.789, 5e-324})
+    BOOST_CHECK_EQUAL(
+      boost::any_cast<double>(elle::json::read(write(v))), v);
+  std::stringstream output;
+  BOOST_CHECK_THROW(
+    elle::json::write(output, std::numeric_limits<double>::infinity()),
+    elle::Error);
+}
+
+static
+void
+writer()
+{
+  {
+    std::stringstream output;
+    elle::json::Writer w(output);
+    w.object_begin();
+    w.key("ids");
+    w.array_begin();
+    for (int64_t i = -1; i < 2; ++i)
+      w.integer(i);
+    w.array_end();
+    w.key("empty");
+    w.object_begin();
+    w.object_end();
+    w.object_end();
+    BOOST_CHECK_EQUAL(output.str(), "{\"ids\":[-1,0,1],\"empty\":{}}");
+  }
+  {
+    elle::json::Object object;
+    object["b"] = elle::json::Array{int64_t(1), std::string("two")};
+    object["a"] = elle::json::Object{};
+    object["c"] = elle::json::NullType();
+    // Keys are sorted.
+    BOOST_CHECK_EQUAL(elle::json::pretty_print(object),
+                      "{\n"
+                      "    \"a\" : {\n"
+                      "    },\n"
+                      "    \"b\" : [\n"
+                      "        1,\n"
+                      "        \"two\"\n"
+                      "    ],\n"
+                      "    \"c\" : null\n"
+                      "}");
+  }
+}
+
 ELLE_TEST_SUITE()
 {
   auto timeout = 3;
@@ -159,4 +310,10 @@ ELLE_TEST_SUITE()
   suite.add(BOOST_TEST_CASE(read_escaped_utf_8), 0, timeout);
   suite.add(BOOST_TEST_CASE(write_utf_8), 0, timeout);
   suite.add(BOOST_TEST_CASE(pretty_printer_utf_8), 0, timeout);
+  suite.add(BOOST_TEST_CASE(reader), 0, timeout);
+  suite.add(BOOST_TEST_CASE(read_numbers), 0, timeout);
+  suite.add(BOOST_TEST_CASE(read_errors), 0, timeout);
+  suite.add(BOOST_TEST_CASE(write_strings), 0, timeout);
+  suite.add(BOOST_TEST_CASE(write_reals), 0, timeout);
+  suite.add(BOOST_TEST_CASE(writer), 0, timeout);
 }
@@ -0,0 +1,152 @@
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <elle/Measure.hh>
+#include <elle/bench.hh>
+#include <elle/metrics.hh>
+#include <elle/test.hh>
+
+static
+void
+counter()
+{
+  auto& c = elle::metrics::counter("test.counter");
+  BOOST_TEST(&c == &elle::metrics::counter("test.counter"));
+  auto threads = std::vector<std::thread>{};
+  for (int i = 0; i < 16; ++i)
+    threads.emplace_back(
+      [&c]
+      {
+        for (int j = 0; j < 1000; ++j)
+          c.increment();
+      });
+  for (auto& t: threads)
+    t.join();
+  c.increment(42);
+  BOOST_TEST(c.value() == 16042u);
+  BOOST_TEST(elle::metrics::snapshot().counters.at("test.counter") == 16042u);
+}
+
+static
+void
+gauge()
+{
+  auto& g = elle::metrics::gauge("test.gauge");
+  g.set(10);
+  g.add(-15);
+  BOOST_TEST(g.value() == -5);
+  BOOST_TEST(elle::metrics::snapshot().gauges.at("test.gauge") == -5);
+}
+
+static
+void
+buckets()
+{
+  using elle::metrics::Histogram;
+  // Buckets are contiguous and cover every value.
+  for (int b = 1; b < Histogram::buckets; ++b)
+  {
+    auto const lower = Histogram::upper(b - 1) + 1;
+    BOOST_TEST(Histogram::bucket(lower) == b);
+    BOOST_TEST(Histogram::bucket(Histogram::upper(b)) == b);
+  }
+  BOOST_TEST(Histogram::upper(Histogram::buckets - 1) == ~std::uint64_t(0));
+}
+
+static
+void
+histogram()
+{
+  auto& h = elle::metrics::histogram("test.histogram");
+  BOOST_TEST(h.distribution().count == 0u);
+  for (int i = 1; i <= 1000; ++i)
+    h.record(i * 1000);
+  auto const d = h.distribution();
+  BOOST_TEST(d.count == 1000u);
+  BOOST_TEST(d.min == 1000u);
+  BOOST_TEST(d.max == 1000000u);
+  BOOST_TEST(d.mean() == 500500.);
+  // Percentiles are upper bounds at most 1/16 above.
+  auto const check = [&] (double p, std::uint64_t expected)
+    {
+      auto const v = d.percentile(p);
+      BOOST_TEST(v >= expected);
+      BOOST_TEST(v <= expected + expected / 16);
+    };
+  check(50, 500000);
+  check(90, 900000);
+  check(99, 990000);
+  BOOST_TEST(d.percentile(100) == 1000000u);
+}
+
+static
+void
+measure()
+{
+  auto& h = elle::metrics::histogram("test.measure");
+  elle::metrics::enabled(false);
+  ELLE_MEASURE("test.measure")
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  BOOST_TEST(h.distribution().count == 0u);
+  elle::metrics::enabled(true);
+  ELLE_MEASURE("test.measure")
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  {
+    ELLE_MEASURE_SCOPE("test.measure");
+  }
+  elle::metrics::enabled(false);
+  auto const d = h.distribution();
+  BOOST_TEST(d.count == 2u);
+  BOOST_TEST(d.max >= 1000000u);
+}
+
+static
+void
+bench()
+{
+  {
+    auto b = elle::Bench("test.bench");
+    b.add(10);
+    b.add(20);
+  }
+  auto const d = elle::metrics::histogram("test.bench").distribution();
+  BOOST_TEST(d.count == 2u);
+  BOOST_TEST(d.sum == 30u);
+  // Scopes record nanoseconds, like ELLE_MEASURE.
+  {
+    auto b = elle::Bench("test.bench.scope");
+    elle::Bench::BenchScope s(b);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto const scope =
+    elle::metrics::histogram("test.bench.scope").distribution();
+  BOOST_TEST(scope.count == 1u);
+  BOOST_TEST(scope.max >= 1000000u);
+}
+
+static
+void
+print()
+{
+  elle::metrics::counter("test.print.counter").increment(3);
+  elle::metrics::histogram("test.print.histogram").record(7);
+  std::stringstream output;
+  output << elle::metrics::snapshot();
+  auto const text = output.str();
+  BOOST_TEST(text.find("test.print.counter 3\n") != std::string::npos);
+  BOOST_TEST(text.find("test.print.histogram 1 7 7 7 7 7 7 7\n") !=
+             std::string::npos);
+}
+
+ELLE_TEST_SUITE()
+{
+  auto& master = boost::unit_test::framework::master_test_suite();
+  master.add(BOOST_TEST_CASE(counter), 0, 10);
+  master.add(BOOST_TEST_CASE(gauge), 0, 1);
+  master.add(BOOST_TEST_CASE(buckets), 0, 1);
+  master.add(BOOST_TEST_CASE(histogram), 0, 1);
+  master.add(BOOST_TEST_CASE(measure), 0, 1);
+  master.add(BOOST_TEST_CASE(bench), 0, 1);
+  master.add(BOOST_TEST_CASE(print), 0, 1);
+}
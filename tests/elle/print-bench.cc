@@ -0,0 +1,87 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+
+#include <elle/Buffer.hh>
+#include <elle/print.hh>
+#include <elle/printf.hh>
+
+// Not an automated test: measure the cost of formatting.
+//
+// Usage: print-bench [rounds]
+//
+// Format the same message, a string, an integer and a user type, with every
+// formatter and report the time per call.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct Point
+  {
+    int x;
+    int y;
+  };
+
+  std::ostream&
+  operator <<(std::ostream& o, Point const& p)
+  {
+    return o << "(" << p.x << ", " << p.y << ")";
+  }
+
+  /// Keep results alive so the work is not optimized away.
+  std::size_t volatile sink;
+
+  template <typename F>
+  void
+  bench(char const* name, int rounds, F const& f)
+  {
+    auto const start = Clock::now();
+    for (int i = 0; i < rounds; ++i)
+      sink = sink + f(i);
+    auto const time =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    elle::fprintf(std::cout, "%-24s %8.0f ns/call\n", name, time / rounds);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const rounds =
+    argc > 1 ? boost::lexical_cast<int>(argv[1]) : 1000000;
+  auto const name = std::string("connection");
+  auto const point = Point{3, 4};
+  bench("sprintf", rounds, [&] (int i) {
+      return elle::sprintf("%s %s: read %s bytes at %s",
+                           name, i, 4096, point).size();
+    });
+  bench("ostringstream", rounds, [&] (int i) {
+      std::ostringstream s;
+      s << name << " " << i << ": read " << 4096 << " bytes at " << point;
+      return s.str().size();
+    });
+  bench("print", rounds, [&] (int i) {
+      return elle::print("{} {}: read {} bytes at {}",
+                         name, i, 4096, point).size();
+    });
+  bench("print static", rounds, [&] (int i) {
+      return elle::print(ELLE_PRINT_FORMAT("{} {}: read {} bytes at {}"),
+                         name, i, 4096, point).size();
+    });
+  bench("print static, no stream", rounds, [&] (int i) {
+      return elle::print(ELLE_PRINT_FORMAT("{} {}: read {} bytes at ({}, {})"),
+                         name, i, 4096, point.x, point.y).size();
+    });
+  auto buffer = elle::Buffer();
+  bench("print static to Buffer", rounds, [&] (int i) {
+      buffer.size(0);
+      elle::print(buffer, ELLE_PRINT_FORMAT("{} {}: read {} bytes at {}"),
+                  name, i, 4096, point);
+      return buffer.size();
+    });
+  return 0;
+}
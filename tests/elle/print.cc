@@ -1,6 +1,11 @@
 #include <ostream>
+#include <sstream>
 
+#include <elle/Buffer.hh>
+#include <elle/Error.hh>
+#include <elle/err.hh>
 #include <elle/print.hh>
+#include <elle/printf.hh>
 #include <elle/test.hh>
 
 static
@@ -56,6 +61,13 @@ too_few()
   BOOST_CHECK_THROW(elle::print("{}{}", "foo"), std::exception);
 }
 
+static
+void
+too_many()
+{
+  BOOST_CHECK_THROW(elle::print("{}", "foo", "bar"), std::exception);
+}
+
 namespace detail
 {
   struct foo
@@ -145,6 +157,51 @@ namespace
   {
     BOOST_TEST(elle::print("%x %s%%", 134, 134) == "86 134%");
     BOOST_TEST(elle::print("%r %s", Foo{}, Foo{}) == "Verbose Silent");
+    BOOST_TEST(elle::print("%x %o %d", -1, -8, -42) ==
+               "ffffffff 37777777770 -42");
+  }
+
+  void
+  compile_time()
+  {
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("")) == "");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("foo{}baz"), "bar") ==
+               "foobarbaz");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("{} {} {}"), 42, true, 'c') ==
+               "42 true c");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("{1} {0}"), 0, 1) == "1 0");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("{?{}, }{?{}}"),
+                           false, 0, true, 1) == "1");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("%x %r %s"), 255, Foo{}, Foo{})
+               == "ff Verbose Silent");
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("{}"), detail::foo{5}) ==
+               "foo(i = 5)");
+    std::stringstream stream;
+    stream << std::hex;
+    elle::print(stream, ELLE_PRINT_FORMAT("{} %d {}"), 16, 16, 16);
+    BOOST_TEST(stream.str() == "10 16 10");
+    BOOST_CHECK_THROW(elle::err(ELLE_PRINT_FORMAT("{}"), 42), elle::Error);
+    BOOST_TEST(elle::print(ELLE_PRINT_FORMAT("{n} * {n} = {squared?{squared}}"),
+                           {{"n", 4}, {"squared", 16}}) == "4 * 4 = 16");
+    BOOST_CHECK_THROW(elle::print(ELLE_PRINT_FORMAT("{n}"), {{"m", 4}}),
+                      elle::Error);
+  }
+
+  void
+  buffer()
+  {
+    auto b = elle::Buffer("prefix: ");
+    elle::print(b, "{} {}", "foo", 42);
+    elle::print(b, ELLE_PRINT_FORMAT(" {}"), detail::foo{5});
+    BOOST_TEST(b.string() == "prefix: foo 42 foo(i = 5)");
+  }
+
+  void
+  large()
+  {
+    auto const big = std::string(1000, 'x');
+    auto const res = elle::print("{}{}{}", big, detail::foo{1}, big);
+    BOOST_TEST(res == big + "foo(i = 1)" + big);
   }
 }
 
@@ -159,6 +216,7 @@ ELLE_TEST_SUITE()
   suite.add(BOOST_TEST_CASE(null_string));
   suite.add(BOOST_TEST_CASE(c_string));
   suite.add(BOOST_TEST_CASE(too_few));
+  suite.add(BOOST_TEST_CASE(too_many));
   suite.add(BOOST_TEST_CASE(scoped));
   suite.add(BOOST_TEST_CASE(boolean));
   suite.add(BOOST_TEST_CASE(indexed));
@@ -166,4 +224,7 @@ ELLE_TEST_SUITE()
   suite.add(BOOST_TEST_CASE(conditional));
   suite.add(BOOST_TEST_CASE(conditional_positional));
   suite.add(BOOST_TEST_CASE(legacy));
+  suite.add(BOOST_TEST_CASE(compile_time));
+  suite.add(BOOST_TEST_CASE(buffer));
+  suite.add(BOOST_TEST_CASE(large));
 }
@@ -3,10 +3,13 @@
 ELLE_LOG_COMPONENT("elle.protocol.Channel.test");
 
 #include <elle/compiler.hh>
+#include <elle/metrics.hh>
 #include <elle/test.hh>
 
 #include <elle/protocol/ChanneledStream.hh>
 #include <elle/protocol/Serializer.hh>
+#include <elle/reactor/Scope.hh>
+#include <elle/reactor/TimeoutGuard.hh>
 #include <elle/reactor/network/Error.hh>
 #include <elle/reactor/network/TCPServer.hh>
 #include <elle/reactor/network/TCPSocket.hh>
@@ -80,6 +83,312 @@ ELLE_TEST_SCHEDULED(eof_read)
     });
 }
 
+/*-------------.
+| Flow control |
+`-------------*/
+
+namespace
+{
+  using Window = boost::optional<elle::protocol::ChanneledStream::Size>;
+
+  /// Run @a server and @a client on both ends of a loopback connection.
+  ///
+  /// The server runs @a server_version if given, @a version otherwise.
+  void
+  connected(std::function<void (elle::protocol::ChanneledStream&)> server,
+            std::function<void (elle::protocol::ChanneledStream&)> client,
+            Window server_window = {},
+            Window client_window = {},
+            elle::Version const& version = elle::Version(0, 8, 0),
+            boost::optional<elle::Version> server_version = {})
+  {
+    auto s = elle::reactor::network::TCPServer{};
+    s.listen();
+    auto&& thread = elle::reactor::Thread(
+      "server",
+      [&]
+      {
+        auto socket = s.accept();
+        auto&& ser = elle::protocol::Serializer(
+          *socket, server_version.value_or(version));
+        auto&& channels =
+          elle::protocol::ChanneledStream(ser, server_window);
+        server(channels);
+      });
+    auto socket = elle::reactor::network::TCPSocket("127.0.0.1", s.port());
+    auto&& ser = elle::protocol::Serializer(socket, version);
+    auto&& channels = elle::protocol::ChanneledStream(ser, client_window);
+    client(channels);
+    elle::reactor::wait(thread);
+  }
+}
+
+// Writers block once their window is in flight, until the peer reads.
+static
+void
+_window(Window server_window,
+        Window client_window,
+        elle::Version const& version,
+        int ahead)
+{
+  auto& stalls = elle::metrics::counter("elle.protocol.Channel.stalls");
+  auto const stalls_start = stalls.value();
+  auto const packet = elle::Buffer(std::string(400, 'x'));
+  auto reading = elle::reactor::Barrier{};
+  auto written = 0;
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = channels.accept();
+      elle::reactor::wait(reading);
+      for (int i = 0; i < 10; ++i)
+        BOOST_TEST(c.read() == packet);
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = elle::protocol::Channel(channels);
+      auto&& writer = elle::reactor::Thread(
+        "writer",
+        [&]
+        {
+          for (int i = 0; i < 10; ++i)
+          {
+            c.write(packet);
+            ++written;
+          }
+        });
+      elle::reactor::sleep(100_ms);
+      BOOST_TEST(written == ahead);
+      reading.open();
+      elle::reactor::wait(writer);
+      BOOST_TEST(written == 10);
+    },
+    server_window,
+    client_window,
+    version);
+  if (ahead < 10)
+    BOOST_TEST(stalls.value() - stalls_start >= 1);
+  else
+    BOOST_TEST(stalls.value() == stalls_start);
+}
+
+ELLE_TEST_SCHEDULED(window)
+{
+  _window(1000, 1000, elle::Version(0, 7, 0), 2);
+}
+
+// The reader credits bytes back even without a window of its own.
+ELLE_TEST_SCHEDULED(window_writer)
+{
+  _window({}, 1000, elle::Version(0, 7, 0), 2);
+}
+
+// The reader's window does not hold the writer back.
+ELLE_TEST_SCHEDULED(window_reader)
+{
+  _window(1000, {}, elle::Version(0, 7, 0), 10);
+}
+
+// Peers older than 0.7.0 do not credit bytes back: windows are dropped.
+ELLE_TEST_SCHEDULED(window_old)
+{
+  _window(1000, 1000, elle::Version(0, 6, 0), 10);
+}
+
+// A packet larger than the window goes through once nothing is in flight.
+ELLE_TEST_SCHEDULED(window_large)
+{
+  auto const small = elle::Buffer("small");
+  auto const large = elle::Buffer(std::string(5000, 'x'));
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = channels.accept();
+      for (int i = 0; i < 3; ++i)
+      {
+        BOOST_TEST(c.read() == small);
+        BOOST_TEST(c.read() == large);
+      }
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = elle::protocol::Channel(channels);
+      for (int i = 0; i < 3; ++i)
+      {
+        c.write(small);
+        c.write(large);
+      }
+    },
+    1000,
+    1000);
+}
+
+// Writers waiting for credit fail with the connection.
+ELLE_TEST_SCHEDULED(window_broken)
+{
+  auto const packet = elle::Buffer(std::string(400, 'x'));
+  auto blocked = elle::reactor::Barrier{};
+  auto written = 0;
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = channels.accept();
+      // Close the connection without reading anything.
+      elle::reactor::wait(blocked);
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto c = elle::protocol::Channel(channels);
+      auto&& writer = elle::reactor::Thread(
+        "writer",
+        [&]
+        {
+          BOOST_CHECK_THROW(
+            while (true)
+            {
+              c.write(packet);
+              ++written;
+            },
+            elle::reactor::network::ConnectionClosed);
+        });
+      elle::reactor::sleep(100_ms);
+      BOOST_TEST(written == 2);
+      blocked.open();
+      elle::reactor::wait(writer);
+      BOOST_CHECK_THROW(elle::protocol::Channel(channels).write(packet),
+                        elle::reactor::network::ConnectionClosed);
+    },
+    1000,
+    1000);
+}
+
+// Nothing more is read from the connection while the budget is exhausted.
+ELLE_TEST_SCHEDULED(budget)
+{
+  auto const packet = elle::Buffer(std::string(400, 'x'));
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      channels.budget(1000);
+      auto accepted = std::vector<elle::protocol::Channel>{};
+      accepted.reserve(5);
+      auto&& acceptor = elle::reactor::Thread(
+        "acceptor",
+        [&]
+        {
+          for (int i = 0; i < 5; ++i)
+            accepted.emplace_back(channels.accept());
+        });
+      elle::reactor::sleep(100_ms);
+      BOOST_TEST(accepted.size() == 3);
+      // Every packet read lets one more in.
+      for (unsigned i = 0; i < 5; ++i)
+      {
+        while (accepted.size() <= i)
+          elle::reactor::yield();
+        BOOST_TEST(accepted[i].read() == packet);
+      }
+      elle::reactor::wait(acceptor);
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      auto opened = std::vector<elle::protocol::Channel>{};
+      for (int i = 0; i < 5; ++i)
+      {
+        opened.emplace_back(channels);
+        opened.back().write(packet);
+      }
+      // Keep the channels open until the server is done.
+      BOOST_CHECK_THROW(opened.front().read(),
+                        elle::reactor::network::ConnectionClosed);
+    });
+}
+
+/*---------.
+| Batching |
+`---------*/
+
+// Batched writers hit by a timeout still send their packet, and later
+// writers are not stuck behind them.
+ELLE_TEST_SCHEDULED(batching_timeout)
+{
+  auto const packet = elle::Buffer("packet");
+  auto timeouts = 0;
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      for (int i = 0; i < 4; ++i)
+        BOOST_TEST(channels.accept().read() == packet);
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      channels.batching(100_ms);
+      elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+      {
+        for (int i = 0; i < 3; ++i)
+          scope.run_background(
+            elle::sprintf("writer %s", i),
+            [&]
+            {
+              auto c = elle::protocol::Channel(channels);
+              try
+              {
+                elle::reactor::TimeoutGuard guard(10_ms);
+                c.write(packet);
+              }
+              catch (elle::reactor::Timeout const&)
+              {
+                ++timeouts;
+              }
+            });
+        elle::reactor::wait(scope);
+      };
+      auto c = elle::protocol::Channel(channels);
+      c.write(packet);
+      // Keep the connection open until the server is done.
+      BOOST_CHECK_THROW(c.read(), elle::reactor::network::ConnectionClosed);
+    });
+  BOOST_TEST(timeouts == 3);
+}
+
+// Peers older than 0.8.0 get packets one by one.
+ELLE_TEST_SCHEDULED(batching_old)
+{
+  auto& batches =
+    elle::metrics::counter("elle.protocol.ChanneledStream.batches");
+  auto const before = batches.value();
+  auto const packet = elle::Buffer("packet");
+  connected(
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      BOOST_TEST(channels.version() == elle::Version(0, 7, 0));
+      for (int i = 0; i < 3; ++i)
+        BOOST_TEST(channels.accept().read() == packet);
+    },
+    [&] (elle::protocol::ChanneledStream& channels)
+    {
+      channels.batching(10_ms);
+      auto opened = std::vector<elle::protocol::Channel>{};
+      opened.reserve(3);
+      for (int i = 0; i < 3; ++i)
+        opened.emplace_back(channels);
+      elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+      {
+        for (auto& c: opened)
+          scope.run_background("writer", [&] { c.write(packet); });
+        elle::reactor::wait(scope);
+      };
+      // Keep the connection open until the server is done.
+      BOOST_CHECK_THROW(opened.front().read(),
+                        elle::reactor::network::ConnectionClosed);
+    },
+    {},
+    {},
+    elle::Version(0, 8, 0),
+    elle::Version(0, 7, 0));
+  BOOST_TEST(batches.value() == before);
+}
+
 ELLE_TEST_SUITE()
 {
   auto& suite = boost::unit_test::framework::master_test_suite();
@@ -89,4 +398,22 @@ ELLE_TEST_SUITE()
     eof->add(ELLE_TEST_CASE(eof_accept, "accept"), 0, valgrind(2));
     eof->add(ELLE_TEST_CASE(eof_read, "read"), 0, valgrind(2));
   }
+  {
+    auto flow = BOOST_TEST_SUITE("flow_control");
+    suite.add(flow);
+    flow->add(ELLE_TEST_CASE(window, "window"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(window_writer, "window_writer"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(window_reader, "window_reader"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(window_old, "window_old"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(window_large, "window_large"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(window_broken, "window_broken"), 0, valgrind(2));
+    flow->add(ELLE_TEST_CASE(budget, "budget"), 0, valgrind(2));
+  }
+  {
+    auto batching = BOOST_TEST_SUITE("batching");
+    suite.add(batching);
+    batching->add(ELLE_TEST_CASE(batching_timeout, "timeout"), 0,
+                  valgrind(2));
+    batching->add(ELLE_TEST_CASE(batching_old, "old"), 0, valgrind(2));
+  }
 }
@@ -0,0 +1,211 @@
+#include <chrono>
+#include <iostream>
+
+#include <boost/lexical_cast.hpp>
+
+#include <elle/With.hh>
+#include <elle/err.hh>
+#include <elle/metrics.hh>
+#include <elle/printf.hh>
+#include <elle/protocol/ChanneledStream.hh>
+#include <elle/protocol/RPC.hh>
+#include <elle/protocol/Serializer.hh>
+#include <elle/protocol/exceptions.hh>
+#include <elle/reactor/Scope.hh>
+#include <elle/reactor/network/TCPServer.hh>
+#include <elle/reactor/network/TCPSocket.hh>
+#include <elle/reactor/scheduler.hh>
+
+// Not an automated test: measure the rate of small RPCs.
+//
+// Usage: rpc-bench [calls] [callers] [payload size]
+//
+// Issue echo calls from concurrent callers over a loopback TCP connection,
+// without batching, batching per scheduler round and batching over a window,
+// then failing calls with and without backtraces, and report the calls per
+// second and the number of batches.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  class OutputArchive
+  {
+  public:
+    OutputArchive(std::ostream& output)
+      : _output(output)
+    {}
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, OutputArchive&>
+    operator <<(T value)
+    {
+      this->_output.write(reinterpret_cast<char const*>(&value), sizeof value);
+      return *this;
+    }
+
+    OutputArchive&
+    operator <<(std::string const& value)
+    {
+      *this << uint32_t(value.size());
+      this->_output.write(value.data(), value.size());
+      return *this;
+    }
+
+  private:
+    std::ostream& _output;
+  };
+
+  class InputArchive
+  {
+  public:
+    InputArchive(std::istream& input)
+      : _input(input)
+    {}
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, InputArchive&>
+    operator >>(T& value)
+    {
+      this->_input.read(reinterpret_cast<char*>(&value), sizeof value);
+      return *this;
+    }
+
+    InputArchive&
+    operator >>(std::string& value)
+    {
+      auto size = uint32_t(0);
+      *this >> size;
+      value.resize(size);
+      this->_input.read(&value[0], size);
+      return *this;
+    }
+
+  private:
+    std::istream& _input;
+  };
+
+  struct EchoRPC
+    : public elle::protocol::RPC<InputArchive, OutputArchive>
+  {
+    EchoRPC(elle::protocol::ChanneledStream& channels)
+      : elle::protocol::RPC<InputArchive, OutputArchive>(channels)
+      , echo("echo", *this)
+      , lookup("lookup", *this)
+    {}
+
+    RemoteProcedure<std::string, std::string const&> echo;
+    RemoteProcedure<std::string, std::string const&> lookup;
+  };
+
+  enum class Mode
+  {
+    /// Successful echo calls.
+    echo,
+    /// Calls failing with an error.
+    error,
+    /// Calls failing with an error and its backtrace.
+    backtrace,
+  };
+
+  void
+  bench(char const* name,
+        elle::reactor::DurationOpt batching,
+        Mode mode,
+        int calls,
+        int callers,
+        std::string const& payload)
+  {
+    // Small packets: disable Nagle's algorithm on both ends.
+    elle::reactor::network::TCPServer server(true);
+    server.listen(0);
+    elle::reactor::network::TCPSocket client("127.0.0.1", server.port());
+    client.socket()->set_option(boost::asio::ip::tcp::no_delay(true));
+    auto accepted = server.accept();
+    auto& batches =
+      elle::metrics::counter("elle.protocol.ChanneledStream.batches");
+    auto const batches_start = batches.value();
+    auto const start = Clock::now();
+    elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+    {
+      auto& serve = scope.run_background(
+        "server",
+        [&]
+        {
+          elle::protocol::Serializer s(*accepted, elle::Version(0, 4, 0));
+          elle::protocol::ChanneledStream channels(s);
+          channels.batching(batching);
+          EchoRPC rpc(channels);
+          rpc.echo = [] (std::string const& s) { return s; };
+          rpc.lookup = [] (std::string const& s) -> std::string
+            {
+              throw elle::Error("not found");
+            };
+          rpc.parallel_run();
+        });
+      elle::protocol::Serializer s(client, elle::Version(0, 4, 0));
+      elle::protocol::ChanneledStream channels(s);
+      channels.batching(batching);
+      EchoRPC rpc(channels);
+      rpc.backtraces(mode == Mode::backtrace);
+      elle::With<elle::reactor::Scope>() <<
+        [&] (elle::reactor::Scope& callers_scope)
+      {
+        for (int i = 0; i < callers; ++i)
+          callers_scope.run_background(
+            elle::sprintf("caller %s", i),
+            [&, i]
+            {
+              for (int c = i; c < calls; c += callers)
+                if (mode == Mode::echo)
+                {
+                  if (rpc.echo(payload) != payload)
+                    elle::err("call %s: unexpected answer", c);
+                }
+                else
+                  try
+                  {
+                    rpc.lookup(payload);
+                    elle::err("call %s: unexpected success", c);
+                  }
+                  catch (elle::protocol::RPCError const&)
+                  {}
+            });
+        elle::reactor::wait(callers_scope);
+      };
+      serve.terminate_now();
+    };
+    auto const seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    elle::fprintf(std::cout, "%-24s %10.0f calls/s %8s batches\n",
+                  name, calls / seconds, batches.value() - batches_start);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const calls =
+    argc > 1 ? boost::lexical_cast<int>(argv[1]) : 100000;
+  auto const callers =
+    argc > 2 ? boost::lexical_cast<int>(argv[2]) : 64;
+  auto const payload_size =
+    argc > 3 ? boost::lexical_cast<int>(argv[3]) : 64;
+  auto const payload = std::string(payload_size, 'x');
+  elle::reactor::Scheduler sched;
+  elle::reactor::Thread main(
+    sched, "main",
+    [&]
+    {
+      bench("unbatched", boost::none, Mode::echo, calls, callers, payload);
+      bench("batched, round", elle::reactor::Duration(), Mode::echo,
+            calls, callers, payload);
+      bench("batched, 100us", boost::posix_time::microseconds(100),
+            Mode::echo, calls, callers, payload);
+      bench("errors", boost::none, Mode::error, calls, callers, payload);
+      bench("errors, backtraces", boost::none, Mode::backtrace,
+            calls, callers, payload);
+    });
+  sched.run();
+  return 0;
+}
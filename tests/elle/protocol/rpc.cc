@@ -1,15 +1,21 @@
+#include <elle/metrics.hh>
 #include <elle/protocol/ChanneledStream.hh>
 #include <elle/protocol/RPC.hh>
+#include <elle/protocol/RPCPool.hh>
 #include <elle/protocol/Serializer.hh>
 
+#include <elle/reactor/Barrier.hh>
+#include <elle/reactor/Scope.hh>
 #include <elle/reactor/asio.hh>
+#include <elle/reactor/exception.hh>
 #include <elle/reactor/network/Error.hh>
 #include <elle/reactor/network/TCPServer.hh>
 #include <elle/reactor/network/TCPSocket.hh>
 #include <elle/reactor/scheduler.hh>
-#include <elle/reactor/scheduler.hh>
 #include <elle/reactor/semaphore.hh>
 #include <elle/reactor/Thread.hh>
+#include <elle/reactor/TimeoutGuard.hh>
+#include <elle/serialization/Error.hh>
 
 #include <elle/test.hh>
 
@@ -20,18 +26,90 @@ struct TestConfig
   bool sync;
   bool checksum;
   elle::Version version;
+  elle::reactor::DurationOpt batching;
 };
 
+/// Whether callers cancel their abandoned calls on the server.
+static
+bool
+cancellable(TestConfig const& config)
+{
+  return config.version >= elle::Version(0, 6, 0);
+}
+
+/// Whether packets are batched.
+static
+bool
+batched(TestConfig const& config)
+{
+  return config.version >= elle::Version(0, 8, 0);
+}
+
 static
 elle::reactor::Thread* suicide_thread(nullptr);
 
+/// Minimal binary archives for the RPC templates.
+class OutputArchive
+{
+public:
+  OutputArchive(std::ostream& output)
+    : _output(output)
+  {}
+
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic<T>::value, OutputArchive&>
+  operator <<(T value)
+  {
+    this->_output.write(reinterpret_cast<char const*>(&value), sizeof value);
+    return *this;
+  }
+
+  OutputArchive&
+  operator <<(std::string const& value)
+  {
+    *this << uint32_t(value.size());
+    this->_output.write(value.data(), value.size());
+    return *this;
+  }
+
+private:
+  std::ostream& _output;
+};
+
+class InputArchive
+{
+public:
+  InputArchive(std::istream& input)
+    : _input(input)
+  {}
+
+  template <typename T>
+  std::enable_if_t<std::is_arithmetic<T>::value, InputArchive&>
+  operator >>(T& value)
+  {
+    this->_input.read(reinterpret_cast<char*>(&value), sizeof value);
+    return *this;
+  }
+
+  InputArchive&
+  operator >>(std::string& value)
+  {
+    uint32_t size;
+    *this >> size;
+    value.resize(size);
+    this->_input.read(&value[0], size);
+    return *this;
+  }
+
+private:
+  std::istream& _input;
+};
+
 struct DummyRPC:
-  public elle::protocol::RPC<elle::serialize::InputBinaryArchive,
-                                elle::serialize::OutputBinaryArchive>
+  public elle::protocol::RPC<InputArchive, OutputArchive>
 {
   DummyRPC(elle::protocol::ChanneledStream& channels)
-    : elle::protocol::RPC<elle::serialize::InputBinaryArchive,
-                             elle::serialize::OutputBinaryArchive>(channels)
+    : elle::protocol::RPC<InputArchive, OutputArchive>(channels)
     , answer("answer", *this)
     , square("square", *this)
     , concat("concat", *this)
@@ -39,6 +117,13 @@ struct DummyRPC:
     , suicide("suicide", *this)
     , count("count", *this)
     , wait("wait", *this)
+    , slow("slow", *this)
+    , fail("fail", *this)
+    , upload("upload", *this)
+    , download("download", *this)
+    , faulty("faulty", *this)
+    , expire("expire", *this)
+    , corrupt("corrupt", *this)
   {}
 
   RemoteProcedure<int> answer;
@@ -48,6 +133,25 @@ struct DummyRPC:
   RemoteProcedure<void> suicide;
   RemoteProcedure<int> count;
   RemoteProcedure<void> wait;
+  RemoteProcedure<int, int> slow;
+  RemoteProcedure<void> fail;
+  RemoteProcedure<int, elle::protocol::Chunks> upload;
+  RemoteProcedure<elle::protocol::Chunks, int, int> download;
+  RemoteProcedure<elle::protocol::Chunks> faulty;
+  RemoteProcedure<void> expire;
+  RemoteProcedure<void> corrupt;
+};
+
+/// A client expecting a procedure the server does not know.
+struct ExtendedRPC:
+  public DummyRPC
+{
+  ExtendedRPC(elle::protocol::ChanneledStream& channels)
+    : DummyRPC(channels)
+    , missing("missing", *this)
+  {}
+
+  RemoteProcedure<void> missing;
 };
 
 class RPCServer
@@ -56,6 +160,9 @@ public:
   RPCServer(TestConfig config)
     : _config(config)
     , _counter(0)
+    , _cancelled(0)
+    , _consumed(0)
+    , _produced(0)
     , _server()
     , _thread(elle::sprintf("%s runner", *this), [this] { this->_run(); })
   {
@@ -82,28 +189,30 @@ public:
   void
   _run()
   {
-    auto& sched = *elle::reactor::Scheduler::scheduler();
     auto socket = this->_server.accept();
-    elle::protocol::Serializer s(sched, *socket, _config.version, _config.checksum);
-    elle::protocol::ChanneledStream channels(sched, s, _config.version);
-
+    elle::protocol::Serializer s(*socket, _config.version, _config.checksum);
+    elle::protocol::ChanneledStream channels(s);
+    channels.batching(this->_config.batching);
     DummyRPC rpc(channels);
     rpc.answer = [] { return 42; };
     rpc.square = [] (int x) { return x * x; };
     rpc.concat = []
       (std::string const& a, std::string const& b) { return a + b; };
     rpc.raise = [] { throw std::runtime_error("blablabla"); };
-    rpc.suicide = []
+    rpc.suicide = [this]
       {
         suicide_thread->terminate();
         suicide_thread = nullptr;
-        elle::reactor::yield();
-        elle::reactor::yield();
-        elle::reactor::yield();
-        elle::reactor::yield();
-        elle::reactor::yield();
-        elle::reactor::yield();
-        BOOST_CHECK(false);
+        // The dying caller cancels the call.
+        try
+        {
+          elle::reactor::sleep();
+        }
+        catch (elle::reactor::Terminate const&)
+        {
+          ++this->_cancelled;
+          throw;
+        }
       };
     rpc.count =
       [this]
@@ -112,7 +221,66 @@ public:
         elle::reactor::wait(this->_count_barrier);
         return this->_counter;
       };
-    rpc.wait = [this] { ++this->_counter; elle::reactor::sleep(); };
+    rpc.wait = [this]
+      {
+        ++this->_counter;
+        try
+        {
+          elle::reactor::sleep();
+        }
+        catch (elle::reactor::Terminate const&)
+        {
+          ++this->_cancelled;
+          throw;
+        }
+      };
+    rpc.fail = [] { throw elle::Error("not found"); };
+    rpc.expire = []
+      {
+        elle::reactor::TimeoutGuard guard(10_ms);
+        elle::reactor::Barrier never;
+        elle::reactor::wait(never);
+      };
+    rpc.corrupt = [] { throw elle::serialization::Error("corrupted"); };
+    rpc.slow = [this] (int x)
+      {
+        elle::reactor::wait(this->_slow_barrier);
+        return x;
+      };
+    // Consume slowly, to let the caller run ahead if it can.
+    rpc.upload = [this] (elle::protocol::Chunks chunks)
+      {
+        auto res = 0;
+        while (auto chunk = chunks.next())
+        {
+          ++this->_consumed;
+          res += chunk->size();
+          elle::reactor::yield();
+        }
+        return res;
+      };
+    rpc.download = [this] (int count, int size)
+      {
+        this->_produced = 0;
+        return elle::protocol::Chunks(
+          [this, count, size] () -> boost::optional<elle::Buffer>
+          {
+            if (this->_produced == count)
+              return boost::none;
+            return elle::Buffer(std::string(size, 'a' + this->_produced++));
+          });
+      };
+    rpc.faulty = []
+      {
+        auto i = std::make_shared<int>(0);
+        return elle::protocol::Chunks(
+          [i] () -> boost::optional<elle::Buffer>
+          {
+            if ((*i)++ == 2)
+              throw elle::Error("disk failure");
+            return elle::Buffer("chunk");
+          });
+      };
     try
     {
       if (this->_config.sync)
@@ -126,7 +294,11 @@ public:
 
   ELLE_ATTRIBUTE_R(TestConfig, config);
   ELLE_ATTRIBUTE_R(int, counter);
+  ELLE_ATTRIBUTE_R(int, cancelled);
+  ELLE_ATTRIBUTE_R(int, consumed);
+  ELLE_ATTRIBUTE_R(int, produced);
   ELLE_ATTRIBUTE_RX(elle::reactor::Barrier, count_barrier)
+  ELLE_ATTRIBUTE_RX(elle::reactor::Barrier, slow_barrier)
   ELLE_ATTRIBUTE(elle::reactor::network::TCPServer, server);
   ELLE_ATTRIBUTE(elle::reactor::Thread, thread);
 };
@@ -140,7 +312,7 @@ ELLE_TEST_SCHEDULED(rpc, (TestConfig, config))
   RPCServer server(config);
   elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
   elle::protocol::Serializer s(socket, config.version, config.checksum);
-  elle::protocol::ChanneledStream channels(s, config.version);
+  elle::protocol::ChanneledStream channels(s);
   DummyRPC rpc(channels);
   BOOST_CHECK_EQUAL(rpc.answer(), 42);
   BOOST_CHECK_EQUAL(rpc.square(8), 64);
@@ -161,12 +333,15 @@ ELLE_TEST_SCHEDULED(terminate, (TestConfig, config))
     {
       elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
       elle::protocol::Serializer s(socket, config.version, config.checksum);
-      elle::protocol::ChanneledStream channels(s, config.version);
+      elle::protocol::ChanneledStream channels(s);
       DummyRPC rpc(channels);
       suicide_thread = &thread;
       BOOST_CHECK_THROW(rpc.suicide(), std::runtime_error);
     });
   elle::reactor::wait(thread);
+  if (!config.sync && cancellable(config))
+    while (server.cancelled() != 1)
+      elle::reactor::yield();
 }
 
 /*---------.
@@ -178,7 +353,7 @@ ELLE_TEST_SCHEDULED(parallel, (TestConfig, config))
   RPCServer server(config);
   elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
   elle::protocol::Serializer s(socket, config.version, config.checksum);
-  elle::protocol::ChanneledStream channels(s, config.version);
+  elle::protocol::ChanneledStream channels(s);
   DummyRPC rpc(channels);
   std::vector<elle::reactor::Thread*> threads;
   std::list<int> inserted;
@@ -220,7 +395,7 @@ ELLE_TEST_SCHEDULED(disconnection, (TestConfig, config))
   RPCServer server(config);
   elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
   elle::protocol::Serializer s(socket, config.version, config.checksum);
-  elle::protocol::ChanneledStream channels(s, config.version);
+  elle::protocol::ChanneledStream channels(s);
   DummyRPC rpc(channels);
   elle::reactor::Thread call_1("call 1",
                          [&]
@@ -241,34 +416,490 @@ ELLE_TEST_SCHEDULED(disconnection, (TestConfig, config))
   elle::reactor::wait({call_1, call_2});
 }
 
+/*-------------.
+| Multiplexing |
+`-------------*/
+
+// Answers come back as they are ready, not in the order of the calls.
+ELLE_TEST_SCHEDULED(out_of_order, (TestConfig, config))
+{
+  // A sequential server answers in order.
+  if (config.sync)
+    return;
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  elle::reactor::Thread slow(
+    "slow", [&] { BOOST_CHECK_EQUAL(rpc.slow(7), 7); });
+  elle::reactor::yield();
+  BOOST_CHECK_EQUAL(rpc.square(3), 9);
+  BOOST_CHECK(!slow.done());
+  server.slow_barrier().open();
+  elle::reactor::wait(slow);
+}
+
+// Many calls from many threads share the connection.
+ELLE_TEST_SCHEDULED(concurrent, (TestConfig, config))
+{
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+  {
+    for (int i = 0; i < 200; ++i)
+      scope.run_background(
+        elle::sprintf("call %s", i),
+        [&, i] { BOOST_CHECK_EQUAL(rpc.square(i), i * i); });
+    elle::reactor::wait(scope);
+  };
+}
+
+// Calls past their deadline are abandoned, and the server terminates them.
+ELLE_TEST_SCHEDULED(deadline, (TestConfig, config))
+{
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  rpc.wait.timeout(100_ms);
+  BOOST_CHECK_THROW(rpc.wait(), elle::reactor::Timeout);
+  BOOST_CHECK_EQUAL(server.counter(), 1);
+  if (!config.sync)
+  {
+    if (cancellable(config))
+      while (server.cancelled() != 1)
+        elle::reactor::yield();
+    // The connection is still usable.
+    BOOST_CHECK_EQUAL(rpc.answer(), 42);
+    rpc.timeout(10_sec);
+    BOOST_CHECK_EQUAL(rpc.square(8), 64);
+  }
+}
+
+// Terminating a caller cancels its call on the server.
+ELLE_TEST_SCHEDULED(cancel, (TestConfig, config))
+{
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  elle::reactor::Thread caller("caller", [&] { rpc.wait(); });
+  while (server.counter() != 1)
+    elle::reactor::yield();
+  caller.terminate_now();
+  if (!config.sync)
+  {
+    if (cancellable(config))
+      while (server.cancelled() != 1)
+        elle::reactor::yield();
+    BOOST_CHECK_EQUAL(rpc.answer(), 42);
+    BOOST_CHECK_EQUAL(server.cancelled(), cancellable(config) ? 1 : 0);
+  }
+}
+
+/*-------.
+| Errors |
+`-------*/
+
+namespace
+{
+  elle::protocol::RPCError
+  rpc_error(std::function<void ()> const& call)
+  {
+    try
+    {
+      call();
+    }
+    catch (elle::protocol::RPCError const& e)
+    {
+      return e;
+    }
+    BOOST_FAIL("no RPCError thrown");
+    elle::unreachable();
+  }
+
+  std::vector<elle::StackFrame>
+  remote_frames(elle::protocol::RPCError const& e)
+  {
+    try
+    {
+      std::rethrow_exception(e.inner_exception());
+    }
+    catch (elle::Exception const& inner)
+    {
+      return inner.backtrace().frames();
+    }
+  }
+}
+
+// Errors come with a code and the remote exception type, and a backtrace
+// only when asked for.
+ELLE_TEST_SCHEDULED(errors, (TestConfig, config))
+{
+  using Code = elle::protocol::RPCError::Code;
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  ExtendedRPC rpc(channels);
+  {
+    auto e = rpc_error([&] { rpc.fail(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::failed);
+    BOOST_CHECK(e.is<elle::Error>());
+    BOOST_CHECK(remote_frames(e).empty());
+    BOOST_CHECK_NE(std::string(e.what()).find("not found"),
+                   std::string::npos);
+  }
+  {
+    auto e = rpc_error([&] { rpc.raise(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::failed);
+    BOOST_CHECK(e.is<std::runtime_error>());
+    BOOST_CHECK_EQUAL(e.type(), "std::runtime_error");
+  }
+  {
+    auto e = rpc_error([&] { rpc.expire(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::timeout);
+    BOOST_CHECK(e.is<elle::reactor::Timeout>());
+  }
+  {
+    auto e = rpc_error([&] { rpc.corrupt(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::serialization);
+    BOOST_CHECK(e.is<elle::serialization::Error>());
+  }
+  {
+    auto e = rpc_error([&] { rpc.missing(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::unknown_procedure);
+    BOOST_CHECK_EQUAL(e.type(), "");
+  }
+  rpc.backtraces(true);
+  {
+    auto e = rpc_error([&] { rpc.fail(); });
+    BOOST_CHECK_EQUAL(e.code(), Code::failed);
+    BOOST_CHECK(!remote_frames(e).empty());
+  }
+  // The connection is still usable.
+  BOOST_CHECK_EQUAL(rpc.answer(), 42);
+}
+
+/*---------.
+| Batching |
+`---------*/
+
+// Calls issued together share packets both ways, and are served concurrently.
+ELLE_TEST_SCHEDULED(batching, (TestConfig, config))
+{
+  auto& batches = elle::metrics::counter("elle.protocol.ChanneledStream.batches");
+  for (auto window: {0_ms, 1_ms})
+  {
+    config.batching = window;
+    RPCServer server(config);
+    elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+    elle::protocol::Serializer s(socket, config.version, config.checksum);
+    elle::protocol::ChanneledStream channels(s);
+    channels.batching(window);
+    DummyRPC rpc(channels);
+    auto const before = batches.value();
+    elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+    {
+      for (int i = 0; i < 50; ++i)
+        scope.run_background(
+          elle::sprintf("call %s", i),
+          [&, i] { BOOST_CHECK_EQUAL(rpc.square(i), i * i); });
+      elle::reactor::wait(scope);
+    };
+    // At least one batch of questions, and one of answers unless served one
+    // by one. Older peers get packets one by one.
+    if (batched(config))
+      BOOST_CHECK_GE(batches.value() - before, config.sync ? 1 : 2);
+    else
+      BOOST_CHECK_EQUAL(batches.value(), before);
+    // A lone call is sent as is.
+    BOOST_CHECK_EQUAL(rpc.answer(), 42);
+  }
+}
+
+/*----------.
+| Streaming |
+`----------*/
+
+namespace
+{
+  elle::protocol::Chunks
+  chunks(int count, int size, std::function<void (int)> const& produced = {})
+  {
+    auto i = std::make_shared<int>(0);
+    return elle::protocol::Chunks(
+      [=] () -> boost::optional<elle::Buffer>
+      {
+        if (*i == count)
+          return boost::none;
+        if (produced)
+          produced(*i);
+        return elle::Buffer(std::string(size, 'a' + (*i)++ % 26));
+      });
+  }
+}
+
+// Streamed arguments are consumed as they come, the caller never runs more
+// than a window ahead.
+ELLE_TEST_SCHEDULED(upload, (TestConfig, config))
+{
+  auto const window = elle::protocol::ChunkLink::window;
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  auto ahead = 0;
+  BOOST_CHECK_EQUAL(
+    rpc.upload(chunks(100, 1000,
+                      [&] (int i)
+                      {
+                        ahead = std::max(ahead, i - server.consumed());
+                      })),
+    100000);
+  BOOST_CHECK_EQUAL(server.consumed(), 100);
+  BOOST_CHECK_LE(ahead, window + 1);
+  BOOST_CHECK_EQUAL(rpc.upload(chunks(0, 0)), 0);
+  // A failing source aborts the call.
+  auto failing = elle::protocol::Chunks(
+    [] () -> boost::optional<elle::Buffer>
+    {
+      throw std::runtime_error("unreadable");
+    });
+  BOOST_CHECK_THROW(rpc.upload(failing), std::runtime_error);
+  BOOST_CHECK_EQUAL(rpc.answer(), 42);
+}
+
+// Streamed results are produced as they are consumed, and dropping them
+// stops the producer.
+ELLE_TEST_SCHEDULED(download, (TestConfig, config))
+{
+  auto const window = elle::protocol::ChunkLink::window;
+  RPCServer server(config);
+  elle::reactor::network::TCPSocket socket("127.0.0.1", server.port());
+  elle::protocol::Serializer s(socket, config.version, config.checksum);
+  elle::protocol::ChanneledStream channels(s);
+  DummyRPC rpc(channels);
+  {
+    auto res = rpc.download(100, 1000);
+    auto count = 0;
+    while (auto chunk = res.next())
+    {
+      BOOST_CHECK_EQUAL(chunk->size(), 1000);
+      BOOST_CHECK_EQUAL((*chunk)[0], 'a' + count);
+      BOOST_CHECK_LE(server.produced() - count, window + 1);
+      ++count;
+      elle::reactor::yield();
+    }
+    BOOST_CHECK_EQUAL(count, 100);
+  }
+  {
+    auto res = rpc.download(1000, 10);
+    BOOST_CHECK(res.next());
+    BOOST_CHECK(res.next());
+  }
+  // The producer stopped, the connection is still usable.
+  BOOST_CHECK_EQUAL(rpc.answer(), 42);
+  BOOST_CHECK_LE(server.produced(), 2 + window + 1);
+  {
+    auto res = rpc.faulty();
+    BOOST_CHECK(res.next());
+    BOOST_CHECK(res.next());
+    BOOST_CHECK_THROW(res.next(), elle::protocol::RPCError);
+    BOOST_CHECK(!res.next());
+  }
+  BOOST_CHECK_EQUAL(rpc.answer(), 42);
+}
+
+/*-----.
+| Pool |
+`-----*/
+
+// Calls go to the least loaded connection, and broken connections are
+// replaced in the background.
+ELLE_TEST_SCHEDULED(pool, (TestConfig, config))
+{
+  auto const size = 3;
+  elle::reactor::network::TCPServer server;
+  server.listen();
+  auto connections = std::vector<elle::reactor::Thread*>{};
+  elle::reactor::Barrier slow;
+  auto listener = elle::reactor::Thread::unique_ptr(
+    new elle::reactor::Thread(
+      "listener",
+      [&]
+      {
+        elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& s)
+        {
+          while (true)
+          {
+            auto socket =
+              std::shared_ptr<elle::reactor::network::Socket>(server.accept());
+            connections.push_back(&s.run_background(
+              elle::sprintf("connection %s", connections.size()),
+              [&, socket]
+              {
+                elle::protocol::Serializer serializer(
+                  *socket, config.version, config.checksum);
+                elle::protocol::ChanneledStream channels(serializer);
+                DummyRPC rpc(channels);
+                rpc.answer = [] { return 42; };
+                rpc.slow = [&] (int x)
+                  {
+                    elle::reactor::wait(slow);
+                    return x;
+                  };
+                try
+                {
+                  if (config.sync)
+                    rpc.run();
+                  else
+                    rpc.parallel_run();
+                }
+                catch (elle::reactor::network::Error const&)
+                {}
+              }));
+          }
+        };
+      }));
+  auto streams =
+    std::unordered_map<DummyRPC*, elle::protocol::ChanneledStream*>{};
+  elle::protocol::RPCPool<DummyRPC> pool(
+    [&]
+    {
+      return std::make_unique<elle::reactor::network::TCPSocket>(
+        "127.0.0.1", server.port());
+    },
+    size, config.version, config.checksum, {}, {},
+    [&] (elle::protocol::ChanneledStream& channels, DummyRPC& rpc)
+    {
+      streams[&rpc] = &channels;
+    });
+  pool.backoff_min(std::chrono::milliseconds(10));
+  BOOST_CHECK_EQUAL(pool.call([] (DummyRPC& rpc) { return rpc.answer(); }),
+                    42);
+  while (pool.ready() != size)
+    elle::reactor::yield();
+  BOOST_CHECK_EQUAL(connections.size(), size);
+  // Concurrent calls spread evenly.
+  auto used = std::unordered_map<DummyRPC*, int>{};
+  elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+  {
+    for (int i = 0; i < size * 2; ++i)
+      scope.run_background(
+        elle::sprintf("call %s", i),
+        [&, i]
+        {
+          BOOST_CHECK_EQUAL(
+            pool.call(
+              [&] (DummyRPC& rpc)
+              {
+                ++used[&rpc];
+                return rpc.slow(i);
+              }),
+            i);
+        });
+    elle::reactor::yield();
+    elle::reactor::yield();
+    slow.open();
+    elle::reactor::wait(scope);
+  };
+  BOOST_CHECK_EQUAL(used.size(), size);
+  for (auto const& u: used)
+    BOOST_CHECK_EQUAL(u.second, 2);
+  // A dropped connection is noticed and reopened, calls go elsewhere
+  // meanwhile.
+  connections[0]->terminate_now();
+  while (pool.ready() == size)
+    elle::reactor::yield();
+  BOOST_CHECK_EQUAL(
+    pool.call([] (DummyRPC& rpc) { return rpc.answer(); }), 42);
+  while (pool.ready() != size)
+    elle::reactor::yield();
+  BOOST_CHECK_EQUAL(connections.size(), size + 1);
+  for (int i = 0; i < size; ++i)
+    BOOST_CHECK_EQUAL(
+      pool.call([] (DummyRPC& rpc) { return rpc.answer(); }), 42);
+  // A call failing before anything was written is retried on a fresh
+  // connection.
+  auto attempts = 0;
+  BOOST_CHECK_EQUAL(
+    pool.call(
+      [&] (DummyRPC& rpc)
+      {
+        if (!attempts++)
+        {
+          auto dropped = false;
+          boost::signals2::scoped_connection watch =
+            streams.at(&rpc)->read_failed().connect([&] { dropped = true; });
+          for (int i = 1; i <= size; ++i)
+            connections[i]->terminate_now();
+          while (!dropped)
+            elle::reactor::yield();
+        }
+        return rpc.answer();
+      }),
+    42);
+  BOOST_CHECK_EQUAL(attempts, 2);
+  while (pool.ready() != size)
+    elle::reactor::yield();
+  BOOST_CHECK_EQUAL(connections.size(), 2 * size + 1);
+}
+
 /*-----------.
 | Test suite |
 `-----------*/
 
-#define ELLE_TEST_NAMED_CASE(func, name)\
-  ::boost::unit_test::make_test_case(func, name)
-
 ELLE_TEST_SUITE()
 {
   auto& suite = boost::unit_test::framework::master_test_suite();
   TestConfig configs[] = {
-    {true,  false, elle::Version(0, 1, 0)},
-    {true,  false, elle::Version(0, 2, 0)},
-    {true,  true,  elle::Version(0, 1, 0)},
-    {true,  true,  elle::Version(0, 2, 0)},
-    {false, true,  elle::Version(0, 1, 0)},
-    {false, true,  elle::Version(0, 2, 0)},
-    {false, false, elle::Version(0, 1, 0)},
-    {false, false, elle::Version(0, 2, 0)},
+    {true,  false, elle::Version(0, 1, 0), {}},
+    {true,  false, elle::Version(0, 2, 0), {}},
+    {true,  true,  elle::Version(0, 1, 0), {}},
+    {true,  true,  elle::Version(0, 2, 0), {}},
+    {false, true,  elle::Version(0, 1, 0), {}},
+    {false, true,  elle::Version(0, 2, 0), {}},
+    {false, false, elle::Version(0, 1, 0), {}},
+    {false, false, elle::Version(0, 2, 0), {}},
+    {true,  true,  elle::Version(0, 4, 0), {}},
+    {false, true,  elle::Version(0, 4, 0), {}},
+    {true,  true,  elle::Version(0, 6, 0), {}},
+    {false, true,  elle::Version(0, 6, 0), {}},
+    {true,  true,  elle::Version(0, 8, 0), {}},
+    {false, true,  elle::Version(0, 8, 0), {}},
   };
   auto test = [&](std::string const& name, std::function<void(TestConfig)> f)
   {
-    for (int i=0; i<8; ++i)
-      suite.add(
-        BOOST_TEST_CASE(std::bind(f, configs[i])), 0, valgrind(1, 10));
+    auto sub = BOOST_TEST_SUITE(name);
+    suite.add(sub);
+    for (auto const& config: configs)
+      sub->add(
+        ELLE_TEST_CASE(std::bind(f, config),
+                       elle::sprintf("%s_%s_%s",
+                                     config.sync ? "sync" : "parallel",
+                                     config.checksum ? "checksum" : "plain",
+                                     config.version)),
+        0, valgrind(1, 10));
   };
   test("rpc", &rpc);
   test("terminate", &terminate);
   test("parallel", &parallel);
   test("disconnection", &disconnection);
+  test("out_of_order", &out_of_order);
+  test("concurrent", &concurrent);
+  test("deadline", &deadline);
+  test("cancel", &cancel);
+  test("errors", &errors);
+  test("batching", &batching);
+  test("upload", &upload);
+  test("download", &download);
+  test("pool", &pool);
 }
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include <elle/Buffer.hh>
+#include <elle/With.hh>
+#include <elle/err.hh>
+#include <elle/metrics.hh>
+#include <elle/printf.hh>
+#include <elle/protocol/Channel.hh>
+#include <elle/protocol/ChanneledStream.hh>
+#include <elle/protocol/Serializer.hh>
+#include <elle/reactor/Scope.hh>
+#include <elle/reactor/network/TCPServer.hh>
+#include <elle/reactor/network/TCPSocket.hh>
+#include <elle/reactor/scheduler.hh>
+
+// Not an automated test: measure the throughput of Serializer.
+//
+// Usage: serializer-bench [megabytes] [packet size]
+//
+// Send packets between the two ends of a loopback TCP connection with each
+// checksum scheme, directly and through a Channel, and report the throughput
+// and the number of bytes copied in the socket stream buffer per packet.
+//
+// Then send a corpus of JSON documents and binary blobs with each
+// compression setting, and report the bytes sent and the time spent
+// compressing and decompressing per packet.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  void
+  bench(char const* name,
+        elle::Version const& version,
+        bool checksum,
+        bool channeled,
+        int count,
+        elle::Buffer const& packet)
+  {
+    elle::reactor::network::TCPServer server;
+    server.listen(0);
+    elle::reactor::network::TCPSocket client("127.0.0.1", server.port());
+    auto accepted = server.accept();
+    auto& buffered = elle::metrics::counter(
+      "elle.reactor.network.Socket.write.buffered");
+    auto const buffered_start = buffered.value();
+    auto const start = Clock::now();
+    elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+    {
+      scope.run_background(
+        "writer",
+        [&]
+        {
+          elle::protocol::Serializer s(client, version, checksum);
+          if (channeled)
+          {
+            elle::protocol::ChanneledStream stream(s);
+            elle::protocol::Channel channel(stream);
+            for (int i = 0; i < count; ++i)
+              channel.write(packet);
+          }
+          else
+            for (int i = 0; i < count; ++i)
+              s.write(packet);
+        });
+      scope.run_background(
+        "reader",
+        [&]
+        {
+          elle::protocol::Serializer s(*accepted, version, checksum);
+          auto check = [&] (int i, elle::Buffer const& p)
+            {
+              if (p.size() != packet.size())
+                elle::err("packet %s: unexpected size", i);
+            };
+          if (channeled)
+          {
+            elle::protocol::ChanneledStream stream(s);
+            auto channel = stream.accept();
+            for (int i = 0; i < count; ++i)
+              check(i, channel.read());
+          }
+          else
+            for (int i = 0; i < count; ++i)
+              check(i, s.read());
+        });
+      scope.wait();
+    };
+    auto const seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    elle::fprintf(std::cout, "%-32s %8.1f MB/s %10.1f buffered bytes/packet\n",
+                  name, double(count) * packet.size() / seconds / 1e6,
+                  double(buffered.value() - buffered_start) / count);
+  }
+
+  // Small and large JSON documents, and binary blobs: half of them
+  // compressible, as RPC payloads.
+  std::vector<elle::Buffer>
+  corpus(int count)
+  {
+    auto res = std::vector<elle::Buffer>{};
+    for (int i = 0; i < count; ++i)
+    {
+      auto json = std::string("[");
+      for (int j = 0; j < (i % 4 == 0 ? 400 : 8); ++j)
+        json += elle::sprintf(
+          "{\"id\": %s, \"owner\": \"user-%s\", \"size\": %s, "
+          "\"replicas\": [\"node-%s\", \"node-%s\"]},",
+          i * 1000 + j, j % 17, (i * j) % 65536, j % 5, (j + 1) % 5);
+      json += "]";
+      res.emplace_back(json);
+      auto blob = elle::Buffer(i % 4 == 0 ? 64 << 10 : 600);
+      auto seed = uint32_t(i + 1);
+      for (auto& b: blob)
+        b = static_cast<elle::Buffer::Byte>((seed = seed * 1103515245 + 12345)
+                                            >> 16);
+      res.emplace_back(std::move(blob));
+    }
+    return res;
+  }
+
+  void
+  bench_compression(char const* name,
+                    elle::protocol::Compression const& compression,
+                    std::vector<elle::Buffer> const& packets)
+  {
+    elle::reactor::network::TCPServer server;
+    server.listen(0);
+    elle::reactor::network::TCPSocket client("127.0.0.1", server.port());
+    auto accepted = server.accept();
+    auto& sent = elle::metrics::counter(
+      "elle.protocol.Serializer.compression.sent");
+    auto& raw = elle::metrics::counter(
+      "elle.protocol.Serializer.compression.raw");
+    auto& compress = elle::metrics::histogram(
+      "elle.protocol.Serializer.compression.compress");
+    auto& decompress = elle::metrics::histogram(
+      "elle.protocol.Serializer.compression.decompress");
+    auto const sent_start = sent.value();
+    auto const raw_start = raw.value();
+    auto const compress_start = compress.distribution().sum;
+    auto const decompress_start = decompress.distribution().sum;
+    auto total = uint64_t(0);
+    auto small = uint64_t(0);
+    for (auto const& p: packets)
+    {
+      total += p.size();
+      if (p.size() < compression.threshold)
+        small += p.size() + 1;
+    }
+    auto const start = Clock::now();
+    elle::With<elle::reactor::Scope>() << [&] (elle::reactor::Scope& scope)
+    {
+      auto const version = elle::Version(0, 5, 0);
+      scope.run_background(
+        "writer",
+        [&]
+        {
+          elle::protocol::Serializer s(
+            client, version, true, {}, {}, 2 << 16, compression);
+          for (auto const& p: packets)
+            s.write(p);
+        });
+      scope.run_background(
+        "reader",
+        [&]
+        {
+          elle::protocol::Serializer s(
+            *accepted, version, true, {}, {}, 2 << 16, compression);
+          for (auto const& p: packets)
+            if (s.read().size() != p.size())
+              elle::err("unexpected packet size");
+        });
+      scope.wait();
+    };
+    auto const seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+    auto const count = double(packets.size());
+    auto const wire = compression.algorithm ==
+      elle::protocol::Compression::Algorithm::none
+      ? double(total)
+      : double(sent.value() - sent_start + small);
+    elle::fprintf(
+      std::cout,
+      "%-32s %8.1f MB/s %5.1f%% of %s bytes on the wire, "
+      "%6.1f us compress %6.1f us decompress per packet (%s compressed)\n",
+      name, total / seconds / 1e6, 100 * wire / total, total,
+      (compress.distribution().sum - compress_start) / count / 1e3,
+      (decompress.distribution().sum - decompress_start) / count / 1e3,
+      raw.value() - raw_start);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const megabytes =
+    argc > 1 ? boost::lexical_cast<int>(argv[1]) : 512;
+  auto const packet_size =
+    argc > 2 ? boost::lexical_cast<int>(argv[2]) : 1 << 20;
+  auto const count = std::max(1, int(megabytes * (1LL << 20) / packet_size));
+  auto packet = elle::Buffer(packet_size);
+  for (int i = 0; i < packet_size; ++i)
+    packet[i] = static_cast<elle::Buffer::Byte>(i * 7 + 3);
+  elle::reactor::Scheduler sched;
+  elle::reactor::Thread main(
+    sched, "main",
+    [&]
+    {
+      for (auto channeled: {false, true})
+      {
+        auto const name = [&] (char const* scheme)
+          {
+            return elle::sprintf("%s%s", scheme, channeled ? ", channel" : "");
+          };
+        bench(name("0.3.0, SHA-1").c_str(), elle::Version(0, 3, 0), true,
+              channeled, count, packet);
+        bench(name("0.4.0, CRC-32C").c_str(), elle::Version(0, 4, 0), true,
+              channeled, count, packet);
+        bench(name("0.4.0, no checksum").c_str(), elle::Version(0, 4, 0),
+              false, channeled, count, packet);
+      }
+      using Algorithm = elle::protocol::Compression::Algorithm;
+      auto const packets = corpus(std::max(4, megabytes * 8));
+      auto dictionary = elle::Buffer(
+        "{\"id\": , \"owner\": \"user-\", \"size\": , "
+        "\"replicas\": [\"node-\", \"node-\"]},");
+      bench_compression("no compression", {}, packets);
+      bench_compression("deflate 1", {Algorithm::deflate}, packets);
+      bench_compression("deflate 6", {Algorithm::deflate, 256, 6}, packets);
+      bench_compression("deflate 1, dictionary",
+                        {Algorithm::deflate, 256, 1, dictionary}, packets);
+    });
+  sched.run();
+  return 0;
+}
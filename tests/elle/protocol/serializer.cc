@@ -4,6 +4,7 @@
 #include <elle/ScopedAssignment.hh>
 #include <elle/With.hh>
 #include <elle/cast.hh>
+#include <elle/metrics.hh>
 #include <elle/test.hh>
 
 #include <elle/cryptography/random.hh>
@@ -21,6 +22,8 @@
 #include <elle/reactor/network/TCPSocket.hh>
 #include <elle/reactor/scheduler.hh>
 
+#include <elle/serialization/binary.hh>
+
 ELLE_LOG_COMPONENT("elle.protocol.test");
 
 constexpr static elle::Buffer::Size buffer_size = 4096;
@@ -403,7 +406,8 @@ dialog(elle::Version const& version,
 
 #define CASES(function)                                                 \
   for (auto const& version: {elle::Version{0, 1, 0},                    \
-                             elle::Version{0, 2, 0}})                   \
+                             elle::Version{0, 2, 0},                    \
+                             elle::Version{0, 4, 0}})                   \
     for (auto checksum: {true, false})                                  \
       ELLE_LOG("case: version = %s, checksum = %s", version, checksum)  \
         function(version, checksum)                                     \
@@ -749,7 +753,9 @@ ELLE_TEST_SCHEDULED(eof)
 
 ELLE_TEST_SCHEDULED(message)
 {
-  for (auto version: {elle::Version{0, 2, 0}, elle::Version{0, 3, 0}})
+  for (auto version: {elle::Version{0, 2, 0},
+                      elle::Version{0, 3, 0},
+                      elle::Version{0, 4, 0}})
   {
     uint32_t chunk_size = 0;
     dialog<Connector>(
@@ -814,7 +820,9 @@ ELLE_TEST_SCHEDULED(interruption2)
   // Check that terminating a Channel.read() call does not lose an unrelated
   // packet.
   namespace ip = elle::protocol;
-  for (auto version: {elle::Version{0, 2, 0}, elle::Version{0, 3, 0}})
+  for (auto version: {elle::Version{0, 2, 0},
+                      elle::Version{0, 3, 0},
+                      elle::Version{0, 4, 0}})
   {
     ELLE_LOG("test version %s", version);
     elle::reactor::Barrier pinger_block;
@@ -977,6 +985,146 @@ ELLE_TEST_SCHEDULED(ping)
     std::chrono::milliseconds(200));
 }
 
+// A 0.4 peer falls back to SHA-1 checksums with a 0.3 one.
+ELLE_TEST_SCHEDULED(checksum_negotiation)
+{
+  auto const packet = elle::Buffer(std::string(3 * 4096 + 17, 'x'));
+  for (auto const& versions: {std::make_pair(elle::Version(0, 4, 0),
+                                             elle::Version(0, 3, 0)),
+                              std::make_pair(elle::Version(0, 4, 0),
+                                             elle::Version(0, 4, 0))})
+  {
+    ELLE_LOG("alice: %s, bob: %s", versions.first, versions.second);
+    auto const expected = std::min(versions.first, versions.second);
+    Connector sockets;
+    elle::reactor::Thread alice(
+      "alice",
+      [&]
+      {
+        elle::protocol::Serializer s(
+          sockets.alice(), versions.first, true, {}, {}, 4096);
+        BOOST_TEST(s.version() == expected);
+        s.write(packet);
+        BOOST_TEST(s.read() == packet);
+      });
+    elle::reactor::Thread bob(
+      "bob",
+      [&]
+      {
+        elle::protocol::Serializer s(
+          sockets.bob(), versions.second, true, {}, {}, 4096);
+        BOOST_TEST(s.version() == expected);
+        BOOST_TEST(s.read() == packet);
+        s.write(packet);
+      });
+    elle::reactor::wait(elle::reactor::Waitables{&alice, &bob});
+  }
+}
+
+// Bytes the socket stream reads ahead while negotiating the version must reach
+// the Serializer, which then reads from the socket directly.
+ELLE_TEST_SCHEDULED(read_ahead)
+{
+  auto const version = elle::Version(0, 4, 0);
+  auto const packet = elle::Buffer(std::string(3 * 4096 + 17, 'x'));
+  // A version followed by a packet, as a peer would send them.
+  auto wire = std::stringstream{};
+  elle::serialization::binary::serialize(version, wire);
+  wire.seekp(0);
+  {
+    // Negotiate with itself: overwrite and read back the same version.
+    elle::protocol::Serializer s(wire, version);
+    s.write(packet);
+    s.write(packet);
+  }
+  elle::reactor::network::TCPServer server;
+  server.listen(0);
+  elle::reactor::network::TCPSocket alice("127.0.0.1", server.port());
+  auto bob = server.accept();
+  alice.write(elle::ConstWeakBuffer(wire.str()));
+  elle::protocol::Serializer s(*bob, version);
+  BOOST_TEST(s.read() == packet);
+  BOOST_TEST(s.read() == packet);
+}
+
+// Packets are compressed only if both ends agree on it, and only if worth it.
+ELLE_TEST_SCHEDULED(compression)
+{
+  using Algorithm = elle::protocol::Compression::Algorithm;
+  auto json = std::string{};
+  for (int i = 0; json.size() < 3 * 4096 + 17; ++i)
+    json += elle::sprintf("{\"key\": \"%s\", \"value\": %s},", i, i * i);
+  auto const packets = std::vector<elle::Buffer>{
+    elle::Buffer("small"),
+    elle::Buffer(json),
+    elle::cryptography::random::generate<elle::Buffer>(3 * 4096 + 17),
+  };
+  auto const deflate = elle::protocol::Compression{Algorithm::deflate};
+  auto const dictionary =
+    elle::protocol::Compression{Algorithm::deflate, 64, 1,
+                                elle::Buffer("{\"key\": \"\", \"value\": }")};
+  struct Case
+  {
+    elle::Version version;
+    elle::protocol::Compression alice;
+    elle::protocol::Compression bob;
+    Algorithm expected;
+  };
+  auto const& raw =
+    elle::metrics::counter("elle.protocol.Serializer.compression.raw");
+  auto const& sent =
+    elle::metrics::counter("elle.protocol.Serializer.compression.sent");
+  for (auto const& c: {
+      Case{elle::Version(0, 5, 0), deflate, deflate, Algorithm::deflate},
+      Case{elle::Version(0, 5, 0), dictionary, dictionary, Algorithm::deflate},
+      Case{elle::Version(0, 5, 0), deflate, {}, Algorithm::none},
+      Case{elle::Version(0, 5, 0), deflate, dictionary, Algorithm::none},
+      Case{elle::Version(0, 4, 0), deflate, deflate, Algorithm::none},
+    })
+  {
+    ELLE_LOG("version %s, expect compression %s",
+             c.version, int(c.expected));
+    auto const raw_start = raw.value();
+    auto const sent_start = sent.value();
+    Connector sockets;
+    elle::reactor::Thread alice(
+      "alice",
+      [&]
+      {
+        elle::protocol::Serializer s(
+          sockets.alice(), c.version, true, {}, {}, 4096, c.alice);
+        BOOST_TEST(int(s.compression()) == int(c.expected));
+        for (auto const& packet: packets)
+          s.write(packet);
+        for (auto const& packet: packets)
+          BOOST_TEST(s.read() == packet);
+      });
+    elle::reactor::Thread bob(
+      "bob",
+      [&]
+      {
+        elle::protocol::Serializer s(
+          sockets.bob(), c.version, true, {}, {}, 4096, c.bob);
+        BOOST_TEST(int(s.compression()) == int(c.expected));
+        for (auto const& packet: packets)
+          BOOST_TEST(s.read() == packet);
+        for (auto const& packet: packets)
+          s.write(packet);
+      });
+    elle::reactor::wait(elle::reactor::Waitables{&alice, &bob});
+    if (c.expected == Algorithm::none)
+      BOOST_TEST(raw.value() == raw_start);
+    else
+    {
+      // The JSON shrinks, random bytes are sent as is.
+      BOOST_TEST(raw.value() - raw_start ==
+                 2 * (packets[1].size() + packets[2].size()));
+      BOOST_TEST(sent.value() - sent_start <
+                 2 * (packets[1].size() / 2 + packets[2].size() + 1));
+    }
+  }
+}
+
 class YAStream:
   public elle::IOStream
 {
@@ -1094,6 +1242,9 @@ ELLE_TEST_SUITE()
   suite.add(BOOST_TEST_CASE(connection_lost_reader), 0, valgrind(3, 10));
   suite.add(BOOST_TEST_CASE(connection_lost_sender), 0, valgrind(3, 10));
   suite.add(BOOST_TEST_CASE(corruption), 0, valgrind(3, 10));
+  suite.add(BOOST_TEST_CASE(checksum_negotiation), 0, valgrind(3, 10));
+  suite.add(BOOST_TEST_CASE(read_ahead), 0, valgrind(3, 10));
+  suite.add(BOOST_TEST_CASE(compression), 0, valgrind(3, 10));
   suite.add(BOOST_TEST_CASE(interruption), 0, valgrind(6, 15));
   suite.add(BOOST_TEST_CASE(interruption2), 0, valgrind(6, 15));
   {
@@ -1101,7 +1252,8 @@ ELLE_TEST_SUITE()
     suite.add(sub);
     for (auto const& version: {elle::Version(0, 1, 0),
                                elle::Version(0, 2, 0),
-                               elle::Version(0, 3, 0)})
+                               elle::Version(0, 3, 0),
+                               elle::Version(0, 4, 0)})
       sub->add(ELLE_TEST_CASE(std::bind(read_interruption, version),
                               elle::sprintf("%s", version)), 0, valgrind(1));
   }
@@ -4,8 +4,12 @@
 # include <elle/reactor/backend/coro_io/backend.hh>
 #elif defined REACTOR_CORO_BACKEND_BOOST_CONTEXT
 # include <elle/reactor/backend/boost/backend.hh>
+# include <elle/reactor/backend/boost/stack-pool.hh>
 #endif
 
+#include <algorithm>
+#include <array>
+
 #include <boost/range/algorithm/for_each.hpp>
 
 using elle::reactor::backend::Thread;
@@ -125,6 +129,78 @@ namespace
     val *= 10;
     t->step();
   }
+
+  /// Check coro can run on a custom stack size.
+  template <typename Backend>
+  void
+  test_stack_size()
+  {
+    auto&& m = Backend{};
+    auto sum = 0;
+    auto coro = [&m, &sum]
+    {
+      auto array = std::array<int, 1024>{};
+      boost::for_each(array, [](auto& i) { i = 1; });
+      m.current()->yield();
+      boost::for_each(array, [&sum](auto i) { sum += i; });
+    };
+    auto t = m.make_thread("coro", coro, 16 * 1024);
+    t->step();
+    t->step();
+    BOOST_CHECK(t->status() == Thread::Status::done);
+    BOOST_TEST(sum == 1024);
+  }
+
+#if defined REACTOR_CORO_BACKEND_BOOST_CONTEXT
+  void
+  stack_pool()
+  {
+    using elle::reactor::backend::boost::StackPool;
+    auto& pool = StackPool::instance();
+    BOOST_TEST(StackPool::round(10000) == 16384u);
+    BOOST_TEST(StackPool::round(16384) == 16384u);
+    auto const before = pool.statistics();
+    auto const top = pool.allocate(10000);
+    {
+      auto const stats = pool.statistics();
+      BOOST_TEST(stats.stacks == before.stacks + 1);
+      BOOST_TEST(stats.used == before.used + 16384);
+      BOOST_TEST(stats.peak_stacks >= stats.stacks);
+      BOOST_TEST(stats.mapped >= stats.used);
+    }
+    // Touch the whole stack.
+    std::fill(static_cast<char*>(top) - 16384, static_cast<char*>(top), 1);
+    pool.deallocate(top, 10000);
+    {
+      auto const stats = pool.statistics();
+      BOOST_TEST(stats.stacks == before.stacks);
+      BOOST_TEST(stats.used == before.used);
+      BOOST_TEST(stats.resident >= 16384u);
+    }
+    // Stacks are recycled.
+    auto const again = pool.allocate(16384);
+    BOOST_TEST(again == top);
+    pool.deallocate(again, 16384);
+    // Stacks above the largest size class are mapped on their own.
+    auto const huge = std::size_t(16) << 20;
+    auto const big = pool.allocate(huge);
+    {
+      auto const stats = pool.statistics();
+      BOOST_TEST(stats.stacks == before.stacks + 1);
+      BOOST_TEST(stats.used == before.used + huge);
+      BOOST_TEST(stats.pooled == before.pooled);
+      BOOST_TEST(stats.mapped >= before.mapped + huge);
+    }
+    std::fill(static_cast<char*>(big) - huge, static_cast<char*>(big), 1);
+    pool.deallocate(big, huge);
+    {
+      auto const stats = pool.statistics();
+      BOOST_TEST(stats.stacks == before.stacks);
+      BOOST_TEST(stats.used == before.used);
+      BOOST_TEST(stats.mapped == before.mapped);
+    }
+  }
+#endif
 }
 
 ELLE_TEST_SUITE()
@@ -146,4 +222,8 @@ ELLE_TEST_SUITE()
   TEST(deadlock_switch);
   TEST(status);
   TEST(stack);
+  TEST(stack_size);
+#if defined REACTOR_CORO_BACKEND_BOOST_CONTEXT
+  backend->add(BOOST_TEST_CASE(stack_pool), 0, 10);
+#endif
 }
@@ -6,6 +6,7 @@
 
 #include <elle/Buffer.hh>
 #include <elle/With.hh>
+#include <elle/metrics.hh>
 #include <elle/test.hh>
 #include <elle/utility/Move.hh>
 
@@ -52,6 +53,16 @@ ELLE_TEST_SCHEDULED(simple)
   BOOST_CHECK_EQUAL(page, elle::ConstWeakBuffer("/simple"));
 }
 
+ELLE_TEST_SCHEDULED(metrics)
+{
+  HTTPServer server;
+  server.register_metrics();
+  elle::metrics::counter("test.http.metrics").increment(42);
+  auto page = elle::reactor::http::get(server.url("metrics"));
+  BOOST_CHECK(page.string().find("test.http.metrics 42\n") !=
+              std::string::npos);
+}
+
 ELLE_TEST_SCHEDULED(complex)
 {
   HTTPServer server;
@@ -789,6 +800,7 @@ ELLE_TEST_SUITE()
 {
   auto& suite = boost::unit_test::framework::master_test_suite();
   suite.add(BOOST_TEST_CASE(simple), 0, valgrind(1));
+  suite.add(BOOST_TEST_CASE(metrics), 0, valgrind(1));
   suite.add(BOOST_TEST_CASE(complex), 0, valgrind(1));
   suite.add(BOOST_TEST_CASE(not_found), 0, valgrind(1));
   suite.add(BOOST_TEST_CASE(bad_request), 0, valgrind(1));
@@ -1,6 +1,8 @@
+#include <array>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <sstream>
 
 #include "reactor.hh"
 
@@ -12,12 +14,14 @@
 #include <elle/reactor/Channel.hh>
 #include <elle/reactor/MultiLockBarrier.hh>
 #include <elle/reactor/OrWaitable.hh>
+#include <elle/reactor/Profiler.hh>
 #include <elle/reactor/Scope.hh>
 #include <elle/reactor/TimeoutGuard.hh>
 #include <elle/reactor/asio.hh>
 #include <elle/reactor/duration.hh>
 #include <elle/reactor/exception.hh>
 #include <elle/reactor/for-each.hh>
+#include <elle/reactor/multi-scheduler.hh>
 #include <elle/reactor/mutex.hh>
 #include <elle/reactor/rw-mutex.hh>
 #include <elle/reactor/semaphore.hh>
@@ -280,6 +284,25 @@ ELLE_TEST_SCHEDULED(deadlock)
   elle::reactor::wait(*starting);
 }
 
+// Threads may have stacks larger than the largest pooled size.
+ELLE_TEST_SCHEDULED(stack_size_large)
+{
+  auto sum = 0;
+  elle::reactor::Thread large(
+    "large",
+    [&]
+    {
+      // More than 8 MiB of stack.
+      auto array = std::array<char, 9 * 1024 * 1024>{};
+      std::fill(array.begin(), array.end(), 1);
+      elle::reactor::yield();
+      sum = array.front() + array[array.size() / 2] + array.back();
+    },
+    elle::reactor::stack_size = std::size_t(16 * 1024 * 1024));
+  elle::reactor::wait(large);
+  BOOST_TEST(sum == 3);
+}
+
 /*-----.
 | Wait |
 `-----*/
@@ -3359,6 +3382,203 @@ namespace for_each
   }
 }
 
+namespace multi_scheduler
+{
+  // Boost.Test is not thread safe: jobs record what they see in atomics,
+  // checked once the pool is done.
+
+  static
+  void
+  jobs()
+  {
+    elle::reactor::MultiScheduler pool(4);
+    std::atomic<int> count(0);
+    std::atomic<int> outside(0);
+    for (int i = 0; i < 256; ++i)
+      pool.spawn(
+        elle::sprintf("job %s", i),
+        [&]
+        {
+          if (pool.current() == -1)
+            ++outside;
+          elle::reactor::yield();
+          ++count;
+        });
+    pool.run();
+    BOOST_CHECK_EQUAL(count.load(), 256);
+    BOOST_CHECK_EQUAL(outside.load(), 0);
+  }
+
+  static
+  void
+  pinned()
+  {
+    elle::reactor::MultiScheduler pool(4);
+    std::atomic<int> count(0);
+    std::atomic<int> misplaced(0);
+    for (int i = 0; i < 64; ++i)
+      pool.spawn(
+        elle::sprintf("job %s", i),
+        [&, i]
+        {
+          auto const worker = i % pool.size();
+          if (pool.current() != worker ||
+              elle::reactor::Scheduler::scheduler() != &pool.worker(worker))
+            ++misplaced;
+          // Children stay on the worker of their parent.
+          elle::reactor::Thread child(
+            "child",
+            [&, worker]
+            {
+              if (pool.current() != worker)
+                ++misplaced;
+            });
+          elle::reactor::wait(child);
+          ++count;
+        },
+        i % pool.size());
+    pool.run();
+    BOOST_CHECK_EQUAL(count.load(), 64);
+    BOOST_CHECK_EQUAL(misplaced.load(), 0);
+    BOOST_CHECK_EQUAL(pool.stolen(), 0);
+  }
+
+  static
+  void
+  steal()
+  {
+    elle::reactor::MultiScheduler pool(2);
+    std::atomic<int> count(0);
+    std::atomic<int> misplaced(0);
+    std::atomic<bool> released(false);
+    // Keep worker 1 from stealing until the jobs are spawned.
+    pool.spawn(
+      "blocker",
+      [&]
+      {
+        while (!released)
+          std::this_thread::yield();
+      },
+      1);
+    // Spawn jobs from a job that then keeps worker 0 busy until they are all
+    // done. It yields, so worker 0 keeps polling, but never runs out of
+    // runnable Threads: the jobs queued on worker 0 are left for worker 1 to
+    // steal.
+    pool.spawn(
+      "hog",
+      [&]
+      {
+        for (int i = 0; i < 32; ++i)
+          pool.spawn(elle::sprintf("job %s", i),
+                     [&]
+                     {
+                       if (pool.current() != 1)
+                         ++misplaced;
+                       ++count;
+                     });
+        for (int i = 0; i < 3; ++i)
+          elle::reactor::yield();
+        released = true;
+        while (count < 32)
+        {
+          std::this_thread::yield();
+          elle::reactor::yield();
+        }
+      },
+      0);
+    pool.run();
+    BOOST_CHECK_EQUAL(count.load(), 32);
+    BOOST_CHECK_EQUAL(misplaced.load(), 0);
+    BOOST_CHECK_GT(pool.stolen(), 0);
+  }
+
+  static
+  void
+  exception()
+  {
+    elle::reactor::MultiScheduler pool(4);
+    pool.spawn("sleeper", [] { elle::reactor::sleep(); });
+    pool.spawn("thrower",
+               []
+               {
+                 elle::reactor::yield();
+                 throw BeaconException();
+               });
+    BOOST_CHECK_THROW(pool.run(), BeaconException);
+  }
+}
+
+namespace profiler
+{
+  static
+  void
+  statistics()
+  {
+    elle::reactor::Scheduler sched;
+    sched.profile(true);
+    auto const busy = std::chrono::milliseconds(2);
+    elle::reactor::Barrier gate("gate");
+    elle::reactor::Thread waiter(
+      sched, "waiter",
+      [&]
+      {
+        elle::reactor::wait(gate);
+      });
+    elle::reactor::Thread opener(
+      sched, "opener",
+      [&]
+      {
+        std::this_thread::sleep_for(busy);
+        elle::reactor::yield();
+        gate.open();
+      });
+    sched.run();
+    auto const& stats = sched.profiler()->statistics();
+    auto const& w = stats.at("waiter");
+    BOOST_CHECK_EQUAL(w.steps, 2u);
+    BOOST_CHECK_EQUAL(w.wakeups, 1u);
+    BOOST_CHECK(w.frozen.at("gate") >= busy);
+    auto const& o = stats.at("opener");
+    BOOST_CHECK_EQUAL(o.steps, 2u);
+    BOOST_CHECK(o.running >= busy);
+    BOOST_CHECK(o.step_max >= busy);
+    std::stringstream collapsed;
+    sched.profiler()->collapsed(collapsed);
+    BOOST_CHECK_NE(collapsed.str().find("waiter;frozen;gate "),
+                   std::string::npos);
+    BOOST_CHECK_NE(collapsed.str().find("opener;running "), std::string::npos);
+    std::stringstream trace;
+    sched.profiler()->chrome_trace(trace);
+    BOOST_CHECK_NE(trace.str().find(
+                     "\"name\":\"thread_name\",\"args\":{\"name\":\"waiter\"}"),
+                   std::string::npos);
+    BOOST_CHECK_NE(trace.str().find("\"name\":\"gate\",\"cat\":\"frozen\""),
+                   std::string::npos);
+    sched.profile(false);
+    BOOST_CHECK(!sched.profiler());
+  }
+
+  static
+  void
+  anonymous()
+  {
+    elle::reactor::Scheduler sched;
+    sched.profile(true);
+    elle::reactor::Thread sleeper(
+      sched, "sleeper",
+      [&]
+      {
+        elle::reactor::sleep(10_ms);
+      });
+    sched.run();
+    // Anonymous Waitables are named after their type.
+    auto const& frozen = sched.profiler()->statistics().at("sleeper").frozen;
+    BOOST_CHECK_EQUAL(frozen.size(), 1u);
+    BOOST_CHECK_EQUAL(frozen.begin()->first, "elle::reactor::Sleep");
+    BOOST_CHECK(frozen.begin()->second >= std::chrono::milliseconds(10));
+  }
+}
+
 /*-----.
 | Main |
 `-----*/
@@ -3375,6 +3595,7 @@ ELLE_TEST_SUITE()
     basics->add(BOOST_TEST_CASE(non_managed), 0, valgrind(1, 5));
     basics->add(BOOST_TEST_CASE(unique_ptr), 0, valgrind(1, 5));
     basics->add(BOOST_TEST_CASE(deadlock), 0, valgrind(1, 5));
+    basics->add(BOOST_TEST_CASE(stack_size_large), 0, valgrind(1, 5));
   }
 
   {
@@ -3630,4 +3851,26 @@ ELLE_TEST_SUITE()
     auto parallel_break = &for_each::parallel_break;
     s->add(BOOST_TEST_CASE(parallel_break));
   }
+
+  {
+    boost::unit_test::test_suite* s = BOOST_TEST_SUITE("multi_scheduler");
+    boost::unit_test::framework::master_test_suite().add(s);
+    auto jobs = &multi_scheduler::jobs;
+    s->add(BOOST_TEST_CASE(jobs), 0, valgrind(1, 5));
+    auto pinned = &multi_scheduler::pinned;
+    s->add(BOOST_TEST_CASE(pinned), 0, valgrind(1, 5));
+    auto steal = &multi_scheduler::steal;
+    s->add(BOOST_TEST_CASE(steal), 0, valgrind(1, 5));
+    auto exception = &multi_scheduler::exception;
+    s->add(BOOST_TEST_CASE(exception), 0, valgrind(1, 5));
+  }
+
+  {
+    boost::unit_test::test_suite* s = BOOST_TEST_SUITE("profiler");
+    boost::unit_test::framework::master_test_suite().add(s);
+    auto statistics = &profiler::statistics;
+    s->add(BOOST_TEST_CASE(statistics), 0, valgrind(1, 5));
+    auto anonymous = &profiler::anonymous;
+    s->add(BOOST_TEST_CASE(anonymous), 0, valgrind(1, 5));
+  }
 }
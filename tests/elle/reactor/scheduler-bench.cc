@@ -0,0 +1,167 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <elle/printf.hh>
+#include <elle/reactor/Barrier.hh>
+#include <elle/reactor/multi-scheduler.hh>
+#include <elle/reactor/scheduler.hh>
+#if defined REACTOR_CORO_BACKEND_BOOST_CONTEXT
+# include <elle/reactor/backend/boost/stack-pool.hh>
+#endif
+
+// Not an automated test: measure the reactor scheduling throughput.
+//
+// Usage: scheduler-bench yield [threads] [rounds]
+//        scheduler-bench idle [threads] [stack size]
+//        scheduler-bench scale [jobs] [workers]
+//
+//   yield: run many Threads yielding in a loop on a single Scheduler and report
+//          the context switch rate.
+//   idle:  park many Threads with the given stack size and report the memory
+//          they use.
+//   scale: run CPU-bound jobs on a MultiScheduler with 1, 2, 4, ... workers and
+//          report the throughput and speedup relative to one worker.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  double
+  seconds(Clock::duration d)
+  {
+    return std::chrono::duration<double>(d).count();
+  }
+
+  /// Some CPU work, yielding every now and then like a real coroutine would.
+  void
+  work()
+  {
+    auto volatile h = 14695981039346656037ull;
+    for (int round = 0; round < 16; ++round)
+    {
+      for (int i = 0; i < 20000; ++i)
+        h = (h ^ i) * 1099511628211ull;
+      elle::reactor::yield();
+    }
+  }
+
+  void
+  yield(int threads, int rounds)
+  {
+    elle::reactor::Scheduler sched;
+    for (int i = 0; i < threads; ++i)
+      new elle::reactor::Thread(
+        sched, "yielder",
+        [rounds]
+        {
+          for (int r = 0; r < rounds; ++r)
+            elle::reactor::yield();
+        },
+        true);
+    auto const start = Clock::now();
+    sched.run();
+    auto const time = seconds(Clock::now() - start);
+    auto const switches = double(threads) * (rounds + 1);
+    elle::fprintf(std::cout, "%s threads, %s rounds: %.3fs, %.0f switches/s\n",
+                  threads, rounds, time, switches / time);
+  }
+
+  /// Resident memory of the process, in bytes.
+  std::size_t
+  rss()
+  {
+    auto statm = std::ifstream("/proc/self/statm");
+    auto size = std::size_t(0);
+    auto resident = std::size_t(0);
+    statm >> size >> resident;
+    return resident * ::sysconf(_SC_PAGESIZE);
+  }
+
+  void
+  idle(int threads, int stack_size)
+  {
+    elle::reactor::Scheduler sched;
+    elle::reactor::Thread main(
+      sched, "main",
+      [&]
+      {
+        auto const before = rss();
+        auto barrier = elle::reactor::Barrier{};
+        auto const start = Clock::now();
+        for (int i = 0; i < threads; ++i)
+          new elle::reactor::Thread(
+            "idle", [&] { elle::reactor::wait(barrier); },
+            elle::reactor::dispose = true,
+            elle::reactor::stack_size = std::size_t(stack_size));
+        elle::reactor::yield();
+        elle::reactor::yield();
+        auto const time = seconds(Clock::now() - start);
+        auto const used = rss() - before;
+        elle::fprintf(std::cout,
+                      "%s idle threads: %.3fs to start, %s bytes RSS, "
+                      "%s bytes per thread\n",
+                      threads, time, used, used / threads);
+#if defined REACTOR_CORO_BACKEND_BOOST_CONTEXT
+        elle::fprintf(
+          std::cout, "%s\n",
+          elle::reactor::backend::boost::StackPool::instance().statistics());
+#endif
+        barrier.open();
+      });
+    sched.run();
+  }
+
+  void
+  scale(int jobs, int max)
+  {
+    auto base = 0.;
+    elle::fprintf(std::cout, "%8s %12s %12s %8s %8s\n",
+                  "workers", "time (s)", "jobs/s", "speedup", "stolen");
+    for (int workers = 1; workers <= max; workers *= 2)
+    {
+      elle::reactor::MultiScheduler pool(workers);
+      for (int i = 0; i < jobs; ++i)
+        pool.spawn("job", &work);
+      auto const start = Clock::now();
+      pool.run();
+      auto const time = seconds(Clock::now() - start);
+      auto const rate = jobs / time;
+      if (workers == 1)
+        base = rate;
+      elle::fprintf(std::cout, "%8s %12.3f %12.0f %8.2f %8s\n",
+                    workers, time, rate, rate / base, pool.stolen());
+    }
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const mode = argc > 1 ? std::string(argv[1]) : std::string("scale");
+  auto arg = [&] (int i, int def)
+    {
+      return argc > i ? boost::lexical_cast<int>(argv[i]) : def;
+    };
+  if (mode == "yield")
+    yield(arg(2, 100000), arg(3, 100));
+  else if (mode == "idle")
+    idle(arg(2, 1000000), arg(3, 16 * 1024));
+  else if (mode == "scale")
+    scale(arg(2, 4096), arg(3, std::thread::hardware_concurrency()));
+  else
+  {
+    std::cerr << "Usage: " << argv[0] << " yield [threads] [rounds]\n"
+              << "       " << argv[0] << " idle [threads] [stack size]\n"
+              << "       " << argv[0] << " scale [jobs] [workers]"
+              << std::endl;
+    return 1;
+  }
+  return 0;
+}
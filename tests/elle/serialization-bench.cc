@@ -0,0 +1,199 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/optional.hpp>
+
+#include <elle/Buffer.hh>
+#include <elle/IOStream.hh>
+#include <elle/err.hh>
+#include <elle/printf.hh>
+#include <elle/serialization/binary.hh>
+
+// Not an automated test: measure the cost of binary serialization.
+//
+// Usage: serialization-bench [rounds]
+//
+// Serialize a block and an RPC call, typical of what goes to disk and over
+// the wire, to a std::ostream and to a Buffer, deserialize them back from
+// both, or borrow the payload of the block, and report the time per
+// operation.
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct Block
+  {
+    Block(int i, int size)
+      : address(32)
+      , owner(elle::sprintf("user-%s@example.com", i))
+      , version(i)
+      , signature(elle::Buffer(64))
+      , replicas{"node-1", "node-2", "node-3"}
+      , data(size)
+    {
+      for (int j = 0; j < 32; ++j)
+        this->address[j] = i + j;
+    }
+
+    Block(elle::serialization::SerializerIn& s)
+    {
+      this->serialize(s);
+    }
+
+    void
+    serialize(elle::serialization::Serializer& s)
+    {
+      s.serialize("address", this->address);
+      s.serialize("owner", this->owner);
+      s.serialize("version", this->version);
+      s.serialize("signature", this->signature);
+      s.serialize("replicas", this->replicas);
+      s.serialize("data", this->data);
+    }
+
+    elle::Buffer address;
+    std::string owner;
+    int64_t version;
+    boost::optional<elle::Buffer> signature;
+    std::vector<std::string> replicas;
+    elle::Buffer data;
+  };
+
+  /// A Block whose payload is borrowed from the serialized data.
+  struct BlockView
+  {
+    BlockView(elle::serialization::SerializerIn& s)
+    {
+      s.serialize("address", this->address);
+      s.serialize("owner", this->owner);
+      s.serialize("version", this->version);
+      s.serialize("signature", this->signature);
+      s.serialize("replicas", this->replicas);
+      s.serialize("data", this->data);
+    }
+
+    elle::ConstWeakBuffer address;
+    std::string owner;
+    int64_t version;
+    boost::optional<elle::Buffer> signature;
+    std::vector<std::string> replicas;
+    elle::ConstWeakBuffer data;
+  };
+
+  struct Call
+  {
+    Call(int i)
+      : id(i)
+      , procedure("fetch_block")
+      , arguments{i, i * 1000, -i, 1 << 20}
+      , metadata{{"deadline", "250ms"}, {"trace", "8f3a9c01"}}
+    {}
+
+    Call(elle::serialization::SerializerIn& s)
+    {
+      this->serialize(s);
+    }
+
+    void
+    serialize(elle::serialization::Serializer& s)
+    {
+      s.serialize("id", this->id);
+      s.serialize("procedure", this->procedure);
+      s.serialize("arguments", this->arguments);
+      s.serialize("metadata", this->metadata);
+    }
+
+    uint64_t id;
+    std::string procedure;
+    std::vector<int64_t> arguments;
+    std::unordered_map<std::string, std::string> metadata;
+  };
+
+  /// Keep results alive so the work is not optimized away.
+  std::size_t volatile sink;
+
+  template <typename F>
+  void
+  bench(char const* name, int rounds, F const& f)
+  {
+    auto const start = Clock::now();
+    for (int i = 0; i < rounds; ++i)
+      sink = sink + f(i);
+    auto const time =
+      std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    elle::fprintf(std::cout, "%-32s %8.0f ns/op\n", name, time / rounds);
+  }
+
+  template <typename T>
+  void
+  bench_type(char const* name, int rounds, T const& value)
+  {
+    auto const serialized =
+      elle::serialization::binary::serialize(value, false);
+    {
+      auto stream = std::stringstream{};
+      elle::serialization::binary::serialize(value, stream, false);
+      if (stream.str() != serialized.string())
+        elle::err("%s: Buffer and stream serializations differ", name);
+    }
+    elle::fprintf(std::cout, "%s: %s bytes\n", name, serialized.size());
+    bench("  serialize to stream", rounds, [&] (int)
+          {
+            auto stream = std::stringstream{};
+            elle::serialization::binary::serialize(value, stream, false);
+            return stream.tellp();
+          });
+    bench("  serialize to Buffer", rounds, [&] (int)
+          {
+            return
+              elle::serialization::binary::serialize(value, false).size();
+          });
+    bench("  deserialize from stream", rounds, [&] (int)
+          {
+            elle::IOStream stream(serialized.istreambuf());
+            auto const res =
+              elle::serialization::binary::deserialize<T>(stream, false);
+            return sizeof res;
+          });
+    bench("  deserialize from Buffer", rounds, [&] (int)
+          {
+            auto const res =
+              elle::serialization::binary::deserialize<T>(serialized, false);
+            return sizeof res;
+          });
+  }
+
+  void
+  bench_borrow(char const* name, int rounds, Block const& value)
+  {
+    auto const serialized =
+      elle::serialization::binary::serialize(value, false);
+    elle::fprintf(std::cout, "%s: %s bytes\n", name, serialized.size());
+    bench("  borrow from Buffer", rounds, [&] (int)
+          {
+            auto s = elle::serialization::binary::BorrowingSerializerIn(
+              serialized, false);
+            auto const res = BlockView(s);
+            return res.data.size();
+          });
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  auto const rounds =
+    argc > 1 ? boost::lexical_cast<int>(argv[1]) : 100000;
+  bench_type("small block", rounds, Block(1, 256));
+  bench_type("4KB block", rounds, Block(2, 4096));
+  bench_type("RPC call", rounds, Call(3));
+  bench_borrow("small block view", rounds, Block(1, 256));
+  bench_borrow("4KB block view", rounds, Block(2, 4096));
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <deque>
+#include <limits>
 #include <list>
 #include <sstream>
 #include <string>
@@ -65,6 +66,41 @@ namespace std
   };
 }
 
+/// JSON, written and read incrementally.
+class IncrementalJson
+{
+public:
+  class SerializerIn
+    : public elle::serialization::json::SerializerIn
+  {
+  public:
+    using Super = elle::serialization::json::SerializerIn;
+
+    SerializerIn(std::istream& input, bool versioned = true)
+      : Super(input, versioned, true)
+    {}
+
+    SerializerIn(std::istream& input, Versions versions, bool versioned = true)
+      : Super(input, std::move(versions), versioned, true)
+    {}
+  };
+
+  class SerializerOut
+    : public elle::serialization::json::SerializerOut
+  {
+  public:
+    using Super = elle::serialization::json::SerializerOut;
+
+    SerializerOut(std::ostream& output, bool versioned = true)
+      : Super(output, versioned, false, true)
+    {}
+
+    SerializerOut(std::ostream& output, Versions versions, bool versioned = true)
+      : Super(output, std::move(versions), versioned, false, true)
+    {}
+  };
+};
+
 template <typename Format>
 static
 void
@@ -1514,6 +1550,256 @@ json_optionals()
   }
 }
 
+/// Where the input was when an element was deserialized.
+class Progress
+{
+public:
+  Progress(elle::serialization::SerializerIn& s)
+    : _id(s.deserialize<int>("id"))
+  {
+    std::istream* input = nullptr;
+    s.serialize_context(input);
+    this->_offset = input->tellg();
+  }
+
+  void
+  serialize(elle::serialization::Serializer& s)
+  {
+    s.serialize("id", this->_id);
+  }
+
+  using serialization_tag = elle::serialization_tag;
+  ELLE_ATTRIBUTE_R(int, id);
+  ELLE_ATTRIBUTE_R(std::streamoff, offset);
+};
+
+static
+void
+json_incremental()
+{
+  using elle::serialization::json::SerializerIn;
+  using elle::serialization::json::SerializerOut;
+  ELLE_LOG("write tokens as they are serialized")
+  {
+    std::stringstream output;
+    {
+      SerializerOut s(output, false, false, true);
+      auto i = 1;
+      s.serialize("i", i);
+      BOOST_CHECK_EQUAL(output.str(), "{\"i\":1");
+      auto v = std::vector<boost::optional<int>>{2, boost::none};
+      s.serialize("v", v);
+      auto none = boost::optional<int>{};
+      s.serialize("none", none);
+      auto empty = std::vector<int>{};
+      s.serialize("empty", empty);
+      BOOST_CHECK_EQUAL(output.str(), "{\"i\":1,\"v\":[2,null],\"empty\":[]");
+    }
+    BOOST_CHECK_EQUAL(output.str(), "{\"i\":1,\"v\":[2,null],\"empty\":[]}\n");
+  }
+  ELLE_LOG("pretty print")
+  {
+    std::stringstream tree;
+    std::stringstream incremental;
+    auto v = std::vector<int>{1, 2};
+    {
+      SerializerOut s(tree, false, true);
+      s.serialize("v", v);
+    }
+    {
+      SerializerOut s(incremental, false, true, true);
+      s.serialize("v", v);
+    }
+    BOOST_CHECK_EQUAL(incremental.str(), tree.str());
+  }
+  ELLE_LOG("read keys out of order")
+  {
+    std::stringstream input(
+      "{\"b\": [1, 2], \"c\": {\"x\": [[]]}, \"a\": \"a\", \"d\": null, "
+      "\"e\": 5}");
+    SerializerIn s(input, false, true);
+    BOOST_CHECK_EQUAL(s.deserialize<std::string>("a"), "a");
+    // Scalars are kept.
+    BOOST_CHECK_EQUAL(s.deserialize<std::string>("a"), "a");
+    BOOST_CHECK_EQUAL(s.deserialize<std::vector<int>>("b"),
+                      (std::vector<int>{1, 2}));
+    BOOST_CHECK(!s.deserialize<boost::optional<int>>("d"));
+    BOOST_CHECK(!s.deserialize<boost::optional<int>>("f"));
+    BOOST_CHECK_EQUAL(s.deserialize<int>("e"), 5);
+    BOOST_CHECK_THROW(s.deserialize<int>("f"),
+                      elle::serialization::MissingKey);
+  }
+  ELLE_LOG("skip what is left of a value")
+  {
+    std::stringstream input(
+      "{\"o\": {\"x\": 1, \"y\": [1, {\"z\": []}]}, \"v\": [[1, 2], [3]],"
+      " \"w\": 4}");
+    SerializerIn s(input, false, true);
+    auto const o = std::string("o");
+    if (auto entry = s.enter(o))
+      BOOST_CHECK_EQUAL(s.deserialize<int>("x"), 1);
+    BOOST_CHECK_EQUAL(s.deserialize<std::vector<std::vector<int>>>("v"),
+                      (std::vector<std::vector<int>>{{1, 2}, {3}}));
+    BOOST_CHECK_EQUAL(s.deserialize<int>("w"), 4);
+    // Containers are gone once read.
+    BOOST_CHECK_THROW(s.deserialize<std::vector<std::vector<int>>>("v"),
+                      elle::serialization::Error);
+  }
+  ELLE_LOG("skip every level left open")
+  {
+    std::stringstream input(
+      "{\"inner\": {\"leaf\": {\"v\": 1, \"x\": [2]}, \"y\": 3}, \"w\": 2}");
+    SerializerIn s(input, false, true);
+    auto const inner = std::string("inner");
+    auto const leaf = std::string("leaf");
+    if (auto i = s.enter(inner))
+      if (auto l = s.enter(leaf))
+        BOOST_CHECK_EQUAL(s.deserialize<int>("v"), 1);
+    BOOST_CHECK_EQUAL(s.deserialize<int>("w"), 2);
+  }
+  ELLE_LOG("report invalid JSON when reading it")
+  {
+    std::stringstream input("{\"a\": 1, \"b\": [1, 2 }");
+    SerializerIn s(input, false, true);
+    BOOST_CHECK_EQUAL(s.deserialize<int>("a"), 1);
+    BOOST_CHECK_THROW(s.deserialize<std::vector<int>>("b"),
+                      elle::serialization::Error);
+  }
+  ELLE_LOG("read arrays element by element")
+  {
+    std::stringstream input;
+    input << '[';
+    for (int i = 0; i < 1000; ++i)
+      input << elle::sprintf("{\"id\": %s},", i);
+    input << ']';
+    auto const size = input.str().size();
+    SerializerIn s(input, false, true);
+    s.set_context<std::istream*>(&input);
+    auto const elements = s.deserialize<std::vector<Progress>>();
+    BOOST_REQUIRE_EQUAL(elements.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+      BOOST_CHECK_EQUAL(elements[i].id(), i);
+      // Each element was read on its own, not the whole array at once.
+      BOOST_CHECK_LT(elements[i].offset(), size * (i + 2) / 1000);
+    }
+  }
+}
+
+static
+void
+binary_buffer()
+{
+  auto const numbers = std::vector<int64_t>{
+    0, 1, -1, 63, 64, -64, 8191, 8192, -8192, 1 << 20, -(1 << 20),
+    std::numeric_limits<int32_t>::max(),
+    std::numeric_limits<int32_t>::min(),
+    std::numeric_limits<int64_t>::max(),
+    std::numeric_limits<int64_t>::min() + 1,
+  };
+  auto const strings =
+    std::vector<std::string>{"", "castor", std::string(300, 'p')};
+  auto const buffer = elle::Buffer(std::string(5000, 'b'));
+  auto const serialize = [&] (elle::serialization::SerializerOut& s)
+    {
+      s.serialize("numbers", numbers);
+      s.serialize("strings", strings);
+      s.serialize("buffer", buffer);
+      s.serialize("double", 0.5);
+      s.serialize("bool", true);
+      s.serialize("byte", uint8_t(200));
+      s.serialize("short", int16_t(-300));
+      s.serialize("unsigned", std::numeric_limits<uint64_t>::max());
+      // Binary names are not tracked.
+      BOOST_TEST(s.current_name() == "");
+    };
+  std::stringstream stream;
+  {
+    elle::serialization::binary::SerializerOut s(stream, false);
+    serialize(s);
+  }
+  ELLE_LOG("serialize to a Buffer")
+  {
+    // Appended, byte for byte as to a stream.
+    auto res = elle::Buffer("prefix");
+    {
+      elle::serialization::binary::SerializerOut s(res, false);
+      serialize(s);
+    }
+    BOOST_CHECK_EQUAL(res, elle::Buffer("prefix" + stream.str()));
+  }
+  ELLE_LOG("serialize to a Buffer by value")
+  {
+    std::stringstream expected;
+    elle::serialization::binary::serialize(strings, expected, false);
+    BOOST_CHECK_EQUAL(elle::serialization::binary::serialize(strings, false),
+                      elle::Buffer(expected.str()));
+  }
+  ELLE_LOG("deserialize")
+  {
+    elle::serialization::binary::SerializerIn s(stream, false);
+    BOOST_CHECK_EQUAL(s.deserialize<std::vector<int64_t>>("numbers"),
+                      numbers);
+    BOOST_CHECK_EQUAL(s.deserialize<std::vector<std::string>>("strings"),
+                      strings);
+    BOOST_CHECK_EQUAL(s.deserialize<elle::Buffer>("buffer"), buffer);
+    BOOST_CHECK_EQUAL(s.deserialize<double>("double"), 0.5);
+    BOOST_CHECK(s.deserialize<bool>("bool"));
+    BOOST_CHECK_EQUAL(s.deserialize<uint8_t>("byte"), 200);
+    BOOST_CHECK_EQUAL(s.deserialize<int16_t>("short"), -300);
+    BOOST_CHECK_EQUAL(s.deserialize<uint64_t>("unsigned"),
+                      std::numeric_limits<uint64_t>::max());
+  }
+}
+
+static
+void
+binary_borrow()
+{
+  using elle::serialization::binary::BorrowingSerializerIn;
+  using elle::serialization::binary::SerializerIn;
+  static_assert(
+    !std::is_constructible<BorrowingSerializerIn, elle::Buffer&&, bool>(),
+    "borrowing from a temporary");
+  auto const payload = elle::Buffer(std::string(4096, 'p'));
+  auto data = elle::Buffer{};
+  {
+    elle::serialization::binary::SerializerOut s(data, false);
+    s.serialize("id", 42);
+    // Serialized just like a Buffer.
+    s.serialize("payload", elle::ConstWeakBuffer(payload));
+    s.serialize("copy", payload);
+  }
+  ELLE_LOG("borrow")
+  {
+    BorrowingSerializerIn s(data, false);
+    BOOST_CHECK_EQUAL(s.deserialize<int>("id"), 42);
+    auto const borrowed = s.deserialize<elle::ConstWeakBuffer>("payload");
+    BOOST_CHECK_EQUAL(borrowed, payload);
+    BOOST_CHECK(borrowed.contents() > data.contents());
+    BOOST_CHECK(borrowed.contents() + borrowed.size() <
+                data.contents() + data.size());
+    auto const copy = s.deserialize<elle::ConstWeakBuffer>("copy");
+    BOOST_CHECK_EQUAL(copy, payload);
+  }
+  ELLE_LOG("copy from memory")
+  {
+    SerializerIn s(data, false);
+    BOOST_CHECK_EQUAL(s.deserialize<int>("id"), 42);
+    BOOST_CHECK_EQUAL(s.deserialize<elle::Buffer>("payload"), payload);
+    BOOST_CHECK_THROW(s.deserialize<elle::ConstWeakBuffer>("copy"),
+                      elle::serialization::Error);
+  }
+  ELLE_LOG("truncated input")
+  {
+    auto const truncated = elle::ConstWeakBuffer(data.contents(), 100);
+    BorrowingSerializerIn s(truncated, false);
+    BOOST_CHECK_EQUAL(s.deserialize<int>("id"), 42);
+    BOOST_CHECK_THROW(s.deserialize<elle::ConstWeakBuffer>("payload"),
+                      elle::serialization::Error);
+  }
+}
+
 template <typename Format>
 static
 void
@@ -1523,12 +1809,12 @@ text_parser()
   {
     typename Format::SerializerOut ser(stream);
     BOOST_CHECK_EQUAL(ser.text(),
-                      (std::is_same<Format, elle::serialization::Json>::value));
+                      (!std::is_same<Format, elle::serialization::Binary>::value));
   }
   {
     typename Format::SerializerIn ser(stream);
     BOOST_CHECK_EQUAL(ser.text(),
-                      (std::is_same<Format, elle::serialization::Json>::value));
+                      (!std::is_same<Format, elle::serialization::Binary>::value));
   }
 }
 
@@ -1749,6 +2035,8 @@ convert()
     subsuite->add(BOOST_TEST_CASE(json));                               \
     auto binary = &Name<elle::serialization::Binary>;                   \
     subsuite->add(BOOST_TEST_CASE(binary));                             \
+    auto incremental_json = &Name<IncrementalJson>;                     \
+    subsuite->add(BOOST_TEST_CASE(incremental_json));                   \
     suite.add(subsuite);                                                \
   }                                                                     \
 
@@ -1782,6 +2070,8 @@ ELLE_TEST_SUITE()
       s->add(BOOST_TEST_CASE(json));
       auto binary = &hierarchy<elle::serialization::Binary, false>;
       s->add(BOOST_TEST_CASE(binary));
+      auto incremental_json = &hierarchy<IncrementalJson, false>;
+      s->add(BOOST_TEST_CASE(incremental_json));
       subsuite->add(s);
     }
     {
@@ -1790,6 +2080,8 @@ ELLE_TEST_SUITE()
       s->add(BOOST_TEST_CASE(json));
       auto binary = &hierarchy<elle::serialization::Binary, true>;
       s->add(BOOST_TEST_CASE(binary));
+      auto incremental_json = &hierarchy<IncrementalJson, true>;
+      s->add(BOOST_TEST_CASE(incremental_json));
       subsuite->add(s);
     }
     suite.add(subsuite);
@@ -1815,4 +2107,7 @@ ELLE_TEST_SUITE()
   suite.add(BOOST_TEST_CASE(json_iso8601));
   suite.add(BOOST_TEST_CASE(json_unicode_surrogate));
   suite.add(BOOST_TEST_CASE(json_optionals));
+  suite.add(BOOST_TEST_CASE(json_incremental));
+  suite.add(BOOST_TEST_CASE(binary_buffer));
+  suite.add(BOOST_TEST_CASE(binary_borrow));
 }